@@ -213,10 +213,17 @@ C_MODE_START
 /* lf_hash overhead per element (that is, sizeof(LF_SLIST) */
 extern const int LF_HASH_OVERHEAD;
 
-typedef struct {
+struct st_lf_hash;
+typedef uint lf_hash_func(const struct st_lf_hash *, const uchar *, size_t);
+typedef void lf_hash_initializer(struct st_lf_hash *hash, void *dst,
+                                 const void *src);
+
+typedef struct st_lf_hash {
   LF_DYNARRAY array;                    /* hash itself */
   LF_ALLOCATOR alloc;                   /* allocator for elements */
   my_hash_get_key get_key;              /* see HASH */
+  lf_hash_func *hash_function;          /* see HASH */
+  lf_hash_initializer *initializer;     /* called when an element is inserted */
   CHARSET_INFO *charset;                /* see HASH */
   uint key_offset, key_length;          /* see HASH */
   uint element_size;                    /* size of memcpy'ed area on insert */
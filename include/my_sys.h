@@ -744,6 +744,16 @@ extern my_bool radixsort_is_appliccable(uint n_items, size_t size_of_element);
 extern void my_string_ptr_sort(uchar *base,uint items,size_t size);
 extern void radixsort_for_str_ptr(uchar* base[], uint number_of_elements,
 				  size_t size_of_element,uchar *buffer[]);
+/* An element of the work space of radixsort_for_key_prefix() */
+typedef struct st_radix_key_prefix
+{
+  ulonglong prefix;
+  uchar *ptr;
+} RADIX_KEY_PREFIX;
+extern my_bool radixsort_for_key_prefix(uchar **base, uint number_of_elements,
+                                        size_t size_of_element,
+                                        RADIX_KEY_PREFIX *buffer,
+                                        myf my_flags);
 extern qsort_t my_qsort(void *base_ptr, size_t total_elems, size_t size,
                         qsort_cmp cmp);
 extern qsort_t my_qsort2(void *base_ptr, size_t total_elems, size_t size,
@@ -308,11 +308,23 @@ static inline const uchar* hash_key(const LF_HASH *hash,
   bit to distinguish between normal and dummy nodes.
 */
 static inline uint calc_hash(LF_HASH *hash, const uchar *key, uint keylen)
+{
+  return hash->hash_function(hash, key, keylen) & INT_MAX32;
+}
+
+/* Default hash function, see LF_HASH::hash_function */
+static uint cset_hash_sort_adapter(const LF_HASH *hash, const uchar *key,
+                                   size_t length)
 {
   ulong nr1= 1, nr2= 4;
-  hash->charset->coll->hash_sort(hash->charset, (uchar*) key, keylen,
-                                 &nr1, &nr2);
-  return nr1 & INT_MAX32;
+  hash->charset->coll->hash_sort(hash->charset, key, length, &nr1, &nr2);
+  return (uint) nr1;
+}
+
+/* Default initializer, see LF_HASH::initializer */
+static void default_initializer(LF_HASH *hash, void *dst, const void *src)
+{
+  memcpy(dst, src, hash->element_size);
 }
 
 #define MAX_LOAD 1.0    /* average number of elements in a bucket */
@@ -331,6 +343,10 @@ static int initialize_bucket(LF_HASH *, LF_SLIST * volatile*, uint, LF_PINS *);
   DYNAMIC_ARRAY. In this case they should be initialize in the
   LF_ALLOCATOR::constructor, and lf_hash_insert should not overwrite them.
   See wt_init() for example.
+  As an alternative to decreasing LF_HASH::element_size one can set
+  LF_HASH::initializer, which is called instead of memcpy() by
+  lf_hash_insert(). Similarly, LF_HASH::hash_function can be overridden
+  to use a hash value cached in the element instead of hashing the key.
 */
 void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
                   uint key_offset, uint key_length, my_hash_get_key get_key,
@@ -347,6 +363,8 @@ void lf_hash_init(LF_HASH *hash, uint element_size, uint flags,
   hash->key_offset= key_offset;
   hash->key_length= key_length;
   hash->get_key= get_key;
+  hash->hash_function= cset_hash_sort_adapter;
+  hash->initializer= default_initializer;
   DBUG_ASSERT(get_key ? !key_offset && !key_length : key_length);
 }
 
@@ -393,7 +411,7 @@ int lf_hash_insert(LF_HASH *hash, LF_PINS *pins, const void *data)
   node= (LF_SLIST *)_lf_alloc_new(pins);
   if (unlikely(!node))
     return -1;
-  memcpy(node+1, data, hash->element_size);
+  hash->initializer(hash, node + 1, data);
   node->key= hash_key(hash, (uchar *)(node+1), &node->keylen);
   hashnr= calc_hash(hash, node->key, node->keylen);
   bucket= hashnr % hash->size;
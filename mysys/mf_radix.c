@@ -58,3 +58,203 @@ void radixsort_for_str_ptr(uchar **base, uint number_of_elements, size_t size_of
   next:;
   }
 }
+
+
+
+/*
+  Radixsort for pointers to fixed length keys that compare like memcmp().
+
+  Unlike radixsort_for_str_ptr() the keys are not read through the
+  pointers at every pass. 8 bytes of each key are copied, together with
+  the pointer, into an array of (prefix, pointer) pairs, and the sort is
+  done on that array. It is a most significant byte first radix sort:
+  bytes that are the same in all keys of a bucket are skipped without
+  moving anything, and small buckets are finished with an insertion sort.
+  Only when the 8 bytes of a bucket are used up are the next 8 bytes of
+  its keys read through the pointers. So keys need not be short, and
+  common prefixes (like the high bytes of small integers) cost little.
+
+  The sort needs work space for 2 RADIX_KEY_PREFIX per key. If 'buffer'
+  is NULL it is allocated with my_flags. Returns 1 if the allocation
+  failed, in which case 'base' is not changed.
+*/
+
+/* Buckets smaller than this are sorted by insertion sort */
+#define RADIX_INSERTION_SORT_LIMIT 32
+
+/*
+  Buckets below this depth of recursion are sorted by my_qsort2(). As
+  the largest bucket is sorted without recursion, a bucket at depth d
+  has at most 1/2^d of the keys, so this is rarely reached. It bounds
+  the stack used for keys that differ in few bytes each.
+*/
+#define RADIX_MAX_DEPTH 16
+
+typedef struct st_radix_cmp_arg
+{
+  size_t offset, size;
+} RADIX_CMP_ARG;
+
+static void radix_load_prefix(RADIX_KEY_PREFIX *elem, RADIX_KEY_PREFIX *end,
+                              size_t offset, size_t size)
+{
+  size_t length= MY_MIN(size - offset, 8), i;
+  for (; elem < end ; elem++)
+  {
+    const uchar *key= elem->ptr + offset;
+    ulonglong prefix= 0;
+    for (i= 0 ; i < length ; i++)
+      prefix= (prefix << 8) | key[i];
+    elem->prefix= prefix << (8 * (8 - length));
+  }
+}
+
+static int radix_cmp(const RADIX_KEY_PREFIX *a, const RADIX_KEY_PREFIX *b,
+                     size_t offset, size_t size)
+{
+  if (a->prefix != b->prefix)
+    return a->prefix < b->prefix ? -1 : 1;
+  if (offset + 8 >= size)
+    return 0;
+  return memcmp(a->ptr + offset + 8, b->ptr + offset + 8, size - offset - 8);
+}
+
+static int radix_qsort_cmp(const void *arg, const void *a, const void *b)
+{
+  const RADIX_CMP_ARG *cmp_arg= (const RADIX_CMP_ARG*) arg;
+  return radix_cmp((const RADIX_KEY_PREFIX*) a, (const RADIX_KEY_PREFIX*) b,
+                   cmp_arg->offset, cmp_arg->size);
+}
+
+/*
+  Go on to the next key byte of elem[0..n). Returns 0 if there are no
+  more bytes, that is if the keys are equal.
+*/
+
+static my_bool radix_next_byte(RADIX_KEY_PREFIX *elem, uint n, int *shift,
+                               size_t *offset, size_t size)
+{
+  if ((*shift-= 8) >= 0)
+    return 1;
+  if ((*offset+= 8) >= size)
+    return 0;
+  radix_load_prefix(elem, elem + n, *offset, size);
+  *shift= 56;
+  return 1;
+}
+
+/*
+  Sort elem[0..n) on key bytes from offset on, knowing that the bytes
+  before offset and the bytes of prefix above 'shift'+8 are equal.
+
+  Only the buckets that are not the largest one are sorted by recursion,
+  the largest one is sorted in the same call.
+*/
+
+static void radix_sort_prefix(RADIX_KEY_PREFIX *elem, RADIX_KEY_PREFIX *tmp,
+                              uint n, int shift, size_t offset, size_t size,
+                              uint depth)
+{
+  uint32 end[256];
+  uint i, j, largest;
+
+  for (;;)
+  {
+    if (n < RADIX_INSERTION_SORT_LIMIT)
+    {
+      for (i= 1 ; i < n ; i++)
+      {
+        RADIX_KEY_PREFIX key= elem[i];
+        for (j= i ; j > 0 && radix_cmp(&key, elem + j - 1, offset, size) < 0 ;
+             j--)
+          elem[j]= elem[j - 1];
+        elem[j]= key;
+      }
+      return;
+    }
+    if (depth >= RADIX_MAX_DEPTH)
+    {
+      RADIX_CMP_ARG cmp_arg;
+      cmp_arg.offset= offset;
+      cmp_arg.size= size;
+      my_qsort2(elem, n, sizeof(*elem), radix_qsort_cmp, &cmp_arg);
+      return;
+    }
+
+    bzero((uchar*) end, sizeof(end));
+    for (i= 0 ; i < n ; i++)
+      end[(elem[i].prefix >> shift) & 255]++;
+    for (i= 0 ; i < 256 && end[i] != n ; i++) ;
+    if (i < 256)
+    {
+      /* All keys have the same byte here: go on to the next one */
+      if (!radix_next_byte(elem, n, &shift, &offset, size))
+        return;
+      continue;
+    }
+
+    {
+      uint32 sum= 0, count;
+      for (i= 0 ; i < 256 ; i++)
+      {
+        count= end[i];
+        end[i]= sum;
+        sum+= count;
+      }
+    }
+    /* This moves end[i] from the start to the end of bucket i */
+    for (i= 0 ; i < n ; i++)
+      tmp[end[(elem[i].prefix >> shift) & 255]++]= elem[i];
+    memcpy(elem, tmp, n * sizeof(*elem));
+
+    for (i= 1, largest= 0 ; i < 256 ; i++)
+    {
+      if (end[i] - end[i - 1] > end[largest] - (largest ? end[largest - 1] : 0))
+        largest= i;
+    }
+    for (i= 0, j= 0 ; i < 256 ; j= end[i++])
+    {
+      RADIX_KEY_PREFIX *bucket= elem + j;
+      uint count= end[i] - j;
+      int bucket_shift= shift;
+      size_t bucket_offset= offset;
+      if (i == largest || count < 2 ||
+          !radix_next_byte(bucket, count, &bucket_shift, &bucket_offset, size))
+        continue;
+      radix_sort_prefix(bucket, tmp, count, bucket_shift, bucket_offset, size,
+                        depth + 1);
+    }
+
+    j= largest ? end[largest - 1] : 0;
+    elem+= j;
+    n= end[largest] - j;
+    if (n < 2 || !radix_next_byte(elem, n, &shift, &offset, size))
+      return;
+  }
+}
+
+my_bool radixsort_for_key_prefix(uchar **base, uint number_of_elements,
+                                 size_t size_of_element,
+                                 RADIX_KEY_PREFIX *buffer, myf my_flags)
+{
+  RADIX_KEY_PREFIX *elem= buffer;
+  uint i;
+
+  if (!elem &&
+      !(elem= (RADIX_KEY_PREFIX*) my_malloc(2 * number_of_elements *
+                                            sizeof(RADIX_KEY_PREFIX),
+                                            my_flags)))
+    return 1;
+
+  for (i= 0 ; i < number_of_elements ; i++)
+    elem[i].ptr= base[i];
+  radix_load_prefix(elem, elem + number_of_elements, 0, size_of_element);
+  radix_sort_prefix(elem, elem + number_of_elements, number_of_elements, 56,
+                    0, size_of_element, 0);
+  for (i= 0 ; i < number_of_elements ; i++)
+    base[i]= elem[i].ptr;
+
+  if (elem != buffer)
+    my_free(elem);
+  return 0;
+}
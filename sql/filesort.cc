@@ -196,6 +196,7 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
                           table,
                           thd->variables.max_length_for_sort_data,
                           max_rows, sort_positions);
+  param.sort_threads= (uint) thd->variables.sort_threads;
 
   table_sort.addon_buf= 0;
   table_sort.addon_length= param.addon_length;
@@ -254,13 +255,23 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
     set_if_bigger(min_sort_memory, sizeof(BUFFPEK*)*MERGEBUFF2);
     while (memory_available >= min_sort_memory)
     {
-      ulonglong keys= memory_available / (param.rec_length + sizeof(char*));
+      /*
+        The work space for sorting the buffer is allocated with it, out
+        of the sort_buffer_size budget. Less of it is needed if only few
+        keys fit in the buffer with it.
+      */
+      uint work_length= sort_work_length(&param, num_rows);
+      ulonglong keys= memory_available /
+                      (param.rec_length + work_length + sizeof(char*));
+      work_length= sort_work_length(&param, MY_MIN(num_rows, keys));
+      keys= memory_available / (param.rec_length + work_length + sizeof(char*));
       param.max_keys_per_buffer= (uint) MY_MIN(num_rows, keys);
       if (table_sort.get_sort_keys())
       {
         // If we have already allocated a buffer, it better have same size!
         if (!table_sort.check_sort_buffer_properties(param.max_keys_per_buffer,
-                                                     param.rec_length))
+                                                     param.rec_length,
+                                                     work_length))
         {
           /*
             table->sort will still have a pointer to the same buffer,
@@ -269,7 +280,8 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
           table_sort.free_sort_buffer();
         }
       }
-      table_sort.alloc_sort_buffer(param.max_keys_per_buffer, param.rec_length);
+      table_sort.alloc_sort_buffer(param.max_keys_per_buffer, param.rec_length,
+                                   work_length);
       if (table_sort.get_sort_keys())
         break;
       size_t old_memory_available= memory_available;
@@ -333,12 +345,11 @@ ha_rows filesort(THD *thd, TABLE *table, SORT_FIELD *sortorder, uint s_length,
       goto err;
 
     /*
-      Use also the space previously used by string pointers in sort_buffer
-      for temporary key storage.
+      Use also the space previously used by string pointers and the sort
+      work space in sort_buffer for temporary key storage.
     */
-    param.max_keys_per_buffer=((param.max_keys_per_buffer *
-                                (param.rec_length + sizeof(char*))) /
-                               param.rec_length - 1);
+    param.max_keys_per_buffer= (uint) (table_sort.sort_buffer_size() /
+                                       param.rec_length - 1);
     maxbuffer--;				// Offset from 0
     if (merge_many_buff(&param,
                         (uchar*) table_sort.get_sort_keys(),
@@ -1331,10 +1342,13 @@ bool check_if_pq_applicable(Sort_param *param,
 
   ulong num_available_keys=
     memory_available / (param->rec_length + sizeof(char*));
+  // The merge sort buffer also holds the work space for sorting it.
+  ulong num_merge_keys= memory_available /
+    (param->rec_length + sort_work_length(param, num_rows) + sizeof(char*));
   // We need 1 extra record in the buffer, when using PQ.
   param->max_keys_per_buffer= (uint) param->max_rows + 1;
 
-  if (num_rows < num_available_keys)
+  if (num_rows < num_merge_keys)
   {
     // The whole source set fits into memory.
     if (param->max_rows < num_rows/PQ_slowness )
@@ -1365,12 +1379,15 @@ bool check_if_pq_applicable(Sort_param *param,
       param->sort_length + param->ref_length + sizeof(char*);
     num_available_keys= memory_available / row_length;
 
+    num_merge_keys= memory_available /
+      (row_length + sort_work_length(param, num_rows));
+
     // Can we fit all the keys in memory?
     if (param->max_keys_per_buffer < num_available_keys)
     {
       const double sort_merge_cost=
         get_merge_many_buffs_cost_fast(num_rows,
-                                       num_available_keys,
+                                       MY_MAX(num_merge_keys, 1),
                                        row_length);
       /*
         PQ has cost:
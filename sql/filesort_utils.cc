@@ -18,9 +18,22 @@
 #include "sql_sort.h"
 #include "table.h"
 #include "my_sys.h"
+#include "my_pthread.h"
+#include "mysql/psi/mysql_thread.h"
 
 
 namespace {
+/**
+  Sorting fewer keys than this per thread does not pay for the thread
+  creation.
+*/
+const size_t MIN_KEYS_PER_SORT_THREAD= 32768;
+
+/**
+  For fewer keys my_qsort2() is as fast as radixsort_for_key_prefix().
+*/
+const uint MIN_KEYS_FOR_RADIX_SORT= 1000;
+
 /**
   A local helper function. See comments for get_merge_buffers_cost().
  */
@@ -31,6 +44,201 @@ double get_merge_cost(ha_rows num_elements, ha_rows num_buffers, uint elem_size)
     + (double) num_elements * log((double) num_buffers) /
       (TIME_FOR_COMPARE_ROWID * M_LN2);
 }
+
+
+/**
+  A part of the work of parallel_sort_keys(), done by one thread:
+  either sort a run of keys in place, or merge two sorted runs,
+  or copy a run (the odd one out in a merge round).
+*/
+struct Sort_task
+{
+  enum task_type { SORT_RUN, MERGE_RUNS, COPY_RUN };
+  task_type type;
+  uchar **a, **a_end;       // The run to sort/copy, or the left run to merge
+  uchar **b, **b_end;       // The right run to merge
+  uchar **to;               // Destination of merge/copy
+  size_t size;              // Length of the keys
+};
+
+
+void do_sort_task(Sort_task *task)
+{
+  uchar **a= task->a, **b= task->b, **to= task->to;
+  size_t size= task->size;
+
+  switch (task->type) {
+  case Sort_task::SORT_RUN:
+    my_qsort2(a, task->a_end - a, sizeof(uchar*), get_ptr_compare(size),
+              &size);
+    return;
+  case Sort_task::MERGE_RUNS:
+    while (a < task->a_end && b < task->b_end)
+      *to++= memcmp(*a, *b, size) <= 0 ? *a++ : *b++;
+    memcpy(to, b, (task->b_end - b) * sizeof(uchar*));
+    /* Fall through to copy the rest of the left run */
+  case Sort_task::COPY_RUN:
+    memcpy(to, a, (task->a_end - a) * sizeof(uchar*));
+    return;
+  }
+}
+
+
+extern "C" pthread_handler_t sort_task_handler(void *arg)
+{
+  do_sort_task((Sort_task *) arg);
+  return 0;
+}
+
+
+/**
+  Run the tasks, each in its own thread. The first one is done by the
+  calling thread, as is any task a thread could not be created for.
+*/
+void run_sort_tasks(Sort_task *tasks, uint n_tasks)
+{
+  pthread_t threads[MAX_SORT_THREADS + 1];
+  bool started[MAX_SORT_THREADS + 1];
+
+  for (uint i= 1; i < n_tasks; i++)
+  {
+    started[i]= !mysql_thread_create(0, /* Not instrumented */
+                                     &threads[i], NULL,
+                                     sort_task_handler, tasks + i);
+    if (!started[i])
+      do_sort_task(tasks + i);
+  }
+  do_sort_task(tasks);
+  for (uint i= 1; i < n_tasks; i++)
+  {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+}
+
+
+/** The first key in the sorted run [first, last) that is not less than key */
+uchar **lower_bound_key(uchar **first, uchar **last, uchar *key, size_t size)
+{
+  size_t len= last - first;
+  while (len > 0)
+  {
+    size_t half= len / 2;
+    if (memcmp(first[half], key, size) < 0)
+    {
+      first+= half + 1;
+      len-= half + 1;
+    }
+    else
+      len= half;
+  }
+  return first;
+}
+} // namespace
+
+
+/**
+  Sort an array of pointers to byte-comparable keys with several threads.
+
+  The array is cut into one run per thread, the runs are sorted in
+  parallel, and then merged pairwise in rounds until one run is left.
+  When there are fewer pairs of runs left than threads, each merge is
+  split into independent parts: a key taken at a regular interval from
+  the left run is looked up in the right run, and the keys on either
+  side of the two cut points are merged by different threads.
+
+  @param keys       The array to sort
+  @param count      Number of keys in the array
+  @param size       Length of each key
+  @param threads    Maximum number of threads to use, the calling one
+                    included
+  @param buffer     Work space for count pointers
+
+  @note
+    If a thread can not be created its work is done by the calling thread,
+    so the function does not fail.
+*/
+
+void parallel_sort_keys(uchar **keys, size_t count, size_t size,
+                        uint threads, uchar **buffer)
+{
+  Sort_task tasks[MAX_SORT_THREADS + 1];
+  uchar **bounds[MAX_SORT_THREADS + 1];
+  uchar **from= keys, **to= buffer;
+  uint runs;
+
+  set_if_smaller(threads, MAX_SORT_THREADS);
+  runs= (uint) MY_MIN((size_t) threads, count / MIN_KEYS_PER_SORT_THREAD);
+  if (runs < 2)
+  {
+    my_qsort2(keys, count, sizeof(uchar*), get_ptr_compare(size), &size);
+    return;
+  }
+
+  for (uint i= 0; i < runs; i++)
+  {
+    bounds[i]= keys + count * i / runs;
+    tasks[i].type= Sort_task::SORT_RUN;
+    tasks[i].size= size;
+    tasks[i].a= bounds[i];
+    tasks[i].a_end= keys + count * (i + 1) / runs;
+  }
+  bounds[runs]= keys + count;
+  run_sort_tasks(tasks, runs);
+
+  while (runs > 1)
+  {
+    uint pairs= runs / 2;
+    uint parts= MY_MAX(threads / pairs, 1);
+    uint n_tasks= 0;
+
+    for (uint i= 0; i < pairs; i++)
+    {
+      uchar **a= bounds[2 * i], **b= bounds[2 * i + 1], **b_end= bounds[2 * i + 2];
+      uchar **a_cut= a, **b_cut= b;
+      for (uint j= 1; j <= parts; j++)
+      {
+        Sort_task *task= tasks + n_tasks++;
+        task->type= Sort_task::MERGE_RUNS;
+        task->size= size;
+        task->a= a_cut;
+        task->b= b_cut;
+        task->to= to + (a_cut - from) + (b_cut - b);
+        if (j == parts)
+        {
+          a_cut= b;
+          b_cut= b_end;
+        }
+        else
+        {
+          a_cut= a + (b - a) * j / parts;
+          b_cut= lower_bound_key(b_cut, b_end, *a_cut, size);
+        }
+        task->a_end= a_cut;
+        task->b_end= b_cut;
+      }
+    }
+    if (runs % 2)
+    {
+      Sort_task *task= tasks + n_tasks++;
+      task->type= Sort_task::COPY_RUN;
+      task->a= bounds[runs - 1];
+      task->a_end= bounds[runs];
+      task->to= to + (bounds[runs - 1] - from);
+    }
+    run_sort_tasks(tasks, n_tasks);
+
+    /* The bounds of the merged runs in 'to' */
+    for (uint i= 0; i <= pairs; i++)
+      bounds[i]= to + (bounds[2 * i] - from);
+    if (runs % 2)
+      bounds[pairs + 1]= to + count;
+    runs= (runs + 1) / 2;
+    swap_variables(uchar **, from, to);
+  }
+
+  if (from != keys)
+    memcpy(keys, from, count * sizeof(uchar*));
 }
 
 /**
@@ -85,7 +293,19 @@ double get_merge_many_buffs_cost_fast(ha_rows num_rows,
   return total_cost;
 }
 
-uchar **Filesort_buffer::alloc_sort_buffer(uint num_records, uint record_length)
+uint sort_work_length(const Sort_param *param, ha_rows max_keys)
+{
+  if (param->sort_threads <= 1 || max_keys < MIN_KEYS_FOR_RADIX_SORT)
+    return 0;
+  if (max_keys >= 2 * MIN_KEYS_PER_SORT_THREAD ||
+      radixsort_is_appliccable((uint) max_keys, param->sort_length))
+    return sizeof(uchar*);
+  return 2 * sizeof(RADIX_KEY_PREFIX);
+}
+
+
+uchar **Filesort_buffer::alloc_sort_buffer(uint num_records, uint record_length,
+                                           uint work_length)
 {
   ulong sort_buff_sz;
 
@@ -96,19 +316,23 @@ uchar **Filesort_buffer::alloc_sort_buffer(uint num_records, uint record_length)
 
   if (m_idx_array.is_null())
   {
-    sort_buff_sz= num_records * (record_length + sizeof(uchar*));
+    DBUG_ASSERT(work_length % sizeof(uchar*) == 0);
+    sort_buff_sz= num_records * (record_length + work_length + sizeof(uchar*));
     set_if_bigger(sort_buff_sz, record_length * MERGEBUFF2); 
     uchar **sort_keys=
       (uchar**) my_malloc(sort_buff_sz, MYF(MY_THREAD_SPECIFIC));
     m_idx_array= Idx_array(sort_keys, num_records);
     m_record_length= record_length;
+    m_work_length= work_length;
     uchar **start_of_data= m_idx_array.array() + m_idx_array.size();
-    m_start_of_data= reinterpret_cast<uchar*>(start_of_data);
+    m_start_of_data= reinterpret_cast<uchar*>(start_of_data) +
+                     num_records * work_length;
   }
   else
   {
     DBUG_ASSERT(num_records == m_idx_array.size());
     DBUG_ASSERT(record_length == m_record_length);
+    DBUG_ASSERT(work_length == m_work_length);
   }
   DBUG_RETURN(m_idx_array.array());
 }
@@ -119,6 +343,7 @@ void Filesort_buffer::free_sort_buffer()
   my_free(m_idx_array.array());
   m_idx_array= Idx_array();
   m_record_length= 0;
+  m_work_length= 0;
   m_start_of_data= NULL;
 }
 
@@ -130,14 +355,59 @@ void Filesort_buffer::sort_buffer(const Sort_param *param, uint count)
     return;
   uchar **keys= get_sort_keys();
   uchar **buffer= NULL;
+
+  /*
+    The parallel sort merges through the work space that filesort()
+    reserved out of sort_buffer_size together with the buffer.
+  */
+  if (param->sort_threads > 1 && count >= 2 * MIN_KEYS_PER_SORT_THREAD &&
+      m_work_length >= sizeof(uchar*))
+  {
+    parallel_sort_keys(keys, count, size, param->sort_threads,
+                       reinterpret_cast<uchar**>(get_work_space()));
+    return;
+  }
+
+  /*
+    For keys of up to 8 bytes the plain radix sort, which reads the keys
+    through the pointers, does fewer passes than the prefix radix sort
+    below and is fastest as long as the keys stay in the CPU cache.
+    Without work space in the sort buffer it allocates its own, as it
+    always did.
+  */
   if (radixsort_is_appliccable(count, param->sort_length) &&
-      (buffer= (uchar**) my_malloc(count*sizeof(char*),
-                                   MYF(MY_THREAD_SPECIFIC))))
+      (size <= 8 || m_work_length < 2 * sizeof(RADIX_KEY_PREFIX)))
   {
-    radixsort_for_str_ptr(keys, count, param->sort_length, buffer);
-    my_free(buffer);
+    if (m_work_length >= sizeof(uchar*))
+    {
+      radixsort_for_str_ptr(keys, count, param->sort_length,
+                            reinterpret_cast<uchar**>(get_work_space()));
+      return;
+    }
+    if ((buffer= (uchar**) my_malloc(count*sizeof(char*),
+                                     MYF(MY_THREAD_SPECIFIC))))
+    {
+      radixsort_for_str_ptr(keys, count, param->sort_length, buffer);
+      my_free(buffer);
+      return;
+    }
+  }
+
+  /*
+    make_sortkey() makes keys that compare with memcmp(), so they can be
+    radix sorted. This is several times faster than my_qsort2() for all
+    key lengths, but needs 2*16 bytes of work space per key. filesort()
+    only reserves it when sort_threads allows to spend more than one
+    thread's resources on a sort.
+  */
+  if (count >= MIN_KEYS_FOR_RADIX_SORT &&
+      m_work_length >= 2 * sizeof(RADIX_KEY_PREFIX))
+  {
+    radixsort_for_key_prefix(keys, count, size,
+                             reinterpret_cast<RADIX_KEY_PREFIX*>
+                             (get_work_space()), MYF(0));
     return;
   }
-  
+
   my_qsort2(keys, count, sizeof(uchar*), get_ptr_compare(size), &size);
 }
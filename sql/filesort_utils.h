@@ -45,6 +45,30 @@ double get_merge_many_buffs_cost_fast(ha_rows num_rows,
                                       uint    elem_size);
 
 
+/**
+  Sort an array of pointers to keys that are compared with memcmp(),
+  using up to 'threads' threads. 'buffer' must have room for 'count'
+  pointers.
+
+  @note
+    Declared here in order to be able to unit test it.
+*/
+
+void parallel_sort_keys(uchar **keys, size_t count, size_t size,
+                        uint threads, uchar **buffer);
+
+
+/**
+  The number of bytes of work space per key that
+  Filesort_buffer::sort_buffer() needs to sort up to max_keys keys in
+  the fastest way. filesort() allocates it as part of the sort buffer.
+  With sort_threads=1 no work space is reserved, and the buffer holds as
+  many keys as it did before the radix and parallel sorts were added.
+*/
+
+uint sort_work_length(const Sort_param *param, ha_rows max_keys);
+
+
 /**
   A wrapper class around the buffer used by filesort().
   The buffer is a contiguous chunk of memory,
@@ -61,7 +85,8 @@ class Filesort_buffer
 {
 public:
   Filesort_buffer() :
-    m_idx_array(), m_record_length(0), m_start_of_data(NULL)
+    m_idx_array(), m_record_length(0), m_work_length(0),
+    m_start_of_data(NULL)
   {}
 
   /** Sort me... */
@@ -81,21 +106,29 @@ class Filesort_buffer
       (void) get_record_buffer(ix);
   }
 
-  /// Returns total size: pointer array + record buffers.
+  /// Returns total size: pointer array + work space + record buffers.
   size_t sort_buffer_size() const
   {
-    return m_idx_array.size() * (m_record_length + sizeof(uchar*));
+    return m_idx_array.size() *
+      (m_record_length + m_work_length + sizeof(uchar*));
   }
 
-  /// Allocates the buffer, but does *not* initialize pointers.
-  uchar **alloc_sort_buffer(uint num_records, uint record_length);
+  /**
+    Allocates the buffer, but does *not* initialize pointers.
+    work_length bytes per record are allocated as work space for
+    sort_buffer(), between the pointer array and the record buffers.
+  */
+  uchar **alloc_sort_buffer(uint num_records, uint record_length,
+                            uint work_length= 0);
 
 
-  /// Check  <num_records, record_length> for the buffer
-  bool check_sort_buffer_properties(uint num_records,  uint record_length)
+  /// Check  <num_records, record_length, work_length> for the buffer
+  bool check_sort_buffer_properties(uint num_records,  uint record_length,
+                                    uint work_length= 0)
   {
     return (static_cast<uint>(m_idx_array.size()) == num_records &&
-            m_record_length == record_length);
+            m_record_length == record_length &&
+            m_work_length == work_length);
   }
 
   /// Frees the buffer.
@@ -114,6 +147,7 @@ class Filesort_buffer
   {
     m_idx_array= rhs.m_idx_array;
     m_record_length= rhs.m_record_length;
+    m_work_length= rhs.m_work_length;
     m_start_of_data= rhs.m_start_of_data;
     return *this;
   }
@@ -121,8 +155,17 @@ class Filesort_buffer
 private:
   typedef Bounds_checked_array<uchar*> Idx_array;
 
+  /// Work space for sorting, m_work_length bytes per record, or NULL.
+  uchar *get_work_space()
+  {
+    return m_work_length ?
+      reinterpret_cast<uchar*>(m_idx_array.array() + m_idx_array.size()) :
+      NULL;
+  }
+
   Idx_array  m_idx_array;
   uint       m_record_length;
+  uint       m_work_length;
   uchar     *m_start_of_data;
 };
 
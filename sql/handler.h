@@ -33,6 +33,7 @@
 #include "structs.h"                            /* SHOW_COMP_OPTION */
 #include "sql_array.h"          /* Dynamic_array<> */
 #include "mdl.h"
+#include "sql_analyze_stmt.h"   /* Exec_time_tracker */
 
 #include <my_compare.h>
 #include <ft_global.h>
@@ -2619,6 +2620,17 @@ class handler :public Sql_alloc
   virtual void unbind_psi();
   virtual void rebind_psi();
 
+  /*
+    Tracker for time spent in row reading functions, set for tables
+    used by ANALYZE statements. Reset in ha_reset().
+  */
+  Exec_time_tracker *tracker;
+
+  void set_time_tracker(Exec_time_tracker *tracker_arg)
+  {
+    tracker= tracker_arg;
+  }
+
 private:
   /**
     The lock type set by when calling::ha_external_lock(). This is 
@@ -2646,7 +2658,7 @@ class handler :public Sql_alloc
     pushed_idx_cond(NULL),
     pushed_idx_cond_keyno(MAX_KEY),
     auto_inc_intervals_count(0),
-    m_psi(NULL), m_lock_type(F_UNLCK), ha_share(NULL)
+    m_psi(NULL), tracker(NULL), m_lock_type(F_UNLCK), ha_share(NULL)
   {
     DBUG_PRINT("info",
                ("handler created F_UNLCK %d F_RDLCK %d F_WRLCK %d",
@@ -3240,6 +3252,8 @@ class handler :public Sql_alloc
   get_parent_foreign_key_list(THD *thd, List<FOREIGN_KEY_INFO> *f_key_list)
   { return 0; }
   virtual uint referenced_by_foreign_key() { return 0;}
+  /** Check if the table is the child or the parent of a foreign key */
+  virtual bool has_foreign_keys() { return referenced_by_foreign_key() != 0; }
   virtual void init_table_handle_for_HANDLER()
   { return; }       /* prepare InnoDB for HANDLER */
   virtual void free_foreign_key_create_info(char* str) {}
@@ -36,6 +36,7 @@
 #include "tztime.h"             // my_tz_OFFSET0, struct Time_zone
 #include "sql_acl.h"            // SUPER_ACL
 #include "log_event.h"          // Query_log_event
+#include "key.h"                // key_copy, key_hashnr
 #include "rpl_filter.h"
 #include "rpl_rli.h"
 #include "sql_audit.h"
@@ -437,6 +438,57 @@ class binlog_cache_data
   binlog_cache_data(const binlog_cache_data& info);
 };
 
+
+/*
+  Hashes of the primary and unique keys changed by the row events in the
+  transaction cache, written to the GTID event of the transaction when
+  --binlog-writeset-size is set (see THD::binlog_writeset_add_row()).
+
+  The writeset is marked invalid as soon as it cannot describe all changes
+  in the cache: more keys than --binlog-writeset-size, rows without a usable
+  key or of non-transactional tables, or statement events.
+*/
+class binlog_writeset {
+public:
+  binlog_writeset() : hashes(NULL), count(0), valid(true) {}
+  ~binlog_writeset() { my_free(hashes); }
+
+  void reset()
+  {
+    count= 0;
+    valid= true;
+  }
+
+  void add(uint32 hash)
+  {
+    if (!valid)
+      return;
+    for (uint32 i= 0; i < count; i++)
+    {
+      if (hashes[i] == hash)
+        return;
+    }
+    if (count >= opt_binlog_writeset_size ||
+        (!hashes &&
+         !(hashes= (uint32 *) my_malloc(GTID_WRITESET_MAX * sizeof(uint32),
+                                        MYF(0)))))
+    {
+      valid= false;
+      return;
+    }
+    hashes[count++]= hash;
+  }
+
+  uint32 *hashes;
+  uint32 count;
+  bool valid;
+
+private:
+  binlog_writeset& operator=(const binlog_writeset& info);
+  binlog_writeset(const binlog_writeset& info);
+};
+
+
 class binlog_cache_mngr {
 public:
   binlog_cache_mngr(my_off_t param_max_binlog_stmt_cache_size,
@@ -463,6 +515,7 @@ class binlog_cache_mngr {
     if (do_trx)
     {
       trx_cache.reset();
+      writeset.reset();
       using_xa= FALSE;
       last_commit_pos_file[0]= 0;
       last_commit_pos_offset= 0;
@@ -483,6 +536,8 @@ class binlog_cache_mngr {
 
   binlog_cache_data trx_cache;
 
+  binlog_writeset writeset;
+
   /*
     Binlog position for current transaction.
     For START TRANSACTION WITH CONSISTENT SNAPSHOT, this is the binlog
@@ -4187,8 +4242,7 @@ int MYSQL_BIN_LOG::purge_first_log(Relay_log_info* rli, bool included)
       included= 1;
       to_purge_if_included= my_strdup(ir->name, MYF(0));
     }
-    my_atomic_rwlock_destroy(&ir->inuse_relaylog_atomic_lock);
-    my_free(ir);
+    rli->free_inuse_relaylog(ir);
     ir= next;
   }
   rli->inuse_relaylog_list= ir;
@@ -5460,6 +5514,82 @@ int THD::binlog_write_table_map(TABLE *table, bool is_transactional,
   DBUG_RETURN(0);
 }
 
+
+/**
+  Add the keys of a row to the writeset of the transaction.
+
+  Every primary or unique key of the row that has no NULL part is hashed
+  together with the table name and key number. Two transactions that
+  changed a row with the same key thus always have a hash in common.
+
+  @param table             The table the row belongs to.
+  @param is_transactional  The row goes to the transactional cache.
+  @param record            The row, in record format.
+*/
+void THD::binlog_writeset_add_row(TABLE *table, bool is_transactional,
+                                  const uchar *record)
+{
+  binlog_cache_mngr *const cache_mngr=
+    (binlog_cache_mngr*) thd_get_ha_data(this, binlog_hton);
+  my_ptrdiff_t diff= record - table->record[0];
+  uchar key_buff[MAX_KEY_LENGTH];
+  bool found= false;
+
+  /* Rows in the statement cache keep the transaction from having a writeset */
+  if (!cache_mngr || !cache_mngr->writeset.valid ||
+      !use_trans_cache(this, is_transactional))
+    return;
+
+  /*
+    Changes to non-transactional tables cannot be retried, and rows with
+    foreign keys may depend on rows with other keys.
+  */
+  if (!table->file->has_transactions() || table->file->has_foreign_keys())
+  {
+    cache_mngr->writeset.valid= false;
+    return;
+  }
+
+  for (uint i= 0; i < table->s->keys; i++)
+  {
+    KEY *key= table->key_info + i;
+    KEY_PART_INFO *part, *end= key->key_part + key->user_defined_key_parts;
+    uchar key_nr= (uchar) i;
+
+    if (!(key->flags & HA_NOSAME))
+      continue;
+    /* A unique key allows many rows with NULL in it */
+    for (part= key->key_part; part < end; part++)
+    {
+      if (part->null_bit && (record[part->null_offset] & part->null_bit))
+        break;
+    }
+    if (part < end)
+      continue;
+
+    for (part= key->key_part; part < end; part++)
+      part->field->move_field_offset(diff);
+    key_copy(key_buff, (uchar *) record, key, 0);
+    for (part= key->key_part; part < end; part++)
+      part->field->move_field_offset(-diff);
+
+    ulong nr1= key_hashnr(key, key->user_defined_key_parts, key_buff);
+    ulong nr2= 4;
+    my_charset_bin.coll->hash_sort(&my_charset_bin,
+                                   (uchar *) table->s->table_cache_key.str,
+                                   table->s->table_cache_key.length,
+                                   &nr1, &nr2);
+    my_charset_bin.coll->hash_sort(&my_charset_bin, &key_nr, 1, &nr1, &nr2);
+    /* Zero marks a free slot in the slave's hash of writesets */
+    cache_mngr->writeset.add((uint32) nr1 ? (uint32) nr1 : 1);
+    found= true;
+  }
+
+  /* Without a key, conflicting rows cannot be told apart */
+  if (!found)
+    cache_mngr->writeset.valid= false;
+}
+
 /**
   This function retrieves a pending row event from a cache which is
   specified through the parameter @c is_transactional. Respectively, when it
@@ -5613,7 +5743,8 @@ MYSQL_BIN_LOG::flush_and_set_pending_rows_event(THD *thd,
 
 bool
 MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
-                                bool is_transactional, uint64 commit_id)
+                                bool is_transactional, uint64 commit_id,
+                                const uint32 *writeset, uint32 writeset_count)
 {
   rpl_gtid gtid;
   uint32 domain_id= thd->variables.gtid_domain_id;
@@ -5659,7 +5790,7 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, bool standalone,
 
   Gtid_log_event gtid_event(thd, seq_no, domain_id, standalone,
                             LOG_EVENT_SUPPRESS_USE_F, is_transactional,
-                            commit_id);
+                            commit_id, writeset, writeset_count);
 
   /* Write the event to the binary log. */
   if (gtid_event.write(&mysql_bin_log.log_file))
@@ -5934,6 +6065,13 @@ bool MYSQL_BIN_LOG::write(Log_event *event_info, my_bool *with_annotate)
       file= cache_mngr->get_binlog_cache_log(is_trans_cache);
       cache_data= cache_mngr->get_binlog_cache_data(is_trans_cache);
 
+      /* The writeset cannot tell what a statement event changes */
+      if (is_trans_cache &&
+          event_info->get_type_code() != TABLE_MAP_EVENT &&
+          thd->lex->sql_command != SQLCOM_SAVEPOINT &&
+          thd->lex->sql_command != SQLCOM_ROLLBACK_TO_SAVEPOINT)
+        cache_mngr->writeset.valid= false;
+
       if (thd->lex->stmt_accessed_non_trans_temp_table())
         cache_data->set_changes_to_non_trans_temp_table();
 
@@ -7606,9 +7744,20 @@ MYSQL_BIN_LOG::write_transaction_or_stmt(group_commit_entry *entry,
                                          uint64 commit_id)
 {
   binlog_cache_mngr *mngr= entry->cache_mngr;
+  const uint32 *writeset= NULL;
+  uint32 writeset_count= 0;
   DBUG_ENTER("MYSQL_BIN_LOG::write_transaction_or_stmt");
 
-  if (write_gtid_event(entry->thd, false, entry->using_trx_cache, commit_id))
+  /* The writeset does not cover changes in the statement cache */
+  if (entry->using_trx_cache && mngr->writeset.valid &&
+      !(entry->using_stmt_cache && !mngr->stmt_cache.empty()))
+  {
+    writeset= mngr->writeset.hashes;
+    writeset_count= mngr->writeset.count;
+  }
+
+  if (write_gtid_event(entry->thd, false, entry->using_trx_cache, commit_id,
+                       writeset, writeset_count))
     DBUG_RETURN(ER_ERROR_ON_WRITE);
 
   if (entry->using_stmt_cache && !mngr->stmt_cache.empty() &&
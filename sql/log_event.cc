@@ -48,6 +48,7 @@
 
 #include <base64.h>
 #include <my_bitmap.h>
+#include <my_bit.h>
 #include "rpl_utility.h"
 
 #define my_b_write_string(A, B) my_b_write((A), (B), (uint) (sizeof(B) - 1))
@@ -1403,7 +1404,8 @@ Log_event* Log_event::read_log_event(IO_CACHE* file,
                                      mysql_mutex_t* log_lock,
                                      const Format_description_log_event
                                      *description_event,
-                                     my_bool crc_check)
+                                     my_bool crc_check,
+                                     my_bool defer_decode)
 #else
 Log_event* Log_event::read_log_event(IO_CACHE* file,
                                      const Format_description_log_event
@@ -1472,7 +1474,22 @@ failed my_b_read"));
     error = "read error";
     goto err;
   }
-  if ((res= read_log_event(buf, data_len, &error, description_event, crc_check)))
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+  /*
+    Leave the checksum test and the decoding of row events to the parallel
+    replication worker threads.
+  */
+  if (defer_decode &&
+      Undecoded_log_event::can_defer(buf, data_len, description_event))
+  {
+    if (!(res= new Undecoded_log_event(buf, data_len, description_event,
+                                       crc_check)))
+      error= "Out of memory";
+  }
+  else
+#endif
+  res= read_log_event(buf, data_len, &error, description_event, crc_check);
+  if (res)
     res->register_temp_buf(buf, TRUE);
 
 err:
@@ -1767,6 +1784,78 @@ Log_event* Log_event::read_log_event(const char* buf, uint event_len,
   DBUG_RETURN(ev);  
 }
 
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+/**
+  Check if the event in buf can be read as an Undecoded_log_event: a row
+  event with a complete post-header.
+*/
+bool
+Undecoded_log_event::can_defer(const char *buf, uint event_len,
+                               const Format_description_log_event
+                               *description_event)
+{
+  uint8 post_header_len;
+
+  switch ((uchar) buf[EVENT_TYPE_OFFSET]) {
+  case WRITE_ROWS_EVENT_V1:
+  case UPDATE_ROWS_EVENT_V1:
+  case DELETE_ROWS_EVENT_V1:
+  case WRITE_ROWS_EVENT:
+  case UPDATE_ROWS_EVENT:
+  case DELETE_ROWS_EVENT:
+    break;
+  default:
+    return false;
+  }
+  if (description_event->binlog_version < 4 ||
+      (uchar) buf[EVENT_TYPE_OFFSET] > description_event->number_of_event_types)
+    return false;
+  post_header_len=
+    description_event->post_header_len[(uchar) buf[EVENT_TYPE_OFFSET] - 1];
+  return post_header_len >= 6 &&
+    event_len >= (uint) description_event->common_header_len + post_header_len;
+}
+
+
+Undecoded_log_event::Undecoded_log_event(const char *buf, uint event_len_arg,
+                                         const Format_description_log_event
+                                         *description_event_arg,
+                                         my_bool crc_check_arg)
+  :Log_event(buf, description_event_arg),
+   description_event(description_event_arg), event_len(event_len_arg),
+   type_code((Log_event_type) buf[EVENT_TYPE_OFFSET]), crc_check(crc_check_arg)
+{
+  uint8 post_header_len= description_event->post_header_len[type_code - 1];
+  const char *post_start= buf + description_event->common_header_len +
+    RW_MAPID_OFFSET;
+
+  /* Same layout as read by Rows_log_event::Rows_log_event(const char*,...) */
+  post_start+= (post_header_len == 6 ? 4 : RW_FLAGS_OFFSET);
+  part_of_group= (uint2korr(post_start) & Rows_log_event::STMT_END_F) != 0;
+}
+
+
+/**
+  Verify the checksum of the event and construct the real event.
+
+  @return The decoded event, which takes over the event buffer, or NULL
+          with *error set.
+*/
+Log_event *
+Undecoded_log_event::decode(const char **error)
+{
+  Log_event *ev;
+
+  if (!(ev= read_log_event(temp_buf, event_len, error, description_event,
+                           crc_check)))
+    return NULL;
+  ev->register_temp_buf(temp_buf, event_owns_temp_buf);
+  temp_buf= 0;
+  return ev;
+}
+#endif
+
 #ifdef MYSQL_CLIENT
 
 static void hexdump_minimal_header_to_io_cache(IO_CACHE *file,
@@ -5089,7 +5178,8 @@ int Format_description_log_event::do_apply_event(rpl_group_info *rgi)
   if (!ret)
   {
     /* Save the information describing this binlog */
-    delete rli->relay_log.description_event_for_exec;
+    const_cast<Relay_log_info *>(rli)->
+      retire_fdev(rli->relay_log.description_event_for_exec);
     const_cast<Relay_log_info *>(rli)->relay_log.description_event_for_exec= this;
   }
 
@@ -6347,10 +6437,12 @@ bool Binlog_checkpoint_log_event::write(IO_CACHE *file)
 
 Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
                const Format_description_log_event *description_event)
-  : Log_event(buf, description_event), seq_no(0), commit_id(0)
+  : Log_event(buf, description_event), seq_no(0), commit_id(0),
+    writeset(NULL), writeset_count(0)
 {
   uint8 header_size= description_event->common_header_len;
   uint8 post_header_len= description_event->post_header_len[GTID_EVENT-1];
+  const char *buf_start= buf;
   if (event_len < header_size + post_header_len ||
       post_header_len < GTID_HEADER_LEN)
     return;
@@ -6371,6 +6463,28 @@ Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
     ++buf;
     commit_id= uint8korr(buf);
   }
+  if (flags2 & FL_WRITESET)
+  {
+    uint offset= header_size + GTID_HEADER_LEN +
+      ((flags2 & FL_GROUP_COMMIT_ID) ? 2 : 0);
+    if (event_len < offset + 2 ||
+        event_len < offset + 2 + 4 * (uint) uint2korr(buf_start + offset))
+    {
+      seq_no= 0;                                // So is_valid() returns false
+      return;
+    }
+    buf= buf_start + offset;
+    writeset_count= uint2korr(buf);
+    buf+= 2;
+    if (!(writeset= (uint32 *) my_malloc(writeset_count * sizeof(uint32),
+                                         MYF(MY_WME))))
+    {
+      seq_no= 0;
+      return;
+    }
+    for (uint32 i= 0; i < writeset_count; i++, buf+= 4)
+      writeset[i]= uint4korr(buf);
+  }
 }
 
 
@@ -6379,10 +6493,13 @@ Gtid_log_event::Gtid_log_event(const char *buf, uint event_len,
 Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
                                uint32 domain_id_arg, bool standalone,
                                uint16 flags_arg, bool is_transactional,
-                               uint64 commit_id_arg)
+                               uint64 commit_id_arg,
+                               const uint32 *writeset_arg,
+                               uint32 writeset_count_arg)
   : Log_event(thd_arg, flags_arg, is_transactional),
     seq_no(seq_no_arg), commit_id(commit_id_arg), domain_id(domain_id_arg),
-    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0))
+    flags2((standalone ? FL_STANDALONE : 0) | (commit_id_arg ? FL_GROUP_COMMIT_ID : 0)),
+    writeset(NULL), writeset_count(0)
 {
   cache_type= Log_event::EVENT_NO_CACHE;
   if (thd_arg->transaction.stmt.trans_did_wait() ||
@@ -6397,6 +6514,16 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
   /* Preserve any DDL or WAITED flag in the slave's binlog. */
   if (thd_arg->rgi_slave)
     flags2|= (thd_arg->rgi_slave->gtid_ev_flags2 & (FL_DDL|FL_WAITED));
+  /* A writeset only describes transactional DML */
+  if (writeset_count_arg && !standalone &&
+      (flags2 & (FL_TRANSACTIONAL|FL_DDL)) == FL_TRANSACTIONAL &&
+      (writeset= (uint32 *) my_malloc(writeset_count_arg * sizeof(uint32),
+                                      MYF(0))))
+  {
+    memcpy(writeset, writeset_arg, writeset_count_arg * sizeof(uint32));
+    writeset_count= writeset_count_arg;
+    flags2|= FL_WRITESET;
+  }
 }
 
 
@@ -6439,7 +6566,7 @@ Gtid_log_event::peek(const char *event_start, size_t event_len,
 bool
 Gtid_log_event::write(IO_CACHE *file)
 {
-  uchar buf[GTID_HEADER_LEN+2];
+  uchar buf[GTID_HEADER_LEN+2+2];
   size_t write_len;
 
   int8store(buf, seq_no);
@@ -6455,9 +6582,24 @@ Gtid_log_event::write(IO_CACHE *file)
     bzero(buf+13, GTID_HEADER_LEN-13);
     write_len= GTID_HEADER_LEN;
   }
-  return write_header(file, write_len) ||
-    wrapper_my_b_safe_write(file, buf, write_len) ||
-    write_footer(file);
+  if (flags2 & FL_WRITESET)
+  {
+    int2store(buf + write_len, writeset_count);
+    write_len+= 2;
+  }
+  if (write_header(file, write_len + writeset_count * 4) ||
+      wrapper_my_b_safe_write(file, buf, write_len))
+    return true;
+  if (writeset_count)
+  {
+    uchar hashes[GTID_WRITESET_MAX * 4];
+    DBUG_ASSERT(writeset_count <= GTID_WRITESET_MAX);
+    for (uint32 i= 0; i < writeset_count; i++)
+      int4store(hashes + i * 4, writeset[i]);
+    if (wrapper_my_b_safe_write(file, hashes, writeset_count * 4))
+      return true;
+  }
+  return write_footer(file);
 }
 
 
@@ -6486,6 +6628,22 @@ Gtid_log_event::make_compatible_event(String *packet, bool *need_dummy_event,
   }
 
   *need_dummy_event= true;
+  if (flags2 & FL_WRITESET)
+  {
+    /*
+      The BEGIN event has no room for the writeset, which the old slave
+      would not use anyway. Cut it off the end of the event.
+    */
+    uchar *p= (uchar *) packet->ptr() + ev_offset;
+    uint32 len= LOG_EVENT_HEADER_LEN + GTID_HEADER_LEN +
+      ((flags2 & FL_GROUP_COMMIT_ID) ? 2 : 0) +
+      (checksum_alg == BINLOG_CHECKSUM_ALG_CRC32 ? BINLOG_CHECKSUM_LEN : 0);
+    if (packet->length() - ev_offset < len)
+      return 1;
+    p[LOG_EVENT_HEADER_LEN + 12]= flags2 & ~FL_WRITESET;
+    int4store(p + EVENT_LEN_OFFSET, len);
+    packet->length(ev_offset + len);
+  }
   return Query_log_event::begin_event(packet, ev_offset, checksum_alg);
 }
 
@@ -6624,6 +6782,8 @@ Gtid_log_event::print(FILE *file, PRINT_EVENT_INFO *print_event_info)
       my_b_write_string(&cache, " trans");
     if (flags2 & FL_WAITED)
       my_b_write_string(&cache, " waited");
+    if (flags2 & FL_WRITESET)
+      my_b_printf(&cache, " writeset=%u", writeset_count);
     my_b_printf(&cache, "\n");
 
     if (!print_event_info->allow_parallel_printed ||
@@ -9232,7 +9392,7 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg, ulong tid,
     m_type(event_type), m_extra_row_data(0)
 #ifdef HAVE_REPLICATION
     , m_curr_row(NULL), m_curr_row_end(NULL),
-    m_key(NULL), m_key_info(NULL), m_key_nr(0),
+    m_key(NULL), m_key_info(NULL), m_key_nr(0), m_hash_scan(NULL),
     master_had_triggers(0)
 #endif
 {
@@ -9282,7 +9442,7 @@ Rows_log_event::Rows_log_event(const char *buf, uint event_len,
     m_extra_row_data(0)
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
     , m_curr_row(NULL), m_curr_row_end(NULL),
-    m_key(NULL), m_key_info(NULL), m_key_nr(0),
+    m_key(NULL), m_key_info(NULL), m_key_nr(0), m_hash_scan(NULL),
     master_had_triggers(0)
 #endif
 {
@@ -9880,6 +10040,20 @@ int Rows_log_event::do_apply_event(rpl_group_info *rgi)
     rgi->set_row_stmt_start_timestamp();
 
     THD_STAGE_INFO(thd, stage_executing);
+
+    /*
+      Apply the rows of a keyless Update/Delete event in one table scan
+      where possible; do_exec_row() then skips the rows already applied.
+    */
+    if (error == 0 && use_hash_scan())
+    {
+      THD* old_thd= table->in_use;
+      if (!table->in_use)
+        table->in_use= thd;
+      hash_scan_rows(rgi);
+      table->in_use= old_thd;
+    }
+
     while (error == 0 && m_curr_row < m_rows_end)
     {
       /* in_use can have been set to NULL in close_tables_for_reopen */
@@ -12117,6 +12291,260 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
   DBUG_RETURN(error);
 }
 
+/*
+  Rows of an Update or Delete event applied by hash_scan_rows(), in the
+  order they come in the event.
+*/
+
+struct Rows_hash_scan
+{
+  struct Row
+  {
+    const uchar *start;         /* Before image in the event */
+    const uchar *after_image;   /* After image in the event, for updates */
+    const uchar *end;           /* One-after the end of the row */
+    uchar *record;              /* The unpacked before image */
+    Row *next;                  /* Next row of the event */
+    Row *hash_next;             /* Next row not applied in the same bucket */
+    ulong hash;
+    bool applied;
+  };
+
+  MEM_ROOT mem_root;
+  Row *first;
+  Row *cursor;                  /* Next row to be seen by do_exec_row() */
+};
+
+
+/*
+  Hash the record in table->record[0].
+
+  Records that record_compare() finds equal always get the same hash
+  value: null bits are hashed as they are and field values are hashed
+  with the sort order of their character set.
+*/
+
+static ulong record_hash(TABLE *table)
+{
+  ulong nr1= 1, nr2= 4;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, table->null_flags,
+                                 table->s->null_bytes, &nr1, &nr2);
+  for (Field **ptr= table->field; *ptr; ptr++)
+    (*ptr)->hash(&nr1, &nr2);
+  return nr1;
+}
+
+
+/**
+  Check if the rows of this event can be located with hash_scan_rows().
+
+  This is the case for Update and Delete events on tables that find_row()
+  would have to scan once per row: tables without a usable key, where the
+  row cannot be located through the primary key either.  Tables with blobs
+  are excluded as the unpacked blob values are not kept between rows, and
+  so are events that fire triggers on the slave.
+*/
+
+bool Rows_log_event::use_hash_scan()
+{
+  Log_event_type type= get_general_type_code();
+  return ((type == UPDATE_ROWS_EVENT || type == DELETE_ROWS_EVENT) &&
+          !m_key_info && !m_table->s->blob_fields &&
+          !((m_table->file->ha_table_flags() &
+             HA_PRIMARY_KEY_REQUIRED_FOR_POSITION) &&
+            m_table->s->primary_key < MAX_KEY) &&
+          !(slave_run_triggers_for_rbr && !master_had_triggers &&
+            m_table->triggers));
+}
+
+
+/**
+  Apply all rows of the event with a single table scan.
+
+  The before images of the rows are unpacked and put in a hash on their
+  contents. The table is then scanned once, and each record that
+  record_compare() finds equal to a before image not yet applied is
+  deleted or updated on the spot.
+
+  This is done on a best effort basis: rows that are not found, or whose
+  change fails, are left to do_exec_row(), which locates them with
+  find_row() and reports any error the usual way.
+*/
+
+void Rows_log_event::hash_scan_rows(rpl_group_info *rgi)
+{
+  TABLE *table= m_table;
+  const uchar *saved_row= m_curr_row, *saved_row_end= m_curr_row_end;
+  const bool is_update= get_general_type_code() == UPDATE_ROWS_EVENT;
+  Rows_hash_scan::Row *row, **last= NULL, **buckets;
+  uint count= 0, bucket_mask;
+  int error;
+  DBUG_ENTER("Rows_log_event::hash_scan_rows");
+
+  if (!(m_hash_scan= (Rows_hash_scan *) my_malloc(sizeof(Rows_hash_scan),
+                                                  MYF(MY_WME))))
+    DBUG_VOID_RETURN;
+  init_alloc_root(&m_hash_scan->mem_root, 8192, 0, MYF(MY_THREAD_SPECIFIC));
+  m_hash_scan->first= m_hash_scan->cursor= NULL;
+  last= &m_hash_scan->first;
+
+  /* Unpack the before images of all rows */
+  while (m_curr_row < m_rows_end)
+  {
+    if (!(row= (Rows_hash_scan::Row *)
+          alloc_root(&m_hash_scan->mem_root, sizeof(*row))) ||
+        !(row->record= (uchar *) alloc_root(&m_hash_scan->mem_root,
+                                            table->s->reclength)))
+      goto err;
+    prepare_record(table, m_width, FALSE);
+    if (unpack_current_row(rgi))
+      goto err;
+    memcpy(row->record, table->record[0], table->s->reclength);
+    row->hash= record_hash(table);
+    row->start= m_curr_row;
+    row->after_image= m_curr_row_end;
+    if (is_update)
+    {
+      m_curr_row= m_curr_row_end;
+      if (unpack_current_row(rgi))
+        goto err;
+    }
+    row->end= m_curr_row_end;
+    row->next= NULL;
+    row->applied= false;
+    *last= row;
+    last= &row->next;
+    m_curr_row= m_curr_row_end;
+    count++;
+  }
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+
+  /* A single row is as quickly found by find_row() */
+  if (count < 2)
+    goto err;
+
+  bucket_mask= my_round_up_to_next_power(count) - 1;
+  if (!(buckets= (Rows_hash_scan::Row **)
+        alloc_root(&m_hash_scan->mem_root, (bucket_mask + 1) * sizeof(row))))
+    goto err;
+  bzero(buckets, (bucket_mask + 1) * sizeof(row));
+  for (row= m_hash_scan->first; row; row= row->next)
+  {
+    Rows_hash_scan::Row **bucket= buckets + (row->hash & bucket_mask);
+    row->hash_next= *bucket;
+    *bucket= row;
+  }
+
+  DBUG_PRINT("info",("locating %u records using hash scan (rnd_next)",
+                     count));
+  /* This is still a table scan, as far as the test cases are concerned */
+  DBUG_EXECUTE_IF("slave_crash_if_table_scan", abort(););
+
+  table->use_all_columns();
+  if ((error= table->file->ha_rnd_init_with_error(1)))
+  {
+    table->default_column_bitmaps();
+    goto err;
+  }
+
+  while (count)
+  {
+    if ((error= table->file->ha_rnd_next(table->record[0])))
+    {
+      if (error == HA_ERR_RECORD_DELETED)
+        continue;
+      break;
+    }
+
+    ulong hash= record_hash(table);
+    Rows_hash_scan::Row **prev;
+    for (prev= buckets + (hash & bucket_mask); (row= *prev);
+         prev= &row->hash_next)
+    {
+      if (row->hash != hash)
+        continue;
+      memcpy(table->record[1], row->record, table->s->reclength);
+      if (!record_compare(table))
+        break;
+    }
+    if (!row)
+      continue;
+
+    if (is_update)
+    {
+      /* The found row goes to record[1] and the after image to record[0] */
+      store_record(table, record[1]);
+      m_curr_row= row->after_image;
+      if (!(error= unpack_current_row(rgi)))
+      {
+        error= table->file->ha_update_row(table->record[1], table->record[0]);
+        if (error == HA_ERR_RECORD_IS_THE_SAME)
+          error= 0;
+      }
+    }
+    else
+      error= table->file->ha_delete_row(table->record[0]);
+    if (error)
+    {
+      DBUG_PRINT("info",("error: %s, leaving the rest of the rows to"
+                         " find_row()", HA_ERR(error)));
+      break;
+    }
+    /* Each before image matches only one record */
+    *prev= row->hash_next;
+    row->applied= true;
+    count--;
+  }
+  table->file->ha_rnd_end();
+  table->default_column_bitmaps();
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+  m_hash_scan->cursor= m_hash_scan->first;
+
+  issue_long_find_row_warning(get_general_type_code(), m_table->alias.c_ptr(),
+                              false, rgi);
+  DBUG_VOID_RETURN;
+
+err:
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+  free_hash_scan();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Skip the current row if hash_scan_rows() has already applied it.
+
+  @retval true   The row was applied; @c m_curr_row_end is set to its end.
+  @retval false  The row must be applied by do_exec_row().
+*/
+
+bool Rows_log_event::hash_scan_skip_row()
+{
+  Rows_hash_scan::Row *row;
+  if (!m_hash_scan || !(row= m_hash_scan->cursor) || row->start != m_curr_row)
+    return false;
+  m_hash_scan->cursor= row->next;
+  if (!row->applied)
+    return false;
+  m_curr_row_end= row->end;
+  return true;
+}
+
+
+void Rows_log_event::free_hash_scan()
+{
+  if (m_hash_scan)
+  {
+    free_root(&m_hash_scan->mem_root, MYF(0));
+    my_free(m_hash_scan);
+    m_hash_scan= NULL;
+  }
+}
+
+
 #endif
 
 /*
@@ -12178,6 +12606,7 @@ Delete_rows_log_event::do_after_row_operations(const Slave_reporting_capability
   my_free(m_key);
   m_key= NULL;
   m_key_info= NULL;
+  free_hash_scan();
 
   return error;
 }
@@ -12191,6 +12620,9 @@ int Delete_rows_log_event::do_exec_row(rpl_group_info *rgi)
     slave_run_triggers_for_rbr && !master_had_triggers && m_table->triggers;
   DBUG_ASSERT(m_table != NULL);
 
+  if (hash_scan_skip_row())
+    return 0;
+
 #ifdef WSREP_PROC_INFO
   my_snprintf(thd->wsrep_info, sizeof(thd->wsrep_info) - 1,
               "Delete_rows_log_event::find_row(%lld)",
@@ -12342,6 +12774,7 @@ Update_rows_log_event::do_after_row_operations(const Slave_reporting_capability
   my_free(m_key); // Free for multi_malloc
   m_key= NULL;
   m_key_info= NULL;
+  free_hash_scan();
 
   return error;
 }
@@ -12355,6 +12788,9 @@ Update_rows_log_event::do_exec_row(rpl_group_info *rgi)
   const char *message= "Update_rows_log_event::find_row()";
   DBUG_ASSERT(m_table != NULL);
 
+  if (hash_scan_skip_row())
+    return 0;
+
 #ifdef WSREP_PROC_INFO
   my_snprintf(thd->wsrep_info, sizeof(thd->wsrep_info) - 1,
               "Update_rows_log_event::find_row(%lld)",
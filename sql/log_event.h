@@ -264,6 +264,8 @@ struct sql_ex_info
 #define ANNOTATE_ROWS_HEADER_LEN  0
 #define BINLOG_CHECKPOINT_HEADER_LEN 4
 #define GTID_HEADER_LEN       19
+/* Max number of key hashes in the writeset of a GTID event */
+#define GTID_WRITESET_MAX     1024
 #define GTID_LIST_HEADER_LEN   4
 
 /* 
@@ -1142,7 +1144,8 @@ class Log_event
                                    mysql_mutex_t* log_lock,
                                    const Format_description_log_event
                                    *description_event,
-                                   my_bool crc_check);
+                                   my_bool crc_check,
+                                   my_bool defer_decode= FALSE);
 
   /**
     Reads an event from a binlog or relay log. Used by the dump thread
@@ -1408,6 +1411,10 @@ class Log_event
     rows event except the last one.
   */
   virtual bool is_part_of_group() { return 0; }
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+  /* True for an Undecoded_log_event, which must be decoded before use. */
+  virtual bool is_undecoded() { return 0; }
+#endif
 
   static bool is_group_event(enum Log_event_type ev_type)
   {
@@ -3139,6 +3146,8 @@ class Binlog_checkpoint_log_event: public Log_event
         @@SESSION.replicate_allow_parallel value was true at commit).</td>
     <td>Bit 4 set indicates that this transaction encountered a row (or other)
         lock wait during execution.</td>
+    <td>Bit 5 set indicates that the event group contains DDL.</td>
+    <td>Bit 6 set indicates that a writeset follows.</td>
   </tr>
 
   <tr>
@@ -3148,10 +3157,18 @@ class Binlog_checkpoint_log_event: public Log_event
         group commit). OR commit id, same for all GTIDs in the same group
         commit (see flags bit 1).</td>
   </tr>
+
+  <tr>
+    <td>writeset (see flags bit 6)</td>
+    <td>2 byte unsigned count, followed by count 4 byte hashes</td>
+    <td>Hashes of the primary and unique keys of all rows changed by the
+        event group. Two event groups with no hash in common changed
+        different rows.</td>
+  </tr>
   </table>
 
   The Body of Gtid_log_event is empty. The total event size is 19 bytes +
-  the normal 19 bytes common-header.
+  the normal 19 bytes common-header, plus any commit id and writeset.
 */
 
 class Gtid_log_event: public Log_event
@@ -3161,6 +3178,9 @@ class Gtid_log_event: public Log_event
   uint64 commit_id;
   uint32 domain_id;
   uchar flags2;
+  /* Key hashes, if FL_WRITESET is set */
+  uint32 *writeset;
+  uint32 writeset_count;
 
   /* Flags2. */
 
@@ -3188,10 +3208,17 @@ class Gtid_log_event: public Log_event
   static const uchar FL_WAITED= 16;
   /* FL_DDL is set for event group containing DDL. */
   static const uchar FL_DDL= 32;
+  /*
+    FL_WRITESET is set when the event carries a writeset: the hashes of all
+    the keys the transactional event group changed (see
+    --binlog-writeset-size).
+  */
+  static const uchar FL_WRITESET= 64;
 
 #ifdef MYSQL_SERVER
   Gtid_log_event(THD *thd_arg, uint64 seq_no, uint32 domain_id, bool standalone,
-                 uint16 flags, bool is_transactional, uint64 commit_id);
+                 uint16 flags, bool is_transactional, uint64 commit_id,
+                 const uint32 *writeset_arg= NULL, uint32 writeset_count_arg= 0);
 #ifdef HAVE_REPLICATION
   void pack_info(THD *thd, Protocol *protocol);
   virtual int do_apply_event(rpl_group_info *rgi);
@@ -3203,11 +3230,12 @@ class Gtid_log_event: public Log_event
 #endif
   Gtid_log_event(const char *buf, uint event_len,
                  const Format_description_log_event *description_event);
-  ~Gtid_log_event() { }
+  ~Gtid_log_event() { my_free(writeset); }
   Log_event_type get_type_code() { return GTID_EVENT; }
   int get_data_size()
   {
-    return GTID_HEADER_LEN + ((flags2 & FL_GROUP_COMMIT_ID) ? 2 : 0);
+    return GTID_HEADER_LEN + ((flags2 & FL_GROUP_COMMIT_ID) ? 2 : 0) +
+      ((flags2 & FL_WRITESET) ? 2 + writeset_count * 4 : 0);
   }
   bool is_valid() const { return seq_no != 0; }
 #ifdef MYSQL_SERVER
@@ -3672,6 +3700,47 @@ class Unknown_log_event: public Log_event
   bool is_valid() const { return 1; }
 };
 #endif
+
+#if defined(MYSQL_SERVER) && defined(HAVE_REPLICATION)
+/**
+  @class Undecoded_log_event
+
+  A row event read from the relay log by the parallel replication SQL driver
+  thread, but not yet decoded.
+
+  Only the common header (and the flags of the post-header) is parsed, which
+  is all the driver thread needs to route the event to a worker thread. The
+  worker thread then calls decode() to verify the checksum and construct the
+  real event, so that this work is spread over the worker threads.
+
+  The Format_description_log_event used to decode the event must stay alive
+  until the worker thread is done; see Relay_log_info::retire_fdev().
+*/
+class Undecoded_log_event: public Log_event
+{
+public:
+  Undecoded_log_event(const char *buf, uint event_len,
+                      const Format_description_log_event *description_event,
+                      my_bool crc_check);
+  ~Undecoded_log_event() {}
+  static bool can_defer(const char *buf, uint event_len,
+                        const Format_description_log_event *description_event);
+  Log_event *decode(const char **error);
+
+  Log_event_type get_type_code() { return type_code; }
+  bool is_valid() const { return 1; }
+  bool is_part_of_group() { return part_of_group; }
+  bool is_undecoded() { return 1; }
+
+private:
+  const Format_description_log_event *description_event;
+  uint event_len;
+  Log_event_type type_code;
+  bool part_of_group;
+  my_bool crc_check;
+};
+#endif
+
 char *str_to_hex(char *to, const char *from, uint len);
 
 /**
@@ -4179,6 +4248,7 @@ class Table_map_log_event : public Log_event
   @section Rows_log_event_binary_format Binary Format
 */
 
+struct Rows_hash_scan;
 
 class Rows_log_event : public Log_event
 {
@@ -4354,10 +4424,15 @@ class Rows_log_event : public Log_event
   uchar    *m_key;      /* Buffer to keep key value during searches */
   KEY      *m_key_info; /* Pointer to KEY info for m_key_nr */
   uint      m_key_nr;   /* Key number */
+  Rows_hash_scan *m_hash_scan; /* Rows already applied by hash_scan_rows() */
   bool master_had_triggers;     /* set after tables opening */
 
   int find_key(); // Find a best key to use in find_row()
   int find_row(rpl_group_info *);
+  bool use_hash_scan();
+  void hash_scan_rows(rpl_group_info *);
+  bool hash_scan_skip_row();
+  void free_hash_scan();
   int write_row(rpl_group_info *, const bool);
 
   // Unpack the current row into m_table->record[0]
@@ -28,11 +28,13 @@
 #ifdef HAVE_PSI_INTERFACE
 static PSI_mutex_key key_MDL_map_mutex;
 static PSI_mutex_key key_MDL_wait_LOCK_wait_status;
+static PSI_mutex_key key_MDL_context_LOCK_fast_path;
 
 static PSI_mutex_info all_mdl_mutexes[]=
 {
   { &key_MDL_map_mutex, "MDL_map::mutex", 0},
-  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0}
+  { &key_MDL_wait_LOCK_wait_status, "MDL_wait::LOCK_wait_status", 0},
+  { &key_MDL_context_LOCK_fast_path, "MDL_context::LOCK_fast_path", 0}
 };
 
 static PSI_rwlock_key key_MDL_lock_rwlock;
@@ -111,62 +113,23 @@ void MDL_key::init_psi_keys()
 static bool mdl_initialized= 0;
 
 
-class MDL_object_lock;
-class MDL_object_lock_cache_adapter;
+class MDL_lock;
 
 
 /**
-  A partition in a collection of all MDL locks.
-  MDL_map is partitioned for scalability reasons.
-  Maps MDL_key to MDL_lock instances.
+  Protects atomic operations on MDL_lock::m_fast_path_state on platforms
+  which lack native atomic support.
 */
+my_atomic_rwlock_t LOCK_mdl_atomics;
 
-class MDL_map_partition
-{
-public:
-  MDL_map_partition();
-  ~MDL_map_partition();
-  inline MDL_lock *find_or_insert(const MDL_key *mdl_key);
-  unsigned long get_lock_owner(const MDL_key *key);
-  inline void remove(MDL_lock *lock);
-private:
-  bool move_from_hash_to_lock_mutex(MDL_lock *lock);
-  /** A partition of all acquired locks in the server. */
-  HASH m_locks;
-  /* Protects access to m_locks hash. */
-  mysql_mutex_t m_mutex;
-  /**
-    Cache of (unused) MDL_lock objects available for re-use.
-
-    On some systems (e.g. Windows XP) constructing/destructing
-    MDL_lock objects can be fairly expensive. We use this cache
-    to avoid these costs in scenarios in which they can have
-    significant negative effect on performance. For example, when
-    there is only one thread constantly executing statements in
-    auto-commit mode and thus constantly causing creation/
-    destruction of MDL_lock objects for the tables it uses.
-
-    Note that this cache contains only MDL_object_lock objects.
-
-    Protected by m_mutex mutex.
-  */
-  typedef I_P_List<MDL_object_lock, MDL_object_lock_cache_adapter,
-                   I_P_List_counter>
-          Lock_cache;
-  Lock_cache m_unused_locks_cache;
-  friend int mdl_iterate(int (*)(MDL_ticket *, void *), void *);
-};
-
-
-/**
-  Start-up parameter for the number of partitions of the MDL_lock hash.
-*/
-ulong mdl_locks_hash_partitions;
 
 /**
   A collection of all MDL locks. A singleton,
   there is only one instance of the map in the server.
-  Contains instances of MDL_map_partition
+
+  Locks of all namespaces except GLOBAL and COMMIT are stored in
+  the lock-free hash, so lookups and insertions of MDL_lock objects
+  don't serialize on any mutex.
 */
 
 class MDL_map
@@ -174,12 +137,14 @@ class MDL_map
 public:
   void init();
   void destroy();
-  MDL_lock *find_or_insert(const MDL_key *key);
-  unsigned long get_lock_owner(const MDL_key *key);
-  void remove(MDL_lock *lock);
+  MDL_lock *find_or_insert(LF_PINS *pins, const MDL_key *key);
+  unsigned long get_lock_owner(LF_PINS *pins, const MDL_key *key);
+  void remove(LF_PINS *pins, MDL_lock *lock);
+  void remove_destroyed(LF_PINS *pins, MDL_lock *lock);
+  LF_PINS *get_pins() { return lf_hash_get_pins(&m_locks); }
 private:
-  /** Array of partitions where the locks are actually stored. */
-  Dynamic_array<MDL_map_partition *> m_partitions;
+  /** LF_HASH with all locks in the server. */
+  LF_HASH m_locks;
   /** Pre-allocated MDL_lock object for GLOBAL namespace. */
   MDL_lock *m_global_lock;
   /** Pre-allocated MDL_lock object for COMMIT namespace. */
@@ -339,9 +304,10 @@ Deadlock_detection_visitor::opt_change_victim_to(MDL_context *new_victim)
   and it exists only when the lock has been granted.
   Can be seen as an MDL subsystem's version of TABLE_SHARE.
 
-  This is an abstract class which lacks information about
-  compatibility rules for lock types. They should be specified
-  in its descendants.
+  This is a non-polymorphic class, since MDL_lock objects are allocated
+  and re-used by the lock-free hash. Information about compatibility
+  rules for lock types is provided by the strategy object which is
+  selected according to the namespace of the lock's key.
 */
 
 class MDL_lock
@@ -377,6 +343,160 @@ class MDL_lock
 
   typedef Ticket_list::List::Iterator Ticket_iterator;
 
+  /**
+    Type of MDL_lock::m_fast_path_state: counters of locks acquired
+    using the "fast path" and flags describing the state of the lock.
+  */
+  typedef int64 fast_path_state_t;
+
+  /**
+    Unobtrusive lock types, i.e. SR and SW, which are compatible with
+    each other and with other unobtrusive locks, can be acquired without
+    touching MDL_lock::m_rwlock. Instead the per-type counter packed in
+    MDL_lock::m_fast_path_state is incremented atomically, as long as
+    there are no obtrusive (SNW, SNRW, X) locks granted or pending.
+  */
+  static const fast_path_state_t SR_FAST_PATH_UNIT= 1LL;
+  static const fast_path_state_t SW_FAST_PATH_UNIT= 1LL << 20;
+  static const fast_path_state_t SR_FAST_PATH_MASK= (1LL << 20) - 1;
+  static const fast_path_state_t SW_FAST_PATH_MASK=
+    ((1LL << 40) - 1) & ~SR_FAST_PATH_MASK;
+  /** Some obtrusive lock is granted or pending, fast path is disabled. */
+  static const fast_path_state_t HAS_OBTRUSIVE= 1LL << 60;
+  /** m_granted or m_waiting are not empty, object can't be destroyed. */
+  static const fast_path_state_t HAS_SLOW_PATH= 1LL << 61;
+  /** Object is being removed from the hash and must not be used. */
+  static const fast_path_state_t IS_DESTROYED= 1LL << 62;
+
+  /**
+    Helper struct which defines how different types of locks are handled
+    for a specific MDL_lock. In practice we use only two strategies:
+    "scoped" lock strategy for locks in GLOBAL, COMMIT and SCHEMA namespaces
+    and "object" lock strategy for all other namespaces.
+  */
+  struct MDL_lock_strategy
+  {
+    virtual const bitmap_t *incompatible_granted_types_bitmap() const = 0;
+    virtual const bitmap_t *incompatible_waiting_types_bitmap() const = 0;
+    virtual bool needs_notification(const MDL_ticket *ticket) const = 0;
+    virtual bool conflicting_locks(const MDL_ticket *ticket) const = 0;
+    virtual bitmap_t hog_lock_types_bitmap() const = 0;
+    /** Lock types which are incompatible with fast path locks. */
+    virtual bitmap_t obtrusive_lock_types_bitmap() const = 0;
+    /**
+      Value to be added to m_fast_path_state when the lock of given
+      type is acquired using the fast path, or 0 if this is impossible.
+    */
+    virtual fast_path_state_t fast_path_increment(enum_mdl_type type) const= 0;
+    virtual ~MDL_lock_strategy() {}
+  };
+
+
+  /**
+    An implementation of the scoped metadata lock. The only locking modes
+    which are supported at the moment are SHARED and INTENTION EXCLUSIVE
+    and EXCLUSIVE
+  */
+  struct MDL_scoped_lock : public MDL_lock_strategy
+  {
+    MDL_scoped_lock() {}
+    virtual const bitmap_t *incompatible_granted_types_bitmap() const
+    { return m_granted_incompatible; }
+    virtual const bitmap_t *incompatible_waiting_types_bitmap() const
+    { return m_waiting_incompatible; }
+    virtual bool needs_notification(const MDL_ticket *ticket) const
+    { return (ticket->get_type() == MDL_SHARED); }
+
+    /**
+      Notify threads holding scoped IX locks which conflict with a pending
+      S lock.
+
+      Thread which holds global IX lock can be a handler thread for
+      insert delayed. We need to kill such threads in order to get
+      global shared lock. We do this my calling code outside of MDL.
+    */
+    virtual bool conflicting_locks(const MDL_ticket *ticket) const
+    { return ticket->get_type() == MDL_INTENTION_EXCLUSIVE; }
+
+    /*
+      In scoped locks, only IX lock request would starve because of X/S.
+      But that is practically very rare case. So just return 0 from this
+      function.
+    */
+    virtual bitmap_t hog_lock_types_bitmap() const
+    { return 0; }
+
+    /* Fast path is not used for scoped locks. */
+    virtual bitmap_t obtrusive_lock_types_bitmap() const
+    { return 0; }
+    virtual fast_path_state_t fast_path_increment(enum_mdl_type type) const
+    { return 0; }
+
+  private:
+    static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
+    static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
+  };
+
+
+  /**
+    An implementation of a per-object lock. Supports SHARED, SHARED_UPGRADABLE,
+    SHARED HIGH PRIORITY and EXCLUSIVE locks.
+  */
+  struct MDL_object_lock : public MDL_lock_strategy
+  {
+    MDL_object_lock() {}
+    virtual const bitmap_t *incompatible_granted_types_bitmap() const
+    { return m_granted_incompatible; }
+    virtual const bitmap_t *incompatible_waiting_types_bitmap() const
+    { return m_waiting_incompatible; }
+    virtual bool needs_notification(const MDL_ticket *ticket) const
+    { return (ticket->get_type() >= MDL_SHARED_NO_WRITE); }
+
+    /**
+      Notify threads holding a shared metadata locks on object which
+      conflict with a pending X, SNW or SNRW lock.
+
+      If thread which holds conflicting lock is waiting on table-level
+      lock or some other non-MDL resource we might need to wake it up
+      by calling code outside of MDL.
+    */
+    virtual bool conflicting_locks(const MDL_ticket *ticket) const
+    { return ticket->get_type() < MDL_SHARED_UPGRADABLE; }
+
+    /*
+      To prevent starvation, these lock types that are only granted
+      max_write_lock_count times in a row while other lock types are
+      waiting.
+    */
+    virtual bitmap_t hog_lock_types_bitmap() const
+    {
+      return (MDL_BIT(MDL_SHARED_NO_WRITE) |
+              MDL_BIT(MDL_SHARED_NO_READ_WRITE) |
+              MDL_BIT(MDL_EXCLUSIVE));
+    }
+
+    /*
+      Lock types which are incompatible with granted SR or SW locks.
+      Note that SNW, SNRW and X locks are also the only types which
+      have priority over SR and SW locks.
+    */
+    virtual bitmap_t obtrusive_lock_types_bitmap() const
+    {
+      return (MDL_BIT(MDL_SHARED_NO_WRITE) |
+              MDL_BIT(MDL_SHARED_NO_READ_WRITE) |
+              MDL_BIT(MDL_EXCLUSIVE));
+    }
+    virtual fast_path_state_t fast_path_increment(enum_mdl_type type) const
+    {
+      return (type == MDL_SHARED_READ ? SR_FAST_PATH_UNIT :
+              type == MDL_SHARED_WRITE ? SW_FAST_PATH_UNIT : 0);
+    }
+
+  private:
+    static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
+    static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
+  };
+
 public:
   /** The key of the object (data) being protected. */
   MDL_key key;
@@ -420,30 +540,87 @@ class MDL_lock
     return (m_granted.is_empty() && m_waiting.is_empty());
   }
 
-  virtual const bitmap_t *incompatible_granted_types_bitmap() const = 0;
-  virtual const bitmap_t *incompatible_waiting_types_bitmap() const = 0;
+  const bitmap_t *incompatible_granted_types_bitmap() const
+  { return m_strategy->incompatible_granted_types_bitmap(); }
+  const bitmap_t *incompatible_waiting_types_bitmap() const
+  { return m_strategy->incompatible_waiting_types_bitmap(); }
 
   bool has_pending_conflicting_lock(enum_mdl_type type);
 
   bool can_grant_lock(enum_mdl_type type, MDL_context *requstor_ctx,
                       bool ignore_lock_priority) const;
 
-  inline static MDL_lock *create(const MDL_key *key,
-                                 MDL_map_partition *map_part);
-
   inline unsigned long get_lock_owner() const;
 
   void reschedule_waiters();
 
-  void remove_ticket(Ticket_list MDL_lock::*queue, MDL_ticket *ticket);
+  void remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*queue,
+                     MDL_ticket *ticket);
+  void remove_fast_path_ticket(LF_PINS *pins, MDL_ticket *ticket);
 
   bool visit_subgraph(MDL_ticket *waiting_ticket,
                       MDL_wait_for_graph_visitor *gvisitor);
 
-  virtual bool needs_notification(const MDL_ticket *ticket) const = 0;
-  virtual void notify_conflicting_locks(MDL_context *ctx) = 0;
+  bool needs_notification(const MDL_ticket *ticket) const
+  { return m_strategy->needs_notification(ticket); }
+  void notify_conflicting_locks(MDL_context *ctx)
+  {
+    Ticket_iterator it(m_granted);
+    MDL_ticket *conflicting_ticket;
+    while ((conflicting_ticket= it++))
+    {
+      if (conflicting_ticket->get_ctx() != ctx &&
+          m_strategy->conflicting_locks(conflicting_ticket))
+      {
+        MDL_context *conflicting_ctx= conflicting_ticket->get_ctx();
 
-  virtual bitmap_t hog_lock_types_bitmap() const = 0;
+        ctx->get_owner()->
+          notify_shared_lock(conflicting_ctx->get_owner(),
+                             conflicting_ctx->get_needs_thr_lock_abort());
+      }
+    }
+  }
+
+  bitmap_t hog_lock_types_bitmap() const
+  { return m_strategy->hog_lock_types_bitmap(); }
+
+  fast_path_state_t get_fast_path_state() const
+  {
+    fast_path_state_t state;
+    my_atomic_rwlock_rdlock(&LOCK_mdl_atomics);
+    state= my_atomic_load64(const_cast<volatile fast_path_state_t*>
+                            (&m_fast_path_state));
+    my_atomic_rwlock_rdunlock(&LOCK_mdl_atomics);
+    return state;
+  }
+
+  bool cas_fast_path_state(fast_path_state_t *old_state,
+                           fast_path_state_t new_state)
+  {
+    bool res;
+    my_atomic_rwlock_wrlock(&LOCK_mdl_atomics);
+    res= my_atomic_cas64(&m_fast_path_state, old_state, new_state);
+    my_atomic_rwlock_wrunlock(&LOCK_mdl_atomics);
+    return res;
+  }
+
+  void add_fast_path_state(fast_path_state_t value)
+  {
+    my_atomic_rwlock_wrlock(&LOCK_mdl_atomics);
+    my_atomic_add64(&m_fast_path_state, value);
+    my_atomic_rwlock_wrunlock(&LOCK_mdl_atomics);
+  }
+
+  /** Bitmap of types of locks granted using the fast path. */
+  bitmap_t fast_path_granted_bitmap() const
+  {
+    fast_path_state_t state= get_fast_path_state();
+    return ((state & SR_FAST_PATH_MASK ? MDL_BIT(MDL_SHARED_READ) : 0) |
+            (state & SW_FAST_PATH_MASK ? MDL_BIT(MDL_SHARED_WRITE) : 0));
+  }
+
+  bool fast_path_acquire(fast_path_state_t increment);
+  bool update_fast_path_flags(bitmap_t pending_types= 0);
 
   /** List of granted tickets for this lock. */
   Ticket_list m_granted;
@@ -456,198 +633,91 @@ class MDL_lock
   */
   ulong m_hog_lock_count;
 
-public:
-
-  MDL_lock(const MDL_key *key_arg, MDL_map_partition *map_part)
-  : key(key_arg),
-    m_hog_lock_count(0),
-    m_ref_usage(0),
-    m_ref_release(0),
-    m_is_destroyed(FALSE),
-    m_version(0),
-    m_map_part(map_part)
-  {
-    mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
-  }
+  const MDL_lock_strategy *m_strategy;
 
-  virtual ~MDL_lock()
-  {
-    mysql_prlock_destroy(&m_rwlock);
-  }
-  inline static void destroy(MDL_lock *lock);
-public:
-  /**
-    These three members are used to make it possible to separate
-    the MDL_map_partition::m_mutex mutex and MDL_lock::m_rwlock in
-    MDL_map::find_or_insert() for increased scalability.
-    The 'm_is_destroyed' member is only set by destroyers that
-    have both the MDL_map_partition::m_mutex and MDL_lock::m_rwlock, thus
-    holding any of the mutexes is sufficient to read it.
-    The 'm_ref_usage; is incremented under protection by
-    MDL_map_partition::m_mutex, but when 'm_is_destroyed' is set to TRUE, this
-    member is moved to be protected by the MDL_lock::m_rwlock.
-    This means that the MDL_map::find_or_insert() which only
-    holds the MDL_lock::m_rwlock can compare it to 'm_ref_release'
-    without acquiring MDL_map_partition::m_mutex again and if equal
-    it can also destroy the lock object safely.
-    The 'm_ref_release' is incremented under protection by
-    MDL_lock::m_rwlock.
-    Note since we are only interested in equality of these two
-    counters we don't have to worry about overflows as long as
-    their size is big enough to hold maximum number of concurrent
-    threads on the system.
-  */
-  uint m_ref_usage;
-  uint m_ref_release;
-  bool m_is_destroyed;
-  /**
-    We use the same idea and an additional version counter to support
-    caching of unused MDL_lock object for further re-use.
-    This counter is incremented while holding both MDL_map_partition::m_mutex
-    and MDL_lock::m_rwlock locks each time when a MDL_lock is moved from
-    the partitioned hash to the paritioned unused objects list (or destroyed).
-    A thread, which has found a MDL_lock object for the key in the hash
-    and then released the MDL_map_partition::m_mutex before acquiring the
-    MDL_lock::m_rwlock, can determine that this object was moved to the
-    unused objects list (or destroyed) while it held no locks by comparing
-    the version value which it read while holding the MDL_map_partition::m_mutex
-    with the value read after acquiring the MDL_lock::m_rwlock.
-    Note that since it takes several years to overflow this counter such
-    theoretically possible overflows should not have any practical effects.
-  */
-  ulonglong m_version;
   /**
-    Partition of MDL_map where the lock is stored.
+    Counters of SR and SW locks granted using the fast path, combined
+    with HAS_OBTRUSIVE, HAS_SLOW_PATH and IS_DESTROYED flags.
+
+    Counters are changed atomically without MDL_lock::m_rwlock by
+    owners of fast path locks. Flags are set and cleared while holding
+    MDL_lock::m_rwlock, except IS_DESTROYED which is set by whoever
+    removes the object from the hash once it is unused, i.e. once
+    the whole value becomes 0.
   */
-  MDL_map_partition *m_map_part;
-};
-
-
-/**
-  An implementation of the scoped metadata lock. The only locking modes
-  which are supported at the moment are SHARED and INTENTION EXCLUSIVE
-  and EXCLUSIVE
-*/
+  volatile fast_path_state_t m_fast_path_state;
 
-class MDL_scoped_lock : public MDL_lock
-{
 public:
-  MDL_scoped_lock(const MDL_key *key_arg, MDL_map_partition *map_part)
-    : MDL_lock(key_arg, map_part)
-  { }
 
-  virtual const bitmap_t *incompatible_granted_types_bitmap() const
-  {
-    return m_granted_incompatible;
-  }
-  virtual const bitmap_t *incompatible_waiting_types_bitmap() const
+  MDL_lock()
+  : m_hog_lock_count(0),
+    m_strategy(0),
+    m_fast_path_state(0)
   {
-    return m_waiting_incompatible;
-  }
-  virtual bool needs_notification(const MDL_ticket *ticket) const
-  {
-    return (ticket->get_type() == MDL_SHARED);
+    mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
   }
-  virtual void notify_conflicting_locks(MDL_context *ctx);
 
-  /*
-    In scoped locks, only IX lock request would starve because of X/S. But that
-    is practically very rare case. So just return 0 from this function.
-  */
-  virtual bitmap_t hog_lock_types_bitmap() const
+  MDL_lock(const MDL_key *key_arg)
+  : key(key_arg),
+    m_hog_lock_count(0),
+    m_strategy(get_strategy(key_arg)),
+    m_fast_path_state(0)
   {
-    return 0;
+    mysql_prlock_init(key_MDL_lock_rwlock, &m_rwlock);
   }
 
-private:
-  static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
-  static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
-};
-
-
-/**
-  An implementation of a per-object lock. Supports SHARED, SHARED_UPGRADABLE,
-  SHARED HIGH PRIORITY and EXCLUSIVE locks.
-*/
-
-class MDL_object_lock : public MDL_lock
-{
-public:
-  MDL_object_lock(const MDL_key *key_arg, MDL_map_partition *map_part)
-    : MDL_lock(key_arg, map_part)
-  { }
-
-  /**
-    Reset unused MDL_object_lock object to represent the lock context for a
-    different object.
-  */
-  void reset(const MDL_key *new_key)
-  {
-    /* We need to change only object's key. */
-    key.mdl_key_init(new_key);
-    /* m_granted and m_waiting should be already in the empty/initial state. */
-    DBUG_ASSERT(is_empty());
-    /* Object should not be marked as destroyed. */
-    DBUG_ASSERT(! m_is_destroyed);
-    /*
-      Values of the rest of the fields should be preserved between old and
-      new versions of the object. E.g., m_version and m_ref_usage/release
-      should be kept intact to properly handle possible remaining references
-      to the old version of the object.
-    */
+  ~MDL_lock()
+  {
+    mysql_prlock_destroy(&m_rwlock);
   }
 
-  virtual const bitmap_t *incompatible_granted_types_bitmap() const
+  static const MDL_lock_strategy *get_strategy(const MDL_key *key_arg)
   {
-    return m_granted_incompatible;
+    switch (key_arg->mdl_namespace())
+    {
+      case MDL_key::GLOBAL:
+      case MDL_key::SCHEMA:
+      case MDL_key::COMMIT:
+        return &m_scoped_lock_strategy;
+      default:
+        return &m_object_lock_strategy;
+    }
   }
-  virtual const bitmap_t *incompatible_waiting_types_bitmap() const
+
+  static void lf_alloc_constructor(uchar *arg)
   {
-    return m_waiting_incompatible;
+    new (arg + LF_HASH_OVERHEAD) MDL_lock();
   }
-  virtual bool needs_notification(const MDL_ticket *ticket) const
+
+  static void lf_alloc_destructor(uchar *arg)
   {
-    return (ticket->get_type() >= MDL_SHARED_NO_WRITE);
+    ((MDL_lock*) (arg + LF_HASH_OVERHEAD))->~MDL_lock();
   }
-  virtual void notify_conflicting_locks(MDL_context *ctx);
 
-  /*
-    To prevent starvation, these lock types that are only granted
-    max_write_lock_count times in a row while other lock types are
-    waiting.
-  */
-  virtual bitmap_t hog_lock_types_bitmap() const
+  static void lf_hash_initializer(LF_HASH *hash __attribute__((unused)),
+                                  void *dst, const void *src)
   {
-    return (MDL_BIT(MDL_SHARED_NO_WRITE) |
-            MDL_BIT(MDL_SHARED_NO_READ_WRITE) |
-            MDL_BIT(MDL_EXCLUSIVE));
+    MDL_lock *lock= static_cast<MDL_lock*>(dst);
+    const MDL_key *key_arg= static_cast<const MDL_key*>(src);
+    DBUG_ASSERT(key_arg->mdl_namespace() != MDL_key::GLOBAL &&
+                key_arg->mdl_namespace() != MDL_key::COMMIT);
+    lock->key.mdl_key_init(key_arg);
+    lock->m_strategy= get_strategy(key_arg);
+    lock->m_hog_lock_count= 0;
+    lock->m_fast_path_state= 0;
+    DBUG_ASSERT(lock->is_empty());
   }
 
-private:
-  static const bitmap_t m_granted_incompatible[MDL_TYPE_END];
-  static const bitmap_t m_waiting_incompatible[MDL_TYPE_END];
-
-public:
-  /** Members for linking the object into the list of unused objects. */
-  MDL_object_lock *next_in_cache, **prev_in_cache;
+  static const MDL_scoped_lock m_scoped_lock_strategy;
+  static const MDL_object_lock m_object_lock_strategy;
 };
 
 
-/**
-  Helper class for linking MDL_object_lock objects into the unused objects list.
-*/
-class MDL_object_lock_cache_adapter :
-      public I_P_List_adapter<MDL_object_lock, &MDL_object_lock::next_in_cache,
-                              &MDL_object_lock::prev_in_cache>
-{
-};
+const MDL_lock::MDL_scoped_lock MDL_lock::m_scoped_lock_strategy;
+const MDL_lock::MDL_object_lock MDL_lock::m_object_lock_strategy;
 
 
 static MDL_map mdl_locks;
-/**
-  Start-up parameter for the maximum size of the unused MDL_lock objects cache.
-*/
-ulong mdl_locks_cache_size;
 
 
 extern "C"
@@ -683,6 +753,7 @@ void mdl_init()
   init_mdl_psi_keys();
 #endif
 
+  my_atomic_rwlock_init(&LOCK_mdl_atomics);
   mdl_locks.init();
 }
 
@@ -700,149 +771,117 @@ void mdl_destroy()
   {
     mdl_initialized= FALSE;
     mdl_locks.destroy();
+    my_atomic_rwlock_destroy(&LOCK_mdl_atomics);
   }
 }
 
 
-static inline int mdl_iterate_lock(MDL_lock *lock,
-                                   int (*callback)(MDL_ticket *ticket, void *arg),
-                                   void *arg)
+struct mdl_iterate_arg
+{
+  int (*callback)(MDL_ticket *ticket, void *arg);
+  void *argument;
+};
+
+
+static my_bool mdl_iterate_lock(MDL_lock *lock, mdl_iterate_arg *arg)
 {
+  int res= FALSE;
+  /*
+    We can skip check for IS_DESTROYED here, because m_granted
+    must be empty for such locks anyway.
+  */
+  mysql_prlock_rdlock(&lock->m_rwlock);
   MDL_lock::Ticket_iterator ticket_it(lock->m_granted);
   MDL_ticket *ticket;
-  int res= 0;
-  mysql_prlock_rdlock(&lock->m_rwlock);
-  while ((ticket= ticket_it++) && !(res= callback(ticket, arg))) /* no-op */;
+  while ((ticket= ticket_it++) && !(res= arg->callback(ticket, arg->argument)))
+    /* no-op */;
   mysql_prlock_unlock(&lock->m_rwlock);
-  return res;
+  return MY_TEST(res);
 }
 
 
+/**
+  Call callback for all tickets granted in the server.
+
+  @note Locks acquired using the fast path are visited first, so that
+        a lock which is materialized meanwhile is not missed.
+  @note Callback might be called for some tickets twice.
+*/
+
 int mdl_iterate(int (*callback)(MDL_ticket *ticket, void *arg), void *arg)
 {
-  DYNAMIC_ARRAY locks;
-  uint i, j;
-  int res;
   DBUG_ENTER("mdl_iterate");
+  mdl_iterate_arg argument= { callback, arg };
+  LF_PINS *pins= mdl_locks.get_pins();
+  THD *tmp;
+  int res= 1;
 
-  if ((res= mdl_iterate_lock(mdl_locks.m_global_lock, callback, arg)) ||
-      (res= mdl_iterate_lock(mdl_locks.m_commit_lock, callback, arg)))
-    DBUG_RETURN(res);
-
-  my_init_dynamic_array(&locks, sizeof(MDL_lock*), 512, 1, MYF(0));
-
-  for (i= 0; i < mdl_locks.m_partitions.elements(); i++)
+  mysql_mutex_lock(&LOCK_thread_count);
+  I_List_iterator<THD> it(threads);
+  while ((tmp= it++))
   {
-    MDL_map_partition *part= mdl_locks.m_partitions.at(i);
-    /* Collect all locks first */
-    mysql_mutex_lock(&part->m_mutex);
-    if (allocate_dynamic(&locks, part->m_locks.records))
-    {
-      res= 1;
-      mysql_mutex_unlock(&part->m_mutex);
-      break;
-    }
-    reset_dynamic(&locks);
-    for (j= 0; j < part->m_locks.records; j++)
+    if (tmp->mdl_context.iterate_fast_path_locks(callback, arg))
     {
-      MDL_lock *lock= (MDL_lock*) my_hash_element(&part->m_locks, j);
-      lock->m_ref_usage++;
-      insert_dynamic(&locks, &lock);
-    }
-    mysql_mutex_unlock(&part->m_mutex);
-
-    /* Now show them */
-    for (j= 0; j < locks.elements; j++)
-    {
-      MDL_lock *lock= (MDL_lock*) *dynamic_element(&locks, j, MDL_lock**);
-      res= mdl_iterate_lock(lock, callback, arg);
-
-      mysql_prlock_wrlock(&lock->m_rwlock);
-      uint ref_usage= lock->m_ref_usage;
-      uint ref_release= ++lock->m_ref_release;
-      bool is_destroyed= lock->m_is_destroyed;
-      mysql_prlock_unlock(&lock->m_rwlock);
-
-      if (unlikely(is_destroyed && ref_usage == ref_release))
-        MDL_lock::destroy(lock);
-
-      if (res)
-        break;
+      mysql_mutex_unlock(&LOCK_thread_count);
+      if (pins)
+        lf_hash_put_pins(pins);
+      DBUG_RETURN(1);
     }
   }
-  delete_dynamic(&locks);
-  DBUG_RETURN(res);
-}
-
-
-/** Initialize the container for all MDL locks. */
+  mysql_mutex_unlock(&LOCK_thread_count);
 
-void MDL_map::init()
-{
-  MDL_key global_lock_key(MDL_key::GLOBAL, "", "");
-  MDL_key commit_lock_key(MDL_key::COMMIT, "", "");
-
-  m_global_lock= MDL_lock::create(&global_lock_key, NULL);
-  m_commit_lock= MDL_lock::create(&commit_lock_key, NULL);
-
-  for (uint i= 0; i < mdl_locks_hash_partitions; i++)
+  if (pins)
   {
-    MDL_map_partition *part= new (std::nothrow) MDL_map_partition();
-    m_partitions.append(part);
+    res= mdl_iterate_lock(mdl_locks.m_global_lock, &argument) ||
+         mdl_iterate_lock(mdl_locks.m_commit_lock, &argument) ||
+         lf_hash_iterate(&mdl_locks.m_locks, pins,
+                         (my_hash_walk_action) mdl_iterate_lock, &argument);
+    lf_hash_put_pins(pins);
   }
+  DBUG_RETURN(res);
 }
 
 
-my_hash_value_type mdl_hash_function(CHARSET_INFO *cs,
-                                     const uchar *key, size_t length)
+uint mdl_hash_function(const LF_HASH *hash __attribute__((unused)),
+                       const uchar *key,
+                       size_t length __attribute__((unused)))
 {
   MDL_key *mdl_key= (MDL_key*) (key - offsetof(MDL_key, m_ptr));
   return mdl_key->hash_value();
 }
 
 
-/** Initialize the partition in the container with all MDL locks. */
+/** Initialize the container for all MDL locks. */
 
-MDL_map_partition::MDL_map_partition()
+void MDL_map::init()
 {
-  mysql_mutex_init(key_MDL_map_mutex, &m_mutex, NULL);
-  my_hash_init2(&m_locks, 0, &my_charset_bin, 16 /* FIXME */, 0, 0,
-                mdl_locks_key, mdl_hash_function, 0, 0);
-};
-
-
-/**
-  Destroy the container for all MDL locks.
-  @pre It must be empty.
-*/
+  MDL_key global_lock_key(MDL_key::GLOBAL, "", "");
+  MDL_key commit_lock_key(MDL_key::COMMIT, "", "");
 
-void MDL_map::destroy()
-{
-  MDL_lock::destroy(m_global_lock);
-  MDL_lock::destroy(m_commit_lock);
+  m_global_lock= new (std::nothrow) MDL_lock(&global_lock_key);
+  m_commit_lock= new (std::nothrow) MDL_lock(&commit_lock_key);
 
-  while (m_partitions.elements() > 0)
-  {
-    MDL_map_partition *part= m_partitions.pop();
-    delete part;
-  }
+  lf_hash_init(&m_locks, sizeof(MDL_lock), LF_HASH_UNIQUE, 0, 0,
+               mdl_locks_key, &my_charset_bin);
+  m_locks.alloc.constructor= MDL_lock::lf_alloc_constructor;
+  m_locks.alloc.destructor= MDL_lock::lf_alloc_destructor;
+  m_locks.initializer= MDL_lock::lf_hash_initializer;
+  m_locks.hash_function= mdl_hash_function;
 }
 
 
 /**
-  Destroy the partition in container for all MDL locks.
+  Destroy the container for all MDL locks.
   @pre It must be empty.
 */
 
-MDL_map_partition::~MDL_map_partition()
+void MDL_map::destroy()
 {
-  DBUG_ASSERT(!m_locks.records);
-  mysql_mutex_destroy(&m_mutex);
-  my_hash_free(&m_locks);
+  delete m_global_lock;
+  delete m_commit_lock;
 
-  MDL_object_lock *lock;
-  while ((lock= m_unused_locks_cache.pop_front()))
-    MDL_lock::destroy(lock);
+  DBUG_ASSERT(!my_atomic_load32(&m_locks.count));
+  lf_hash_destroy(&m_locks);
 }
 
 
@@ -850,12 +889,16 @@ MDL_map_partition::~MDL_map_partition()
   Find MDL_lock object corresponding to the key, create it
   if it does not exist.
 
-  @retval non-NULL - Success. MDL_lock instance for the key with
-                     locked MDL_lock::m_rwlock.
+  @retval non-NULL - Success. MDL_lock instance for the key. Unless it is
+                     one of pre-allocated objects, it is pinned by pins[2]
+                     and the caller should release it with
+                     lf_hash_search_unpin(). MDL_lock::m_rwlock is not
+                     locked, and the object might be in the process of
+                     being destroyed (see MDL_lock::IS_DESTROYED).
   @retval NULL     - Failure (OOM).
 */
 
-MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
+MDL_lock* MDL_map::find_or_insert(LF_PINS *pins, const MDL_key *mdl_key)
 {
   MDL_lock *lock;
 
@@ -863,9 +906,9 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
       mdl_key->mdl_namespace() == MDL_key::COMMIT)
   {
     /*
-      Avoid locking any m_mutex when lock for GLOBAL or COMMIT namespace is
+      Avoid lookups in the hash when lock for GLOBAL or COMMIT namespace is
       requested. Return pointer to pre-allocated MDL_lock instance instead.
-      Such an optimization allows to save one mutex lock/unlock for any
+      Such an optimization allows to save one hash lookup for any
       statement changing data.
 
       It works since these namespaces contain only one element so keys
@@ -873,165 +916,27 @@ MDL_lock* MDL_map::find_or_insert(const MDL_key *mdl_key)
     */
     DBUG_ASSERT(mdl_key->length() == 3);
 
-    lock= (mdl_key->mdl_namespace() == MDL_key::GLOBAL) ? m_global_lock :
-                                                          m_commit_lock;
-
-    mysql_prlock_wrlock(&lock->m_rwlock);
-
-    return lock;
+    return (mdl_key->mdl_namespace() == MDL_key::GLOBAL) ? m_global_lock :
+                                                           m_commit_lock;
   }
 
-  uint part_id= mdl_key->hash_value() % mdl_locks_hash_partitions;
-  MDL_map_partition *part= m_partitions.at(part_id);
-
-  return part->find_or_insert(mdl_key);
-}
-
-
-/**
-  Find MDL_lock object corresponding to the key and hash value in
-  MDL_map partition, create it if it does not exist.
-
-  @retval non-NULL - Success. MDL_lock instance for the key with
-                     locked MDL_lock::m_rwlock.
-  @retval NULL     - Failure (OOM).
-*/
-
-MDL_lock* MDL_map_partition::find_or_insert(const MDL_key *mdl_key)
-{
-  MDL_lock *lock;
-
-retry:
-  mysql_mutex_lock(&m_mutex);
-  if (!(lock= (MDL_lock*) my_hash_search_using_hash_value(&m_locks,
-                                                          mdl_key->hash_value(),
-                                                          mdl_key->ptr(),
-                                                          mdl_key->length())))
+  while (!(lock= (MDL_lock*) lf_hash_search(&m_locks, pins, mdl_key->ptr(),
+                                             mdl_key->length())))
   {
-    MDL_object_lock *unused_lock= NULL;
-
     /*
-      No lock object found so we need to create a new one
-      or reuse an existing unused object.
+      No lock object found so we need to create a new one. If some other
+      thread has inserted the same key concurrently, lf_hash_insert() fails
+      with 1 and we simply repeat the search.
     */
-    if (mdl_key->mdl_namespace() != MDL_key::SCHEMA &&
-        m_unused_locks_cache.elements())
-    {
-      /*
-        We need a MDL_object_lock type of object and the unused objects
-        cache has some. Get the first object from the cache and set a new
-        key for it.
-      */
-      DBUG_ASSERT(mdl_key->mdl_namespace() != MDL_key::GLOBAL &&
-                  mdl_key->mdl_namespace() != MDL_key::COMMIT);
-
-      unused_lock= m_unused_locks_cache.pop_front();
-      unused_lock->reset(mdl_key);
-
-      lock= unused_lock;
-    }
-    else
-    {
-      lock= MDL_lock::create(mdl_key, this);
-    }
-
-    if (!lock || my_hash_insert(&m_locks, (uchar*)lock))
-    {
-      if (unused_lock)
-      {
-        /*
-          Note that we can't easily destroy an object from cache here as it
-          still might be referenced by other threads. So we simply put it
-          back into the cache.
-        */
-        m_unused_locks_cache.push_front(unused_lock);
-      }
-      else
-      {
-        MDL_lock::destroy(lock);
-      }
-      mysql_mutex_unlock(&m_mutex);
+    if (lf_hash_insert(&m_locks, pins, mdl_key) == -1)
       return NULL;
-    }
   }
-
-  if (move_from_hash_to_lock_mutex(lock))
-    goto retry;
-
-  return lock;
-}
-
-
-/**
-  Release MDL_map_partition::m_mutex mutex and lock MDL_lock::m_rwlock for lock
-  object from the hash. Handle situation when object was released
-  while we held no locks.
-
-  @retval FALSE - Success.
-  @retval TRUE  - Object was released while we held no mutex, caller
-                  should re-try looking up MDL_lock object in the hash.
-*/
-
-bool MDL_map_partition::move_from_hash_to_lock_mutex(MDL_lock *lock)
-{
-  ulonglong version;
-
-  DBUG_ASSERT(! lock->m_is_destroyed);
-  mysql_mutex_assert_owner(&m_mutex);
-
-  /*
-    We increment m_ref_usage which is a reference counter protected by
-    MDL_map_partition::m_mutex under the condition it is present in the hash
-    and m_is_destroyed is FALSE.
-  */
-  lock->m_ref_usage++;
-  /* Read value of the version counter under protection of m_mutex lock. */
-  version= lock->m_version;
-  mysql_mutex_unlock(&m_mutex);
-
-  mysql_prlock_wrlock(&lock->m_rwlock);
-  lock->m_ref_release++;
-
-  if (unlikely(lock->m_version != version))
+  if (lock == MY_ERRPTR)
   {
-    /*
-      If the current value of version differs from one that was read while
-      we held m_mutex mutex, this MDL_lock object was moved to the unused
-      objects list or destroyed while we held no locks.
-      We should retry our search. But first we should destroy the MDL_lock
-      object if necessary.
-    */
-    if (unlikely(lock->m_is_destroyed))
-    {
-      /*
-        Object was released while we held no locks, we need to
-        release it if no others hold references to it, while our own
-        reference count ensured that the object as such haven't got
-        its memory released yet. We can also safely compare
-        m_ref_usage and m_ref_release since the object is no longer
-        present in the hash (or unused objects list) so no one will
-        be able to find it and increment m_ref_usage anymore.
-      */
-      uint ref_usage= lock->m_ref_usage;
-      uint ref_release= lock->m_ref_release;
-      mysql_prlock_unlock(&lock->m_rwlock);
-      if (ref_usage == ref_release)
-        MDL_lock::destroy(lock);
-    }
-    else
-    {
-      /*
-        Object was not destroyed but its version has changed.
-        This means that it was moved to the unused objects list
-        (and even might be already re-used). So now it might
-        correspond to a different key, therefore we should simply
-        retry our search.
-      */
-      mysql_prlock_unlock(&lock->m_rwlock);
-    }
-    return TRUE;
+    lf_hash_search_unpin(pins);
+    return NULL;
   }
-  return FALSE;
+  return lock;
 }
 
 
@@ -1040,7 +945,7 @@ bool MDL_map_partition::move_from_hash_to_lock_mutex(MDL_lock *lock)
  */
 
 unsigned long
-MDL_map::get_lock_owner(const MDL_key *mdl_key)
+MDL_map::get_lock_owner(LF_PINS *pins, const MDL_key *mdl_key)
 {
   MDL_lock *lock;
   unsigned long res= 0;
@@ -1056,124 +961,190 @@ MDL_map::get_lock_owner(const MDL_key *mdl_key)
   }
   else
   {
-    uint part_id= mdl_key->hash_value() % mdl_locks_hash_partitions;
-    MDL_map_partition *part= m_partitions.at(part_id);
-    res= part->get_lock_owner(mdl_key);
+    lock= (MDL_lock*) lf_hash_search(&m_locks, pins, mdl_key->ptr(),
+                                     mdl_key->length());
+    if (lock)
+    {
+      /*
+        We can skip check for IS_DESTROYED here, because m_granted
+        must be empty for such locks anyway.
+      */
+      if (lock != MY_ERRPTR)
+      {
+        mysql_prlock_rdlock(&lock->m_rwlock);
+        res= lock->get_lock_owner();
+        mysql_prlock_unlock(&lock->m_rwlock);
+      }
+      lf_hash_search_unpin(pins);
+    }
   }
   return res;
 }
 
 
-
-unsigned long
-MDL_map_partition::get_lock_owner(const MDL_key *mdl_key)
-{
-  MDL_lock *lock;
-  unsigned long res= 0;
-
-  mysql_mutex_lock(&m_mutex);
-  lock= (MDL_lock*) my_hash_search_using_hash_value(&m_locks,
-                                                  mdl_key->hash_value(),
-                                                  mdl_key->ptr(),
-                                                  mdl_key->length());
-  if (lock)
-    res= lock->get_lock_owner();
-  mysql_mutex_unlock(&m_mutex);
-
-  return res;
-}
-
-
 /**
-  Destroy MDL_lock object or delegate this responsibility to
-  whatever thread that holds the last outstanding reference to
-  it.
+  Remove MDL_lock object from the hash if it is no longer used, or
+  delegate this responsibility to the thread which releases the last
+  lock acquired using the fast path.
+
+  @pre MDL_lock::m_rwlock is write-locked, m_granted and m_waiting
+       queues are empty. The lock is released by this function.
 */
 
-void MDL_map::remove(MDL_lock *lock)
+void MDL_map::remove(LF_PINS *pins, MDL_lock *lock)
 {
+  MDL_lock::fast_path_state_t state= 0;
+
+  DBUG_ASSERT(lock->is_empty());
+  lock->update_fast_path_flags();
+
   if (lock->key.mdl_namespace() == MDL_key::GLOBAL ||
-      lock->key.mdl_namespace() == MDL_key::COMMIT)
+      lock->key.mdl_namespace() == MDL_key::COMMIT ||
+      !lock->cas_fast_path_state(&state, MDL_lock::IS_DESTROYED))
   {
     /*
       Never destroy pre-allocated MDL_lock objects for GLOBAL and
-      COMMIT namespaces.
+      COMMIT namespaces. Objects which still have locks acquired using
+      the fast path are destroyed by the owner of the last such lock.
     */
     mysql_prlock_unlock(&lock->m_rwlock);
     return;
   }
 
-  lock->m_map_part->remove(lock);
+  mysql_prlock_unlock(&lock->m_rwlock);
+  remove_destroyed(pins, lock);
 }
 
 
 /**
-  Destroy MDL_lock object belonging to specific MDL_map
-  partition or delegate this responsibility to whatever
-  thread that holds the last outstanding reference to it.
+  Delete MDL_lock object marked with MDL_lock::IS_DESTROYED flag
+  from the hash.
+
+  @note Threads which have found the object in the hash before it was
+        deleted see the flag and retry the lookup. The memory is not
+        reused while they keep the object pinned.
 */
 
-void MDL_map_partition::remove(MDL_lock *lock)
+void MDL_map::remove_destroyed(LF_PINS *pins, MDL_lock *lock)
 {
-  mysql_mutex_lock(&m_mutex);
-  my_hash_delete(&m_locks, (uchar*) lock);
-  /*
-    To let threads holding references to the MDL_lock object know that it was
-    moved to the list of unused objects or destroyed, we increment the version
-    counter under protection of both MDL_map_partition::m_mutex and
-    MDL_lock::m_rwlock locks. This allows us to read the version value while
-    having either one of those locks.
-  */
-  lock->m_version++;
+  DBUG_ASSERT(lock->get_fast_path_state() == MDL_lock::IS_DESTROYED);
+  lf_hash_delete(&m_locks, pins, lock->key.ptr(), lock->key.length());
+}
 
-  if ((lock->key.mdl_namespace() != MDL_key::SCHEMA) &&
-      (m_unused_locks_cache.elements() <
-       mdl_locks_cache_size/mdl_locks_hash_partitions))
+
+/**
+  Try to acquire lock of unobtrusive type using the fast path,
+  i.e. by incrementing corresponding counter in m_fast_path_state
+  without acquiring m_rwlock.
+
+  @param increment  Value to be added to m_fast_path_state.
+
+  @retval TRUE   Lock acquired.
+  @retval FALSE  Obtrusive locks are granted or pending, or the object
+                 is being destroyed (IS_DESTROYED is set in this case).
+*/
+
+bool MDL_lock::fast_path_acquire(fast_path_state_t increment)
+{
+  fast_path_state_t old_state= get_fast_path_state();
+
+  do
   {
-    /*
-      This is an object of MDL_object_lock type and the cache of unused
-      objects has not reached its maximum size yet. So instead of destroying
-      object we move it to the list of unused objects to allow its later
-      re-use with possibly different key. Any threads holding references to
-      this object (owning MDL_map_partition::m_mutex or MDL_lock::m_rwlock)
-      will notice this thanks to the fact that we have changed the
-      MDL_lock::m_version counter.
-    */
-    DBUG_ASSERT(lock->key.mdl_namespace() != MDL_key::GLOBAL &&
-                lock->key.mdl_namespace() != MDL_key::COMMIT);
+    if (old_state & (HAS_OBTRUSIVE | IS_DESTROYED))
+      return FALSE;
+  } while (!cas_fast_path_state(&old_state, old_state + increment));
+  return TRUE;
+}
 
-    m_unused_locks_cache.push_front((MDL_object_lock*)lock);
-    mysql_mutex_unlock(&m_mutex);
-    mysql_prlock_unlock(&lock->m_rwlock);
-  }
-  else
+
+/**
+  Bring HAS_OBTRUSIVE and HAS_SLOW_PATH flags in sync with the state
+  of m_granted and m_waiting queues.
+
+  @pre MDL_lock::m_rwlock is write-locked.
+
+  @param pending_types  Types of locks which are about to be added
+                        to the queues.
+
+  @retval TRUE   Success.
+  @retval FALSE  The object is being destroyed and can't be used. Can
+                 only happen when queues are empty.
+*/
+
+bool MDL_lock::update_fast_path_flags(bitmap_t pending_types)
+{
+  bitmap_t types= m_granted.bitmap() | m_waiting.bitmap() | pending_types;
+  fast_path_state_t old_state= get_fast_path_state();
+  fast_path_state_t new_state;
+
+  do
   {
-    /*
-      Destroy the MDL_lock object, but ensure that anyone that is
-      holding a reference to the object is not remaining, if so he
-      has the responsibility to release it.
-
-      Setting of m_is_destroyed to TRUE while holding _both_
-      MDL_map_partition::m_mutex and MDL_lock::m_rwlock mutexes transfers
-      the protection of m_ref_usage from MDL_map_partition::m_mutex to
-      MDL_lock::m_rwlock while removal of the object from the hash
-      (and cache of unused objects) makes it read-only. Therefore
-      whoever acquires MDL_lock::m_rwlock next will see the most up
-      to date version of m_ref_usage.
-
-      This means that when m_is_destroyed is TRUE and we hold the
-      MDL_lock::m_rwlock we can safely read the m_ref_usage
-      member.
-    */
-    uint ref_usage, ref_release;
+    if (old_state & IS_DESTROYED)
+    {
+      DBUG_ASSERT(is_empty());
+      return FALSE;
+    }
+    new_state= old_state & ~(HAS_OBTRUSIVE | HAS_SLOW_PATH);
+    if (types & m_strategy->obtrusive_lock_types_bitmap())
+      new_state|= HAS_OBTRUSIVE;
+    if (types)
+      new_state|= HAS_SLOW_PATH;
+  } while (new_state != old_state &&
+           !cas_fast_path_state(&old_state, new_state));
+  return TRUE;
+}
 
-    lock->m_is_destroyed= TRUE;
-    ref_usage= lock->m_ref_usage;
-    ref_release= lock->m_ref_release;
-    mysql_mutex_unlock(&m_mutex);
-    mysql_prlock_unlock(&lock->m_rwlock);
-    if (ref_usage == ref_release)
-      MDL_lock::destroy(lock);
+
+/**
+  Release lock acquired using the fast path.
+
+  @param pins    Pins for the hash of all MDL_lock objects.
+  @param ticket  Ticket for lock to be released.
+*/
+
+void MDL_lock::remove_fast_path_ticket(LF_PINS *pins, MDL_ticket *ticket)
+{
+  fast_path_state_t increment=
+    m_strategy->fast_path_increment(ticket->get_type());
+  fast_path_state_t old_state= get_fast_path_state();
+
+  DBUG_ASSERT(increment);
+
+  for (;;)
+  {
+    if (old_state & HAS_OBTRUSIVE)
+    {
+      /*
+        There is an obtrusive lock granted or pending, its owner might be
+        waiting for our lock to go away. So decrement the counter and wake
+        up waiters under protection of m_rwlock. Our lock prevents the
+        object from being destroyed until the counter is decremented.
+      */
+      mysql_prlock_wrlock(&m_rwlock);
+      add_fast_path_state(-increment);
+      if (is_empty())
+        mdl_locks.remove(pins, this);
+      else
+      {
+        reschedule_waiters();
+        mysql_prlock_unlock(&m_rwlock);
+      }
+      return;
+    }
+    if (old_state == increment)
+    {
+      /*
+        This is the last user of the object, mark it as destroyed
+        in the same step so that nobody can start using it.
+      */
+      if (cas_fast_path_state(&old_state, IS_DESTROYED))
+      {
+        mdl_locks.remove_destroyed(pins, this);
+        return;
+      }
+    }
+    else if (cas_fast_path_state(&old_state, old_state - increment))
+      return;
   }
 }
 
@@ -1188,9 +1159,12 @@ MDL_context::MDL_context()
   :
   m_owner(NULL),
   m_needs_thr_lock_abort(FALSE),
-  m_waiting_for(NULL)
+  m_waiting_for(NULL),
+  m_pins(NULL)
 {
   mysql_prlock_init(key_MDL_context_LOCK_waiting_for, &m_LOCK_waiting_for);
+  mysql_mutex_init(key_MDL_context_LOCK_fast_path, &m_LOCK_fast_path,
+                   MY_MUTEX_INIT_FAST);
 }
 
 
@@ -1211,8 +1185,122 @@ void MDL_context::destroy()
   DBUG_ASSERT(m_tickets[MDL_STATEMENT].is_empty());
   DBUG_ASSERT(m_tickets[MDL_TRANSACTION].is_empty());
   DBUG_ASSERT(m_tickets[MDL_EXPLICIT].is_empty());
+  DBUG_ASSERT(m_fast_path_tickets.is_empty());
 
   mysql_prlock_destroy(&m_LOCK_waiting_for);
+  mysql_mutex_destroy(&m_LOCK_fast_path);
+  if (m_pins)
+    lf_hash_put_pins(m_pins);
+}
+
+
+/**
+  Allocate pins for the hash of all MDL_lock objects, unless
+  this context already has them.
+
+  @retval FALSE  Success.
+  @retval TRUE   Out of memory.
+*/
+
+bool MDL_context::fix_pins()
+{
+  return m_pins ? FALSE : (m_pins= mdl_locks.get_pins()) == 0;
+}
+
+
+/**
+  Check if this context may acquire locks using the fast path.
+
+  Owners of locks acquired using the fast path are invisible to
+  MDL_lock::notify_conflicting_locks(), so contexts which might need
+  to be notified about conflicts by calling code outside of MDL
+  don't use it.
+*/
+
+bool MDL_context::is_fast_path_allowed() const
+{
+  if (WSREP_ON || m_needs_thr_lock_abort)
+    return FALSE;
+  return !(get_thd()->system_thread & SYSTEM_THREAD_DELAYED_INSERT);
+}
+
+
+/**
+  Move lock acquired using the fast path to MDL_lock::m_granted list,
+  so it becomes visible to other contexts and to the deadlock detector.
+*/
+
+void MDL_context::materialize_fast_path_lock(MDL_ticket *ticket)
+{
+  MDL_lock *lock= ticket->m_lock;
+
+  DBUG_ASSERT(ticket->m_is_fast_path);
+  mysql_prlock_wrlock(&lock->m_rwlock);
+  lock->m_granted.add_ticket(ticket);
+  /*
+    Unlink the ticket while it is in both places, so that mdl_iterate()
+    always finds it in one of them.
+  */
+  mysql_mutex_lock(&m_LOCK_fast_path);
+  m_fast_path_tickets.remove(ticket);
+  mysql_mutex_unlock(&m_LOCK_fast_path);
+  /*
+    Set HAS_SLOW_PATH flag before decrementing the counter, so the
+    object can't be destroyed in between.
+  */
+  lock->update_fast_path_flags();
+  lock->add_fast_path_state(-lock->m_strategy->
+                            fast_path_increment(ticket->get_type()));
+  mysql_prlock_unlock(&lock->m_rwlock);
+  ticket->m_is_fast_path= false;
+}
+
+
+/** Materialize all locks acquired by this context using the fast path. */
+
+void MDL_context::materialize_fast_path_locks()
+{
+  int i;
+
+  for (i= 0; i < MDL_DURATION_END; i++)
+  {
+    Ticket_iterator it(m_tickets[i]);
+    MDL_ticket *ticket;
+
+    while ((ticket= it++))
+    {
+      if (ticket->m_is_fast_path)
+        materialize_fast_path_lock(ticket);
+    }
+  }
+}
+
+
+/**
+  Call callback for the locks which this context has acquired using
+  the fast path. May be called by any thread.
+
+  @return Non-zero value returned by the callback, or 0.
+*/
+
+int MDL_context::iterate_fast_path_locks(int (*callback)(MDL_ticket *ticket,
+                                                         void *arg),
+                                         void *arg)
+{
+  I_P_List_iterator<MDL_ticket,
+                    I_P_List<MDL_ticket,
+                             I_P_List_adapter<MDL_ticket,
+                                              &MDL_ticket::next_fast_path,
+                                              &MDL_ticket::prev_fast_path> > >
+    it(m_fast_path_tickets);
+  MDL_ticket *ticket;
+  int res= 0;
+
+  mysql_mutex_lock(&m_LOCK_fast_path);
+  while ((ticket= it++) && !(res= callback(ticket, arg)))
+    /* no-op */;
+  mysql_mutex_unlock(&m_LOCK_fast_path);
+  return res;
 }
 
 
@@ -1269,33 +1357,6 @@ void MDL_request::init(const MDL_key *key_arg,
 }
 
 
-/**
-  Auxiliary functions needed for creation/destruction of MDL_lock objects.
-
-  @note Also chooses an MDL_lock descendant appropriate for object namespace.
-*/
-
-inline MDL_lock *MDL_lock::create(const MDL_key *mdl_key,
-                                  MDL_map_partition *map_part)
-{
-  switch (mdl_key->mdl_namespace())
-  {
-    case MDL_key::GLOBAL:
-    case MDL_key::SCHEMA:
-    case MDL_key::COMMIT:
-      return new (std::nothrow) MDL_scoped_lock(mdl_key, map_part);
-    default:
-      return new (std::nothrow) MDL_object_lock(mdl_key, map_part);
-  }
-}
-
-
-void MDL_lock::destroy(MDL_lock *lock)
-{
-  delete lock;
-}
-
-
 /**
   Auxiliary functions needed for creation/destruction of MDL_ticket
   objects.
@@ -1754,14 +1815,14 @@ void MDL_lock::reschedule_waiters()
   on schema objects) and aren't acquired for DML.
 */
 
-const MDL_lock::bitmap_t MDL_scoped_lock::m_granted_incompatible[MDL_TYPE_END] =
+const MDL_lock::bitmap_t MDL_lock::MDL_scoped_lock::m_granted_incompatible[MDL_TYPE_END] =
 {
   MDL_BIT(MDL_EXCLUSIVE) | MDL_BIT(MDL_SHARED),
   MDL_BIT(MDL_EXCLUSIVE) | MDL_BIT(MDL_INTENTION_EXCLUSIVE), 0, 0, 0, 0, 0, 0,
   MDL_BIT(MDL_EXCLUSIVE) | MDL_BIT(MDL_SHARED) | MDL_BIT(MDL_INTENTION_EXCLUSIVE)
 };
 
-const MDL_lock::bitmap_t MDL_scoped_lock::m_waiting_incompatible[MDL_TYPE_END] =
+const MDL_lock::bitmap_t MDL_lock::MDL_scoped_lock::m_waiting_incompatible[MDL_TYPE_END] =
 {
   MDL_BIT(MDL_EXCLUSIVE) | MDL_BIT(MDL_SHARED),
   MDL_BIT(MDL_EXCLUSIVE), 0, 0, 0, 0, 0, 0, 0
@@ -1823,7 +1884,7 @@ const MDL_lock::bitmap_t MDL_scoped_lock::m_waiting_incompatible[MDL_TYPE_END] =
 */
 
 const MDL_lock::bitmap_t
-MDL_object_lock::m_granted_incompatible[MDL_TYPE_END] =
+MDL_lock::MDL_object_lock::m_granted_incompatible[MDL_TYPE_END] =
 {
   0,
   MDL_BIT(MDL_EXCLUSIVE),
@@ -1847,7 +1908,7 @@ MDL_object_lock::m_granted_incompatible[MDL_TYPE_END] =
 
 
 const MDL_lock::bitmap_t
-MDL_object_lock::m_waiting_incompatible[MDL_TYPE_END] =
+MDL_lock::MDL_object_lock::m_waiting_incompatible[MDL_TYPE_END] =
 {
   0,
   MDL_BIT(MDL_EXCLUSIVE),
@@ -1897,7 +1958,14 @@ MDL_lock::can_grant_lock(enum_mdl_type type_arg,
   */
   if (ignore_lock_priority || !(m_waiting.bitmap() & waiting_incompat_map))
   {
-    if (! (m_granted.bitmap() & granted_incompat_map))
+    /*
+      Locks acquired using the fast path always belong to other contexts,
+      as requestor materializes its own ones before asking for a lock of
+      type which can be incompatible with them.
+    */
+    if (fast_path_granted_bitmap() & granted_incompat_map)
+      can_grant= FALSE;
+    else if (! (m_granted.bitmap() & granted_incompat_map))
       can_grant= TRUE;
     else
     {
@@ -1977,14 +2045,16 @@ MDL_lock::get_lock_owner() const
 
 /** Remove a ticket from waiting or pending queue and wakeup up waiters. */
 
-void MDL_lock::remove_ticket(Ticket_list MDL_lock::*list, MDL_ticket *ticket)
+void MDL_lock::remove_ticket(LF_PINS *pins, Ticket_list MDL_lock::*list,
+                             MDL_ticket *ticket)
 {
   mysql_prlock_wrlock(&m_rwlock);
   (this->*list).remove_ticket(ticket);
   if (is_empty())
-    mdl_locks.remove(this);
+    mdl_locks.remove(pins, this);
   else
   {
+    update_fast_path_flags();
     /*
       There can be some contexts waiting to acquire a lock
       which now might be able to do it. Grant the lock to
@@ -2149,11 +2219,18 @@ MDL_context::try_acquire_lock(MDL_request *mdl_request)
     /*
       Our attempt to acquire lock without waiting has failed.
       Let us release resources which were acquired in the process.
-      We can't get here if we allocated a new lock object so there
-      is no need to release it.
+      The conflicting lock might have been acquired using the fast path,
+      so the lock object might be left empty and we need to take care
+      of it.
     */
-    DBUG_ASSERT(! ticket->m_lock->is_empty());
-    mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
+    MDL_lock *lock= ticket->m_lock;
+    if (lock->is_empty())
+      mdl_locks.remove(m_pins, lock);
+    else
+    {
+      lock->update_fast_path_flags();
+      mysql_prlock_unlock(&lock->m_rwlock);
+    }
     MDL_ticket::destroy(ticket);
   }
 
@@ -2185,6 +2262,8 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
   MDL_key *key= &mdl_request->key;
   MDL_ticket *ticket;
   enum_mdl_duration found_duration;
+  const MDL_lock::MDL_lock_strategy *strategy;
+  MDL_lock::fast_path_state_t increment;
 
   DBUG_ASSERT(mdl_request->type != MDL_EXCLUSIVE ||
               is_lock_owner(MDL_key::GLOBAL, "", "", MDL_INTENTION_EXCLUSIVE));
@@ -2230,6 +2309,9 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
     return FALSE;
   }
 
+  if (fix_pins())
+    return TRUE;
+
   if (!(ticket= MDL_ticket::create(this, mdl_request->type
 #ifndef DBUG_OFF
                                    , mdl_request->duration
@@ -2237,8 +2319,20 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
                                    )))
     return TRUE;
 
-  /* The below call implicitly locks MDL_lock::m_rwlock on success. */
-  if (!(lock= mdl_locks.find_or_insert(key)))
+  strategy= MDL_lock::get_strategy(key);
+  increment= is_fast_path_allowed() ?
+             strategy->fast_path_increment(mdl_request->type) : 0;
+
+  /*
+    Locks of obtrusive types are incompatible with locks acquired using
+    the fast path, and conflict with our own such locks can't be detected.
+    Move our fast path locks to MDL_lock::m_granted lists first.
+  */
+  if (MDL_BIT(mdl_request->type) & strategy->obtrusive_lock_types_bitmap())
+    materialize_fast_path_locks();
+
+retry:
+  if (!(lock= mdl_locks.find_or_insert(m_pins, key)))
   {
     MDL_ticket::destroy(ticket);
     return TRUE;
@@ -2246,6 +2340,45 @@ MDL_context::try_acquire_lock_impl(MDL_request *mdl_request,
 
   ticket->m_lock= lock;
 
+  if (increment)
+  {
+    if (lock->fast_path_acquire(increment))
+    {
+      /*
+        The lock has been granted without touching MDL_lock::m_rwlock.
+        The non-zero counter prevents the object from being destroyed,
+        so it can be unpinned.
+      */
+      lf_hash_search_unpin(m_pins);
+      ticket->m_is_fast_path= true;
+      m_tickets[mdl_request->duration].push_front(ticket);
+      mysql_mutex_lock(&m_LOCK_fast_path);
+      m_fast_path_tickets.push_front(ticket);
+      mysql_mutex_unlock(&m_LOCK_fast_path);
+      mdl_request->ticket= ticket;
+      return FALSE;
+    }
+    if (lock->get_fast_path_state() & MDL_lock::IS_DESTROYED)
+    {
+      lf_hash_search_unpin(m_pins);
+      goto retry;
+    }
+  }
+
+  mysql_prlock_wrlock(&lock->m_rwlock);
+  if (!lock->update_fast_path_flags(MDL_BIT(mdl_request->type)))
+  {
+    /* The object is being removed from the hash. Look it up again. */
+    mysql_prlock_unlock(&lock->m_rwlock);
+    lf_hash_search_unpin(m_pins);
+    goto retry;
+  }
+  /*
+    Pending ticket or HAS_SLOW_PATH flag prevents the object from being
+    destroyed while MDL_lock::m_rwlock is held.
+  */
+  lf_hash_search_unpin(m_pins);
+
   if (lock->can_grant_lock(mdl_request->type, this, false))
   {
     lock->m_granted.add_ticket(ticket);
@@ -2301,6 +2434,7 @@ MDL_context::clone_ticket(MDL_request *mdl_request)
 
   mysql_prlock_wrlock(&ticket->m_lock->m_rwlock);
   ticket->m_lock->m_granted.add_ticket(ticket);
+  ticket->m_lock->update_fast_path_flags();
   mysql_prlock_unlock(&ticket->m_lock->m_rwlock);
 
   m_tickets[mdl_request->duration].push_front(ticket);
@@ -2309,72 +2443,6 @@ MDL_context::clone_ticket(MDL_request *mdl_request)
 }
 
 
-/**
-  Notify threads holding a shared metadata locks on object which
-  conflict with a pending X, SNW or SNRW lock.
-
-  @param  ctx  MDL_context for current thread.
-*/
-
-void MDL_object_lock::notify_conflicting_locks(MDL_context *ctx)
-{
-  Ticket_iterator it(m_granted);
-  MDL_ticket *conflicting_ticket;
-
-  while ((conflicting_ticket= it++))
-  {
-    /* Only try to abort locks on which we back off. */
-    if (conflicting_ticket->get_ctx() != ctx &&
-        conflicting_ticket->get_type() < MDL_SHARED_UPGRADABLE)
-
-    {
-      MDL_context *conflicting_ctx= conflicting_ticket->get_ctx();
-
-      /*
-        If thread which holds conflicting lock is waiting on table-level
-        lock or some other non-MDL resource we might need to wake it up
-        by calling code outside of MDL.
-      */
-      ctx->get_owner()->
-        notify_shared_lock(conflicting_ctx->get_owner(),
-                           conflicting_ctx->get_needs_thr_lock_abort());
-    }
-  }
-}
-
-
-/**
-  Notify threads holding scoped IX locks which conflict with a pending S lock.
-
-  @param  ctx  MDL_context for current thread.
-*/
-
-void MDL_scoped_lock::notify_conflicting_locks(MDL_context *ctx)
-{
-  Ticket_iterator it(m_granted);
-  MDL_ticket *conflicting_ticket;
-
-  while ((conflicting_ticket= it++))
-  {
-    if (conflicting_ticket->get_ctx() != ctx &&
-        conflicting_ticket->get_type() == MDL_INTENTION_EXCLUSIVE)
-
-    {
-      MDL_context *conflicting_ctx= conflicting_ticket->get_ctx();
-
-      /*
-        Thread which holds global IX lock can be a handler thread for
-        insert delayed. We need to kill such threads in order to get
-        global shared lock. We do this my calling code outside of MDL.
-      */
-      ctx->get_owner()->
-        notify_shared_lock(conflicting_ctx->get_owner(),
-                           conflicting_ctx->get_needs_thr_lock_abort());
-    }
-  }
-}
-
-
 /**
   Acquire one lock with waiting for conflicting locks to go away if needed.
 
@@ -2486,7 +2554,7 @@ MDL_context::acquire_lock(MDL_request *mdl_request, double lock_wait_timeout)
 
   if (wait_status != MDL_wait::GRANTED)
   {
-    lock->remove_ticket(&MDL_lock::m_waiting, ticket);
+    lock->remove_ticket(m_pins, &MDL_lock::m_waiting, ticket);
     MDL_ticket::destroy(ticket);
     switch (wait_status)
     {
@@ -2665,6 +2733,7 @@ MDL_context::upgrade_shared_lock(MDL_ticket *mdl_ticket,
   mdl_ticket->m_lock->m_granted.remove_ticket(mdl_ticket);
   mdl_ticket->m_type= new_type;
   mdl_ticket->m_lock->m_granted.add_ticket(mdl_ticket);
+  mdl_ticket->m_lock->update_fast_path_flags();
 
   mysql_prlock_unlock(&mdl_ticket->m_lock->m_rwlock);
 
@@ -2942,7 +3011,16 @@ void MDL_context::release_lock(enum_mdl_duration duration, MDL_ticket *ticket)
 
   DBUG_ASSERT(this == ticket->get_ctx());
 
-  lock->remove_ticket(&MDL_lock::m_granted, ticket);
+  if (ticket->m_is_fast_path)
+  {
+    /* Unlink the ticket before the lock object may be destroyed. */
+    mysql_mutex_lock(&m_LOCK_fast_path);
+    m_fast_path_tickets.remove(ticket);
+    mysql_mutex_unlock(&m_LOCK_fast_path);
+    lock->remove_fast_path_ticket(m_pins, ticket);
+  }
+  else
+    lock->remove_ticket(m_pins, &MDL_lock::m_granted, ticket);
 
   m_tickets[duration].remove(ticket);
   MDL_ticket::destroy(ticket);
@@ -3055,6 +3133,7 @@ void MDL_ticket::downgrade_lock(enum_mdl_type type)
   m_lock->m_granted.remove_ticket(this);
   m_type= type;
   m_lock->m_granted.add_ticket(this);
+  m_lock->update_fast_path_flags();
   m_lock->reschedule_waiters();
   mysql_prlock_unlock(&m_lock->m_rwlock);
 }
@@ -3103,7 +3182,9 @@ MDL_context::is_lock_owner(MDL_key::enum_mdl_namespace mdl_namespace,
 unsigned long
 MDL_context::get_lock_owner(MDL_key *key)
 {
-  return mdl_locks.get_lock_owner(key);
+  if (fix_pins())
+    return 0;
+  return mdl_locks.get_lock_owner(m_pins, key);
 }
 
 
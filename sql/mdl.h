@@ -29,6 +29,7 @@
 #include <m_string.h>
 #include <mysql_com.h>
 #include <hash.h>
+#include <lf.h>
 
 #include <algorithm>
 
@@ -416,8 +417,7 @@ class MDL_key
 private:
   MDL_key(const MDL_key &);                     /* not implemented */
   MDL_key &operator=(const MDL_key &);          /* not implemented */
-  friend my_hash_value_type mdl_hash_function(CHARSET_INFO *,
-                                              const uchar *, size_t);
+  friend uint mdl_hash_function(const LF_HASH *, const uchar *, size_t);
 };
 
 
@@ -585,6 +585,13 @@ class MDL_ticket : public MDL_wait_for_subgraph
   */
   MDL_ticket *next_in_lock;
   MDL_ticket **prev_in_lock;
+  /**
+    Pointers for participating in the list of locks which the context
+    has acquired using the fast path.
+    Protected by MDL_context::m_LOCK_fast_path.
+  */
+  MDL_ticket *next_fast_path;
+  MDL_ticket **prev_fast_path;
 public:
 #ifdef WITH_WSREP
   void wsrep_report(bool debug);
@@ -625,7 +632,8 @@ class MDL_ticket : public MDL_wait_for_subgraph
      m_duration(duration_arg),
 #endif
      m_ctx(ctx_arg),
-     m_lock(NULL)
+     m_lock(NULL),
+     m_is_fast_path(false)
   {}
 
   static MDL_ticket *create(MDL_context *ctx_arg, enum_mdl_type type_arg
@@ -654,6 +662,15 @@ class MDL_ticket : public MDL_wait_for_subgraph
   */
   MDL_lock *m_lock;
 
+  /**
+    Indicates that ticket corresponds to lock acquired using "fast path"
+    algorithm. Particularly this means that it was not included into
+    MDL_lock::m_granted bitmap/list and instead is accounted for by
+    MDL_lock::m_fast_path_state counters.
+    Context private.
+  */
+  bool m_is_fast_path;
+
 private:
   MDL_ticket(const MDL_ticket &);               /* not implemented */
   MDL_ticket &operator=(const MDL_ticket &);    /* not implemented */
@@ -813,6 +830,13 @@ class MDL_context
 
   void set_needs_thr_lock_abort(bool needs_thr_lock_abort)
   {
+    /*
+      Locks acquired using the fast path are not visible to other
+      connections, so they can't be asked to abort waits for table-level
+      locks. Make sure all our locks are in MDL_lock::m_granted lists.
+    */
+    if (needs_thr_lock_abort)
+      materialize_fast_path_locks();
     /*
       @note In theory, this member should be modified under protection
             of some lock since it can be accessed from different threads.
@@ -889,6 +913,17 @@ class MDL_context
       involved schemas and global intention exclusive lock.
   */
   Ticket_list m_tickets[MDL_DURATION_END];
+  /**
+    Locks acquired using the fast path. They are not in MDL_lock::m_granted
+    lists, so mdl_iterate() finds them here.
+  */
+  I_P_List<MDL_ticket,
+           I_P_List_adapter<MDL_ticket,
+                            &MDL_ticket::next_fast_path,
+                            &MDL_ticket::prev_fast_path> >
+    m_fast_path_tickets;
+  /** Protects m_fast_path_tickets. */
+  mysql_mutex_t m_LOCK_fast_path;
   MDL_context_owner *m_owner;
   /**
     TRUE -  if for this context we will break protocol and try to
@@ -917,6 +952,8 @@ class MDL_context
     readily available to the wait-for graph iterator.
    */
   MDL_wait_for_subgraph *m_waiting_for;
+  /** Pins for the lock-free hash of all MDL_lock objects. */
+  LF_PINS *m_pins;
 private:
   MDL_ticket *find_ticket(MDL_request *mdl_req,
                           enum_mdl_duration *duration);
@@ -924,10 +961,16 @@ class MDL_context
   void release_lock(enum_mdl_duration duration, MDL_ticket *ticket);
   bool try_acquire_lock_impl(MDL_request *mdl_request,
                              MDL_ticket **out_ticket);
+  bool fix_pins();
+  bool is_fast_path_allowed() const;
+  void materialize_fast_path_lock(MDL_ticket *ticket);
 
 public:
   THD *get_thd() const { return m_owner->get_thd(); }
   void find_deadlock();
+  void materialize_fast_path_locks();
+  int iterate_fast_path_locks(int (*callback)(MDL_ticket *ticket, void *arg),
+                              void *arg);
 
   ulong get_thread_id() const { return thd_get_thread_id(get_thd()); }
 
@@ -936,6 +979,12 @@ class MDL_context
   /** Inform the deadlock detector there is an edge in the wait-for graph. */
   void will_wait_for(MDL_wait_for_subgraph *waiting_for_arg)
   {
+    /*
+      The deadlock detector only sees locks which are present in
+      MDL_lock::m_granted lists, so before starting to wait we have
+      to move locks acquired using the fast path there.
+    */
+    materialize_fast_path_locks();
     mysql_prlock_wrlock(&m_LOCK_waiting_for);
     m_waiting_for=  waiting_for_arg;
     mysql_prlock_unlock(&m_LOCK_waiting_for);
@@ -981,21 +1030,6 @@ extern "C" unsigned long thd_get_thread_id(const MYSQL_THD thd);
 extern "C" int thd_is_connected(MYSQL_THD thd);
 
 
-/*
-  Start-up parameter for the maximum size of the unused MDL_lock objects cache
-  and a constant for its default value.
-*/
-extern ulong mdl_locks_cache_size;
-static const ulong MDL_LOCKS_CACHE_SIZE_DEFAULT = 1024;
-
-/*
-  Start-up parameter for the number of partitions of the hash
-  containing all the MDL_lock objects and a constant for
-  its default value.
-*/
-extern ulong mdl_locks_hash_partitions;
-static const ulong MDL_LOCKS_HASH_PARTITIONS_DEFAULT = 8;
-
 /*
   Metadata locking subsystem tries not to grant more than
   max_write_lock_count high-prio, strong locks successively,
@@ -571,6 +571,7 @@ ulonglong opt_slave_parallel_mode=
   SLAVE_PARALLEL_DOMAIN | SLAVE_PARALLEL_FOLLOW_MASTER_COMMIT;
 ulong opt_binlog_commit_wait_count= 0;
 ulong opt_binlog_commit_wait_usec= 0;
+ulong opt_binlog_writeset_size= 0;
 ulong opt_slave_parallel_max_queued= 131072;
 my_bool opt_gtid_ignore_duplicates= FALSE;
 
@@ -609,6 +610,8 @@ const double log_10[] = {
 };
 
 time_t server_start_time, flush_status_time;
+/* Characteristics of timers, used to convert cycles to time in ANALYZE */
+MY_TIMER_INFO sys_timer_info;
 
 char mysql_home[FN_REFLEN], pidfile_name[FN_REFLEN], system_time_zone[30];
 char *default_tz_name;
@@ -1426,7 +1429,8 @@ int deny_severity = LOG_WARNING;
 #endif
 #ifdef HAVE_QUERY_CACHE
 ulong query_cache_min_res_unit= QUERY_CACHE_MIN_RESULT_DATA_SIZE;
-Query_cache query_cache;
+ulong query_cache_partitions= 1;
+Partitioned_query_cache query_cache;
 #endif
 #ifdef HAVE_SMEM
 char *shared_memory_base_name= default_shared_memory_base_name;
@@ -4018,6 +4022,7 @@ static int init_common_variables()
 
   init_libstrings();
   tzset();			// Set tzname
+  my_timer_init(&sys_timer_info);
 
   sf_leaking_memory= 0; // no memory leaks from now on
 #ifdef SAFEMALLOC
@@ -4791,12 +4796,14 @@ static int init_server_components()
     all things are initialized so that unireg_abort() doesn't fail
   */
   mdl_init();
-  tdc_init();
+  if (tdc_init())
+    unireg_abort(1);
   if (hostname_cache_init())
     unireg_abort(1);
 
+  if (query_cache_init())
+    unireg_abort(1);
   query_cache_set_min_res_unit(query_cache_min_res_unit);
-  query_cache_init();
   query_cache_resize(query_cache_size);
   query_cache_result_size_limit(query_cache_limit);
   my_rnd_init(&sql_rand,(ulong) server_start_time,(ulong) server_start_time/2);
@@ -7340,8 +7347,10 @@ struct my_option my_long_options[]=
    "replication domains in parallel; \"follow_master_commit\", to apply "
    "in parallel transactions that group-committed together on the master; "
    "\"transactional\", to optimistically try to apply all transactional "
-   "DML in parallel; and \"waiting\" to extend \"transactional\" to "
-   "even transactions that had to wait on the master.",
+   "DML in parallel; \"waiting\" to extend \"transactional\" to "
+   "even transactions that had to wait on the master; and \"writeset\", "
+   "to apply in parallel transactions whose writesets (see "
+   "--binlog-writeset-size) show that they changed different rows.",
    &opt_slave_parallel_mode, &opt_slave_parallel_mode,
    &slave_parallel_mode_typelib, GET_SET | GET_ASK_ADDR, REQUIRED_ARG,
    SLAVE_PARALLEL_DOMAIN | SLAVE_PARALLEL_FOLLOW_MASTER_COMMIT, 0, 0, 0, 0, 0},
@@ -8082,8 +8091,157 @@ int show_threadpool_idle_threads(THD *thd, SHOW_VAR *var, char *buff)
   *(int *)buff= tp_get_idle_thread_count(); 
   return 0;
 }
+
+
+/**
+  Show queue statistics for each thread group, as
+  Threadpool_groups_<N>_queue_length and similar.
+*/
+static int show_threadpool_groups(THD *thd, SHOW_VAR *var, char *buff)
+{
+  struct st_group_data {
+    TP_GROUP_STATISTICS stats;
+    char name[12];
+    SHOW_VAR var[5];
+  } *data;
+  uint count= tp_get_thread_group_count();
+  SHOW_VAR *groups= (SHOW_VAR *) thd->alloc(sizeof(SHOW_VAR) * (count + 1));
+  data= (st_group_data *) thd->alloc(sizeof(st_group_data) * (count + 1));
+  if (!groups || !data)
+    return 1;
+
+  var->type= SHOW_ARRAY;
+  var->value= (char*) groups;
+
+  for (uint i= 0; i < count; i++, data++)
+  {
+    SHOW_VAR *v= data->var;
+    tp_get_thread_group_stats(i, &data->stats);
+    my_snprintf(data->name, sizeof(data->name), "%u", i);
+
+#define set_one_group_var(X,Y,Z)        \
+  v->name= X;                           \
+  v->type= Z;                           \
+  v->value= (char*)&data->stats.Y;      \
+  v++;
+
+    set_one_group_var("high_prio_dequeues", high_prio_dequeues, SHOW_ULONGLONG);
+    set_one_group_var("high_prio_queue_length", high_prio_queue_length, SHOW_UINT);
+    set_one_group_var("queue_dequeues", dequeues, SHOW_ULONGLONG);
+    set_one_group_var("queue_length", queue_length, SHOW_UINT);
+    v->name= 0;
+
+#undef set_one_group_var
+
+    groups[i].name= data->name;
+    groups[i].type= SHOW_ARRAY;
+    groups[i].value= (char*) data->var;
+  }
+  groups[count].name= 0;
+  return 0;
+}
 #endif
 
+#ifdef HAVE_QUERY_CACHE
+struct st_query_cache_data
+{
+  ulong free_memory_blocks, free_memory, hits, inserts, lowmem_prunes,
+    refused, queries_in_cache, total_blocks;
+  char name[12];
+  SHOW_VAR var[10];
+};
+
+static void set_query_cache_vars(st_query_cache_data *data,
+                                 SHOW_VAR *partitions)
+{
+  SHOW_VAR *v= data->var;
+
+#define set_one_qcache_var(X,Y)         \
+  v->name= X;                           \
+  v->type= SHOW_LONG;                   \
+  v->value= (char*)&data->Y;            \
+  v++;
+
+  set_one_qcache_var("free_blocks", free_memory_blocks);
+  set_one_qcache_var("free_memory", free_memory);
+  set_one_qcache_var("hits", hits);
+  set_one_qcache_var("inserts", inserts);
+  set_one_qcache_var("lowmem_prunes", lowmem_prunes);
+  set_one_qcache_var("not_cached", refused);
+  if (partitions)
+  {
+    v->name= "partitions";
+    v->type= SHOW_ARRAY;
+    v->value= (char*) partitions;
+    v++;
+  }
+  set_one_qcache_var("queries_in_cache", queries_in_cache);
+  set_one_qcache_var("total_blocks", total_blocks);
+  v->name= 0;
+
+#undef set_one_qcache_var
+}
+
+
+/**
+  Show query cache statistics summed over all partitions, as Qcache_hits
+  and similar. With more than one partition, the statistics of each of
+  them are also shown, as Qcache_partitions_<N>_hits and similar.
+*/
+static int show_query_cache(THD *thd, SHOW_VAR *var, char *buff)
+{
+  uint count= query_cache.get_partition_count();
+  st_query_cache_data *data, *total;
+  SHOW_VAR *partitions= NULL;
+
+  if (!(data= (st_query_cache_data *)
+        thd->calloc(sizeof(st_query_cache_data) * (count + 1))))
+    return 1;
+  total= data + count;
+  if (count > 1 &&
+      !(partitions= (SHOW_VAR *) thd->alloc(sizeof(SHOW_VAR) * (count + 1))))
+    return 1;
+
+  for (uint i= 0; i < count; i++)
+  {
+    Query_cache *partition= query_cache.get_partition(i);
+    data[i].free_memory_blocks= partition->free_memory_blocks;
+    data[i].free_memory= partition->free_memory;
+    data[i].hits= partition->hits;
+    data[i].inserts= partition->inserts;
+    data[i].lowmem_prunes= partition->lowmem_prunes;
+    data[i].refused= partition->refused;
+    data[i].queries_in_cache= partition->queries_in_cache;
+    data[i].total_blocks= partition->total_blocks;
+
+    total->free_memory_blocks+= data[i].free_memory_blocks;
+    total->free_memory+= data[i].free_memory;
+    total->hits+= data[i].hits;
+    total->inserts+= data[i].inserts;
+    total->lowmem_prunes+= data[i].lowmem_prunes;
+    total->refused+= data[i].refused;
+    total->queries_in_cache+= data[i].queries_in_cache;
+    total->total_blocks+= data[i].total_blocks;
+
+    if (partitions)
+    {
+      set_query_cache_vars(data + i, NULL);
+      my_snprintf(data[i].name, sizeof(data[i].name), "%u", i);
+      partitions[i].name= data[i].name;
+      partitions[i].type= SHOW_ARRAY;
+      partitions[i].value= (char*) data[i].var;
+    }
+  }
+  if (partitions)
+    partitions[count].name= 0;
+
+  set_query_cache_vars(total, partitions);
+  var->type= SHOW_ARRAY;
+  var->value= (char*) total->var;
+  return 0;
+}
+#endif /*HAVE_QUERY_CACHE*/
+
 /*
   Variables shown by SHOW STATUS in alphabetical order
 */
@@ -8177,14 +8335,7 @@ SHOW_VAR status_vars[]= {
   {"Rows_read",                (char*) offsetof(STATUS_VAR, rows_read), SHOW_LONGLONG_STATUS},
   {"Rows_tmp_read",            (char*) offsetof(STATUS_VAR, rows_tmp_read), SHOW_LONGLONG_STATUS},
 #ifdef HAVE_QUERY_CACHE
-  {"Qcache_free_blocks",       (char*) &query_cache.free_memory_blocks, SHOW_LONG_NOFLUSH},
-  {"Qcache_free_memory",       (char*) &query_cache.free_memory, SHOW_LONG_NOFLUSH},
-  {"Qcache_hits",              (char*) &query_cache.hits,       SHOW_LONG},
-  {"Qcache_inserts",           (char*) &query_cache.inserts,    SHOW_LONG},
-  {"Qcache_lowmem_prunes",     (char*) &query_cache.lowmem_prunes, SHOW_LONG},
-  {"Qcache_not_cached",        (char*) &query_cache.refused,    SHOW_LONG},
-  {"Qcache_queries_in_cache",  (char*) &query_cache.queries_in_cache, SHOW_LONG_NOFLUSH},
-  {"Qcache_total_blocks",      (char*) &query_cache.total_blocks, SHOW_LONG_NOFLUSH},
+  {"Qcache",                   (char*) &show_query_cache,       SHOW_FUNC},
 #endif /*HAVE_QUERY_CACHE*/
   {"Queries",                  (char*) &show_queries,            SHOW_SIMPLE_FUNC},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions), SHOW_LONG_STATUS},
@@ -8254,6 +8405,7 @@ SHOW_VAR status_vars[]= {
   {"Tc_log_page_waits",        (char*) &tc_log_page_waits,      SHOW_LONG},
 #endif
 #ifdef HAVE_POOL_OF_THREADS
+  {"Threadpool_groups",        (char *) &show_threadpool_groups, SHOW_FUNC},
   {"Threadpool_idle_threads",  (char *) &show_threadpool_idle_threads, SHOW_SIMPLE_FUNC},
   {"Threadpool_threads",       (char *) &tp_stats.num_worker_threads, SHOW_INT},
 #endif
@@ -9666,6 +9818,9 @@ void refresh_status(THD *thd)
 
   /* Reset the counters of all key caches (default and named). */
   process_key_caches(reset_key_cache_counters, 0);
+#ifdef HAVE_QUERY_CACHE
+  query_cache.reset_status();
+#endif
   flush_status_time= time((time_t*) 0);
   mysql_mutex_unlock(&LOCK_status);
 
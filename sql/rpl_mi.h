@@ -26,6 +26,7 @@
 #define SLAVE_PARALLEL_FOLLOW_MASTER_COMMIT (1ULL << 1)
 #define SLAVE_PARALLEL_TRX                  (1ULL << 2)
 #define SLAVE_PARALLEL_WAITING              (1ULL << 3)
+#define SLAVE_PARALLEL_WRITESET             (1ULL << 4)
 
 
 #ifdef HAVE_REPLICATION
@@ -315,7 +316,7 @@ class Master_info : public Slave_reporting_capability
   /*
     The parallel replication modes, if any. A combination (binary OR) of any
     of SLAVE_PARALLEL_DOMAIN, SLAVE_PARALLEL_FOLLOW_MASTER_COMMIT,
-    SLAVE_PARALLEL_TRX, and SLAVE_PARALLEL_WAITING.
+    SLAVE_PARALLEL_TRX, SLAVE_PARALLEL_WAITING, and SLAVE_PARALLEL_WRITESET.
   */
   ulonglong parallel_mode;
 };
@@ -34,6 +34,13 @@ rpt_handle_event(rpl_parallel_thread::queued_event *qev,
 
   DBUG_ASSERT(qev->typ == rpl_parallel_thread::queued_event::QUEUED_EVENT);
   ev= qev->ev;
+  /* Row events are left for the worker thread to decode. */
+  if (ev->is_undecoded())
+  {
+    if (!(ev= decode_event(qev->ev)))
+      return 1;
+    qev->ev= ev;
+  }
 
   thd->system_thread_info.rpl_sql_info->rpl_filter = rli->mi->rpl_filter;
   ev->thd= thd;
@@ -1592,12 +1599,133 @@ rpl_parallel_entry::choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
   return thr;
 }
 
+/*
+  Start a new, empty batch. A batch that grew large is shrunk again so that
+  a single huge transaction does not keep its memory around.
+*/
+void
+rpl_writeset_batch::reset()
+{
+  if (size > 256)
+  {
+    my_free(hashes);
+    hashes= NULL;
+    size= 0;
+  }
+  else if (hashes)
+    bzero(hashes, size * sizeof(*hashes));
+  count= 0;
+  valid= true;
+}
+
+
+bool
+rpl_writeset_batch::grow(uint32 new_size)
+{
+  uint32 *old_hashes= hashes;
+  uint32 old_size= size;
+
+  if (!(hashes= (uint32 *) my_malloc(new_size * sizeof(*hashes),
+                                     MYF(MY_ZEROFILL))))
+  {
+    hashes= old_hashes;
+    return true;
+  }
+  size= new_size;
+  count= 0;
+  for (uint32 i= 0; i < old_size; i++)
+  {
+    if (old_hashes[i])
+    {
+      uint32 j= old_hashes[i] & (size - 1);
+      while (hashes[j])
+        j= (j + 1) & (size - 1);
+      hashes[j]= old_hashes[i];
+      ++count;
+    }
+  }
+  my_free(old_hashes);
+  return false;
+}
+
+
+/*
+  Check if the event group of gtid_ev can run in parallel with all event
+  groups of the batch, ie. if both have writesets and none of the rows it
+  changed were changed by the batch.
+*/
+bool
+rpl_writeset_batch::can_join(Gtid_log_event *gtid_ev)
+{
+  if (!valid || !gtid_ev->writeset_count ||
+      count + gtid_ev->writeset_count > MAX_HASHES)
+    return false;
+  if (!count)
+    return true;
+  for (uint32 i= 0; i < gtid_ev->writeset_count; i++)
+  {
+    uint32 hash= gtid_ev->writeset[i];
+    uint32 j= hash & (size - 1);
+    while (hashes[j])
+    {
+      if (hashes[j] == hash)
+        return false;
+      j= (j + 1) & (size - 1);
+    }
+  }
+  return true;
+}
+
+
+/*
+  Add the writeset of the event group of gtid_ev to the batch. An event
+  group without a writeset may change any row, so the batch is then marked
+  invalid until the next reset().
+*/
+void
+rpl_writeset_batch::add(Gtid_log_event *gtid_ev)
+{
+  if (!valid)
+    return;
+  if (!gtid_ev->writeset_count)
+  {
+    valid= false;
+    return;
+  }
+  /* Keep the hash at most half full. */
+  if ((count + gtid_ev->writeset_count) * 2 > size)
+  {
+    uint32 new_size= size ? size : 64;
+    while ((count + gtid_ev->writeset_count) * 2 > new_size)
+      new_size*= 2;
+    if (grow(new_size))
+    {
+      valid= false;
+      return;
+    }
+  }
+  for (uint32 i= 0; i < gtid_ev->writeset_count; i++)
+  {
+    uint32 hash= gtid_ev->writeset[i];
+    uint32 j= hash & (size - 1);
+    while (hashes[j] && hashes[j] != hash)
+      j= (j + 1) & (size - 1);
+    if (!hashes[j])
+    {
+      hashes[j]= hash;
+      ++count;
+    }
+  }
+}
+
+
 static void
 free_rpl_parallel_entry(void *element)
 {
   rpl_parallel_entry *e= (rpl_parallel_entry *)element;
   if (e->current_gco)
     dealloc_gco(e->current_gco);
+  e->writeset_batch.free();
   mysql_cond_destroy(&e->COND_parallel_entry);
   mysql_mutex_destroy(&e->LOCK_parallel_entry);
   my_free(e);
@@ -2088,6 +2216,19 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
         */
         new_gco= false;
       }
+      else if ((mode & SLAVE_PARALLEL_WRITESET) &&
+               !(flags & group_commit_orderer::FORCE_SWITCH) &&
+               (gtid_flags & Gtid_log_event::FL_TRANSACTIONAL) &&
+               e->writeset_batch.can_join(gtid_ev))
+      {
+        /*
+          The writesets show that this event group changed none of the rows
+          changed by the event groups of the current batch, so it can run in
+          parallel with them even though they did not group-commit together
+          on the master. No speculation is needed, the rows do not conflict.
+        */
+        new_gco= false;
+      }
       else if ((mode & SLAVE_PARALLEL_TRX) &&
                !(flags & group_commit_orderer::FORCE_SWITCH))
       {
@@ -2156,8 +2297,11 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
       }
       gco->flags|= force_switch_flag;
       e->current_gco= gco;
+      e->writeset_batch.reset();
     }
     rgi->gco= gco;
+    if (mode & SLAVE_PARALLEL_WRITESET)
+      e->writeset_batch.add(gtid_ev);
 
     qev->rgi= e->current_group_info= rgi;
     e->current_sub_id= rgi->gtid_sub_id;
@@ -75,6 +75,34 @@ struct group_commit_orderer {
 };
 
 
+/*
+  The union of the writesets (see Gtid_log_event::FL_WRITESET) of the event
+  groups queued in the current group_commit_orderer.
+
+  With --slave-parallel-mode=writeset, an event group whose writeset has no
+  hash in common with the batch changed none of the same rows, so it can
+  join the batch even if it did not group-commit with it on the master.
+*/
+struct rpl_writeset_batch {
+  /* Open addressing hash of the key hashes; zero marks a free slot. */
+  uint32 *hashes;
+  uint32 size;
+  uint32 count;
+  /* False once an event group without a writeset joined the batch. */
+  bool valid;
+
+  /* Max number of hashes in a batch, after which a new batch is started. */
+  static const uint32 MAX_HASHES= 16384;
+
+  void reset();
+  bool can_join(Gtid_log_event *gtid_ev);
+  void add(Gtid_log_event *gtid_ev);
+  void free() { my_free(hashes); }
+private:
+  bool grow(uint32 new_size);
+};
+
+
 struct rpl_parallel_thread {
   bool delay_start;
   bool running;
@@ -296,6 +324,8 @@ struct rpl_parallel_entry {
   uint64 count_committing_event_groups;
   /* The group_commit_orderer object for the events currently being queued. */
   group_commit_orderer *current_gco;
+  /* Writesets of the event groups in current_gco. */
+  rpl_writeset_batch writeset_batch;
 
   rpl_parallel_thread * choose_thread(rpl_group_info *rgi, bool *did_enter_cond,
                                       PSI_stage_info *old_stage, bool reuse);
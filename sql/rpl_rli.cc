@@ -108,8 +108,7 @@ Relay_log_info::~Relay_log_info()
   {
     DBUG_ASSERT(cur->queued_count == cur->dequeued_count);
     inuse_relaylog *next= cur->next;
-    my_atomic_rwlock_destroy(&cur->inuse_relaylog_atomic_lock);
-    my_free(cur);
+    free_inuse_relaylog(cur);
     cur= next;
   }
   mysql_mutex_destroy(&run_lock);
@@ -1402,11 +1401,42 @@ Relay_log_info::alloc_inuse_relaylog(const char *name)
   }
   last_inuse_relaylog= ir;
   my_atomic_rwlock_init(&ir->inuse_relaylog_atomic_lock);
+  my_init_dynamic_array(&ir->retired_fdevs,
+                        sizeof(Format_description_log_event *), 0, 2, MYF(0));
 
   return 0;
 }
 
 
+void
+Relay_log_info::free_inuse_relaylog(inuse_relaylog *ir)
+{
+  for (uint i= 0; i < ir->retired_fdevs.elements; i++)
+    delete *dynamic_element(&ir->retired_fdevs, i,
+                            Format_description_log_event **);
+  delete_dynamic(&ir->retired_fdevs);
+  my_atomic_rwlock_destroy(&ir->inuse_relaylog_atomic_lock);
+  my_free(ir);
+}
+
+
+/*
+  Dispose of a Format_description_log_event that was replaced in
+  relay_log.description_event_for_exec.
+
+  Events queued for worker threads may not have been decoded yet, so the
+  event is kept until all relay logs read so far are done with.
+*/
+void
+Relay_log_info::retire_fdev(Format_description_log_event *fdev)
+{
+  if (fdev && last_inuse_relaylog &&
+      !insert_dynamic(&last_inuse_relaylog->retired_fdevs, &fdev))
+    return;
+  delete fdev;
+}
+
+
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
 int
 rpl_load_gtid_slave_state(THD *thd)
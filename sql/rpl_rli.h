@@ -408,6 +408,8 @@ class Relay_log_info : public Slave_reporting_capability
                  time_t event_creation_time, THD *thd,
                  rpl_group_info *rgi);
   int alloc_inuse_relaylog(const char *name);
+  void free_inuse_relaylog(inuse_relaylog *ir);
+  void retire_fdev(Format_description_log_event *fdev);
 
   /**
      Is the replication inside a group?
@@ -504,6 +506,12 @@ struct inuse_relaylog {
   /* Set when all events have been read from a relaylog. */
   bool completed;
   char name[FN_REFLEN];
+  /*
+    Format_description_log_event objects replaced while this relay log was
+    being read. Worker threads may still use them to decode queued events
+    (see Undecoded_log_event), so they are freed together with this object.
+  */
+  DYNAMIC_ARRAY retired_fdevs;
   /* Lock used to protect inuse_relaylog::dequeued_count */
   my_atomic_rwlock_t inuse_relaylog_atomic_lock;
 };
@@ -2585,7 +2585,8 @@ static bool send_show_master_info_header(THD *thd, bool full,
   field_list.push_back(new Item_empty_string("Replicate_Ignore_Domain_Ids",
                                              FN_REFLEN));
   field_list.push_back(new Item_empty_string("Parallel_Mode",
-             sizeof("domain,follow_master_commit,transactional,waiting")-1));
+             sizeof("domain,follow_master_commit,transactional,waiting,"
+                    "writeset")-1));
   if (full)
   {
     field_list.push_back(new Item_return_int("Retried_transactions",
@@ -2790,7 +2791,8 @@ static bool send_show_master_info_data(THD *thd, Master_info *mi, bool full,
     {
       /* Note how sizeof("domain") has room for "domain," due to traling 0. */
       char buf[sizeof("domain") + sizeof("follow_master_commit") +
-               sizeof("transactional") + sizeof("waiting") + 1];
+               sizeof("transactional") + sizeof("waiting") +
+               sizeof("writeset") + 1];
       char *p= buf;
       uint32 mode= mi->parallel_mode;
       if (mode & SLAVE_PARALLEL_DOMAIN)
@@ -2801,6 +2803,8 @@ static bool send_show_master_info_data(THD *thd, Master_info *mi, bool full,
         p= strmov(p, "transactional,");
       if (mode & SLAVE_PARALLEL_WAITING)
         p= strmov(p, "waiting,");
+      if (mode & SLAVE_PARALLEL_WRITESET)
+        p= strmov(p, "writeset,");
       if (p != buf)
         --p;                                    // Discard last ','
       protocol->store(buf, p-buf, &my_charset_bin);
@@ -3415,6 +3419,32 @@ inline void update_state_of_relay_log(Relay_log_info *rli, Log_event *ev)
 }
 
 
+/**
+  Decode an Undecoded_log_event read by the parallel replication driver.
+
+  @return The decoded event, in which case ev is deleted, or NULL with
+          an error set in the current thread.
+*/
+Log_event *decode_event(Log_event *ev)
+{
+  Undecoded_log_event *uev= static_cast<Undecoded_log_event *>(ev);
+  const char *errmsg= NULL;
+  Log_event *decoded_ev;
+  DBUG_ENTER("decode_event");
+
+  DBUG_ASSERT(ev->is_undecoded());
+  if (!(decoded_ev= uev->decode(&errmsg)))
+  {
+    sql_print_error("Error in Log_event::read_log_event(): '%s', "
+                    "event_type: %d", errmsg, (int) uev->get_type_code());
+    my_error(ER_SLAVE_RELAY_LOG_READ_FAILURE, MYF(0), errmsg);
+    DBUG_RETURN(NULL);
+  }
+  delete ev;
+  DBUG_RETURN(decoded_ev);
+}
+
+
 /**
   Top-level function for executing the next event from the relay log.
 
@@ -3524,6 +3554,17 @@ static int exec_relay_log_event(THD* thd, Relay_log_info* rli,
         This is the case for pre-10.0 events without GTID, and for handling
         slave_skip_counter.
       */
+      if (ev->is_undecoded())
+      {
+        Log_event *decoded_ev= decode_event(ev);
+        if (!decoded_ev)
+        {
+          mysql_mutex_unlock(&rli->data_lock);
+          delete ev;
+          DBUG_RETURN(1);
+        }
+        ev= decoded_ev;
+      }
     }
 
     if (typ == GTID_EVENT)
@@ -6421,9 +6462,14 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
       MYSQL_BIN_LOG::open() will write the buffered description event.
     */
     old_pos= rli->event_relay_log_pos;
+    /*
+      With parallel replication, row events are only framed here; the
+      worker threads verify their checksum and decode them.
+    */
     if ((ev= Log_event::read_log_event(cur_log,0,
                                        rli->relay_log.description_event_for_exec,
-                                       opt_slave_sql_verify_checksum)))
+                                       opt_slave_sql_verify_checksum,
+                                       rli->mi->using_parallel())))
 
     {
       /*
@@ -0,0 +1,98 @@
+/*
+   Copyright (c) 2015 MariaDB Foundation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Trackers for collecting execution statistics for ANALYZE statements.
+
+  Trackers are members of EXPLAIN data structures (see sql_explain.h).
+  Execution code only gets pointers to them when running ANALYZE, so
+  regular statements pay no more than a NULL pointer check.
+*/
+
+#ifndef SQL_ANALYZE_STMT_INCLUDED
+#define SQL_ANALYZE_STMT_INCLUDED
+
+/*
+  A class for tracking time it takes to do a certain action, and how many
+  times it was done.
+
+  Time is counted in CPU cycles (my_timer_cycles() is rdtsc on x86), which
+  is cheap enough to be measured around every row read.
+*/
+
+class Exec_time_tracker
+{
+  ulonglong count;
+  ulonglong cycles;
+  ulonglong last_start;
+public:
+  Exec_time_tracker() : count(0), cycles(0) {}
+
+  void start_tracking()
+  {
+    last_start= my_timer_cycles();
+  }
+
+  void stop_tracking()
+  {
+    count++;
+    cycles += my_timer_cycles() - last_start;
+  }
+
+  ulonglong get_loops() const { return count; }
+  bool has_timed_statistics() const { return count != 0; }
+
+  /* Total time, in milliseconds */
+  double get_time_ms() const
+  {
+    if (!sys_timer_info.cycles.frequency)
+      return 0.0;
+    return 1000.0 * ulonglong2double(cycles) /
+           ulonglong2double(sys_timer_info.cycles.frequency);
+  }
+};
+
+
+/*
+  Statistics of filesort runs: how many times the sort was done, how long
+  it took, how many merge passes were needed and how many rows it returned.
+*/
+
+class Filesort_tracker
+{
+public:
+  Filesort_tracker() : r_output_rows(0), r_sort_passes(0) {}
+
+  Exec_time_tracker time_tracker;
+  ha_rows r_output_rows;
+  ulonglong r_sort_passes;
+
+  bool has_scans() const { return time_tracker.has_timed_statistics(); }
+  ha_rows get_avg_rows() const
+  {
+    ulonglong loops= time_tracker.get_loops();
+    return loops ? (ha_rows) rint((double) r_output_rows / loops) : 0;
+  }
+};
+
+
+#define ANALYZE_START_TRACKING(tracker) \
+  { if (unlikely(tracker)) { (tracker)->start_tracking(); } }
+
+#define ANALYZE_STOP_TRACKING(tracker) \
+  { if (unlikely(tracker)) { (tracker)->stop_tracking(); } }
+
+#endif /* SQL_ANALYZE_STMT_INCLUDED */
@@ -1113,8 +1113,8 @@ Query_cache::insert(Query_cache_tls *query_cache_tls,
     header->result(result);
     DBUG_PRINT("qcache", ("free query 0x%lx", (ulong) query_block));
     // The following call will remove the lock on query_block
-    query_cache.free_query(query_block);
-    query_cache.refused++;
+    free_query(query_block);
+    refused++;
     // append_result_data no success => we need unlock
     unlock();
     DBUG_VOID_RETURN;
@@ -1181,7 +1181,7 @@ void Query_cache::end_of_result(THD *thd)
 
   if (thd->killed)
   {
-    query_cache_abort(&thd->query_cache_tls);
+    abort(query_cache_tls);
     DBUG_VOID_RETURN;
   }
 
@@ -1225,9 +1225,9 @@ void Query_cache::end_of_result(THD *thd)
     }
     last_result_block= header->result()->prev;
     allign_size= ALIGN_SIZE(last_result_block->used);
-    len= MY_MAX(query_cache.min_allocation_unit, allign_size);
-    if (last_result_block->length >= query_cache.min_allocation_unit + len)
-      query_cache.split_block(last_result_block,len);
+    len= MY_MAX(min_allocation_unit, allign_size);
+    if (last_result_block->length >= min_allocation_unit + len)
+      split_block(last_result_block,len);
 
     header->found_rows(limit_found_rows);
     header->result()->type= Query_cache_block::RESULT;
@@ -1246,7 +1246,6 @@ void Query_cache::end_of_result(THD *thd)
 void query_cache_invalidate_by_MyISAM_filename(const char *filename)
 {
   query_cache.invalidate_by_MyISAM_filename(filename);
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(0););
 }
 
 
@@ -2405,7 +2404,7 @@ void Query_cache::flush()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   unlock();
   DBUG_VOID_RETURN;
 }
@@ -4173,7 +4172,7 @@ void Query_cache::pack_cache()
 {
   DBUG_ENTER("Query_cache::pack_cache");
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
 
   uchar *border = 0;
   Query_cache_block *before = 0;
@@ -4205,7 +4204,7 @@ void Query_cache::pack_cache()
     DUMP(this);
   }
 
-  DBUG_EXECUTE("check_querycache",query_cache.check_integrity(1););
+  DBUG_EXECUTE("check_querycache",check_integrity(1););
   DBUG_VOID_RETURN;
 }
 
@@ -4568,6 +4567,243 @@ uint Query_cache::filename_2_table_key (char *key, const char *path,
                               filename, NAME_LEN) - key) + 1);
 }
 
+/*****************************************************************************
+  Partitioned_query_cache methods
+*****************************************************************************/
+
+/**
+  Return the partition that a query with the given text is stored in.
+*/
+
+Query_cache *Partitioned_query_cache::partition_for(const char *query,
+                                                    size_t length)
+{
+  ulong nr1= 1, nr2= 4;
+  if (partition_count == 1)
+    return partitions;
+  my_charset_bin.coll->hash_sort(&my_charset_bin, (const uchar*) query,
+                                 length, &nr1, &nr2);
+  return &partitions[nr1 % partition_count];
+}
+
+
+/**
+  Create and initialize query_cache_partitions partitions.
+
+  @retval TRUE  Out of memory
+*/
+
+bool Partitioned_query_cache::init()
+{
+  DBUG_ENTER("Partitioned_query_cache::init");
+  partition_count= (uint) query_cache_partitions;
+  if (!(partitions= new Query_cache[partition_count]))
+    DBUG_RETURN(TRUE);
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].init();
+  DBUG_RETURN(FALSE);
+}
+
+
+/**
+  Split the given size equally between the partitions.
+
+  @return The sum of the sizes the partitions got
+*/
+
+ulong Partitioned_query_cache::resize(ulong query_cache_size_arg)
+{
+  ulong partition_size= query_cache_size_arg / partition_count;
+  ulong new_query_cache_size= 0;
+  for (uint i= 0; i < partition_count; i++)
+    new_query_cache_size+= partitions[i].resize(partition_size);
+  query_cache_size= new_query_cache_size;
+  return new_query_cache_size;
+}
+
+
+void Partitioned_query_cache::result_size_limit(ulong limit)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].result_size_limit(limit);
+}
+
+
+ulong Partitioned_query_cache::set_min_res_unit(ulong size)
+{
+  for (uint i= 0; i < partition_count; i++)
+    size= partitions[i].set_min_res_unit(size);
+  return size;
+}
+
+
+/**
+  Store the query in the partition send_result_to_client() looked it up
+  in, which is derived from the same query text. The partition is
+  remembered for writing the result only if the query was stored.
+*/
+
+void Partitioned_query_cache::store_query(THD *thd, TABLE_LIST *tables_used)
+{
+  Query_cache *partition= partition_for(thd->query(), thd->query_length());
+  partition->store_query(thd, tables_used);
+  if (thd->query_cache_tls.first_query_block != NULL)
+    thd->query_cache_tls.partition= partition;
+}
+
+
+int Partitioned_query_cache::send_result_to_client(THD *thd, char *query,
+                                                   uint query_length)
+{
+  return partition_for(query, query_length)->
+    send_result_to_client(thd, query, query_length);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, TABLE_LIST *tables_used,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate(thd, tables_used, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd,
+                                         CHANGED_TABLE_LIST *tables_used)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate(thd, tables_used);
+}
+
+
+void Partitioned_query_cache::invalidate_locked_for_write(THD *thd,
+                                                          TABLE_LIST *tables_used)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate_locked_for_write(thd, tables_used);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, TABLE *table,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate(thd, table, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, const char *key,
+                                         uint32 key_length,
+                                         my_bool using_transactions)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate(thd, key, key_length, using_transactions);
+}
+
+
+void Partitioned_query_cache::invalidate(THD *thd, char *db)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].invalidate(thd, db);
+}
+
+
+void Partitioned_query_cache::invalidate_by_MyISAM_filename(const char *filename)
+{
+  for (uint i= 0; i < partition_count; i++)
+  {
+    partitions[i].invalidate_by_MyISAM_filename(filename);
+    DBUG_EXECUTE("check_querycache", partitions[i].check_integrity(0););
+  }
+}
+
+
+void Partitioned_query_cache::flush()
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].flush();
+}
+
+
+void Partitioned_query_cache::pack(THD *thd)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].pack(thd);
+}
+
+
+void Partitioned_query_cache::destroy()
+{
+  if (!partitions)
+    return;
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].destroy();
+  delete [] partitions;
+  partitions= NULL;
+  partition_count= 0;
+}
+
+
+/*
+  The following functions continue the result of the current query, which
+  is written to the partition recorded in Query_cache_tls. See the comment
+  on double-check locking usage above.
+*/
+
+void Partitioned_query_cache::insert(Query_cache_tls *query_cache_tls,
+                                     const char *packet, ulong length,
+                                     unsigned pkt_nr)
+{
+  if (query_cache_tls->first_query_block != NULL)
+    query_cache_tls->partition->insert(query_cache_tls, packet, length,
+                                       pkt_nr);
+}
+
+
+void Partitioned_query_cache::end_of_result(THD *thd)
+{
+  if (thd->query_cache_tls.first_query_block != NULL)
+  {
+    thd->query_cache_tls.partition->end_of_result(thd);
+    if (thd->query_cache_tls.first_query_block == NULL)
+      thd->query_cache_tls.partition= NULL;
+  }
+}
+
+
+void Partitioned_query_cache::abort(Query_cache_tls *query_cache_tls)
+{
+  if (query_cache_tls->first_query_block != NULL)
+  {
+    query_cache_tls->partition->abort(query_cache_tls);
+    if (query_cache_tls->first_query_block == NULL)
+      query_cache_tls->partition= NULL;
+  }
+}
+
+
+void Partitioned_query_cache::disable_query_cache(THD *thd)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].disable_query_cache(thd);
+}
+
+
+/**
+  Reset the counters that FLUSH STATUS resets.
+*/
+
+void Partitioned_query_cache::reset_status()
+{
+  for (uint i= 0; i < partition_count; i++)
+  {
+    Query_cache *partition= &partitions[i];
+    partition->hits= partition->inserts= partition->refused=
+      partition->lowmem_prunes= 0;
+  }
+}
+
+
 /****************************************************************************
   Functions to be used when debugging
 ****************************************************************************/
@@ -4616,6 +4852,13 @@ void Query_cache::wreck(uint line, const char *message)
 }
 
 
+void Partitioned_query_cache::wreck(uint line, const char *message)
+{
+  for (uint i= 0; i < partition_count; i++)
+    partitions[i].wreck(line, message);
+}
+
+
 void Query_cache::bins_dump()
 {
   uint i;
@@ -66,6 +66,9 @@ typedef struct st_changed_table_list CHANGED_TABLE_LIST;
 #define QUERY_CACHE_PACK_ITERATION		2
 #define QUERY_CACHE_PACK_LIMIT			(512*1024L)
 
+/* maximal number of query cache partitions (query_cache_partitions) */
+#define QUERY_CACHE_MAX_PARTITIONS		64
+
 #define TABLE_COUNTER_TYPE uint
 
 struct Query_cache_block;
@@ -533,6 +536,78 @@ class Query_cache
   void disable_query_cache(THD *thd);
 };
 
+
+/**
+  The query cache, split into query_cache_partitions independent
+  Query_cache objects. Each partition has its own memory, free block
+  bins, query and table hashes and structure_guard_mutex.
+
+  A query is looked up and stored in the partition chosen by the hash of
+  its text, so lookups of different queries rarely wait for each other.
+  Queries using a table may be in any partition, so invalidation is
+  done in each of them; a partition finds the queries to remove through
+  its own table hash. An invalidation thus takes every partition's lock
+  and does one table hash lookup per partition, which is cheap compared
+  to the queries it removes. With one partition this is the old query
+  cache.
+*/
+
+class Partitioned_query_cache
+{
+  Query_cache *partitions;
+  uint partition_count;
+
+  Query_cache *partition_for(const char *query, size_t length);
+
+public:
+  /* Sum of the sizes of the partitions */
+  ulong query_cache_size;
+
+  Partitioned_query_cache()
+    :partitions(NULL), partition_count(0), query_cache_size(0)
+  {}
+
+  uint get_partition_count() const { return partition_count; }
+  Query_cache *get_partition(uint i) { return &partitions[i]; }
+
+  bool is_disabled(void) { return partitions[0].is_disabled(); }
+  bool is_disable_in_progress(void)
+  { return partitions[0].is_disable_in_progress(); }
+
+  bool init();
+  ulong resize(ulong query_cache_size);
+  void result_size_limit(ulong limit);
+  ulong set_min_res_unit(ulong size);
+
+  void store_query(THD *thd, TABLE_LIST *used_tables);
+  int send_result_to_client(THD *thd, char *query, uint query_length);
+
+  void invalidate(THD *thd, TABLE_LIST *tables_used,
+		  my_bool using_transactions);
+  void invalidate(THD *thd, CHANGED_TABLE_LIST *tables_used);
+  void invalidate_locked_for_write(THD *thd, TABLE_LIST *tables_used);
+  void invalidate(THD *thd, TABLE *table, my_bool using_transactions);
+  void invalidate(THD *thd, const char *key, uint32  key_length,
+		  my_bool using_transactions);
+  void invalidate(THD *thd, char *db);
+  void invalidate_by_MyISAM_filename(const char *filename);
+
+  void flush();
+  void pack(THD *thd);
+  void destroy();
+
+  void insert(Query_cache_tls *query_cache_tls,
+              const char *packet,
+              ulong length,
+              unsigned pkt_nr);
+  void end_of_result(THD *thd);
+  void abort(Query_cache_tls *query_cache_tls);
+
+  void wreck(uint line, const char *message);
+  void disable_query_cache(THD *thd);
+  void reset_status();
+};
+
 #ifdef HAVE_QUERY_CACHE
 struct Query_cache_query_flags
 {
@@ -582,7 +657,7 @@ struct Query_cache_query_flags
 #define query_cache_store_query(A, B)     do { } while(0)
 #define query_cache_destroy()             do { } while(0)
 #define query_cache_result_size_limit(A)  do { } while(0)
-#define query_cache_init()                do { } while(0)
+#define query_cache_init()                0
 #define query_cache_resize(A)             do { } while(0)
 #define query_cache_set_min_res_unit(A)   do { } while(0)
 #define query_cache_invalidate3(A, B, C)  do { } while(0)
@@ -596,5 +671,5 @@ struct Query_cache_query_flags
 #define query_cache_is_cacheable_query(L) 0
 #endif /*HAVE_QUERY_CACHE*/
 
-extern Query_cache query_cache;
+extern Partitioned_query_cache query_cache;
 #endif
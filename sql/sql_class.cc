@@ -5964,6 +5964,9 @@ int THD::binlog_write_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  if (opt_binlog_writeset_size)
+    binlog_writeset_add_row(table, is_trans, record);
+
   return ev->add_row_data(row_data, len);
 }
 
@@ -6013,6 +6016,12 @@ int THD::binlog_update_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  if (opt_binlog_writeset_size)
+  {
+    binlog_writeset_add_row(table, is_trans, before_record);
+    binlog_writeset_add_row(table, is_trans, after_record);
+  }
+
   return
     ev->add_row_data(before_row, before_size) ||
     ev->add_row_data(after_row, after_size);
@@ -6049,6 +6058,9 @@ int THD::binlog_delete_row(TABLE* table, bool is_trans,
   if (unlikely(ev == 0))
     return HA_ERR_OUT_OF_MEM;
 
+  if (opt_binlog_writeset_size)
+    binlog_writeset_add_row(table, is_trans, record);
+
   return ev->add_row_data(row_data, len);
 }
 
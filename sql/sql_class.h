@@ -380,6 +380,7 @@ class MY_LOCALE;
 */
 
 struct Query_cache_block;
+class Query_cache;
 
 struct Query_cache_tls
 {
@@ -388,12 +389,17 @@ struct Query_cache_tls
     functions and methods to maintain proper locking.
   */
   Query_cache_block *first_query_block;
+  /*
+    Query cache partition the result in first_query_block is written to,
+    NULL when no result is being written
+  */
+  Query_cache *partition;
   void set_first_query_block(Query_cache_block *first_query_block_arg)
   {
     first_query_block= first_query_block_arg;
   }
 
-  Query_cache_tls() :first_query_block(NULL) {}
+  Query_cache_tls() :first_query_block(NULL), partition(NULL) {}
 };
 
 /* SIGNAL / RESIGNAL / GET DIAGNOSTICS */
@@ -510,6 +516,7 @@ typedef struct system_variables
   
   ulonglong max_heap_table_size;
   ulonglong tmp_table_size;
+  ulonglong group_by_hash_size;
   ulonglong long_query_time;
   ulonglong max_statement_time;
   ulonglong optimizer_switch;
@@ -556,6 +563,7 @@ typedef struct system_variables
   ulong optimizer_search_depth;
   ulong optimizer_selectivity_sampling_limit;
   ulong optimizer_use_condition_selectivity;
+  ulong sort_threads;
   ulong use_stat_tables;
   ulong histogram_size;
   ulong histogram_type;
@@ -650,6 +658,7 @@ typedef struct system_variables
   uint wsrep_sync_wait;
   ulong wsrep_retry_autocommit;
   double long_query_time_double, max_statement_time_double;
+  double analyze_sample_percentage;
 
   my_bool pseudo_slave_mode;
 
@@ -2074,6 +2083,8 @@ class THD :public Statement,
   int binlog_update_row(TABLE* table, bool is_transactional,
                         MY_BITMAP const* cols, size_t colcnt,
                         const uchar *old_data, const uchar *new_data);
+  void binlog_writeset_add_row(TABLE *table, bool is_transactional,
+                               const uchar *record);
 
   void set_server_id(uint32 sid) { variables.server_id = sid; }
 
@@ -736,6 +736,13 @@ void Explain_select::print_explain_json(Explain_query *query,
     */
     writer->add_member("query_block").start_object();
     writer->add_member("select_id").add_ll(select_id);
+
+    if (is_analyze && time_tracker.has_timed_statistics())
+    {
+      writer->add_member("r_loops").add_ll(time_tracker.get_loops());
+      writer->add_member("r_total_time_ms").
+        add_double(time_tracker.get_time_ms());
+    }
     
     if (exec_const_cond)
     {
@@ -743,6 +750,28 @@ void Explain_select::print_explain_json(Explain_query *query,
       write_item(writer, exec_const_cond);
     }
 
+    if (is_analyze && filesort_tracker.has_scans())
+    {
+      Exec_time_tracker *fs_time= &filesort_tracker.time_tracker;
+      writer->add_member("filesort").start_object();
+      writer->add_member("r_loops").add_ll(fs_time->get_loops());
+      writer->add_member("r_total_time_ms").add_double(fs_time->get_time_ms());
+      writer->add_member("r_output_rows").
+        add_ll(filesort_tracker.get_avg_rows());
+      writer->add_member("r_sort_passes").
+        add_ll(filesort_tracker.r_sort_passes);
+      writer->end_object();
+    }
+
+    if (is_analyze && tmp_table_tracker.has_timed_statistics())
+    {
+      writer->add_member("temporary_table").start_object();
+      writer->add_member("r_loops").add_ll(tmp_table_tracker.get_loops());
+      writer->add_member("r_total_time_ms").
+        add_double(tmp_table_tracker.get_time_ms());
+      writer->end_object();
+    }
+
     Explain_basic_join::print_explain_json_interns(query, writer, is_analyze);
     writer->end_object();
   }
@@ -1295,6 +1324,10 @@ void Explain_table_access::print_explain_json(Explain_query *query,
     else
       writer->add_null();
   }
+
+  /* `r_total_time_ms` */
+  if (is_analyze && op_tracker.has_timed_statistics())
+    writer->add_member("r_total_time_ms").add_double(op_tracker.get_time_ms());
   
   /* `filtered` */
   if (filtered_set)
@@ -1343,6 +1376,8 @@ void Explain_table_access::print_explain_json(Explain_query *query,
         writer->add_double(jbuf_tracker.get_filtered_after_where()*100.0);
       else
         writer->add_null();
+
+      writer->add_member("r_buffer_size").add_ll(bka_type.join_buffer_size);
     }
   }
 
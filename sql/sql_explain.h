@@ -241,6 +241,12 @@ class Explain_select : public Explain_basic_join
   {
     return &using_temporary_read_tracker;
   }
+
+  /* ANALYZE members */
+  Exec_time_tracker time_tracker;
+  Filesort_tracker filesort_tracker;
+  /* Time spent writing the join output into temporary tables */
+  Exec_time_tracker tmp_table_tracker;
 private:
   Table_access_tracker using_temporary_read_tracker;
 };
@@ -463,7 +469,7 @@ enum explain_extra_tag
 class EXPLAIN_BKA_TYPE
 {
 public:
-  EXPLAIN_BKA_TYPE() : join_alg(NULL) {}
+  EXPLAIN_BKA_TYPE() : join_alg(NULL), join_buffer_size(0) {}
 
   bool incremental;
 
@@ -475,6 +481,9 @@ class EXPLAIN_BKA_TYPE
 
   /* Information about MRR usage.  */
   StringBuffer<64> mrr_type;
+
+  /* Size of the join buffer, in bytes */
+  ulonglong join_buffer_size;
   
   bool is_using_jbuf() { return (join_alg != NULL); }
 };
@@ -667,6 +676,8 @@ class Explain_table_access : public Sql_alloc
   /* Tracker for reading the table */
   Table_access_tracker tracker;
   Table_access_tracker jbuf_tracker;
+  /* Time spent reading rows from the table */
+  Exec_time_tracker op_tracker;
 
   int print_explain(select_result_sink *output, uint8 explain_flags, 
                     bool is_analyze,
@@ -2581,6 +2581,7 @@ enum_nested_loop_state JOIN_CACHE::join_null_complements(bool skip_last)
 void JOIN_CACHE::save_explain_data(EXPLAIN_BKA_TYPE *explain)
 {
   explain->incremental= MY_TEST(prev_cache);
+  explain->join_buffer_size= buff_size;
 
   switch (get_join_alg()) {
   case BNL_JOIN_ALG:
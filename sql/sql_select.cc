@@ -2248,6 +2248,16 @@ JOIN::reinit()
 
   first_record= 0;
   cleaned= false;
+  /*
+    Keep the ANALYZE trackers only if the EXPLAIN data is still that of
+    the current statement: a re-executed subquery is not re-optimized,
+    while a new execution of a prepared statement or SP gets new EXPLAIN
+    data from optimize().
+  */
+  if (explain && (!thd->lex->explain ||
+                  thd->lex->explain->get_select(select_lex->select_number) !=
+                  explain))
+    explain= NULL;
 
   if (exec_tmp_table1)
   {
@@ -2390,7 +2400,11 @@ void JOIN::exec()
                                                select_lex->select_number))
                         dbug_serve_apcs(thd, 1);
                  );
+  Exec_time_tracker *tracker= (thd->lex->analyze_stmt && explain) ?
+                              &explain->time_tracker : NULL;
+  ANALYZE_START_TRACKING(tracker);
   exec_inner();
+  ANALYZE_STOP_TRACKING(tracker);
 
   DBUG_EXECUTE_IF("show_explain_probe_join_exec_end", 
                   if (dbug_user_var_equals_int(thd, 
@@ -2592,6 +2606,8 @@ void JOIN::exec_inner()
   List<Item> *curr_all_fields= &all_fields;
   List<Item> *curr_fields_list= &fields_list;
   TABLE *curr_tmp_table= 0;
+  Exec_time_tracker *tmp_tracker= (thd->lex->analyze_stmt && explain) ?
+                                  &explain->tmp_table_tracker : NULL;
   /*
     curr_join->join_free() will call JOIN::cleanup(full=TRUE). It will not 
     be safe to call update_used_tables() after that.
@@ -2632,7 +2648,9 @@ void JOIN::exec_inner()
     }
 
     Procedure *save_proc= curr_join->procedure;
+    ANALYZE_START_TRACKING(tmp_tracker);
     tmp_error= do_select(curr_join, (List<Item> *) 0, curr_tmp_table, 0);
+    ANALYZE_STOP_TRACKING(tmp_tracker);
     curr_join->procedure= save_proc;
     if (tmp_error)
     {
@@ -2811,9 +2829,13 @@ void JOIN::exec_inner()
         first_tab->sorted= MY_TEST(first_tab->loosescan_match_tab);
       }
       tmp_error= -1;
-      if (setup_sum_funcs(curr_join->thd, curr_join->sum_funcs) ||
-	  (tmp_error= do_select(curr_join, (List<Item> *) 0, curr_tmp_table,
-				0)))
+      if (!setup_sum_funcs(curr_join->thd, curr_join->sum_funcs))
+      {
+        ANALYZE_START_TRACKING(tmp_tracker);
+        tmp_error= do_select(curr_join, (List<Item> *) 0, curr_tmp_table, 0);
+        ANALYZE_STOP_TRACKING(tmp_tracker);
+      }
+      if (tmp_error)
       {
 	error= tmp_error;
 	DBUG_VOID_RETURN;
@@ -11740,7 +11762,11 @@ void JOIN::cleanup(bool full)
   DBUG_PRINT("enter", ("full %u", (uint) full));
   
   if (full)
+  {
     have_query_plan= QEP_DELETED;
+    /* The EXPLAIN data is freed together with the statement */
+    explain= NULL;
+  }
 
   if (table)
   {
@@ -17355,6 +17381,262 @@ Next_select_func setup_end_select_func(JOIN *join)
   return end_select;
 }
 
+/**
+  In-memory hash table of the groups of a GROUP BY query, see end_update().
+
+  Without it end_update() looks up the group of every row in the index of
+  the temporary table and updates the found row through the handler. When
+  the group key only has fixed size columns that are compared as binary
+  strings, the groups are kept here instead: the key is the content of
+  the group buffer and the value is the whole temporary table record with
+  the state of the aggregate functions. The table uses open addressing
+  with linear probing and keeps the records in the order the groups were
+  found in, so writing them to the temporary table at the end gives the
+  same table as updating it row by row.
+
+  The table may grow to group_by_hash_size bytes. When it is full, its
+  groups are written to the temporary table and the rest of the rows are
+  aggregated there as before.
+*/
+
+class Group_by_hash
+{
+  struct Slot
+  {
+    uint32 hash;
+    uint32 record_no;                           /* Record number + 1 */
+  };
+
+  uint key_length, rec_length, entry_length;
+  uint records, max_records;
+  uint slot_mask;
+  ulonglong max_size;
+  Slot *slots;
+  uchar *data;                                  /* key + record entries */
+
+  static ulonglong size_for(uint max_records_arg, uint entry_length_arg)
+  {
+    return (ulonglong) max_records_arg * (entry_length_arg + 2 * sizeof(Slot));
+  }
+  bool alloc_slots(uint count);
+
+public:
+  static const uint MIN_RECORDS= 64;
+
+  Group_by_hash(uint key_length_arg, uint rec_length_arg,
+                ulonglong max_size_arg)
+    :key_length(key_length_arg), rec_length(rec_length_arg),
+     entry_length(ALIGN_SIZE(key_length_arg + rec_length_arg)),
+     records(0), max_records(0), slot_mask(0), max_size(max_size_arg),
+     slots(NULL), data(NULL)
+  {}
+  ~Group_by_hash()
+  {
+    my_free(slots);
+    my_free(data);
+  }
+  bool init();
+  bool is_full();
+
+  uint32 hash_key(const uchar *key) const
+  {
+    ulong nr1= 1, nr2= 4;
+    my_charset_bin.coll->hash_sort(&my_charset_bin, key, key_length,
+                                   &nr1, &nr2);
+    return (uint32) nr1;
+  }
+
+  /* Returns the record of the group with the given key or NULL */
+  uchar *find(const uchar *key, uint32 hash)
+  {
+    for (uint i= hash & slot_mask; slots[i].record_no; i= (i + 1) & slot_mask)
+    {
+      if (slots[i].hash == hash)
+      {
+        uchar *entry= data + (size_t) (slots[i].record_no - 1) * entry_length;
+        if (!memcmp(entry, key, key_length))
+          return entry + key_length;
+      }
+    }
+    return NULL;
+  }
+
+  /* Adds a new group. is_full() must have returned FALSE */
+  void insert(const uchar *key, uint32 hash, const uchar *record)
+  {
+    uchar *entry= data + (size_t) records * entry_length;
+    uint i;
+    DBUG_ASSERT(records < max_records);
+    memcpy(entry, key, key_length);
+    memcpy(entry + key_length, record, rec_length);
+    for (i= hash & slot_mask; slots[i].record_no; i= (i + 1) & slot_mask)
+    {}
+    slots[i].hash= hash;
+    slots[i].record_no= ++records;
+  }
+
+  uint elements() const { return records; }
+  uchar *get_record(uint record_no)
+  {
+    return data + (size_t) record_no * entry_length + key_length;
+  }
+};
+
+
+/* Allocates an empty slot array, twice as large as the number of records */
+
+bool Group_by_hash::alloc_slots(uint count)
+{
+  Slot *new_slots;
+  if (!(new_slots= (Slot*) my_malloc(count * sizeof(Slot),
+                                     MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))))
+    return TRUE;
+  for (uint i= 0; i <= slot_mask; i++)
+  {
+    if (slots[i].record_no)
+    {
+      uint j;
+      for (j= slots[i].hash & (count - 1); new_slots[j].record_no;
+           j= (j + 1) & (count - 1))
+      {}
+      new_slots[j]= slots[i];
+    }
+  }
+  my_free(slots);
+  slots= new_slots;
+  slot_mask= count - 1;
+  return FALSE;
+}
+
+
+/**
+  Allocate the table for the first MIN_RECORDS groups.
+
+  @retval TRUE  Out of memory or group_by_hash_size is too small
+*/
+
+bool Group_by_hash::init()
+{
+  if (size_for(MIN_RECORDS, entry_length) > max_size)
+    return TRUE;
+  if (!(data= (uchar*) my_malloc((size_t) MIN_RECORDS * entry_length,
+                                 MYF(MY_THREAD_SPECIFIC))) ||
+      !(slots= (Slot*) my_malloc(2 * MIN_RECORDS * sizeof(Slot),
+                                 MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))))
+    return TRUE;
+  max_records= MIN_RECORDS;
+  slot_mask= 2 * MIN_RECORDS - 1;
+  return FALSE;
+}
+
+
+/**
+  Check if one more group can be added, growing the table if needed.
+
+  @retval TRUE  The table is full and can't grow within group_by_hash_size
+*/
+
+bool Group_by_hash::is_full()
+{
+  uchar *new_data;
+  uint new_max_records;
+  if (records < max_records)
+    return FALSE;
+  if (max_records > UINT_MAX32 / 4)
+    return TRUE;
+  new_max_records= max_records * 2;
+  if (size_for(new_max_records, entry_length) > max_size ||
+      !(new_data= (uchar*) my_realloc(data,
+                                      (size_t) new_max_records * entry_length,
+                                      MYF(MY_THREAD_SPECIFIC))))
+    return TRUE;
+  data= new_data;
+  if (alloc_slots(2 * new_max_records))
+  {
+    /* The data is still valid, only the old number of records can be used */
+    return TRUE;
+  }
+  max_records= new_max_records;
+  return FALSE;
+}
+
+
+/**
+  Find out if end_update() can aggregate the groups in a Group_by_hash.
+
+  Group key columns must compare equal exactly when their images in the
+  group buffer are equal, so only integer, decimal and temporal columns
+  are allowed. Records with blobs are not copied.
+
+  @return Length of the group key, or 0 if the hash table can't be used
+*/
+
+static uint group_by_hash_key_length(JOIN *join, TABLE *table)
+{
+  uchar *key_end= join->tmp_table_param.group_buff;
+  if (!join->thd->variables.group_by_hash_size || !key_end ||
+      table->s->blob_fields)
+    return 0;
+  for (ORDER *group= table->group; group; group= group->next)
+  {
+    Field *field= group->field;
+    Item_result type;
+    if (!field)
+      return 0;
+    type= field->cmp_type();
+    if ((type != INT_RESULT && type != DECIMAL_RESULT && type != TIME_RESULT) ||
+        field->real_type() == MYSQL_TYPE_BIT)
+      return 0;
+    key_end= MY_MAX(key_end, (uchar*) group->buff + field->pack_length());
+  }
+  return (uint) (key_end - join->tmp_table_param.group_buff);
+}
+
+
+/**
+  Write the groups of join->group_hash to the temporary table and free it.
+
+  If the temporary table gets full, it is converted to an on-disk table
+  and end_unique_update() is used for the rest of the rows, like in
+  end_update().
+*/
+
+static bool flush_group_hash(JOIN *join)
+{
+  TABLE *table= join->tmp_table;
+  Group_by_hash *hash= join->group_hash;
+  bool res= FALSE;
+  int error;
+  DBUG_ENTER("flush_group_hash");
+
+  join->group_hash= NULL;
+  for (uint i= 0; i < hash->elements(); i++)
+  {
+    memcpy(table->record[0], hash->get_record(i), table->s->reclength);
+    if ((error= table->file->ha_write_tmp_row(table->record[0])))
+    {
+      if (create_internal_tmp_table_from_heap(join->thd, table,
+                                              join->tmp_table_param.start_recinfo,
+                                              &join->tmp_table_param.recinfo,
+                                              error, 0, NULL))
+      {
+        res= TRUE;                              // Not a table_is_full error
+        break;
+      }
+      if ((error= table->file->ha_index_init(0, 0)))
+      {
+        table->file->print_error(error, MYF(0));
+        res= TRUE;
+        break;
+      }
+      join->join_tab[join->top_join_tab_count-1].next_select=
+        end_unique_update;
+    }
+  }
+  delete hash;
+  DBUG_RETURN(res);
+}
+
 
 /**
   Make a join of all tables and write it on socket or to table.
@@ -17401,6 +17683,20 @@ do_select(JOIN *join,List<Item> *fields,TABLE *table,Procedure *procedure)
     join->join_tab[join->top_join_tab_count - 1].next_select= end_select;
     join_tab=join->join_tab+join->const_tables;
   }
+  if (end_select == end_update)
+  {
+    uint key_length= group_by_hash_key_length(join, table);
+    if (key_length &&
+        (join->group_hash=
+         new Group_by_hash(key_length, table->s->reclength,
+                           join->thd->variables.group_by_hash_size)) &&
+        join->group_hash->init())
+    {
+      /* Not enough memory; aggregate in the temporary table */
+      delete join->group_hash;
+      join->group_hash= NULL;
+    }
+  }
   join->send_records=0;
   if (join->table_count == join->const_tables)
   {
@@ -17466,6 +17762,21 @@ do_select(JOIN *join,List<Item> *fields,TABLE *table,Procedure *procedure)
       error= NESTED_LOOP_OK;                    /* select_limit used */
   }
 
+  if (join->group_hash)
+  {
+    if (error == NESTED_LOOP_OK || error == NESTED_LOOP_NO_MORE_ROWS ||
+        join->thd->killed == ABORT_QUERY)
+    {
+      if (flush_group_hash(join))
+        error= NESTED_LOOP_ERROR;
+    }
+    else
+    {
+      delete join->group_hash;
+      join->group_hash= NULL;
+    }
+  }
+
   join->thd->limit_found_rows= join->send_records;
 
   if (error == NESTED_LOOP_NO_MORE_ROWS || join->thd->killed == ABORT_QUERY)
@@ -19173,8 +19484,7 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 /** Group by searching after group record and updating it if possible. */
 
 static enum_nested_loop_state
-end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
-	   bool end_of_records)
+end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records)
 {
   TABLE *table=join->tmp_table;
   ORDER   *group;
@@ -19202,7 +19512,44 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     item->save_org_in_field(group->field, group->fast_field_copier_func);
     /* Store in the used key if the field was 0 */
     if (item->maybe_null)
+    {
       group->buff[-1]= (char) group->field->is_null();
+      /* The hash table compares the whole key, so clear the old value */
+      if (group->buff[-1] && join->group_hash)
+        bzero(group->buff, group->field->pack_length());
+    }
+  }
+  if (Group_by_hash *hash= join->group_hash)
+  {
+    uchar *key= join->tmp_table_param.group_buff;
+    uint32 hash_value= hash->hash_key(key);
+    uchar *record;
+    if ((record= hash->find(key, hash_value)))
+    {
+      memcpy(table->record[0], record, table->s->reclength);
+      update_tmptable_sum_func(join->sum_funcs,table);
+      memcpy(record, table->record[0], table->s->reclength);
+      goto end;
+    }
+    if (!hash->is_full())
+    {
+      init_tmptable_sum_functions(join->sum_funcs);
+      if (copy_funcs(join->tmp_table_param.items_to_copy, join->thd))
+        DBUG_RETURN(NESTED_LOOP_ERROR);       /* purecov: inspected */
+      hash->insert(key, hash_value, table->record[0]);
+      join->send_records++;
+      goto end;
+    }
+    /*
+      No room for more groups: move them to the temporary table and
+      aggregate the rest of the rows there.
+    */
+    if (flush_group_hash(join))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (join->join_tab[join->top_join_tab_count-1].next_select ==
+        end_unique_update)
+      DBUG_RETURN(end_unique_update(join, join_tab, end_of_records));
+    copy_fields(&join->tmp_table_param);        // record[0] was overwritten
   }
   if (!table->file->ha_index_read_map(table->record[1],
                                       join->tmp_table_param.group_buff,
@@ -20671,6 +21018,8 @@ create_sort_index(THD *thd, JOIN *join, ORDER *order,
   JOIN_TAB *tab;
   int err= 0;
   bool quick_created= FALSE;
+  Filesort_tracker *fs_tracker= NULL;
+  ulong merge_passes;
   DBUG_ENTER("create_sort_index");
 
   if (join->table_count == join->const_tables)
@@ -20804,9 +21153,21 @@ create_sort_index(THD *thd, JOIN *join, ORDER *order,
 
   if (table->s->tmp_table)
     table->file->info(HA_STATUS_VARIABLE);	// Get record count
+  if (thd->lex->analyze_stmt && join->explain)
+    fs_tracker= &join->explain->filesort_tracker;
+  merge_passes= thd->status_var.filesort_merge_passes_;
+  ANALYZE_START_TRACKING(fs_tracker ? &fs_tracker->time_tracker : NULL);
   filesort_retval= filesort(thd, table, join->sortorder, length,
                             select, filesort_limit, 0,
                             &examined_rows, &found_rows);
+  ANALYZE_STOP_TRACKING(fs_tracker ? &fs_tracker->time_tracker : NULL);
+  if (fs_tracker)
+  {
+    fs_tracker->r_sort_passes+= thd->status_var.filesort_merge_passes_ -
+                                merge_passes;
+    if (filesort_retval != HA_POS_ERROR)
+      fs_tracker->r_output_rows+= filesort_retval;
+  }
   table->sort.found_records= filesort_retval;
   if (found_rows != HA_POS_ERROR)
   {
@@ -23318,6 +23679,8 @@ void JOIN_TAB::save_explain_data(Explain_table_access *eta, table_map prefix_tab
   
   tab->tracker= &eta->tracker;
   tab->jbuf_tracker= &eta->jbuf_tracker;
+  if (thd->lex->analyze_stmt)
+    table->file->set_time_tracker(&eta->op_tracker);
   
   /* id and select_type are kept in Explain_select */
 
@@ -23769,6 +24132,7 @@ int JOIN::save_explain_data_intern(Explain_query *output, bool need_tmp_table,
       xpl_sel->using_filesort= true;
 
     xpl_sel->exec_const_cond= exec_const_cond;
+    explain= xpl_sel;
 
     JOIN_TAB* const first_top_tab= first_breadth_first_tab(join, WALK_OPTIMIZATION_TABS);
     JOIN_TAB* prev_bush_root_tab= NULL;
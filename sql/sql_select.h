@@ -196,6 +196,7 @@ int rr_sequential_and_unpack(READ_RECORD *info);
  *************************************************************************************/
 
 class JOIN_CACHE;
+class Group_by_hash;
 class SJ_TMP_TABLE;
 class JOIN_TAB_RANGE;
 
@@ -1154,6 +1155,12 @@ class JOIN :public Sql_alloc
     and should be taken from the appropriate JOIN_TAB
   */
   bool filesort_found_rows;
+
+  /**
+    In-memory hash table that end_update() aggregates groups in before
+    they are written to the temporary table. Only exists during do_select().
+  */
+  Group_by_hash *group_hash;
   
   /**
     Copy of this JOIN to be used with temporary tables.
@@ -1263,6 +1270,12 @@ class JOIN :public Sql_alloc
   
   enum { QEP_NOT_PRESENT_YET, QEP_AVAILABLE, QEP_DELETED} have_query_plan;
 
+  /*
+    EXPLAIN data for this join, or NULL if it was not saved. Used to
+    collect execution statistics for ANALYZE.
+  */
+  Explain_select *explain;
+
   /*
     Additional WHERE and HAVING predicates to be considered for IN=>EXISTS
     subquery transformation of a JOIN object.
@@ -1367,10 +1380,12 @@ class JOIN :public Sql_alloc
     in_to_exists_where= NULL;
     in_to_exists_having= NULL;
     pre_sort_join_tab= NULL;
+    explain= NULL;
     emb_sjm_nest= NULL;
     sjm_lookup_tables= 0;
 
     filesort_found_rows= false;
+    group_hash= NULL;
     /* 
       The following is needed because JOIN::cleanup(true) may be called for 
       joins for which JOIN::optimize was aborted with an error before a proper
@@ -56,6 +56,12 @@
   equal to "never".
 */ 
    
+/*
+  The number of rows to put into the sample of a table when
+  analyze_sample_percentage is set to 0
+*/
+static const ha_rows ANALYZE_AUTO_SAMPLE_ROWS= 100000;
+
 /* Currently there are only 3 persistent statistical tables */
 static const uint STATISTICS_TABLES= 3;
 
@@ -177,6 +183,7 @@ class Column_statistics_collected :public Column_statistics
   Field *column;  /* The column to collect statistics on */
   ha_rows nulls;  /* To accumulate the number of nulls in the column */ 
   ulonglong column_total_length; /* To accumulate the size of column values */
+  ha_rows sampled_values; /* Not null values put into count_distinct */
   Count_distinct_field *count_distinct; /* The container for distinct 
                                            column values */
 
@@ -185,8 +192,8 @@ class Column_statistics_collected :public Column_statistics
 public:
 
   inline void init(THD *thd, Field * table_field);
-  inline bool add(ha_rows rowno);
-  inline void finish(ha_rows rows); 
+  inline bool add(ha_rows rowno, bool in_sample);
+  inline void finish(ha_rows rows, double sample_fraction); 
   inline void cleanup();
 };
 
@@ -1282,6 +1289,7 @@ class Histogram_builder
   uint curr_bucket;        /* number of the current bucket to be built     */
   ulonglong count;         /* number of values retrieved                   */
   ulonglong count_distinct;    /* number of distinct values retrieved      */
+  ulonglong count_singletons;  /* number of values retrieved only once     */
 
 public: 
   Histogram_builder(Field *col, uint col_len, ha_rows rows)
@@ -1296,13 +1304,17 @@ class Histogram_builder
     curr_bucket= 0;
     count= 0;
     count_distinct= 0;    
+    count_singletons= 0;
   }
 
   ulonglong get_count_distinct() { return count_distinct; }
+  ulonglong get_count_singletons() { return count_singletons; }
 
   int next(void *elem, element_count elem_cnt)
   {
     count_distinct++;
+    if (elem_cnt == 1)
+      count_singletons++;
     count+= elem_cnt;
     if (curr_bucket == hist_width)
       return 0;
@@ -1332,9 +1344,79 @@ int histogram_build_walk(void *elem, element_count elem_cnt, void *arg)
   return hist_builder->next(elem, elem_cnt);
 }
 
+
+/*
+  Counters filled by count_distinct_singletons_walk(): the number of
+  distinct values in a Unique tree and the number of values that were
+  added to it exactly once.
+*/
+
+struct Distinct_counts
+{
+  ulonglong distincts;
+  ulonglong singletons;
+};
+
+int count_distinct_singletons_walk(void *elem, element_count count, void *arg)
+{
+  Distinct_counts *counts= (Distinct_counts *) arg;
+  counts->distincts++;
+  if (count == 1)
+    counts->singletons++;
+  return 0;
+}
+
 C_MODE_END
 
 
+/**
+  @brief
+  Estimate the number of distinct values of a column from a row sample
+
+  @param
+  n          The number of not null values in the sample
+  @param
+  d          The number of distinct values in the sample
+  @param
+  f1         The number of values encountered exactly once in the sample
+  @param
+  total      The (estimated) number of not null values in the column
+
+  @details
+  The function uses the Duj1 estimator by Haas, Naughton, Seshadri and
+  Stokes ("Sampling-Based Estimation of the Number of Distinct Values of
+  an Attribute", VLDB 1995):
+
+     D = n*d / (n - f1 + f1*n/total)
+
+  The estimate is exact both when all values of the sample are distinct
+  (then the column is taken as unique) and when no value of the sample is
+  a singleton (then all distinct values are taken as found).
+  Simple scaling of d by the sampling fraction would grossly overestimate
+  D for columns with few distinct values.
+
+  @retval
+  The estimate, always in the range [d, total]
+*/
+
+static
+double estimate_count_distinct(ulonglong n, ulonglong d, ulonglong f1,
+                               double total)
+{
+  double denom;
+  double est;
+  if (!n || (double) n >= total)
+    return (double) d;
+  denom= (double) (n - f1) + (double) f1 * n / total;
+  if (denom <= 0)
+    return total;
+  est= (double) n * d / denom;
+  set_if_bigger(est, (double) d);
+  set_if_smaller(est, total);
+  return est;
+}
+
+
 /*
   The class Count_distinct_field is a helper class used to calculate
   the number of distinct values for a column. The class employs the
@@ -1419,14 +1501,29 @@ class Count_distinct_field: public Sql_alloc
     return count;
   }
 
+  /*
+    @brief
+    Calculate the number of elements accumulated in the container of 'tree'
+    and the number of them that have been added only once
+  */
+  ulonglong get_value_and_singletons(ulonglong *singletons)
+  {
+    Distinct_counts counts= { 0, 0 };
+    tree->walk(table_field->table, count_distinct_singletons_walk,
+               (void*) &counts);
+    *singletons= counts.singletons;
+    return counts.distincts;
+  }
+
   /*
     @brief
     Build the histogram for the elements accumulated in the container of 'tree'
   */
-  ulonglong get_value_with_histogram(ha_rows rows)
+  ulonglong get_value_with_histogram(ha_rows rows, ulonglong *singletons)
   {
     Histogram_builder hist_builder(table_field, tree_key_length, rows);
     tree->walk(table_field->table,  histogram_build_walk, (void *) &hist_builder);
+    *singletons= hist_builder.get_count_singletons();
     return hist_builder.get_count_distinct();
   }
 
@@ -2195,6 +2292,7 @@ void Column_statistics_collected::init(THD *thd, Field *table_field)
 
   nulls= 0;
   column_total_length= 0;
+  sampled_values= 0;
   if (is_single_pk_col)
     count_distinct= NULL;
   if (table_field->flags & BLOB_FLAG)
@@ -2216,11 +2314,19 @@ void Column_statistics_collected::init(THD *thd, Field *table_field)
   Perform aggregation for a row when collecting statistics on a column
 
   @param
-  rowno     The order number of the row
+  rowno      The order number of the row
+  @param
+  in_sample  TRUE <-> the row belongs to the sample of the table rows
+
+  @details
+  The number of nulls, the total length of the values and the minimal and
+  the maximal values are aggregated over all rows of the table, as they
+  are cheap to maintain. Only the values from the rows of the sample are
+  put into the container for distinct values.
 */
 
 inline
-bool Column_statistics_collected::add(ha_rows rowno)
+bool Column_statistics_collected::add(ha_rows rowno, bool in_sample)
 {
 
   bool err= 0;
@@ -2233,8 +2339,11 @@ bool Column_statistics_collected::add(ha_rows rowno)
       set_not_null(COLUMN_STAT_MIN_VALUE);
     if (max_value && column->update_max(max_value, rowno == nulls))
       set_not_null(COLUMN_STAT_MAX_VALUE);
-    if (count_distinct) 
+    if (count_distinct && in_sample) 
+    {
+      sampled_values++;
       err= count_distinct->add();
+    }
   } 
   return err;
 }
@@ -2245,11 +2354,19 @@ bool Column_statistics_collected::add(ha_rows rowno)
   Get the results of aggregation when collecting the statistics on a column
   
   @param
-  rows          The total number of rows in the table 
+  rows             The total number of rows in the table 
+  @param
+  sample_fraction  The fraction of rows whose values were put into the
+                   container for distinct values
+
+  @details
+  If only a sample of the rows has been collected the number of distinct
+  values in the column is estimated by estimate_count_distinct(), and
+  the histogram is built over the values of the sample.
 */
 
 inline
-void Column_statistics_collected::finish(ha_rows rows)
+void Column_statistics_collected::finish(ha_rows rows, double sample_fraction)
 {
   double val;
 
@@ -2268,14 +2385,25 @@ void Column_statistics_collected::finish(ha_rows rows)
   if (count_distinct)
   {
     ulonglong distincts;
+    ulonglong singletons= 0;
+    double distincts_est;
     uint hist_size= count_distinct->get_hist_size();
-    if (hist_size == 0)
+    if (hist_size != 0)
+      distincts= count_distinct->get_value_with_histogram(sampled_values,
+                                                          &singletons);
+    else if (sample_fraction < 1.0)
+      distincts= count_distinct->get_value_and_singletons(&singletons);
+    else
       distincts= count_distinct->get_value();
+    if (sample_fraction < 1.0)
+      distincts_est= estimate_count_distinct(sampled_values, distincts,
+                                             singletons,
+                                             (double) (rows - nulls));
     else
-      distincts= count_distinct->get_value_with_histogram(rows - nulls);
+      distincts_est= (double) distincts;
     if (distincts)
     {
-      val= (double) (rows - nulls) / distincts;
+      val= (double) (rows - nulls) / distincts_est;
       set_avg_frequency(val); 
       set_not_null(COLUMN_STAT_AVG_FREQUENCY);
     }
@@ -2430,6 +2558,36 @@ int collect_statistics_for_index(THD *thd, TABLE *table, uint index)
   (or its derivation). Currently this class cannot count the number of
   distinct values for blob columns. So the value of 'avg_frequency' for
   blob columns is always null.
+  If analyze_sample_percentage is less than 100 only the values from a
+  Bernoulli sample of the scanned rows are put into these containers, and
+  the number of distinct values in the column is estimated from the sample.
+  This reduces the memory and temporary disk space needed by ANALYZE for
+  big tables. The cardinality of the table, the number of nulls, the
+  average length and the minimal/maximal values are still collected from
+  all rows.
+  The table is still scanned in full when sampling: not every engine can
+  read random rows through handler::rnd_pos(), so the sample is drawn
+  during the scan. Sampling saves the cost of the distinct value
+  containers (memory, tmpdir space, merge passes), not of the scan.
+
+  With n values in the sample, the fraction of the values below any
+  point differs from the fraction over all values by more than
+     eps = sqrt(ln(2/alpha) / (2*n))
+  only with a probability of at most alpha (Dvoretzky-Kiefer-Wolfowitz
+  inequality). So the selectivity of a range taken from a histogram built
+  over the sample is off by at most 2*eps of the rows, in addition to the
+  1/histogram_size granularity of any histogram. For the 100000 values
+  of ANALYZE_AUTO_SAMPLE_ROWS and alpha= 0.01 this is about 1% of the
+  rows. The optimizer can thus only pick another plan than with full
+  statistics for conditions whose selectivities are within this bound of
+  each other.
+  No such bound exists for 'avg_frequency': for some data any estimator
+  that looks at n of N values has a ratio error of at least
+  sqrt((N-n)/(2*n) * ln(1/delta)) with probability delta (Charikar et al.,
+  PODS 2000). The Duj1 estimate is exact for unique columns and for
+  columns whose sampled values all repeat; it errs most on skewed columns
+  with many rare values, for which analyze_sample_percentage=100 should
+  be used.
   After the full table scan the function calls collect_statistics_for_index
   for each table index. The latter performs full index scan for each index.
 
@@ -2454,9 +2612,27 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
   Field *table_field;
   ha_rows rows= 0;
   handler *file=table->file;
+  double sample_fraction= thd->variables.analyze_sample_percentage / 100;
+  struct my_rnd_struct sample_rand;
+  bool in_sample= TRUE;
 
   DBUG_ENTER("collect_statistics_for_table");
 
+  /*
+    analyze_sample_percentage=0 means that the fraction of the rows to
+    sample is chosen so that about ANALYZE_AUTO_SAMPLE_ROWS values of each
+    column are put into the containers for distinct values.
+  */
+  if (sample_fraction == 0)
+  {
+    sample_fraction= 1.0;
+    if (!file->info(HA_STATUS_VARIABLE) &&
+        file->stats.records > ANALYZE_AUTO_SAMPLE_ROWS)
+      sample_fraction= (double) ANALYZE_AUTO_SAMPLE_ROWS / file->stats.records;
+  }
+  my_rnd_init(&sample_rand, (ulong) (my_rnd(&thd->rand) * 0x7FFFFFFFL),
+              (ulong) (my_rnd(&thd->rand) * 0x7FFFFFFFL));
+
   table->collected_stats->cardinality_is_null= TRUE;
   table->collected_stats->cardinality= 0;
 
@@ -2487,12 +2663,15 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
         break;
       }
 
+      if (sample_fraction < 1.0)
+        in_sample= my_rnd(&sample_rand) < sample_fraction;
+
       for (field_ptr= table->field; *field_ptr; field_ptr++)
       {
         table_field= *field_ptr;
         if (!bitmap_is_set(table->read_set, table_field->field_index))
           continue;  
-        if ((rc= table_field->collected_stats->add(rows)))
+        if ((rc= table_field->collected_stats->add(rows, in_sample)))
           break;
       }
       if (rc)
@@ -2522,7 +2701,7 @@ int collect_statistics_for_table(THD *thd, TABLE *table)
       continue;
     bitmap_set_bit(table->write_set, table_field->field_index); 
     if (!rc)
-      table_field->collected_stats->finish(rows);
+      table_field->collected_stats->finish(rows, sample_fraction);
     else
       table_field->collected_stats->cleanup();
   }
@@ -1390,16 +1390,23 @@ static Sys_var_ulonglong Sys_max_heap_table_size(
        VALID_RANGE(16384, (ulonglong)~(intptr)0), DEFAULT(16*1024*1024),
        BLOCK_SIZE(1024));
 
+/*
+  MDL_lock objects are stored in the lock-free hash, which neither
+  caches unused objects nor is partitioned. These variables are kept
+  for compatibility only.
+*/
+static ulong mdl_locks_cache_size, mdl_locks_hash_partitions;
+
 static Sys_var_ulong Sys_metadata_locks_cache_size(
-       "metadata_locks_cache_size", "Size of unused metadata locks cache",
+       "metadata_locks_cache_size", "Unused",
        READ_ONLY GLOBAL_VAR(mdl_locks_cache_size), CMD_LINE(REQUIRED_ARG),
-       VALID_RANGE(1, 1024*1024), DEFAULT(MDL_LOCKS_CACHE_SIZE_DEFAULT),
+       VALID_RANGE(1, 1024*1024), DEFAULT(1024),
        BLOCK_SIZE(1));
 
 static Sys_var_ulong Sys_metadata_locks_hash_instances(
-       "metadata_locks_hash_instances", "Number of metadata locks hash instances",
+       "metadata_locks_hash_instances", "Unused",
        READ_ONLY GLOBAL_VAR(mdl_locks_hash_partitions), CMD_LINE(REQUIRED_ARG),
-       VALID_RANGE(1, 1024), DEFAULT(MDL_LOCKS_HASH_PARTITIONS_DEFAULT),
+       VALID_RANGE(1, 1024), DEFAULT(8),
        BLOCK_SIZE(1));
 
 /*
@@ -1957,7 +1964,8 @@ Sys_var_slave_parallel_mode::global_value_ptr(THD *thd, const LEX_STRING *base_n
 
 
 static const char *slave_parallel_mode_names[] = {
-  "domain", "follow_master_commit", "transactional", "waiting", NULL
+  "domain", "follow_master_commit", "transactional", "waiting", "writeset",
+  NULL
 };
 TYPELIB slave_parallel_mode_typelib = {
   array_elements(slave_parallel_mode_names)-1,
@@ -1974,8 +1982,10 @@ static Sys_var_slave_parallel_mode Sys_slave_parallel_mode(
        "replication domains in parallel; \"follow_master_commit\", to apply "
        "in parallel transactions that group-committed together on the master; "
        "\"transactional\", to optimistically try to apply all transactional "
-       "DML in parallel; and \"waiting\" to extend \"transactional\" to "
-       "even transactions that had to wait on the master.",
+       "DML in parallel; \"waiting\" to extend \"transactional\" to "
+       "even transactions that had to wait on the master; and \"writeset\", "
+       "to apply in parallel transactions whose writesets (see "
+       "--binlog-writeset-size) show that they changed different rows.",
        GLOBAL_VAR(opt_slave_parallel_mode),
        NO_CMD_LINE, slave_parallel_mode_names,
        DEFAULT(SLAVE_PARALLEL_DOMAIN |
@@ -2058,6 +2068,17 @@ static Sys_var_ulong Sys_binlog_commit_wait_usec(
        VALID_RANGE(0, ULONG_MAX), DEFAULT(100000), BLOCK_SIZE(1));
 
 
+static Sys_var_ulong Sys_binlog_writeset_size(
+       "binlog_writeset_size",
+       "If non-zero, the GTID event of a transaction that changed only rows "
+       "of transactional tables with a primary or unique key records hashes "
+       "of the keys it changed, up to this many. Slaves running with "
+       "--slave-parallel-mode=writeset use them to apply transactions that "
+       "changed different rows in parallel. Zero disables writesets.",
+       GLOBAL_VAR(opt_binlog_writeset_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, GTID_WRITESET_MAX), DEFAULT(0), BLOCK_SIZE(1));
+
+
 static bool fix_max_join_size(sys_var *self, THD *thd, enum_var_type type)
 {
   SV *sv= type == OPT_GLOBAL ? &global_system_variables : &thd->variables;
@@ -2753,6 +2774,14 @@ static Sys_var_ulong Sys_query_cache_min_res_unit(
        BLOCK_SIZE(8), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_qcache_min_res_unit));
 
+static Sys_var_ulong Sys_query_cache_partitions(
+       "query_cache_partitions",
+       "Number of partitions the query cache is split into. Each partition "
+       "has its own lock and an equal part of query_cache_size. Queries "
+       "are assigned to partitions by a hash of the query text",
+       READ_ONLY GLOBAL_VAR(query_cache_partitions), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, QUERY_CACHE_MAX_PARTITIONS), DEFAULT(1), BLOCK_SIZE(1));
+
 static const char *query_cache_type_names[]= { "OFF", "ON", "DEMAND", 0 };
 static bool check_query_cache_type(sys_var *self, THD *thd, set_var *var)
 {
@@ -2961,6 +2990,14 @@ static Sys_var_ulonglong Sys_sort_buffer(
        VALID_RANGE(MIN_SORT_MEMORY, SIZE_T_MAX), DEFAULT(MAX_SORT_MEMORY),
        BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_sort_threads(
+       "sort_threads",
+       "Maximum number of threads a sort may use to sort the rows collected "
+       "in its sort buffer. Set to 1 to always sort in the thread that "
+       "executes the query. Small sorts are never done in parallel.",
+       SESSION_VAR(sort_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, MAX_SORT_THREADS), DEFAULT(1), BLOCK_SIZE(1));
+
 export ulonglong expand_sql_mode(ulonglong sql_mode)
 {
   if (sql_mode & MODE_ANSI)
@@ -3178,6 +3215,14 @@ static Sys_var_ulong Sys_table_cache_size(
        BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_table_open_cache));
 
+static Sys_var_ulong Sys_table_cache_instances(
+       "table_open_cache_instances",
+       "The number of table cache instances. Threads use the instance "
+       "chosen by their connection id, each instance gets an equal part "
+       "of table_open_cache",
+       READ_ONLY GLOBAL_VAR(tc_instances), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 64), DEFAULT(8), BLOCK_SIZE(1));
+
 static Sys_var_ulong Sys_thread_cache_size(
        "thread_cache_size",
        "How many threads we should keep in a cache for reuse",
@@ -3253,6 +3298,15 @@ static Sys_var_uint Sys_threadpool_oversubscribe(
   GLOBAL_VAR(threadpool_oversubscribe), CMD_LINE(REQUIRED_ARG),
   VALID_RANGE(1, 1000), DEFAULT(3), BLOCK_SIZE(1)
 );
+static Sys_var_uint Sys_threadpool_high_prio_tickets(
+  "thread_pool_high_prio_tickets",
+  "Number of times a connection with an active transaction or locked "
+  "tables can be put into the high priority queue of its thread group, "
+  "before it has to wait in the normal queue. 0 disables high priority "
+  "scheduling",
+  GLOBAL_VAR(threadpool_high_prio_tickets), CMD_LINE(REQUIRED_ARG),
+  VALID_RANGE(0, UINT_MAX), DEFAULT(UINT_MAX), BLOCK_SIZE(1)
+);
 static Sys_var_uint Sys_threadpool_size(
  "thread_pool_size",
  "Number of thread groups in the pool. "
@@ -3860,6 +3914,16 @@ static Sys_var_ulong Sys_default_week_format(
        SESSION_VAR(default_week_format), CMD_LINE(REQUIRED_ARG),
        VALID_RANGE(0, 7), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulonglong Sys_group_by_hash_size(
+       "group_by_hash_size",
+       "Maximum size of the in-memory hash table a GROUP BY on integer, "
+       "decimal or temporal columns aggregates its groups in before "
+       "writing them to the internal temporary table. If there are more "
+       "groups, they are aggregated in the temporary table. 0 disables the "
+       "hash table",
+       SESSION_VAR(group_by_hash_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, ULONGLONG_MAX), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_ulonglong Sys_group_concat_max_len(
        "group_concat_max_len",
        "The maximum length of the result of function  GROUP_CONCAT()",
@@ -5092,6 +5156,16 @@ static Sys_var_enum Sys_histogram_type(
        SESSION_VAR(histogram_type), CMD_LINE(REQUIRED_ARG),
        histogram_types, DEFAULT(0));
 
+static Sys_var_double Sys_analyze_sample_percentage(
+       "analyze_sample_percentage",
+       "Percentage of the rows read by ANALYZE TABLE whose values are "
+       "used to count distinct values and build histograms. The table is "
+       "still read in full. Set to 0 to let MariaDB pick a percentage "
+       "that uses about 100000 rows.",
+       SESSION_VAR(analyze_sample_percentage),
+       CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 100),
+       DEFAULT(100));
+
 static Sys_var_mybool Sys_no_thread_alarm(
        "debug_no_thread_alarm",
        "Disable system thread alarm calls. Disabling it may be useful "
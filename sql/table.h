@@ -349,13 +349,19 @@ class Filesort_info
   uchar **get_sort_keys()
   { return filesort_buffer.get_sort_keys(); }
 
-  uchar **alloc_sort_buffer(uint num_records, uint record_length)
-  { return filesort_buffer.alloc_sort_buffer(num_records, record_length); }
+  uchar **alloc_sort_buffer(uint num_records, uint record_length,
+                            uint work_length= 0)
+  {
+    return filesort_buffer.alloc_sort_buffer(num_records, record_length,
+                                             work_length);
+  }
 
-  bool check_sort_buffer_properties(uint num_records, uint record_length)
+  bool check_sort_buffer_properties(uint num_records, uint record_length,
+                                    uint work_length= 0)
   {
     return filesort_buffer.check_sort_buffer_properties(num_records,
-                                                        record_length);
+                                                        record_length,
+                                                        work_length);
   }
 
   void free_sort_buffer()
@@ -1005,8 +1011,13 @@ struct TABLE
 public:
 
   THD	*in_use;                        /* Which thread uses this */
-  /* Time when table was released to table cache. Valid for unused tables. */
-  ulonglong tc_time;
+  /*
+    Links for the LRU list of unused TABLE objects of the table cache
+    instance this object belongs to.
+  */
+  TABLE *global_free_next, **global_free_prev;
+  /* Table cache instance this object belongs to. */
+  uint instance;
   Field **field;			/* Pointer to fields */
 
   uchar *record[2];			/* Pointer to records */
@@ -35,6 +35,13 @@
   - purge unused TABLE objects of a table from cache (tdc_remove_table())
   - get number of TABLE objects in cache (tc_records())
 
+  Table cache is split into tc_instances independent instances. A TABLE
+  object belongs to the instance of the thread that created it, a thread
+  acquires unused TABLE objects only from its own instance. Each instance
+  has its own mutex, LRU list of unused TABLE objects and share of
+  table_open_cache, so that threads opening the same hot table don't
+  contend on TDC_element::LOCK_table_share.
+
   Dependencies:
   - intern_close_table(): frees TABLE object
   - kill_delayed_threads_for_table()
@@ -46,6 +53,11 @@
   - TABLE_SHARE::free_tables shall not contain objects with TABLE::in_use != 0
   - TABLE_SHARE::free_tables shall not receive new objects if
     TABLE_SHARE::tdc.flushed is true
+  - TABLE_SHARE::free_tables[i] and Table_cache_instance::free_tables of
+    instance i contain the same objects
+
+  Lock order: TDC_element::LOCK_table_share before
+  Table_cache_instance::LOCK_table_cache.
 */
 
 #include "my_global.h"
@@ -57,6 +69,7 @@
 /** Configuration. */
 ulong tdc_size; /**< Table definition cache threshold for LRU eviction. */
 ulong tc_size; /**< Table cache threshold for LRU eviction. */
+ulong tc_instances; /**< Number of table cache instances. */
 
 /** Data collections. */
 static LF_HASH tdc_hash; /**< Collection of TABLE_SHARE objects. */
@@ -70,7 +83,27 @@ static int64 tdc_version;  /* Increments on each reload */
 static int64 last_table_id;
 static bool tdc_inited;
 
-static int32 tc_count; /**< Number of TABLE objects in table cache. */
+
+/**
+  Table cache instance.
+
+  Protects free_tables, records, and TDC_element::free_tables[] of the
+  instance.
+*/
+
+struct Table_cache_instance
+{
+  mysql_mutex_t LOCK_table_cache;
+  /** LRU list of unused TABLE objects, least recently used first. */
+  I_P_List <TABLE, I_P_List_adapter<TABLE, &TABLE::global_free_next,
+                                    &TABLE::global_free_prev>,
+            I_P_List_null_counter, I_P_List_fast_push_back<TABLE> >
+    free_tables;
+  /** Number of TABLE objects (used and unused) of this instance. */
+  ulong records;
+} MY_ALIGNED(64);
+
+static Table_cache_instance *tc;
 
 
 /**
@@ -85,11 +118,13 @@ static mysql_mutex_t LOCK_unused_shares;
 my_atomic_rwlock_t LOCK_tdc_atomics; /**< Protects tdc_version. */
 
 #ifdef HAVE_PSI_INTERFACE
-PSI_mutex_key key_LOCK_unused_shares, key_TABLE_SHARE_LOCK_table_share;
+PSI_mutex_key key_LOCK_unused_shares, key_TABLE_SHARE_LOCK_table_share,
+              key_LOCK_table_cache;
 static PSI_mutex_info all_tc_mutexes[]=
 {
   { &key_LOCK_unused_shares, "LOCK_unused_shares", PSI_FLAG_GLOBAL },
-  { &key_TABLE_SHARE_LOCK_table_share, "TABLE_SHARE::tdc.LOCK_table_share", 0 }
+  { &key_TABLE_SHARE_LOCK_table_share, "TABLE_SHARE::tdc.LOCK_table_share", 0 },
+  { &key_LOCK_table_cache, "LOCK_table_cache", 0 }
 };
 
 PSI_cond_key key_TABLE_SHARE_COND_release;
@@ -121,8 +156,8 @@ static int fix_thd_pins(THD *thd)
 
 
 /*
-  Auxiliary routines for manipulating with per-share all/unused lists
-  and tc_count counter.
+  Auxiliary routines for manipulating with per-share all/unused lists,
+  per-instance unused lists and Table_cache_instance::records counter.
   Responsible for preserving invariants between those lists, counter
   and TABLE::in_use member.
   In fact those routines implement sort of implicit table cache as
@@ -132,31 +167,85 @@ static int fix_thd_pins(THD *thd)
 
 /**
   Get number of TABLE objects (used and unused) in table cache.
+
+  Instances are not locked, the value is only used for statistics and
+  eviction heuristics.
 */
 
 uint tc_records(void)
 {
-  uint count;
-  my_atomic_rwlock_rdlock(&LOCK_tdc_atomics);
-  count= my_atomic_load32_explicit(&tc_count, MY_MEMORY_ORDER_RELAXED);
-  my_atomic_rwlock_rdunlock(&LOCK_tdc_atomics);
-  return count;
+  ulong count= 0;
+  for (ulong i= 0; i < tc_instances; i++)
+    count+= tc[i].records;
+  return (uint) count;
+}
+
+
+/**
+  Table cache threshold for LRU eviction of a single instance.
+*/
+
+static inline ulong tc_instance_size(void)
+{
+  return (tc_size + tc_instances - 1) / tc_instances;
 }
 
 
 /**
   Remove TABLE object from table cache.
 
-  - decrement tc_count
   - remove object from TABLE_SHARE::tdc.all_tables
+  - free object
+
+  @pre object is not in any list of unused objects, and was subtracted
+       from Table_cache_instance::records.
 */
 
 static void tc_remove_table(TABLE *table)
 {
-  my_atomic_rwlock_wrlock(&LOCK_tdc_atomics);
-  my_atomic_add32_explicit(&tc_count, -1, MY_MEMORY_ORDER_RELAXED);
-  my_atomic_rwlock_wrunlock(&LOCK_tdc_atomics);
-  table->s->tdc->all_tables.remove(table);
+  TDC_element *element= table->s->tdc;
+
+  mysql_mutex_lock(&element->LOCK_table_share);
+  element->wait_for_mdl_deadlock_detector();
+  element->all_tables.remove(table);
+  mysql_mutex_unlock(&element->LOCK_table_share);
+  intern_close_table(table);
+}
+
+
+/**
+  Remove all unused TABLE objects of a share from all table cache instances.
+
+  @pre LOCK_table_share is locked and MDL deadlock detector is not
+       traversing TABLE_SHARE::tdc.all_tables.
+
+  While locked:
+  - remove unused objects from TABLE_SHARE::tdc.free_tables,
+    Table_cache_instance::free_tables and TABLE_SHARE::tdc.all_tables
+  - decrement Table_cache_instance::records
+
+  Caller is expected to free objects added to purge_tables.
+*/
+
+static void tc_remove_all_unused_tables(TDC_element *element,
+                                        Share_free_tables::List *purge_tables)
+{
+  TABLE *table;
+
+  mysql_mutex_assert_owner(&element->LOCK_table_share);
+  DBUG_ASSERT(element->all_tables_refs == 0);
+  for (ulong i= 0; i < tc_instances; i++)
+  {
+    mysql_mutex_lock(&tc[i].LOCK_table_cache);
+    while ((table= element->free_tables[i].list.pop_front()))
+    {
+      tc[i].records--;
+      tc[i].free_tables.remove(table);
+      element->all_tables.remove(table);
+      purge_tables->push_front(table);
+    }
+    mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+  }
 }
 
 
@@ -166,7 +255,7 @@ static void tc_remove_table(TABLE *table)
   While locked:
   - remove unused objects from TABLE_SHARE::tdc.free_tables and
     TABLE_SHARE::tdc.all_tables
-  - decrement tc_count
+  - decrement Table_cache_instance::records
 
   While unlocked:
   - free resources related to unused objects
@@ -177,24 +266,18 @@ static void tc_remove_table(TABLE *table)
 
 struct tc_purge_arg
 {
-  TDC_element::TABLE_list purge_tables;
+  Share_free_tables::List purge_tables;
   bool mark_flushed;
 };
 
 
 static my_bool tc_purge_callback(TDC_element *element, tc_purge_arg *arg)
 {
-  TABLE *table;
-
   mysql_mutex_lock(&element->LOCK_table_share);
   element->wait_for_mdl_deadlock_detector();
   if (arg->mark_flushed)
     element->flushed= true;
-  while ((table= element->free_tables.pop_front()))
-  {
-    tc_remove_table(table);
-    arg->purge_tables.push_front(table);
-  }
+  tc_remove_all_unused_tables(element, &arg->purge_tables);
   mysql_mutex_unlock(&element->LOCK_table_share);
   return FALSE;
 }
@@ -221,89 +304,73 @@ void tc_purge(bool mark_flushed)
 
   While locked:
   - add object to TABLE_SHARE::tdc.all_tables
-  - increment tc_count
-  - evict LRU object from table cache if we reached threshold
+  - increment Table_cache_instance::records of current thread's instance
+  - evict LRU object of the instance if we reached threshold
 
   While unlocked:
   - free evicted object
 */
 
-struct tc_add_table_arg
+void tc_add_table(THD *thd, TABLE *table)
 {
-  char key[MAX_DBKEY_LENGTH];
-  uint key_length;
-  ulonglong purge_time;
-};
-
-
-my_bool tc_add_table_callback(TDC_element *element, tc_add_table_arg *arg)
-{
-  TABLE *table;
+  uint i= (uint) (thd->thread_id % tc_instances);
+  TDC_element *element= table->s->tdc;
+  TABLE *LRU_table= 0;
 
+  DBUG_ASSERT(table->in_use == thd);
+  table->instance= i;
   mysql_mutex_lock(&element->LOCK_table_share);
-  if ((table= element->free_tables_back()) && table->tc_time < arg->purge_time)
+  element->wait_for_mdl_deadlock_detector();
+  element->all_tables.push_front(table);
+  mysql_mutex_unlock(&element->LOCK_table_share);
+
+  mysql_mutex_lock(&tc[i].LOCK_table_cache);
+  /* If we have too many TABLE instances around, try to get rid of them */
+  if (tc[i].records >= tc_instance_size() &&
+      (LRU_table= tc[i].free_tables.pop_front()))
   {
-    memcpy(arg->key, element->m_key, element->m_key_length);
-    arg->key_length= element->m_key_length;
-    arg->purge_time= table->tc_time;
+    LRU_table->s->tdc->free_tables[i].list.remove(LRU_table);
+    /* Needed if MDL deadlock detector chimes in before tc_remove_table() */
+    LRU_table->in_use= thd;
   }
-  mysql_mutex_unlock(&element->LOCK_table_share);
-  return FALSE;
+  else
+    tc[i].records++;
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+
+  if (LRU_table)
+    tc_remove_table(LRU_table);
 }
 
 
-void tc_add_table(THD *thd, TABLE *table)
-{
-  bool need_purge;
-  DBUG_ASSERT(table->in_use == thd);
-  mysql_mutex_lock(&table->s->tdc->LOCK_table_share);
-  table->s->tdc->wait_for_mdl_deadlock_detector();
-  table->s->tdc->all_tables.push_front(table);
-  mysql_mutex_unlock(&table->s->tdc->LOCK_table_share);
+/**
+  Acquire TABLE object from current thread's table cache instance.
 
-  /* If we have too many TABLE instances around, try to get rid of them */
-  my_atomic_rwlock_wrlock(&LOCK_tdc_atomics);
-  need_purge= my_atomic_add32_explicit(&tc_count, 1, MY_MEMORY_ORDER_RELAXED) >=
-              (int32) tc_size;
-  my_atomic_rwlock_wrunlock(&LOCK_tdc_atomics);
+  @pre share must be protected against removal.
 
-  if (need_purge)
-  {
-    tc_add_table_arg argument;
-    argument.purge_time= ULONGLONG_MAX;
-    tdc_iterate(thd, (my_hash_walk_action) tc_add_table_callback, &argument);
+  Acquired object cannot be evicted or acquired again.
 
-    if (argument.purge_time != ULONGLONG_MAX)
-    {
-      TDC_element *element= (TDC_element*) lf_hash_search(&tdc_hash,
-                                                          thd->tdc_hash_pins,
-                                                          argument.key,
-                                                          argument.key_length);
-      if (element)
-      {
-        TABLE *entry;
-        mysql_mutex_lock(&element->LOCK_table_share);
-        lf_hash_search_unpin(thd->tdc_hash_pins);
-        element->wait_for_mdl_deadlock_detector();
-
-        /*
-          It may happen that oldest table was acquired meanwhile. In this case
-          just go ahead, number of objects in table cache will normalize
-          eventually.
-        */
-        if ((entry= element->free_tables_back()) &&
-            entry->tc_time == argument.purge_time)
-        {
-          element->free_tables.remove(entry);
-          tc_remove_table(entry);
-          mysql_mutex_unlock(&element->LOCK_table_share);
-          intern_close_table(entry);
-        }
-        else
-          mysql_mutex_unlock(&element->LOCK_table_share);
-      }
-    }
+  @return TABLE object, or NULL if no unused objects.
+*/
+
+static TABLE *tc_acquire_table(THD *thd, TDC_element *element)
+{
+  uint i= (uint) (thd->thread_id % tc_instances);
+  TABLE *table;
+
+  mysql_mutex_lock(&tc[i].LOCK_table_cache);
+  table= element->free_tables[i].list.pop_front();
+  if (table)
+  {
+    DBUG_ASSERT(!table->in_use);
+    table->in_use= thd;
+    /* The ex-unused table must be fully functional. */
+    DBUG_ASSERT(table->db_stat && table->file);
+    /* The children must be detached from the table. */
+    DBUG_ASSERT(!table->file->extra(HA_EXTRA_IS_ATTACHED_CHILDREN));
+    tc[i].free_tables.remove(table);
   }
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+  return table;
 }
 
 
@@ -315,18 +382,17 @@ void tc_add_table(THD *thd, TABLE *table)
   Released object may be evicted or acquired again.
 
   While locked:
-  - if object is marked for purge, decrement tc_count
-  - add object to TABLE_SHARE::tdc.free_tables
-  - evict LRU object from table cache if we reached threshold
+  - if object is marked for purge, decrement Table_cache_instance::records
+  - add object to TABLE_SHARE::tdc.free_tables[] and
+    Table_cache_instance::free_tables
 
   While unlocked:
-  - mark object not in use by any thread
-  - free evicted/purged object
+  - free purged object
 
   @note Another thread may mark share for purge any moment (even
   after version check). It means to-be-purged object may go to
   unused lists. This other thread is expected to call tc_purge(),
-  which is synchronized with us on TABLE_SHARE::tdc.LOCK_table_share.
+  which is synchronized with us on Table_cache_instance::LOCK_table_cache.
 
   @return
     @retval true  object purged
@@ -335,20 +401,19 @@ void tc_add_table(THD *thd, TABLE *table)
 
 bool tc_release_table(TABLE *table)
 {
+  uint i= table->instance;
   DBUG_ASSERT(table->in_use);
   DBUG_ASSERT(table->file);
 
-  if (table->needs_reopen() || tc_records() > tc_size)
+  mysql_mutex_lock(&tc[i].LOCK_table_cache);
+  if (table->needs_reopen() || table->s->tdc->flushed ||
+      tc[i].records > tc_instance_size())
   {
-    mysql_mutex_lock(&table->s->tdc->LOCK_table_share);
-    goto purge;
+    tc[i].records--;
+    mysql_mutex_unlock(&tc[i].LOCK_table_cache);
+    tc_remove_table(table);
+    return true;
   }
-
-  table->tc_time= my_interval_timer();
-
-  mysql_mutex_lock(&table->s->tdc->LOCK_table_share);
-  if (table->s->tdc->flushed)
-    goto purge;
   /*
     in_use doesn't really need mutex protection, but must be reset after
     checking tdc.flushed and before this table appears in free_tables.
@@ -357,17 +422,11 @@ bool tc_release_table(TABLE *table)
   */
   table->in_use= 0;
   /* Add table to the list of unused TABLE objects for this share. */
-  table->s->tdc->free_tables.push_front(table);
-  mysql_mutex_unlock(&table->s->tdc->LOCK_table_share);
+  table->s->tdc->free_tables[i].list.push_front(table);
+  /* Add table to the LRU list of the instance. */
+  tc[i].free_tables.push_back(table);
+  mysql_mutex_unlock(&tc[i].LOCK_table_cache);
   return false;
-
-purge:
-  table->s->tdc->wait_for_mdl_deadlock_detector();
-  tc_remove_table(table);
-  mysql_mutex_unlock(&table->s->tdc->LOCK_table_share);
-  table->in_use= 0;
-  intern_close_table(table);
-  return true;
 }
 
 
@@ -424,26 +483,42 @@ static void tdc_delete_share_from_hash(TDC_element *element)
 
 /**
   Initialize table definition cache.
+
+  @retval  0  Success
+  @retval  1  Error
 */
 
-void tdc_init(void)
+bool tdc_init(void)
 {
   DBUG_ENTER("tdc_init");
 #ifdef HAVE_PSI_INTERFACE
   init_tc_psi_keys();
 #endif
+  if (!(tc= (Table_cache_instance *)
+        my_malloc(sizeof(Table_cache_instance) * tc_instances,
+                  MYF(MY_WME | MY_ZEROFILL))))
+    DBUG_RETURN(true);
+  for (ulong i= 0; i < tc_instances; i++)
+  {
+    mysql_mutex_init(key_LOCK_table_cache, &tc[i].LOCK_table_cache,
+                     MY_MUTEX_INIT_FAST);
+    tc[i].free_tables.empty();
+  }
   tdc_inited= true;
   mysql_mutex_init(key_LOCK_unused_shares, &LOCK_unused_shares,
                    MY_MUTEX_INIT_FAST);
   my_atomic_rwlock_init(&LOCK_tdc_atomics);
   tdc_version= 1L;  /* Increments on each reload */
-  lf_hash_init(&tdc_hash, sizeof(TDC_element), LF_HASH_UNIQUE, 0, 0,
+  lf_hash_init(&tdc_hash,
+               sizeof(TDC_element) +
+               sizeof(Share_free_tables) * (tc_instances - 1),
+               LF_HASH_UNIQUE, 0, 0,
                (my_hash_get_key) TDC_element::key,
                &my_charset_bin);
   tdc_hash.alloc.constructor= TDC_element::lf_alloc_constructor;
   tdc_hash.alloc.destructor= TDC_element::lf_alloc_destructor;
   tdc_hash.element_size= offsetof(TDC_element, version);
-  DBUG_VOID_RETURN;
+  DBUG_RETURN(false);
 }
 
 
@@ -486,6 +561,12 @@ void tdc_deinit(void)
     lf_hash_destroy(&tdc_hash);
     my_atomic_rwlock_destroy(&LOCK_tdc_atomics);
     mysql_mutex_destroy(&LOCK_unused_shares);
+    for (ulong i= 0; i < tc_instances; i++)
+    {
+      DBUG_ASSERT(tc[i].free_tables.is_empty());
+      mysql_mutex_destroy(&tc[i].LOCK_table_cache);
+    }
+    my_free(tc);
   }
   DBUG_VOID_RETURN;
 }
@@ -677,7 +758,7 @@ TABLE_SHARE *tdc_acquire_share(THD *thd, const char *db, const char *table_name,
 
   if (out_table && (flags & GTS_TABLE))
   {
-    if ((*out_table= element->acquire_table(thd)))
+    if ((*out_table= tc_acquire_table(thd, element)))
     {
       lf_hash_search_unpin(thd->tdc_hash_pins);
       DBUG_ASSERT(!(flags & GTS_NOLOCK));
@@ -853,7 +934,7 @@ bool tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
                       const char *db, const char *table_name,
                       bool kill_delayed_threads)
 {
-  I_P_List <TABLE, TABLE_share> purge_tables;
+  Share_free_tables::List purge_tables;
   TABLE *table;
   TDC_element *element;
   uint my_refs= 1;
@@ -904,11 +985,7 @@ bool tdc_remove_table(THD *thd, enum_tdc_remove_table_type remove_type,
   if (remove_type != TDC_RT_REMOVE_NOT_OWN_KEEP_SHARE)
     element->flushed= true;
 
-  while ((table= element->free_tables.pop_front()))
-  {
-    tc_remove_table(table);
-    purge_tables.push_front(table);
-  }
+  tc_remove_all_unused_tables(element, &purge_tables);
   if (kill_delayed_threads)
     kill_delayed_threads_for_table(element);
 
@@ -23,6 +23,7 @@ extern uint threadpool_max_size;
 extern uint threadpool_stall_limit;  /* time interval in 10 ms units for stall checks*/
 extern uint threadpool_max_threads;  /* Maximum threads in pool */
 extern uint threadpool_oversubscribe;  /* Maximum active threads in group */
+extern uint threadpool_high_prio_tickets; /* High priority queueings per transaction */
 
 
 
@@ -57,6 +58,23 @@ struct TP_STATISTICS
 
 extern TP_STATISTICS tp_stats;
 
+/*
+  Per thread group queue statistics
+*/
+struct TP_GROUP_STATISTICS
+{
+  /* Current number of connections in the normal/high priority queue */
+  uint queue_length;
+  uint high_prio_queue_length;
+  /* Total number of connections taken from the normal/high priority queue */
+  ulonglong dequeues;
+  ulonglong high_prio_dequeues;
+};
+
+/* Used in SHOW STATUS for Threadpool_groups */
+extern uint tp_get_thread_group_count();
+extern void tp_get_thread_group_stats(uint group, TP_GROUP_STATISTICS *stats);
+
 
 /* Functions to set threadpool parameters */
 extern void tp_set_min_threads(uint val);
@@ -34,6 +34,7 @@ uint threadpool_max_size;
 uint threadpool_stall_limit;
 uint threadpool_max_threads;
 uint threadpool_oversubscribe;
+uint threadpool_high_prio_tickets;
 
 /* Stats */
 TP_STATISTICS tp_stats;
@@ -116,6 +116,11 @@ struct connection_t
   connection_t *next_in_queue;
   connection_t **prev_in_queue;
   ulonglong abs_wait_timeout;
+  /*
+    Number of times this connection may still be put into the high priority
+    queue before it has to go through the normal queue again.
+  */
+  uint tickets;
   bool logged_in;
   bool bound_to_poll_descriptor;
   bool waiting;
@@ -125,7 +130,7 @@ typedef I_P_List<connection_t,
                      I_P_List_adapter<connection_t,
                                       &connection_t::next_in_queue,
                                       &connection_t::prev_in_queue>,
-                     I_P_List_null_counter,
+                     I_P_List_counter,
                      I_P_List_fast_push_back<connection_t> >
 connection_queue_t;
 
@@ -133,6 +138,11 @@ struct thread_group_t
 {
   mysql_mutex_t mutex;
   connection_queue_t queue;
+  /*
+    Connections that are in the middle of a transaction, or hold table locks.
+    Served before the normal queue, so that locks are released sooner.
+  */
+  connection_queue_t high_prio_queue;
   worker_list_t waiting_threads; 
   worker_thread_t *listener;
   pthread_attr_t *pthread_attr;
@@ -143,6 +153,9 @@ struct thread_group_t
   /* Stats for the deadlock detection timer routine.*/
   int io_event_count;
   int queue_event_count;
+  /* Number of connections dequeued from the normal/high priority queue */
+  ulonglong dequeues;
+  ulonglong high_prio_dequeues;
   ulonglong last_thread_creation_time;
   int  shutdown_pipe[2];
   bool shutdown;
@@ -411,16 +424,71 @@ static void* native_event_get_userdata(native_event *event)
 #endif
 
 
-/* Dequeue element from a workqueue */
+/* Check whether both workqueues of the group are empty */
+
+static inline bool queues_are_empty(thread_group_t *thread_group)
+{
+  return (thread_group->queue.is_empty() &&
+          thread_group->high_prio_queue.is_empty());
+}
+
+
+/*
+  Check whether connection should go to the high priority queue.
+
+  Connections with an active multi-statement transaction or with tables
+  locked by LOCK TABLES hold locks other connections may be waiting for,
+  so they are preferred, as long as they have tickets left. The connection
+  is idle when this is called, so it is safe to look at its THD.
+*/
+
+static bool connection_is_high_prio(connection_t *c)
+{
+  THD *thd= c->thd;
+  return (c->tickets > 0 &&
+          (thd->in_active_multi_stmt_transaction() ||
+           thd->locked_tables_mode != LTM_NONE));
+}
+
+
+/*
+  Put connection with a pending network event into the group's
+  normal or high priority queue. Group mutex must be held.
+*/
+
+static void queue_push(thread_group_t *thread_group, connection_t *c)
+{
+  if (connection_is_high_prio(c))
+  {
+    c->tickets--;
+    thread_group->high_prio_queue.push_back(c);
+  }
+  else
+  {
+    c->tickets= threadpool_high_prio_tickets;
+    thread_group->queue.push_back(c);
+  }
+}
+
+
+/* Dequeue element from a workqueue, high priority queue first */
 
 static connection_t *queue_get(thread_group_t *thread_group)
 {
   DBUG_ENTER("queue_get");
   thread_group->queue_event_count++;
-  connection_t *c= thread_group->queue.front();
+  connection_t *c= thread_group->high_prio_queue.front();
+  if (c)
+  {
+    thread_group->high_prio_queue.remove(c);
+    thread_group->high_prio_dequeues++;
+    DBUG_RETURN(c);
+  }
+  c= thread_group->queue.front();
   if (c)
   {
     thread_group->queue.remove(c);
+    thread_group->dequeues++;
   }
   DBUG_RETURN(c);  
 }
@@ -591,7 +659,7 @@ void check_stall(thread_group_t *thread_group)
     do wait and indicate that via thd_wait_begin/end callbacks, thread creation
     will be faster.
   */
-  if (!thread_group->queue.is_empty() && !thread_group->queue_event_count)
+  if (!queues_are_empty(thread_group) && !thread_group->queue_event_count)
   {
     thread_group->stalled= true;
     wake_or_create_thread(thread_group);
@@ -709,7 +777,7 @@ static connection_t * listener(worker_thread_t *current_thread,
      more workers.
     */
     
-    bool listener_picks_event= thread_group->queue.is_empty();
+    bool listener_picks_event= queues_are_empty(thread_group);
     
     /* 
       If listener_picks_event is set, listener thread will handle first event, 
@@ -719,7 +787,7 @@ static connection_t * listener(worker_thread_t *current_thread,
     for(int i=(listener_picks_event)?1:0; i < cnt ; i++)
     {
       connection_t *c= (connection_t *)native_event_get_userdata(&ev[i]);
-      thread_group->queue.push_back(c);
+      queue_push(thread_group, c);
     }
     
     if (listener_picks_event)
@@ -912,6 +980,7 @@ int thread_group_init(thread_group_t *thread_group, pthread_attr_t* thread_attr)
   thread_group->shutdown_pipe[0]= -1;
   thread_group->shutdown_pipe[1]= -1;
   thread_group->queue.empty();
+  thread_group->high_prio_queue.empty();
   DBUG_RETURN(0);
 }
 
@@ -1017,6 +1086,7 @@ static void queue_put(thread_group_t *thread_group, connection_t *connection)
   DBUG_ENTER("queue_put");
 
   mysql_mutex_lock(&thread_group->mutex);
+  connection->tickets= threadpool_high_prio_tickets;
   thread_group->queue.push_back(connection);
 
   if (thread_group->active_thread_count == 0)
@@ -1172,7 +1242,7 @@ void wait_begin(thread_group_t *thread_group)
   DBUG_ASSERT(thread_group->connection_count > 0);
  
   if ((thread_group->active_thread_count == 0) && 
-     (thread_group->queue.is_empty() || !thread_group->listener))
+     (queues_are_empty(thread_group) || !thread_group->listener))
   {
     /* 
       Group might stall while this thread waits, thus wake 
@@ -1215,6 +1285,7 @@ connection_t *alloc_connection(THD *thd)
     connection->logged_in= false;
     connection->bound_to_poll_descriptor= false;
     connection->abs_wait_timeout= ULONGLONG_MAX;
+    connection->tickets= threadpool_high_prio_tickets;
   }
   DBUG_RETURN(connection);
 }
@@ -1628,6 +1699,34 @@ int tp_get_idle_thread_count()
 }
 
 
+/**
+  Number of thread groups currently in use.
+*/
+
+uint tp_get_thread_group_count()
+{
+  return threadpool_started ? group_count : 0;
+}
+
+
+/**
+  Get queue statistics for a single thread group.
+
+  Like tp_get_idle_thread_count(), this does not lock the group,
+  the values are only used for monitoring.
+*/
+
+void tp_get_thread_group_stats(uint group, TP_GROUP_STATISTICS *stats)
+{
+  thread_group_t *thread_group= &all_groups[group];
+  DBUG_ASSERT(group < threadpool_max_size);
+  stats->queue_length= thread_group->queue.elements();
+  stats->high_prio_queue_length= thread_group->high_prio_queue.elements();
+  stats->dequeues= thread_group->dequeues;
+  stats->high_prio_dequeues= thread_group->high_prio_dequeues;
+}
+
+
 /* Report threadpool problems */
 
 /** 
@@ -745,3 +745,17 @@ int tp_get_idle_thread_count()
   return 0;
 }
 
+
+/**
+  Thread groups and their queues do not exist in Windows implementation.
+*/
+uint tp_get_thread_group_count()
+{
+  return 0;
+}
+
+void tp_get_thread_group_stats(uint, TP_GROUP_STATISTICS *)
+{
+  DBUG_ASSERT(0);
+}
+
@@ -98,6 +98,8 @@ UNIV_INTERN ulint	btr_cur_n_non_sea_old	= 0;
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
 UNIV_INTERN ulint	btr_cur_n_sea_old	= 0;
+/** Search counters of each adaptive hash index partition */
+UNIV_INTERN btr_cur_part_stat_t	btr_cur_part_stats[BTR_SEARCH_MAX_PARTITIONS];
 
 #ifdef UNIV_DEBUG
 /* Flag to limit optimistic insert records */
@@ -488,7 +490,8 @@ btr_cur_search_to_nth_level(
 # ifdef UNIV_SEARCH_PERF_STAT
 	info->n_searches++;
 # endif
-	if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_NOT_LOCKED
+	if (rw_lock_get_writer(btr_search_get_latch(cursor->index))
+	    == RW_LOCK_NOT_LOCKED
 	    && latch_mode <= BTR_MODIFY_LEAF
 	    && info->last_hash_succ
 	    && !estimate
@@ -512,19 +515,21 @@ btr_cur_search_to_nth_level(
 		ut_ad(cursor->low_match != ULINT_UNDEFINED
 		      || mode != PAGE_CUR_LE);
 		btr_cur_n_sea++;
+		btr_cur_part_stats[btr_search_get_part(index)].n_sea++;
 
 		return;
 	}
 # endif /* BTR_CUR_HASH_ADAPT */
 #endif /* BTR_CUR_ADAPT */
 	btr_cur_n_non_sea++;
+	btr_cur_part_stats[btr_search_get_part(index)].n_non_sea++;
 
 	/* If the hash search did not succeed, do binary search down the
 	tree */
 
 	if (has_search_latch) {
 		/* Release possible search latch to obey latching order */
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(cursor->index));
 	}
 
 	/* Store the position of the tree latch we push to mtr so that we
@@ -820,7 +825,7 @@ btr_cur_search_to_nth_level(
 
 	if (has_search_latch) {
 
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(btr_search_get_latch(cursor->index));
 	}
 }
 
@@ -2043,13 +2048,13 @@ btr_cur_update_in_place(
 			btr_search_update_hash_on_delete(cursor);
 		}
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_search_get_latch(cursor->index));
 	}
 
 	row_upd_rec_in_place(rec, index, offsets, update, page_zip);
 
 	if (is_hashed) {
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
 	}
 
 	btr_cur_update_in_place_log(flags, rec, index, update,
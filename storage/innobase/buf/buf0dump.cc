@@ -30,16 +30,19 @@ Created April 08, 2011 Vasil Dimov
 
 #include "buf0buf.h" /* buf_pool_mutex_enter(), srv_buf_pool_instances */
 #include "buf0dump.h"
+#include "buf0rea.h" /* buf_read_page_async() */
 #include "db0err.h"
 #include "dict0dict.h" /* dict_operation_lock */
+#include "mach0data.h" /* mach_write_to_4() */
 #include "os0file.h" /* OS_FILE_MAX_PATH */
 #include "os0sync.h" /* os_event* */
 #include "os0thread.h" /* os_thread_* */
-#include "srv0srv.h" /* srv_fast_shutdown, srv_buf_dump* */
+#include "srv0srv.h" /* srv_fast_shutdown, srv_buf_dump*, srv_io_capacity */
 #include "srv0start.h" /* srv_shutdown_state */
 #include "sync0rw.h" /* rw_lock_s_lock() */
 #include "ut0byte.h" /* ut_ull_create() */
 #include "ut0sort.h" /* UT_SORT_FUNCTION_BODY */
+#include "ut0ut.h" /* ut_time_ms() */
 
 enum status_severity {
 	STATUS_INFO,
@@ -68,6 +71,102 @@ typedef ib_uint64_t	buf_dump_t;
 #define BUF_DUMP_SPACE(a)		((ulint) ((a) >> 32))
 #define BUF_DUMP_PAGE(a)		((ulint) ((a) & 0xFFFFFFFFUL))
 
+/** A page in a buffer pool dump, together with how hot it was when the
+dump was made. */
+struct buf_dump_entry_t {
+	buf_dump_t	id;		/*!< space id and page number */
+	ib_uint32_t	n_accesses;	/*!< buf_page_t::n_accesses */
+	ib_uint32_t	lru_pos;	/*!< position in the LRU list of the
+					buffer pool instance, 0 being the most
+					recently used page */
+};
+
+/* The dump file starts with a header of BUF_DUMP_HEADER_SIZE bytes that
+holds BUF_DUMP_MAGIC and BUF_DUMP_VERSION, followed by one entry of
+BUF_DUMP_ENTRY_SIZE bytes per page: space id, page number, number of
+accesses and LRU position, each stored in 4 bytes, most recently used
+pages first. Files written by older versions are text files of
+"space,page" lines, least recently used pages first; buf_load() reads
+those, too. */
+#define BUF_DUMP_MAGIC		0x49425044	/* "IBPD" */
+#define BUF_DUMP_VERSION	1
+#define BUF_DUMP_HEADER_SIZE	8
+#define BUF_DUMP_ENTRY_SIZE	16
+
+/** Number of entries that are written or read with one call */
+#define BUF_DUMP_IO_BATCH	1024
+
+/** Number of pages that a loader thread reads in one batch */
+#define BUF_LOAD_BATCH		256
+
+/** Maximum number of pages that queries may ask a running load to
+read before the others, see buf_load_prioritize() */
+#define BUF_LOAD_N_REQUESTS	64
+
+/** When a query misses a page, the pages of the dump in the same
+aligned area of this many pages are read before the others */
+#define BUF_LOAD_AREA		64
+
+/** State of a running buffer pool load, shared with the loader threads */
+struct buf_load_t {
+	const buf_dump_entry_t*	entries;/*!< the pages to load, hottest
+					first */
+	ulint		n_entries;	/*!< number of entries */
+	const buf_dump_t*	sorted;	/*!< the same pages, ordered by
+					space id and page number */
+	ulint		next;		/*!< first entry not yet claimed by
+					a loader thread */
+	ulint		n_read;		/*!< number of pages whose read was
+					issued, including pages read on
+					request */
+	ulint		n_threads_active;/*!< number of loader threads that
+					have not exited yet */
+	os_event_t	threads_done;	/*!< set when n_threads_active
+					drops to zero */
+	ulint		throttle_start;	/*!< ut_time_ms() at the start of
+					the current second of the load */
+	ulint		throttle_n_read;/*!< number of pages whose read was
+					issued in the current second */
+	ulint		throttle_activity;/*!< srv_get_activity_count() at
+					the start of the current second */
+};
+
+/** Protects buf_load_running, buf_load_requests, buf_load_n_requests and
+the mutable fields of the buf_load_t of a running load */
+static os_fast_mutex_t	buf_load_mutex;
+
+/** The running buffer pool load, or NULL; the pointer is also read
+without buf_load_mutex, as a hint */
+static buf_load_t*	buf_load_running = NULL;
+
+/** Pages that queries missed while a load was running */
+static buf_dump_t	buf_load_requests[BUF_LOAD_N_REQUESTS];
+
+/** Number of elements in buf_load_requests */
+static ulint		buf_load_n_requests = 0;
+
+/*****************************************************************//**
+Creates the mutex that protects the state of a running buffer pool load. */
+UNIV_INTERN
+void
+buf_load_init()
+/*===========*/
+{
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &buf_load_mutex);
+}
+
+/*****************************************************************//**
+Frees the mutex created in buf_load_init(). */
+UNIV_INTERN
+void
+buf_load_free()
+/*===========*/
+{
+	ut_ad(buf_load_running == NULL);
+
+	os_fast_mutex_free(&buf_load_mutex);
+}
+
 /*****************************************************************//**
 Wakes up the buffer pool dump/load thread and instructs it to start
 a dump. This function is called by MySQL code via buffer_pool_dump_now()
@@ -167,27 +266,65 @@ buf_load_status(
 	va_end(ap);
 }
 
+/*****************************************************************//**
+Writes dump entries to a binary buffer pool dump file.
+@return true on success */
+static
+bool
+buf_dump_write(
+/*===========*/
+	FILE*			f,	/*!< in: dump file */
+	byte*			buf,	/*!< in: buffer of BUF_DUMP_IO_BATCH
+					entries */
+	const buf_dump_entry_t*	dump,	/*!< in: entries to write */
+	ulint			n)	/*!< in: number of entries, at most
+					BUF_DUMP_IO_BATCH */
+{
+	byte*	ptr = buf;
+
+	ut_ad(n <= BUF_DUMP_IO_BATCH);
+
+	for (ulint i = 0; i < n; i++, ptr += BUF_DUMP_ENTRY_SIZE) {
+		mach_write_to_4(ptr, BUF_DUMP_SPACE(dump[i].id));
+		mach_write_to_4(ptr + 4, BUF_DUMP_PAGE(dump[i].id));
+		mach_write_to_4(ptr + 8, dump[i].n_accesses);
+		mach_write_to_4(ptr + 12, dump[i].lru_pos);
+	}
+
+	return(fwrite(buf, BUF_DUMP_ENTRY_SIZE, n, f) == n);
+}
+
 /*****************************************************************//**
 Perform a buffer pool dump into the file specified by
 innodb_buffer_pool_filename. If any errors occur then the value of
 innodb_buffer_pool_dump_status will be set accordingly, see buf_dump_status().
 The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The dump is written to a temporary file that replaces the old dump only
+when it is complete, so that a periodic dump never leaves a truncated
+file behind. Every dump halves the access counts of the pages, so that
+the counts favour recent accesses. */
 static
 void
 buf_dump(
 /*=====*/
-	ibool	obey_shutdown)	/*!< in: quit if we are in a shutting down
+	ibool	obey_shutdown,	/*!< in: quit if we are in a shutting down
 				state */
+	bool	periodic)	/*!< in: true if the dump was started by
+				innodb_buffer_pool_dump_interval; it is
+				then not reported in the error log */
 {
 #define SHOULD_QUIT()	(SHUTTING_DOWN() && obey_shutdown)
 
 	char	full_filename[OS_FILE_MAX_PATH];
 	char	tmp_filename[OS_FILE_MAX_PATH];
 	char	now[32];
+	byte	header[BUF_DUMP_HEADER_SIZE];
+	byte*	buf;
 	FILE*	f;
 	ulint	i;
 	int	ret;
+	enum status_severity	notice = periodic ? STATUS_INFO : STATUS_NOTICE;
 
 	ut_snprintf(full_filename, sizeof(full_filename),
 		    "%s%c%s", srv_data_home, SRV_PATH_SEPARATOR,
@@ -196,11 +333,15 @@ buf_dump(
 	ut_snprintf(tmp_filename, sizeof(tmp_filename),
 		    "%s.incomplete", full_filename);
 
-	buf_dump_status(STATUS_NOTICE, "Dumping buffer pool(s) to %s",
+	buf_dump_status(notice, "Dumping buffer pool(s) to %s",
 			full_filename);
 
-	f = fopen(tmp_filename, "w");
+	buf = static_cast<byte*>(
+		ut_malloc(BUF_DUMP_IO_BATCH * BUF_DUMP_ENTRY_SIZE));
+
+	f = fopen(tmp_filename, "wb");
 	if (f == NULL) {
+		ut_free(buf);
 		buf_dump_status(STATUS_ERR,
 				"Cannot open '%s' for writing: %s",
 				tmp_filename, strerror(errno));
@@ -208,11 +349,24 @@ buf_dump(
 	}
 	/* else */
 
+	mach_write_to_4(header, BUF_DUMP_MAGIC);
+	mach_write_to_4(header + 4, BUF_DUMP_VERSION);
+
+	if (fwrite(header, sizeof header, 1, f) != 1) {
+		ut_free(buf);
+		fclose(f);
+		buf_dump_status(STATUS_ERR,
+				"Cannot write to '%s': %s",
+				tmp_filename, strerror(errno));
+		/* leave tmp_filename to exist */
+		return;
+	}
+
 	/* walk through each buffer pool */
 	for (i = 0; i < srv_buf_pool_instances && !SHOULD_QUIT(); i++) {
 		buf_pool_t*		buf_pool;
-		const buf_page_t*	bpage;
-		buf_dump_t*		dump;
+		buf_page_t*		bpage;
+		buf_dump_entry_t*	dump;
 		ulint			n_pages;
 		ulint			j;
 
@@ -230,11 +384,12 @@ buf_dump(
 			continue;
 		}
 
-		dump = static_cast<buf_dump_t*>(
+		dump = static_cast<buf_dump_entry_t*>(
 			ut_malloc(n_pages * sizeof(*dump))) ;
 
 		if (dump == NULL) {
 			buf_pool_mutex_exit(buf_pool);
+			ut_free(buf);
 			fclose(f);
 			buf_dump_status(STATUS_ERR,
 					"Cannot allocate " ULINTPF " bytes: %s",
@@ -244,26 +399,36 @@ buf_dump(
 			return;
 		}
 
-		for (bpage = UT_LIST_GET_LAST(buf_pool->LRU), j = 0;
+		for (bpage = UT_LIST_GET_FIRST(buf_pool->LRU), j = 0;
 		     bpage != NULL;
-		     bpage = UT_LIST_GET_PREV(LRU, bpage), j++) {
+		     bpage = UT_LIST_GET_NEXT(LRU, bpage), j++) {
 
 			ut_a(buf_page_in_file(bpage));
 
-			dump[j] = BUF_DUMP_CREATE(buf_page_get_space(bpage),
-						  buf_page_get_page_no(bpage));
+			dump[j].id = BUF_DUMP_CREATE(
+				buf_page_get_space(bpage),
+				buf_page_get_page_no(bpage));
+			dump[j].n_accesses = bpage->n_accesses;
+			dump[j].lru_pos = (ib_uint32_t) j;
+
+			/* This races with buf_page_count_access(). Losing
+			an access or an aging step now and then does no
+			harm. */
+			bpage->n_accesses >>= 1;
 		}
 
 		ut_a(j == n_pages);
 
 		buf_pool_mutex_exit(buf_pool);
 
-		for (j = 0; j < n_pages && !SHOULD_QUIT(); j++) {
-			ret = fprintf(f, ULINTPF "," ULINTPF "\n",
-				      BUF_DUMP_SPACE(dump[j]),
-				      BUF_DUMP_PAGE(dump[j]));
-			if (ret < 0) {
+		for (j = 0; j < n_pages && !SHOULD_QUIT();
+		     j += BUF_DUMP_IO_BATCH) {
+
+			if (!buf_dump_write(f, buf, dump + j,
+					    ut_min(BUF_DUMP_IO_BATCH,
+						   n_pages - j))) {
 				ut_free(dump);
+				ut_free(buf);
 				fclose(f);
 				buf_dump_status(STATUS_ERR,
 						"Cannot write to '%s': %s",
@@ -272,20 +437,20 @@ buf_dump(
 				return;
 			}
 
-			if (j % 128 == 0) {
-				buf_dump_status(
-					STATUS_INFO,
-					"Dumping buffer pool "
-					ULINTPF "/" ULINTPF ", "
-					"page " ULINTPF "/" ULINTPF,
-					i + 1, srv_buf_pool_instances,
-					j + 1, n_pages);
-			}
+			buf_dump_status(
+				STATUS_INFO,
+				"Dumping buffer pool "
+				ULINTPF "/" ULINTPF ", "
+				"page " ULINTPF "/" ULINTPF,
+				i + 1, srv_buf_pool_instances,
+				j + 1, n_pages);
 		}
 
 		ut_free(dump);
 	}
 
+	ut_free(buf);
+
 	ret = fclose(f);
 	if (ret != 0) {
 		buf_dump_status(STATUS_ERR,
@@ -320,7 +485,7 @@ buf_dump(
 
 	ut_sprintf_timestamp(now);
 
-	buf_dump_status(STATUS_NOTICE,
+	buf_dump_status(notice,
 			"Buffer pool(s) dump completed at %s", now);
 }
 
@@ -361,54 +526,157 @@ buf_dump_sort(
 }
 
 /*****************************************************************//**
-Perform a buffer pool load from the file specified by
-innodb_buffer_pool_filename. If any errors occur then the value of
-innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
-The dump filename can be specified by (relative to srv_data_home):
-SET GLOBAL innodb_buffer_pool_filename='filename'; */
+Compare two buffer pool dump entries by how hot the pages were: the page
+with more accesses is hotter, and of equally accessed pages the one that
+was closer to the head of the LRU list.
+@return -1/0/1 if entry 1 is hotter/as hot/colder than entry 2 */
+static
+lint
+buf_dump_heat_cmp(
+/*==============*/
+	const buf_dump_entry_t&	e1,	/*!< in: buffer pool dump entry 1 */
+	const buf_dump_entry_t&	e2)	/*!< in: buffer pool dump entry 2 */
+{
+	if (e1.n_accesses != e2.n_accesses) {
+		return(e1.n_accesses > e2.n_accesses ? -1 : 1);
+	} else if (e1.lru_pos != e2.lru_pos) {
+		return(e1.lru_pos < e2.lru_pos ? -1 : 1);
+	}
+
+	return(buf_dump_cmp(e1.id, e2.id));
+}
+
+/*****************************************************************//**
+Sort buffer pool dump entries, hottest pages first. */
 static
 void
-buf_load()
-/*======*/
+buf_dump_heat_sort(
+/*===============*/
+	buf_dump_entry_t*	dump,	/*!< in/out: entries to sort */
+	buf_dump_entry_t*	tmp,	/*!< in/out: temp storage */
+	ulint			low,	/*!< in: lowest index (inclusive) */
+	ulint			high)	/*!< in: highest index
+					(non-inclusive) */
 {
-	char		full_filename[OS_FILE_MAX_PATH];
-	char		now[32];
-	FILE*		f;
-	buf_dump_t*	dump;
-	buf_dump_t*	dump_tmp;
-	ulint		dump_n;
-	ulint		total_buffer_pools_pages;
-	ulint		i;
-	ulint		space_id;
-	ulint		page_no;
-	int		fscanf_ret;
+	UT_SORT_FUNCTION_BODY(buf_dump_heat_sort, dump, tmp, low, high,
+			      buf_dump_heat_cmp);
+}
 
-	/* Ignore any leftovers from before */
-	buf_load_abort_flag = FALSE;
+/*****************************************************************//**
+Reads the entries of a binary buffer pool dump file. The file position
+must be just after the header.
+@return the entries, to be freed with ut_free(), or NULL on error; the
+error is reported with buf_load_status() */
+static
+buf_dump_entry_t*
+buf_load_read_binary(
+/*=================*/
+	FILE*		f,		/*!< in: dump file */
+	const char*	full_filename,	/*!< in: name of the dump file */
+	ulint*		dump_n)		/*!< out: number of entries */
+{
+	buf_dump_entry_t*	dump;
+	byte*			buf;
+	long			size;
+	ulint			n;
+
+	if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0
+	    || fseek(f, BUF_DUMP_HEADER_SIZE, SEEK_SET) != 0) {
+		buf_load_status(STATUS_ERR, "Error reading '%s': %s",
+				full_filename, strerror(errno));
+		return(NULL);
+	}
 
-	ut_snprintf(full_filename, sizeof(full_filename),
-		    "%s%c%s", srv_data_home, SRV_PATH_SEPARATOR,
-		    srv_buf_dump_filename);
+	size -= BUF_DUMP_HEADER_SIZE;
 
-	buf_load_status(STATUS_NOTICE,
-			"Loading buffer pool(s) from %s", full_filename);
+	if (size % BUF_DUMP_ENTRY_SIZE != 0) {
+		buf_load_status(STATUS_ERR,
+				"Error parsing '%s': the size of the file"
+				" is not a multiple of the entry size,"
+				" unable to load buffer pool",
+				full_filename);
+		return(NULL);
+	}
 
-	f = fopen(full_filename, "r");
-	if (f == NULL) {
+	n = (ulint) size / BUF_DUMP_ENTRY_SIZE;
+
+	dump = static_cast<buf_dump_entry_t*>(
+		ut_malloc(ut_max(n, 1) * sizeof(*dump)));
+	buf = static_cast<byte*>(
+		ut_malloc(BUF_DUMP_IO_BATCH * BUF_DUMP_ENTRY_SIZE));
+
+	if (dump == NULL || buf == NULL) {
+		ut_free(dump);
+		ut_free(buf);
 		buf_load_status(STATUS_ERR,
-				"Cannot open '%s' for reading: %s",
-				full_filename, strerror(errno));
-		return;
+				"Cannot allocate " ULINTPF " bytes: %s",
+				(ulint) (n * sizeof(*dump)),
+				strerror(errno));
+		return(NULL);
+	}
+
+	for (ulint i = 0; i < n && !SHUTTING_DOWN(); ) {
+		ulint		batch = ut_min(BUF_DUMP_IO_BATCH, n - i);
+		const byte*	ptr = buf;
+
+		if (fread(buf, BUF_DUMP_ENTRY_SIZE, batch, f) != batch) {
+			ut_free(dump);
+			ut_free(buf);
+			buf_load_status(STATUS_ERR,
+					"Error reading '%s', unable"
+					" to load buffer pool",
+					full_filename);
+			return(NULL);
+		}
+
+		for (ulint end = i + batch; i < end;
+		     i++, ptr += BUF_DUMP_ENTRY_SIZE) {
+			dump[i].id = BUF_DUMP_CREATE(mach_read_from_4(ptr),
+						     mach_read_from_4(ptr + 4));
+			dump[i].n_accesses = (ib_uint32_t)
+				mach_read_from_4(ptr + 8);
+			dump[i].lru_pos = (ib_uint32_t)
+				mach_read_from_4(ptr + 12);
+		}
 	}
-	/* else */
+
+	ut_free(buf);
+
+	*dump_n = n;
+
+	return(dump);
+}
+
+/*****************************************************************//**
+Reads the entries of a text buffer pool dump file that was written by an
+older version. Such a file has no access counts, and lists the least
+recently used pages first.
+@return the entries, to be freed with ut_free(), or NULL on error; the
+error is reported with buf_load_status() */
+static
+buf_dump_entry_t*
+buf_load_read_text(
+/*===============*/
+	FILE*		f,		/*!< in: dump file */
+	const char*	full_filename,	/*!< in: name of the dump file */
+	ulint*		dump_n)		/*!< out: number of entries */
+{
+	buf_dump_entry_t*	dump;
+	ulint			n;
+	ulint			i;
+	ulint			space_id;
+	ulint			page_no;
+	int			fscanf_ret;
+
+	rewind(f);
 
 	/* First scan the file to estimate how many entries are in it.
 	This file is tiny (approx 500KB per 1GB buffer pool), reading it
 	two times is fine. */
-	dump_n = 0;
+	n = 0;
 	while (fscanf(f, ULINTPF "," ULINTPF, &space_id, &page_no) == 2
 	       && !SHUTTING_DOWN()) {
-		dump_n++;
+		n++;
 	}
 
 	if (!SHUTTING_DOWN() && !feof(f)) {
@@ -419,49 +687,26 @@ buf_load()
 		} else {
 			what = "parsing";
 		}
-		fclose(f);
 		buf_load_status(STATUS_ERR, "Error %s '%s', "
 				"unable to load buffer pool (stage 1)",
 				what, full_filename);
-		return;
-	}
-
-	/* If dump is larger than the buffer pool(s), then we ignore the
-	extra trailing. This could happen if a dump is made, then buffer
-	pool is shrunk and then load it attempted. */
-	total_buffer_pools_pages = buf_pool_get_n_pages()
-		* srv_buf_pool_instances;
-	if (dump_n > total_buffer_pools_pages) {
-		dump_n = total_buffer_pools_pages;
+		return(NULL);
 	}
 
-	dump = static_cast<buf_dump_t*>(ut_malloc(dump_n * sizeof(*dump)));
+	dump = static_cast<buf_dump_entry_t*>(
+		ut_malloc(ut_max(n, 1) * sizeof(*dump)));
 
 	if (dump == NULL) {
-		fclose(f);
-		buf_load_status(STATUS_ERR,
-				"Cannot allocate " ULINTPF " bytes: %s",
-				(ulint) (dump_n * sizeof(*dump)),
-				strerror(errno));
-		return;
-	}
-
-	dump_tmp = static_cast<buf_dump_t*>(
-		ut_malloc(dump_n * sizeof(*dump_tmp)));
-
-	if (dump_tmp == NULL) {
-		ut_free(dump);
-		fclose(f);
 		buf_load_status(STATUS_ERR,
 				"Cannot allocate " ULINTPF " bytes: %s",
-				(ulint) (dump_n * sizeof(*dump_tmp)),
+				(ulint) (n * sizeof(*dump)),
 				strerror(errno));
-		return;
+		return(NULL);
 	}
 
 	rewind(f);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	for (i = 0; i < n && !SHUTTING_DOWN(); i++) {
 		fscanf_ret = fscanf(f, ULINTPF "," ULINTPF,
 				    &space_id, &page_no);
 
@@ -472,19 +717,15 @@ buf_load()
 			/* else */
 
 			ut_free(dump);
-			ut_free(dump_tmp);
-			fclose(f);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s', unable "
 					"to load buffer pool (stage 2)",
 					full_filename);
-			return;
+			return(NULL);
 		}
 
 		if (space_id > ULINT32_MASK || page_no > ULINT32_MASK) {
 			ut_free(dump);
-			ut_free(dump_tmp);
-			fclose(f);
 			buf_load_status(STATUS_ERR,
 					"Error parsing '%s': bogus "
 					"space,page " ULINTPF "," ULINTPF
@@ -493,20 +734,272 @@ buf_load()
 					full_filename,
 					space_id, page_no,
 					i);
-			return;
+			return(NULL);
 		}
 
-		dump[i] = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].id = BUF_DUMP_CREATE(space_id, page_no);
+		dump[i].n_accesses = 0;
+		dump[i].lru_pos = (ib_uint32_t) (n - 1 - i);
 	}
 
-	/* Set dump_n to the actual number of initialized elements,
-	i could be smaller than dump_n here if the file got truncated after
+	/* Set the number to the actual number of initialized elements,
+	i could be smaller than n here if the file got truncated after
 	we read it the first time. */
-	dump_n = i;
+	*dump_n = i;
+
+	return(dump);
+}
+
+/*****************************************************************//**
+Asks a running buffer pool load to read the pages of the dump that are
+near a page before the other pages. This is called when a query has to
+read a page from disk: the pages around it are likely to be needed
+soon, too. Does nothing if no load is running. */
+UNIV_INTERN
+void
+buf_load_prioritize(
+/*================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no)	/*!< in: page number */
+{
+	if (buf_load_running == NULL) {
+		return;
+	}
+
+	os_fast_mutex_lock(&buf_load_mutex);
+
+	if (buf_load_running != NULL
+	    && buf_load_n_requests < BUF_LOAD_N_REQUESTS) {
+
+		buf_load_requests[buf_load_n_requests++]
+			= BUF_DUMP_CREATE(space, page_no);
+	}
+
+	os_fast_mutex_unlock(&buf_load_mutex);
+}
+
+/*****************************************************************//**
+Fills the next batch of pages for a loader thread: the pages of the dump
+in the area of the pages that queries missed, and then the hottest pages
+that no thread has claimed yet. The caller must own buf_load_mutex.
+@return number of pages in the batch, 0 if the load is complete */
+static
+ulint
+buf_load_next_batch(
+/*================*/
+	buf_load_t*	load,	/*!< in/out: running load */
+	buf_dump_t*	batch)	/*!< out: BUF_LOAD_BATCH pages */
+{
+	ulint	n = 0;
+
+	while (buf_load_n_requests > 0 && n < BUF_LOAD_BATCH) {
+		buf_dump_t	req = buf_load_requests[--buf_load_n_requests];
+		buf_dump_t	low = req - BUF_DUMP_PAGE(req) % BUF_LOAD_AREA;
+		ulint		lo = 0;
+		ulint		hi = load->n_entries;
+
+		/* Find the first page of the area in the dump. */
+		while (lo < hi) {
+			ulint	mid = (lo + hi) / 2;
+
+			if (load->sorted[mid] < low) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+
+		for (; lo < load->n_entries && n < BUF_LOAD_BATCH
+		       && load->sorted[lo] < low + BUF_LOAD_AREA
+		       && BUF_DUMP_SPACE(load->sorted[lo])
+		       == BUF_DUMP_SPACE(req);
+		     lo++) {
+
+			batch[n++] = load->sorted[lo];
+		}
+	}
+
+	while (load->next < load->n_entries && n < BUF_LOAD_BATCH) {
+		batch[n++] = load->entries[load->next++].id;
+	}
+
+	load->n_read += n;
+	load->throttle_n_read += n;
+
+	return(n);
+}
+
+/*****************************************************************//**
+Limits a load to innodb_io_capacity page reads per second while the
+server is doing other work. An idle server is loaded at full speed. The
+caller must own buf_load_mutex.
+@return number of microseconds that a loader thread must sleep before
+it claims its next batch, or 0 */
+static
+ulint
+buf_load_throttle(
+/*==============*/
+	buf_load_t*	load)	/*!< in/out: running load */
+{
+	ulint	now = ut_time_ms();
+	ulint	activity = srv_get_activity_count();
+	ulint	elapsed = now - load->throttle_start;
+
+	if (elapsed >= 1000) {
+		load->throttle_start = now;
+		load->throttle_n_read = 0;
+		load->throttle_activity = activity;
+		return(0);
+	}
+
+	if (load->throttle_n_read < srv_io_capacity
+	    || activity == load->throttle_activity) {
+		return(0);
+	}
+
+	/* srv_io_capacity reads were issued during this second, and
+	there was other activity: wait for the next second. */
+	return((1000 - elapsed) * 1000);
+}
+
+/*****************************************************************//**
+A thread that issues asynchronous reads of the pages of a buffer pool
+load, a batch at a time. The pages of a batch are read in the order of
+their addresses, in order to increase the chance for sequential IO.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(buf_load_thread)(
+/*============================*/
+	void*	arg)	/*!< in: buf_load_t of the running load */
+{
+	buf_load_t*	load = static_cast<buf_load_t*>(arg);
+	buf_dump_t	batch[BUF_LOAD_BATCH];
+	buf_dump_t	tmp[BUF_LOAD_BATCH];
+	ulint		n;
+	ulint		sleep_us;
+
+	for (;;) {
+		os_fast_mutex_lock(&buf_load_mutex);
+
+		if (buf_load_abort_flag || SHUTTING_DOWN()) {
+			n = 0;
+			sleep_us = 0;
+		} else if ((sleep_us = buf_load_throttle(load)) > 0) {
+			n = 0;
+		} else {
+			n = buf_load_next_batch(load, batch);
+		}
+
+		os_fast_mutex_unlock(&buf_load_mutex);
+
+		if (sleep_us > 0) {
+			os_thread_sleep(sleep_us);
+			continue;
+		}
+
+		if (n == 0) {
+			break;
+		}
+
+		buf_dump_sort(batch, tmp, 0, n);
+
+		for (ulint i = 0; i < n; i++) {
+			buf_read_page_async(BUF_DUMP_SPACE(batch[i]),
+					    BUF_DUMP_PAGE(batch[i]));
+		}
+
+		os_aio_simulated_wake_handler_threads();
+	}
+
+	os_fast_mutex_lock(&buf_load_mutex);
+
+	if (--load->n_threads_active == 0) {
+		os_event_set(load->threads_done);
+	}
+
+	os_fast_mutex_unlock(&buf_load_mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*****************************************************************//**
+Perform a buffer pool load from the file specified by
+innodb_buffer_pool_filename. If any errors occur then the value of
+innodb_buffer_pool_load_status will be set accordingly, see buf_load_status().
+The dump filename can be specified by (relative to srv_data_home):
+SET GLOBAL innodb_buffer_pool_filename='filename';
+The hottest pages are read first, by innodb_buffer_pool_load_threads
+threads. */
+static
+void
+buf_load()
+/*======*/
+{
+	char			full_filename[OS_FILE_MAX_PATH];
+	char			now[32];
+	byte			header[BUF_DUMP_HEADER_SIZE];
+	FILE*			f;
+	buf_dump_entry_t*	dump;
+	buf_dump_entry_t*	dump_tmp;
+	buf_dump_t*		sorted;
+	buf_dump_t*		sorted_tmp;
+	ulint			dump_n;
+	ulint			total_buffer_pools_pages;
+	ulint			i;
+	buf_load_t		load;
+	ib_int64_t		sig_count;
+	ibool			aborted;
+
+	/* Ignore any leftovers from before */
+	buf_load_abort_flag = FALSE;
+
+	ut_snprintf(full_filename, sizeof(full_filename),
+		    "%s%c%s", srv_data_home, SRV_PATH_SEPARATOR,
+		    srv_buf_dump_filename);
+
+	buf_load_status(STATUS_NOTICE,
+			"Loading buffer pool(s) from %s", full_filename);
+
+	f = fopen(full_filename, "rb");
+	if (f == NULL) {
+		buf_load_status(STATUS_ERR,
+				"Cannot open '%s' for reading: %s",
+				full_filename, strerror(errno));
+		return;
+	}
+	/* else */
+
+	if (fread(header, sizeof header, 1, f) == 1
+	    && mach_read_from_4(header) == BUF_DUMP_MAGIC) {
+
+		if (mach_read_from_4(header + 4) != BUF_DUMP_VERSION) {
+			fclose(f);
+			buf_load_status(STATUS_ERR,
+					"Error parsing '%s': unknown version "
+					ULINTPF ", unable to load buffer pool",
+					full_filename,
+					mach_read_from_4(header + 4));
+			return;
+		}
+
+		dump = buf_load_read_binary(f, full_filename, &dump_n);
+	} else {
+		dump = buf_load_read_text(f, full_filename, &dump_n);
+	}
 
 	fclose(f);
 
-	if (dump_n == 0) {
+	if (dump == NULL) {
+		return;
+	}
+
+	if (dump_n == 0 || SHUTTING_DOWN()) {
 		ut_free(dump);
 		ut_sprintf_timestamp(now);
 		buf_load_status(STATUS_NOTICE,
@@ -515,39 +1008,116 @@ buf_load()
 		return;
 	}
 
-	if (!SHUTTING_DOWN()) {
-		buf_dump_sort(dump, dump_tmp, 0, dump_n);
+	dump_tmp = static_cast<buf_dump_entry_t*>(
+		ut_malloc(dump_n * sizeof(*dump_tmp)));
+
+	if (dump_tmp == NULL) {
+		ut_free(dump);
+		buf_load_status(STATUS_ERR,
+				"Cannot allocate " ULINTPF " bytes: %s",
+				(ulint) (dump_n * sizeof(*dump_tmp)),
+				strerror(errno));
+		return;
 	}
 
+	buf_dump_heat_sort(dump, dump_tmp, 0, dump_n);
+
 	ut_free(dump_tmp);
 
-	for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
+	/* If dump is larger than the buffer pool(s), then we ignore the
+	coldest pages. This could happen if a dump is made, then buffer
+	pool is shrunk and then load it attempted. */
+	total_buffer_pools_pages = buf_pool_get_n_pages()
+		* srv_buf_pool_instances;
+	if (dump_n > total_buffer_pools_pages) {
+		dump_n = total_buffer_pools_pages;
+	}
+
+	/* The addresses in ascending order, for finding the pages near
+	a page that a query missed, see buf_load_prioritize(). */
+	sorted = static_cast<buf_dump_t*>(
+		ut_malloc(dump_n * sizeof(*sorted)));
+	sorted_tmp = static_cast<buf_dump_t*>(
+		ut_malloc(dump_n * sizeof(*sorted_tmp)));
 
-		buf_read_page_async(BUF_DUMP_SPACE(dump[i]),
-				    BUF_DUMP_PAGE(dump[i]));
+	if (sorted == NULL || sorted_tmp == NULL) {
+		ut_free(sorted);
+		ut_free(dump);
+		buf_load_status(STATUS_ERR,
+				"Cannot allocate " ULINTPF " bytes: %s",
+				(ulint) (dump_n * sizeof(*sorted)),
+				strerror(errno));
+		return;
+	}
 
-		if (i % 64 == 63) {
-			os_aio_simulated_wake_handler_threads();
-		}
+	for (i = 0; i < dump_n; i++) {
+		sorted[i] = dump[i].id;
+	}
 
-		if (i % 128 == 0) {
-			buf_load_status(STATUS_INFO,
-					"Loaded " ULINTPF "/" ULINTPF " pages",
-					i + 1, dump_n);
-		}
+	buf_dump_sort(sorted, sorted_tmp, 0, dump_n);
+
+	ut_free(sorted_tmp);
+
+	load.entries = dump;
+	load.n_entries = dump_n;
+	load.sorted = sorted;
+	load.next = 0;
+	load.n_read = 0;
+	load.n_threads_active = srv_n_buf_load_threads;
+	load.throttle_start = ut_time_ms();
+	load.throttle_n_read = 0;
+	load.throttle_activity = srv_get_activity_count();
+	load.threads_done = os_event_create();
+	sig_count = os_event_reset(load.threads_done);
+
+	os_fast_mutex_lock(&buf_load_mutex);
+	buf_load_n_requests = 0;
+	buf_load_running = &load;
+	os_fast_mutex_unlock(&buf_load_mutex);
+
+	for (i = 0; i < srv_n_buf_load_threads; i++) {
+		os_thread_create(buf_load_thread, &load, NULL);
+	}
 
-		if (buf_load_abort_flag) {
-			buf_load_abort_flag = FALSE;
-			ut_free(dump);
-			buf_load_status(
-				STATUS_NOTICE,
-				"Buffer pool(s) load aborted on request");
-			return;
+	for (;;) {
+		ulint	n_read;
+		ulint	n_active;
+
+		os_event_wait_time_low(load.threads_done, 1000000, sig_count);
+
+		os_fast_mutex_lock(&buf_load_mutex);
+		n_read = load.n_read;
+		n_active = load.n_threads_active;
+		os_fast_mutex_unlock(&buf_load_mutex);
+
+		if (n_active == 0) {
+			break;
 		}
+
+		buf_load_status(STATUS_INFO,
+				"Loaded " ULINTPF "/" ULINTPF " pages",
+				ut_min(n_read, dump_n), dump_n);
 	}
 
+	os_fast_mutex_lock(&buf_load_mutex);
+	buf_load_running = NULL;
+	buf_load_n_requests = 0;
+	os_fast_mutex_unlock(&buf_load_mutex);
+
+	os_event_free(load.threads_done);
+
+	ut_free(sorted);
 	ut_free(dump);
 
+	aborted = buf_load_abort_flag;
+	buf_load_abort_flag = FALSE;
+
+	if (aborted) {
+		buf_load_status(STATUS_NOTICE,
+				"Buffer pool(s) load aborted on request");
+		return;
+	}
+
 	ut_sprintf_timestamp(now);
 
 	buf_load_status(STATUS_NOTICE,
@@ -569,7 +1139,8 @@ buf_load_abort()
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. If innodb_buffer_pool_dump_interval is set, it also dumps the
+buffer pool when it has not been waked up for that many seconds.
 @return this function does not return, it calls os_thread_exit() */
 extern "C" UNIV_INTERN
 os_thread_ret_t
@@ -578,6 +1149,8 @@ DECLARE_THREAD(buf_dump_thread)(
 	void*	arg __attribute__((unused)))	/*!< in: a dummy parameter
 						required by os_thread_create */
 {
+	ib_int64_t	sig_count;
+
 	ut_ad(!srv_read_only_mode);
 
 	srv_buf_dump_thread_active = TRUE;
@@ -585,30 +1158,42 @@ DECLARE_THREAD(buf_dump_thread)(
 	buf_dump_status(STATUS_INFO, "not started");
 	buf_load_status(STATUS_INFO, "not started");
 
+	sig_count = os_event_reset(srv_buf_dump_event);
+
 	if (srv_buffer_pool_load_at_startup) {
 		buf_load();
 	}
 
 	while (!SHUTTING_DOWN()) {
+		bool	periodic = false;
+
+		if (srv_buf_dump_interval == 0) {
+			os_event_wait_low(srv_buf_dump_event, sig_count);
+		} else if (os_event_wait_time_low(
+				   srv_buf_dump_event,
+				   srv_buf_dump_interval * 1000000,
+				   sig_count) == OS_SYNC_TIME_EXCEEDED) {
+			periodic = !SHUTTING_DOWN();
+		}
 
-		os_event_wait(srv_buf_dump_event);
+		sig_count = os_event_reset(srv_buf_dump_event);
 
 		if (buf_dump_should_start) {
 			buf_dump_should_start = FALSE;
-			buf_dump(TRUE /* quit on shutdown */);
+			buf_dump(TRUE /* quit on shutdown */, false);
+		} else if (periodic) {
+			buf_dump(TRUE /* quit on shutdown */, true);
 		}
 
 		if (buf_load_should_start) {
 			buf_load_should_start = FALSE;
 			buf_load();
 		}
-
-		os_event_reset(srv_buf_dump_event);
 	}
 
 	if (srv_buffer_pool_dump_at_shutdown && srv_fast_shutdown != 2) {
 		buf_dump(FALSE /* ignore shutdown down flag,
-		keep going even if we are in a shutdown state */);
+		keep going even if we are in a shutdown state */, false);
 	}
 
 	srv_buf_dump_thread_active = FALSE;
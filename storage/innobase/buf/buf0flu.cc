@@ -1040,7 +1040,7 @@ buf_flush_page(
 			/* avoiding deadlock possibility involves doublewrite
 			buffer, should flush it, because it might hold the
 			another block->lock. */
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_buffered_writes(NULL);
 
 			rw_lock_s_lock_gen(rw_lock, BUF_IO_WRITE);
                 }
@@ -1662,10 +1662,13 @@ Gather the aggregated stats for both flush list and LRU list flushing */
 void
 buf_flush_common(
 /*=============*/
+	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance that
+					was flushed, or NULL if the flush
+					covered several instances */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
-	buf_dblwr_flush_buffered_writes();
+	buf_dblwr_flush_buffered_writes(buf_pool);
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
@@ -1837,7 +1840,7 @@ buf_flush_list(
 
 		buf_flush_end(buf_pool, BUF_FLUSH_LIST);
 
-		buf_flush_common(BUF_FLUSH_LIST, n.flushed);
+		buf_flush_common(buf_pool, BUF_FLUSH_LIST, n.flushed);
 
 		if (n_processed) {
 			*n_processed += n.flushed;
@@ -1980,7 +1983,7 @@ buf_flush_LRU_tail(void)
 
 		buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-		buf_flush_common(BUF_FLUSH_LRU, n.flushed);
+		buf_flush_common(buf_pool, BUF_FLUSH_LRU, n.flushed);
 
 		if (n.flushed) {
 			MONITOR_INC_VALUE_CUMULATIVE(
@@ -220,7 +220,8 @@ buf_mtflu_flush_pool_instance(
 		&n);
 
 	buf_flush_end(work_item->wr.buf_pool, work_item->wr.flush_type);
-	buf_flush_common(work_item->wr.flush_type, n.flushed);
+	buf_flush_common(work_item->wr.buf_pool,
+			 work_item->wr.flush_type, n.flushed);
 	work_item->n_flushed = n.flushed;
 	work_item->n_evicted = n.evicted;
 
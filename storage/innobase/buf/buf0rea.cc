@@ -32,6 +32,7 @@ Created 11/5/1995 Heikki Tuuri
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "buf0dblwr.h"
+#include "buf0dump.h"
 #include "ibuf0ibuf.h"
 #include "log0recv.h"
 #include "trx0sys.h"
@@ -404,6 +405,10 @@ buf_read_page(
 
 	tablespace_version = fil_space_get_version(space);
 
+	/* If a buffer pool load is running, have it read the pages
+	near this one first, as they are likely to be needed soon. */
+	buf_load_prioritize(space, offset);
+
 	/* We do the i/o in the synchronous aio mode to save thread
 	switches: hence TRUE */
 
@@ -33,6 +33,7 @@ Created 4/24/1996 Heikki Tuuri
 
 #include "btr0pcur.h"
 #include "btr0btr.h"
+#include "btr0sea.h"
 #include "page0page.h"
 #include "mach0data.h"
 #include "dict0dict.h"
@@ -1773,6 +1774,7 @@ dict_load_index_low(
 
 	(*index)->id = id;
 	(*index)->page = mach_read_from_4(field);
+	btr_search_index_init(*index);
 	ut_ad((*index)->page);
 
 	return(NULL);
@@ -90,6 +90,8 @@ enum fts_msg_type_t {
 
 	FTS_MSG_DEL_TABLE,		/*!< Remove a table from the optimize
 					threads work queue */
+
+	FTS_MSG_SYNC_TABLE,		/*!< SYNC the cache of a table */
 };
 
 /** Compressed list of words that have been read from FTS INDEX
@@ -2331,6 +2333,10 @@ fts_optimize_indexes(
 
 	if (error == DB_SUCCESS) {
 		fts_sql_commit(optim->trx);
+
+		/* The optimized rows no longer contain the deleted doc ids
+		that are about to be purged from the DELETED table. */
+		fts_plist_cache_invalidate(optim->table->id);
 	} else {
 		fts_sql_rollback(optim->trx);
 	}
@@ -2605,6 +2611,28 @@ fts_optimize_do_table(
 	ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
 }
 
+/**********************************************************************//**
+Ask the optimize thread to SYNC the cache of a table in the background,
+so that the committing transactions need not wait for the SYNC. */
+UNIV_INTERN
+void
+fts_optimize_request_sync_table(
+/*============================*/
+	dict_table_t*	table)			/*!< in: table to sync */
+{
+	fts_msg_t*	msg;
+
+	/* Without the optimizer thread, SYNC in the calling thread. */
+	if (!fts_optimize_wq || fts_opt_start_shutdown) {
+		fts_sync_table(table, true, false);
+		return;
+	}
+
+	msg = fts_optimize_create_msg(FTS_MSG_SYNC_TABLE, table);
+
+	ib_wqueue_add(fts_optimize_wq, msg, msg->heap);
+}
+
 /**********************************************************************//**
 Remove the table from the OPTIMIZER's list. We do wait for
 acknowledgement from the consumer of the message. */
@@ -2782,6 +2810,37 @@ fts_optimize_del_table(
 	return(FALSE);
 }
 
+/**********************************************************************//**
+SYNC the cache of a table on request of a committing transaction. The
+cache lock is released while the words are written, so that transactions
+can keep adding documents to the cache meanwhile. */
+static
+void
+fts_optimize_sync_table(
+/*====================*/
+	const ib_vector_t*	tables,		/*!< in: registered tables
+						vector */
+	dict_table_t*		table)		/*!< in: table to sync */
+{
+	/* The table could have been removed after the request was
+	queued, do not look at it unless it is still registered. */
+	for (ulint i = 0; i < ib_vector_size(tables); ++i) {
+		const fts_slot_t*	slot;
+
+		slot = static_cast<const fts_slot_t*>(
+			ib_vector_get_const(tables, i));
+
+		if (slot->state != FTS_STATE_EMPTY && slot->table == table) {
+
+			if (table->fts) {
+				fts_sync_table(table, true, false);
+			}
+
+			return;
+		}
+	}
+}
+
 /**********************************************************************//**
 Calculate how many of the registered tables need to be optimized.
 @return no. of tables to optimize */
@@ -2912,7 +2971,7 @@ fts_optimize_need_sync(
 
 		if (table->fts->cache->added
 		    >= fts_optimize_add_threshold) {
-			fts_sync_table(table);
+			fts_sync_table(table, false, true);
 		} else if (deleted >= fts_optimize_delete_threshold) {
 			fts_optimize_do_table(table);
 
@@ -3048,6 +3107,15 @@ fts_optimize_thread(
 					((fts_msg_del_t*) msg->ptr)->event);
 				break;
 
+			case FTS_MSG_SYNC_TABLE:
+				if (!done) {
+					fts_optimize_sync_table(
+						tables,
+						static_cast<dict_table_t*>(
+						msg->ptr));
+				}
+				break;
+
 			default:
 				ut_error;
 			}
@@ -3083,7 +3151,7 @@ fts_optimize_thread(
 				if (table) {
 
 					if (dict_table_has_fts_index(table)) {
-						fts_sync_table(table);
+						fts_sync_table(table, false, true);
 					}
 
 					if (table->fts) {
@@ -33,6 +33,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0pars.h"
 #include "fts0types.h"
 #include "ha_prototypes.h"
+#include "hash0hash.h"
 #include <ctype.h>
 
 #ifndef UNIV_NONINL
@@ -40,6 +41,7 @@ Completed 2011/7/10 Sunny and Jimmy Yang
 #include "fts0vlc.ic"
 #endif
 
+#include <algorithm>
 #include <vector>
 
 #define FTS_ELEM(t, n, i, j) (t[(i) * n + (j)])
@@ -65,6 +67,9 @@ static const double FTS_NORMALIZE_COEFF = 0.0115F;
 typedef std::vector<fts_string_t>	word_vector_t;
 
 struct fts_word_freq_t;
+struct fts_plist_t;
+
+typedef std::vector<fts_plist_t*>	plist_vector_t;
 
 /** State of an FTS query. */
 struct fts_query_t {
@@ -148,6 +153,14 @@ struct fts_query_t {
 					fts_word_freq_t */
 
 	bool		multi_exist;	/*!< multiple FTS_EXIST oper */
+
+	plist_vector_t*	plists;		/*!< Posting lists of the query
+					terms, pinned until the query is
+					freed */
+
+	ib_uint64_t	plist_epoch;	/*!< fts_plist_cache.epoch before
+					trx got its read view; the lists
+					that trx reads are that old */
 };
 
 /** For phrase matching, first we collect the documents and the positions
@@ -237,6 +250,105 @@ struct fts_word_freq_t {
 	double		idf;		/*!< Inverse document frequency */
 };
 
+/** A document of a posting list */
+struct fts_posting_t {
+	doc_id_t	doc_id;		/*!< Document id */
+	ulint		freq;		/*!< Frequency of the word in the
+					document */
+};
+
+typedef std::vector<fts_posting_t>	posting_vector_t;
+
+/** The documents that contain a word, decoded from the ilists of all
+the FTS INDEX rows of the word and ordered by doc id. The lists of
+frequent terms are shared across queries in fts_plist_cache. */
+struct fts_plist_t {
+	table_id_t	table_id;	/*!< Id of the indexed table */
+	index_id_t	index_id;	/*!< Id of the FTS index */
+	fts_string_t	word;		/*!< The word, allocated with
+					ut_malloc() */
+	ib_uint64_t	doc_count;	/*!< Sum of the DOC_COUNT of the
+					rows of the word */
+	posting_vector_t postings;	/*!< The documents, by doc id */
+	ulint		size;		/*!< Memory used by the list */
+	ib_uint64_t	epoch;		/*!< fts_plist_cache.epoch before
+					the read view that the rows were
+					read with was created */
+	ulint		n_ref;		/*!< Number of queries that use the
+					list, protected by
+					fts_plist_cache.mutex */
+	bool		cached;		/*!< true if the list is in
+					fts_plist_cache, protected by
+					fts_plist_cache.mutex */
+	fts_plist_t*	hash;		/*!< Hash chain node */
+	UT_LIST_NODE_T(fts_plist_t)
+			lru;		/*!< LRU list node */
+};
+
+/** Cache of decoded posting lists, shared by all queries */
+struct fts_plist_cache_t {
+	os_fast_mutex_t	mutex;		/*!< Protects the fields below */
+	hash_table_t*	hash;		/*!< The cached lists, hashed on the
+					index id and the word */
+	UT_LIST_BASE_NODE_T(fts_plist_t)
+			lru;		/*!< The cached lists, the most
+					recently used first */
+	ulint		size;		/*!< Memory used by the cached
+					lists */
+	ib_uint64_t	epoch;		/*!< Incremented whenever SYNC or
+					OPTIMIZE modifies an FTS INDEX; a
+					list read in an older epoch may
+					be out of date */
+	ulint		n_prefetch_threads;/*!< Number of
+					fts_prefetch_thread() that have
+					not exited yet, at most
+					fts_query_max_prefetch_threads */
+};
+
+/** Argument of fts_plist_fetch_node() */
+struct fts_plist_fetch_t {
+	fts_plist_t*	plist;		/*!< The list being read */
+	bool		sorted;		/*!< false if the doc ids of the
+					rows were not ascending */
+	dberr_t		error;		/*!< Set if the list grew larger
+					than fts_result_cache_limit */
+};
+
+/** Posting lists read in parallel by fts_query_prefetch() */
+struct fts_prefetch_t {
+	const fts_table_t*
+			index_table;	/*!< FTS auxiliary index table def */
+	fts_plist_t**	plists;		/*!< The lists to read */
+	dberr_t*	errors;		/*!< Outcome of the read of each
+					list */
+	ulint		n_plists;	/*!< Number of lists to read */
+	ulint		next;		/*!< First list that is not yet
+					claimed by a thread */
+	ulint		n_threads_active;/*!< Number of threads that have
+					not exited yet */
+	os_fast_mutex_t	mutex;		/*!< Protects next and
+					n_threads_active */
+	os_event_t	threads_done;	/*!< Set when n_threads_active
+					drops to zero */
+};
+
+/** Number of cells in the hash table of fts_plist_cache */
+#define FTS_PLIST_CACHE_CELLS	1024
+
+/** Number of threads that read the posting lists of the terms of
+a query */
+UNIV_INTERN ulong	fts_query_threads = 4;
+
+/** Maximum number of threads that all the queries may run at a time to
+read posting lists, set at startup */
+UNIV_INTERN ulint	fts_query_max_prefetch_threads = 0;
+
+/** Maximum size of the cache of decoded posting lists, 0 disables it */
+UNIV_INTERN ulong	fts_posting_cache_size = 8 * 1024 * 1024;
+
+/** The cache of decoded posting lists */
+static fts_plist_cache_t	fts_plist_cache;
+
 /********************************************************************
 Callback function to fetch the rows in an FTS INDEX record.
 @return always TRUE */
@@ -263,6 +375,18 @@ fts_query_filter_doc_ids(
 	ibool			calc_doc_count);/*!< in: whether to remember doc
 						count */
 
+/*****************************************************************//**
+Depending upon the current query operator process the doc id.
+@return DB_SUCCESS or DB_FTS_EXCEED_RESULT_CACHE_LIMIT */
+static
+dberr_t
+fts_query_process_doc_id(
+/*=====================*/
+	fts_query_t*	query,		/*!< in: query instance */
+	doc_id_t	doc_id,		/*!< in: doc id to process */
+	fts_rank_t	rank);		/*!< in: if non-zero, it is the
+					rank associated with the doc_id */
+
 #if 0
 /*****************************************************************//***
 Find a doc_id in a word's ilist.
@@ -936,196 +1060,1197 @@ fts_query_free_doc_ids(
 
 		fts_ranking_t*	ranking;
 
-		ranking = rbt_value(fts_ranking_t, node);
+		ranking = rbt_value(fts_ranking_t, node);
+
+		if (ranking->words) {
+			ranking->words = NULL;
+		}
+
+		ut_free(rbt_remove_node(doc_ids, node));
+
+		ut_ad(query->total_size >=
+		      SIZEOF_RBT_NODE_ADD + sizeof(fts_ranking_t));
+		query->total_size -= SIZEOF_RBT_NODE_ADD
+			+ sizeof(fts_ranking_t);
+	}
+
+	rbt_free(doc_ids);
+
+	ut_ad(query->total_size >= SIZEOF_RBT_CREATE);
+	query->total_size -= SIZEOF_RBT_CREATE;
+}
+
+/*******************************************************************//**
+Add the word to the documents "list" of matching words from
+the query. We make a copy of the word from the query heap. */
+static
+void
+fts_query_add_word_to_document(
+/*===========================*/
+	fts_query_t*		query,	/*!< in: query to update */
+	doc_id_t		doc_id,	/*!< in: the document to update */
+	const fts_string_t*	word)	/*!< in: the token to add */
+{
+	ib_rbt_bound_t		parent;
+	fts_ranking_t*		ranking = NULL;
+
+	if (query->flags == FTS_OPT_RANKING) {
+		return;
+	}
+
+	/* First we search the intersection RB tree as it could have
+	taken ownership of the words rb tree instance. */
+	if (query->intersection
+	    && rbt_search(query->intersection, &parent, &doc_id) == 0) {
+
+		ranking = rbt_value(fts_ranking_t, parent.last);
+	}
+
+	if (ranking == NULL
+	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
+
+		ranking = rbt_value(fts_ranking_t, parent.last);
+	}
+
+	if (ranking != NULL) {
+		fts_ranking_words_add(query, ranking, word);
+	}
+}
+
+/*******************************************************************//**
+Check the node ilist. */
+static
+void
+fts_query_check_node(
+/*=================*/
+	fts_query_t*		query,	/*!< in: query to update */
+	const fts_string_t*	token,	/*!< in: the token to search */
+	const fts_node_t*	node)	/*!< in: node to check */
+{
+	/* Skip nodes whose doc ids are out range. */
+	if (query->oper == FTS_EXIST
+	    && ((query->upper_doc_id > 0
+		&& node->first_doc_id > query->upper_doc_id)
+		|| (query->lower_doc_id > 0
+		    && node->last_doc_id < query->lower_doc_id))) {
+
+		/* Ignore */
+
+	} else {
+		int		ret;
+		ib_rbt_bound_t	parent;
+		ulint		ilist_size = node->ilist_size;
+		fts_word_freq_t*word_freqs;
+
+		/* The word must exist. */
+		ret = rbt_search(query->word_freqs, &parent, token);
+		ut_a(ret == 0);
+
+		word_freqs = rbt_value(fts_word_freq_t, parent.last);
+
+		query->error = fts_query_filter_doc_ids(
+					query, token, word_freqs, node,
+					node->ilist, ilist_size, TRUE);
+	}
+}
+
+/*****************************************************************//**
+Search index cache for word with wildcard match.
+@return number of words matched */
+static
+ulint
+fts_cache_find_wildcard(
+/*====================*/
+	fts_query_t*		query,		/*!< in: query instance */
+	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
+	const fts_string_t*	token)		/*!< in: token to search */
+{
+	ib_rbt_bound_t		parent;
+	const ib_vector_t*	nodes = NULL;
+	fts_string_t		srch_text;
+	byte			term[FTS_MAX_WORD_LEN + 1];
+	ulint			num_word = 0;
+
+	srch_text.f_len = (token->f_str[token->f_len - 1] == '%')
+			? token->f_len - 1
+			: token->f_len;
+
+	strncpy((char*) term, (char*) token->f_str, srch_text.f_len);
+	term[srch_text.f_len] = '\0';
+	srch_text.f_str = term;
+
+	/* Lookup the word in the rb tree */
+	if (rbt_search_cmp(index_cache->words, &parent, &srch_text, NULL,
+			   innobase_fts_text_cmp_prefix) == 0) {
+		const fts_tokenizer_word_t*     word;
+		ulint				i;
+		const ib_rbt_node_t*		cur_node;
+		ibool				forward = FALSE;
+
+		word = rbt_value(fts_tokenizer_word_t, parent.last);
+		cur_node = parent.last;
+
+		while (innobase_fts_text_cmp_prefix(
+			index_cache->charset, &srch_text, &word->text) == 0) {
+
+			nodes = word->nodes;
+
+			for (i = 0; nodes && i < ib_vector_size(nodes); ++i) {
+				int                     ret;
+				const fts_node_t*       node;
+				ib_rbt_bound_t          freq_parent;
+				fts_word_freq_t*	word_freqs;
+
+				node = static_cast<const fts_node_t*>(
+					ib_vector_get_const(nodes, i));
+
+				ret = rbt_search(query->word_freqs,
+						 &freq_parent,
+						 &srch_text);
+
+				ut_a(ret == 0);
+
+				word_freqs = rbt_value(
+					fts_word_freq_t,
+					freq_parent.last);
+
+				query->error = fts_query_filter_doc_ids(
+					query, &srch_text,
+					word_freqs, node,
+					node->ilist, node->ilist_size, TRUE);
+
+				if (query->error != DB_SUCCESS) {
+					return(0);
+				}
+			}
+
+			num_word++;
+
+			if (!forward) {
+				cur_node = rbt_prev(
+					index_cache->words, cur_node);
+			} else {
+cont_search:
+				cur_node = rbt_next(
+					index_cache->words, cur_node);
+			}
+
+			if (!cur_node) {
+				break;
+			}
+
+			word = rbt_value(fts_tokenizer_word_t, cur_node);
+		}
+
+		if (!forward) {
+			forward = TRUE;
+			cur_node = parent.last;
+			goto cont_search;
+		}
+	}
+
+	return(num_word);
+}
+
+/*******************************************************************//**
+Fold the index id and the word of a posting list.
+@return fold value */
+static
+ulint
+fts_plist_fold(
+/*===========*/
+	index_id_t		index_id,	/*!< in: FTS index id */
+	const fts_string_t*	word)		/*!< in: the word */
+{
+	return(ut_fold_ulint_pair(ut_fold_ull(index_id),
+				  ut_fold_binary(word->f_str, word->f_len)));
+}
+
+/*******************************************************************//**
+Free a posting list. */
+static
+void
+fts_plist_free(
+/*===========*/
+	fts_plist_t*	plist)		/*!< in, own: list to free */
+{
+	ut_free(plist->word.f_str);
+
+	delete plist;
+}
+
+/*******************************************************************//**
+Remove a posting list from the cache and free it, unless a query still
+uses it. The caller must hold fts_plist_cache.mutex. */
+static
+void
+fts_plist_cache_remove(
+/*===================*/
+	fts_plist_t*	plist)		/*!< in: cached list */
+{
+	ut_ad(plist->cached);
+
+	HASH_DELETE(fts_plist_t, hash, fts_plist_cache.hash,
+		    fts_plist_fold(plist->index_id, &plist->word), plist);
+
+	UT_LIST_REMOVE(lru, fts_plist_cache.lru, plist);
+
+	ut_ad(fts_plist_cache.size >= plist->size);
+	fts_plist_cache.size -= plist->size;
+
+	plist->cached = false;
+
+	if (plist->n_ref == 0) {
+		fts_plist_free(plist);
+	}
+}
+
+/*******************************************************************//**
+Create the cache of decoded posting lists. */
+UNIV_INTERN
+void
+fts_plist_cache_init(void)
+/*======================*/
+{
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &fts_plist_cache.mutex);
+
+	fts_plist_cache.hash = hash_create(FTS_PLIST_CACHE_CELLS);
+
+	UT_LIST_INIT(fts_plist_cache.lru);
+
+	fts_plist_cache.size = 0;
+	fts_plist_cache.epoch = 0;
+	fts_plist_cache.n_prefetch_threads = 0;
+}
+
+/*******************************************************************//**
+Free the cache of decoded posting lists. */
+UNIV_INTERN
+void
+fts_plist_cache_free(void)
+/*======================*/
+{
+	fts_plist_t*	plist;
+
+	while ((plist = UT_LIST_GET_LAST(fts_plist_cache.lru)) != NULL) {
+		ut_ad(plist->n_ref == 0);
+
+		fts_plist_cache_remove(plist);
+	}
+
+	hash_table_free(fts_plist_cache.hash);
+
+	os_fast_mutex_free(&fts_plist_cache.mutex);
+}
+
+/*******************************************************************//**
+Remove the posting lists of a table from the cache. This must be called
+after SYNC or OPTIMIZE has committed changes to the FTS INDEX tables of
+the table. Lists that queries are reading at the same time are not
+added to the cache afterwards. */
+UNIV_INTERN
+void
+fts_plist_cache_invalidate(
+/*=======================*/
+	table_id_t	table_id)	/*!< in: table id */
+{
+	fts_plist_t*	plist;
+	fts_plist_t*	prev;
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+
+	++fts_plist_cache.epoch;
+
+	for (plist = UT_LIST_GET_LAST(fts_plist_cache.lru);
+	     plist != NULL;
+	     plist = prev) {
+
+		prev = UT_LIST_GET_PREV(lru, plist);
+
+		if (plist->table_id == table_id) {
+			fts_plist_cache_remove(plist);
+		}
+	}
+
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+}
+
+/*******************************************************************//**
+Get the current epoch of the posting list cache. A list may only be
+cached if it was read with a read view created after the epoch was
+taken and the epoch has not changed since.
+@return fts_plist_cache.epoch */
+static
+ib_uint64_t
+fts_plist_cache_get_epoch(void)
+/*===========================*/
+{
+	ib_uint64_t	epoch;
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+	epoch = fts_plist_cache.epoch;
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	return(epoch);
+}
+
+/*******************************************************************//**
+Create an empty posting list, pinned by the caller.
+@return new list */
+static
+fts_plist_t*
+fts_plist_create(
+/*=============*/
+	const dict_index_t*	index,	/*!< in: FTS index */
+	const fts_string_t*	word,	/*!< in: the word */
+	ib_uint64_t		epoch)	/*!< in: fts_plist_cache.epoch
+					before the read view that the
+					list will be read with was
+					created */
+{
+	fts_plist_t*	plist = new fts_plist_t;
+
+	plist->table_id = index->table->id;
+	plist->index_id = index->id;
+
+	plist->word.f_str = static_cast<byte*>(ut_malloc(word->f_len + 1));
+	memcpy(plist->word.f_str, word->f_str, word->f_len);
+	plist->word.f_str[word->f_len] = 0;
+	plist->word.f_len = word->f_len;
+	plist->word.f_n_char = word->f_n_char;
+
+	plist->doc_count = 0;
+	plist->size = 0;
+	plist->n_ref = 1;
+	plist->cached = false;
+	plist->hash = NULL;
+	plist->epoch = epoch;
+
+	return(plist);
+}
+
+/*******************************************************************//**
+Look up a posting list in the cache and pin it.
+@return the list, or NULL if it is not cached */
+static
+fts_plist_t*
+fts_plist_cache_get(
+/*================*/
+	const dict_index_t*	index,	/*!< in: FTS index */
+	const fts_string_t*	word)	/*!< in: the word */
+{
+	fts_plist_t*	plist;
+	ulint		fold = fts_plist_fold(index->id, word);
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+
+	HASH_SEARCH(hash, fts_plist_cache.hash, fold, fts_plist_t*, plist,
+		    ut_ad(plist->cached),
+		    plist->index_id == index->id
+		    && plist->word.f_len == word->f_len
+		    && !memcmp(plist->word.f_str, word->f_str, word->f_len));
+
+	if (plist != NULL) {
+		++plist->n_ref;
+
+		UT_LIST_REMOVE(lru, fts_plist_cache.lru, plist);
+		UT_LIST_ADD_FIRST(lru, fts_plist_cache.lru, plist);
+	}
+
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	return(plist);
+}
+
+/*******************************************************************//**
+Add a posting list that the caller has read to the cache, evicting the
+least recently used lists to make room. The list is not added if it is
+larger than the cache, if it was read with a read view that may not see
+the changes of the last SYNC or OPTIMIZE, or if another query cached it
+first. */
+static
+void
+fts_plist_cache_add(
+/*================*/
+	fts_plist_t*	plist)		/*!< in: list pinned by the caller */
+{
+	fts_plist_t*	old;
+	ulint		fold = fts_plist_fold(plist->index_id, &plist->word);
+	ulint		max_size = fts_posting_cache_size;
+
+	ut_ad(!plist->cached);
+	ut_ad(plist->n_ref > 0);
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+
+	if (plist->epoch != fts_plist_cache.epoch || plist->size > max_size) {
+		os_fast_mutex_unlock(&fts_plist_cache.mutex);
+		return;
+	}
+
+	HASH_SEARCH(hash, fts_plist_cache.hash, fold, fts_plist_t*, old,
+		    ut_ad(old->cached),
+		    old->index_id == plist->index_id
+		    && old->word.f_len == plist->word.f_len
+		    && !memcmp(old->word.f_str, plist->word.f_str,
+			       plist->word.f_len));
+
+	if (old == NULL) {
+		while (fts_plist_cache.size + plist->size > max_size) {
+			fts_plist_cache_remove(
+				UT_LIST_GET_LAST(fts_plist_cache.lru));
+		}
+
+		HASH_INSERT(fts_plist_t, hash, fts_plist_cache.hash, fold,
+			    plist);
+
+		UT_LIST_ADD_FIRST(lru, fts_plist_cache.lru, plist);
+
+		fts_plist_cache.size += plist->size;
+		plist->cached = true;
+	}
+
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+}
+
+/*******************************************************************//**
+Unpin a posting list, and free it if it is no longer cached and no
+other query uses it. */
+static
+void
+fts_plist_release(
+/*==============*/
+	fts_plist_t*	plist)		/*!< in: list pinned by the caller */
+{
+	bool	free_plist;
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+
+	ut_ad(plist->n_ref > 0);
+
+	free_plist = --plist->n_ref == 0 && !plist->cached;
+
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	if (free_plist) {
+		fts_plist_free(plist);
+	}
+}
+
+/*******************************************************************//**
+Check whether a pinned posting list is up to date: it is either still
+cached, or no SYNC or OPTIMIZE was committed since it was read.
+@return true if the list is up to date */
+static
+bool
+fts_plist_is_current(
+/*=================*/
+	const fts_plist_t*	plist)	/*!< in: list pinned by the caller */
+{
+	bool	current;
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+
+	current = plist->cached || plist->epoch == fts_plist_cache.epoch;
+
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	return(current);
+}
+
+/*******************************************************************//**
+Compare the doc ids of two postings.
+@return true if p1 comes before p2 */
+static
+bool
+fts_posting_doc_id_lt(
+/*==================*/
+	const fts_posting_t&	p1,	/*!< in: posting */
+	const fts_posting_t&	p2)	/*!< in: posting */
+{
+	return(p1.doc_id < p2.doc_id);
+}
+
+/*******************************************************************//**
+Compare the doc ids of two postings.
+@return true if the postings are for the same document */
+static
+bool
+fts_posting_doc_id_eq(
+/*==================*/
+	const fts_posting_t&	p1,	/*!< in: posting */
+	const fts_posting_t&	p2)	/*!< in: posting */
+{
+	return(p1.doc_id == p2.doc_id);
+}
+
+/*******************************************************************//**
+Compare the doc id of a posting with a doc id.
+@return true if the posting comes before the doc id */
+static
+bool
+fts_posting_lt_doc_id(
+/*==================*/
+	const fts_posting_t&	posting,	/*!< in: posting */
+	doc_id_t		doc_id)		/*!< in: doc id */
+{
+	return(posting.doc_id < doc_id);
+}
+
+/*******************************************************************//**
+Find the first posting at or after pos whose doc id is not less than
+doc_id. The distance from pos is doubled until such a posting is passed
+and the last step is then binary searched, so that the cost grows with
+the logarithm of the number of postings that are skipped.
+@return the posting, or end if there is none */
+static
+const fts_posting_t*
+fts_posting_gallop(
+/*===============*/
+	const fts_posting_t*	pos,	/*!< in: first posting to look at */
+	const fts_posting_t*	end,	/*!< in: end of the postings */
+	doc_id_t		doc_id)	/*!< in: doc id to look for */
+{
+	ulint	n = end - pos;
+	ulint	bound = 1;
+
+	if (n == 0 || pos->doc_id >= doc_id) {
+		return(pos);
+	}
+
+	while (bound < n && pos[bound].doc_id < doc_id) {
+		bound <<= 1;
+	}
+
+	/* pos[bound / 2] is before doc_id, pos[bound] is not. */
+	return(std::lower_bound(pos + bound / 2 + 1, pos + ut_min(bound, n),
+				doc_id, fts_posting_lt_doc_id));
+}
+
+/*******************************************************************//**
+Decode the ilist of an FTS INDEX row and append its documents to the
+posting list that is being read. */
+static
+void
+fts_plist_decode_ilist(
+/*===================*/
+	fts_plist_fetch_t*	arg,	/*!< in/out: list being read */
+	const fts_node_t*	node,	/*!< in: the row */
+	byte*			data,	/*!< in: doc id ilist */
+	ulint			len)	/*!< in: doc id ilist size */
+{
+	posting_vector_t&	postings = arg->plist->postings;
+	byte*			ptr = data;
+	doc_id_t		doc_id = 0;
+
+	while (ulint(ptr - data) < len) {
+		fts_posting_t	posting;
+		ulint		pos = fts_decode_vlc(&ptr);
+
+		/* Some sanity checks. */
+		if (doc_id == 0) {
+			ut_a(pos == node->first_doc_id);
+		}
+
+		/* Add the delta. */
+		doc_id += pos;
+
+		posting.doc_id = doc_id;
+		posting.freq = 0;
+
+		/* Count the positions within the document. */
+		while (*ptr) {
+			fts_decode_vlc(&ptr);
+			++posting.freq;
+		}
+
+		/* Skip the end of word position marker. */
+		++ptr;
+
+		if (!postings.empty() && doc_id <= postings.back().doc_id) {
+			arg->sorted = false;
+		}
+
+		postings.push_back(posting);
+	}
+
+	/* Some sanity checks. */
+	ut_a(doc_id == node->last_doc_id);
+}
+
+/*******************************************************************//**
+Callback function to decode the rows of an FTS INDEX word into a
+posting list.
+@return FALSE if the list grew larger than fts_result_cache_limit */
+static
+ibool
+fts_plist_fetch_node(
+/*=================*/
+	void*		row,		/*!< in: sel_node_t* */
+	void*		user_arg)	/*!< in: pointer to fts_fetch_t */
+{
+	sel_node_t*		sel_node = static_cast<sel_node_t*>(row);
+	fts_fetch_t*		fetch = static_cast<fts_fetch_t*>(user_arg);
+	fts_plist_fetch_t*	arg = static_cast<fts_plist_fetch_t*>(
+		fetch->read_arg);
+	fts_plist_t*		plist = arg->plist;
+	fts_node_t		node;
+	que_node_t*		exp;
+	ulint			i;
+
+	memset(&node, 0, sizeof(node));
+
+	/* Skip the WORD column, all rows are of the same word. */
+	exp = que_node_get_next(sel_node->select_list);
+
+	for (i = 1; exp; exp = que_node_get_next(exp), ++i) {
+		dfield_t*	dfield = que_node_get_val(exp);
+		byte*		data = static_cast<byte*>(
+			dfield_get_data(dfield));
+		ulint		len = dfield_get_len(dfield);
+
+		ut_a(len != UNIV_SQL_NULL);
+
+		/* Note: The column numbers below must match the SELECT
+		in fts_index_fetch_nodes(). */
+
+		switch (i) {
+		case 1: /* DOC_COUNT */
+			plist->doc_count += mach_read_from_4(data);
+			break;
+
+		case 2: /* FIRST_DOC_ID */
+			node.first_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 3: /* LAST_DOC_ID */
+			node.last_doc_id = fts_read_doc_id(data);
+			break;
+
+		case 4: /* ILIST */
+			fts_plist_decode_ilist(arg, &node, data, len);
+			break;
+
+		default:
+			ut_error;
+		}
+	}
+
+	/* Make sure all columns were read. */
+	ut_a(i == 5);
+
+	if (plist->postings.size() * sizeof(fts_posting_t)
+	    > fts_result_cache_limit) {
+
+		arg->error = DB_FTS_EXCEED_RESULT_CACHE_LIMIT;
+
+		return(FALSE);
+	}
+
+	return(TRUE);
+}
+
+/*******************************************************************//**
+Read the rows of the word of a posting list from the FTS INDEX and
+decode them into the list.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+fts_plist_fetch(
+/*============*/
+	trx_t*			trx,		/*!< in: transaction */
+	const fts_table_t*	index_table,	/*!< in: FTS auxiliary index
+						table def */
+	fts_plist_t*		plist)		/*!< in/out: list to read */
+{
+	fts_fetch_t		fetch;
+	fts_plist_fetch_t	arg;
+	que_t*			graph = NULL;
+	dberr_t			error;
+	posting_vector_t&	postings = plist->postings;
+
+	/* fts_index_fetch_nodes() sets the suffix of the table def,
+	which other threads may be reading too. */
+	fts_table_t		fts_table = *index_table;
+
+	arg.plist = plist;
+	arg.sorted = true;
+	arg.error = DB_SUCCESS;
+
+	fetch.read_arg = &arg;
+	fetch.read_record = fts_plist_fetch_node;
+
+	error = fts_index_fetch_nodes(
+		trx, &graph, &fts_table, &plist->word, &fetch);
+
+	fts_que_graph_free(graph);
+
+	if (error == DB_SUCCESS) {
+		error = arg.error;
+	}
+
+	if (error == DB_SUCCESS && !arg.sorted) {
+		/* The doc id ranges of the rows overlap, or a read was
+		retried. Like fts_query_filter_doc_ids(), keep the first
+		frequency read for a document. */
+		std::stable_sort(postings.begin(), postings.end(),
+				 fts_posting_doc_id_lt);
+
+		postings.erase(std::unique(postings.begin(), postings.end(),
+					   fts_posting_doc_id_eq),
+			       postings.end());
+	}
+
+	plist->size = sizeof(*plist) + plist->word.f_len
+		+ postings.capacity() * sizeof(fts_posting_t);
+
+	return(error);
+}
+
+/*******************************************************************//**
+Read the posting lists of fts_prefetch_t that no other thread has
+claimed yet. */
+static
+void
+fts_prefetch_run(
+/*=============*/
+	fts_prefetch_t*	prefetch,	/*!< in/out: lists to read */
+	trx_t*		trx)		/*!< in: transaction */
+{
+	for (;;) {
+		ulint	i;
+
+		os_fast_mutex_lock(&prefetch->mutex);
+
+		i = prefetch->next < prefetch->n_plists
+			? prefetch->next++ : ULINT_UNDEFINED;
+
+		os_fast_mutex_unlock(&prefetch->mutex);
+
+		if (i == ULINT_UNDEFINED) {
+			break;
+		}
+
+		prefetch->errors[i] = fts_plist_fetch(
+			trx, prefetch->index_table, prefetch->plists[i]);
+	}
+}
+
+/*******************************************************************//**
+A thread that reads posting lists for fts_query_prefetch().
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(fts_prefetch_thread)(
+/*================================*/
+	void*	arg)	/*!< in: fts_prefetch_t of the query */
+{
+	fts_prefetch_t*	prefetch = static_cast<fts_prefetch_t*>(arg);
+	trx_t*		trx = trx_allocate_for_background();
+
+	trx->op_info = "FTS query prefetch";
+
+	fts_prefetch_run(prefetch, trx);
+
+	trx_free_for_background(trx);
+
+	os_fast_mutex_lock(&prefetch->mutex);
+
+	if (--prefetch->n_threads_active == 0) {
+		os_event_set(prefetch->threads_done);
+	}
+
+	os_fast_mutex_unlock(&prefetch->mutex);
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+	ut_ad(fts_plist_cache.n_prefetch_threads > 0);
+	fts_plist_cache.n_prefetch_threads--;
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Collect the distinct terms of an expression list, and of its nested
+lists, that are searched without a wildcard. */
+static
+void
+fts_query_collect_terms(
+/*====================*/
+	const fts_ast_node_t*	node,	/*!< in: first node of the list */
+	word_vector_t*		terms)	/*!< in/out: terms */
+{
+	for (; node != NULL; node = node->next) {
+		switch (node->type) {
+		case FTS_AST_TERM:
+			if (!node->term.wildcard && node->term.ptr->len > 0) {
+				fts_string_t			term;
+				word_vector_t::const_iterator	it;
+
+				term.f_str = node->term.ptr->str;
+				term.f_len = node->term.ptr->len;
+				term.f_n_char = 0;
+
+				for (it = terms->begin();
+				     it != terms->end(); ++it) {
+					if (it->f_len == term.f_len
+					    && !memcmp(it->f_str, term.f_str,
+						       term.f_len)) {
+						break;
+					}
+				}
+
+				if (it == terms->end()) {
+					terms->push_back(term);
+				}
+			}
+			break;
+
+		case FTS_AST_LIST:
+		case FTS_AST_SUBEXP_LIST:
+			fts_query_collect_terms(node->list.head, terms);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*******************************************************************//**
+Read the posting lists of the query terms that are not cached with up
+to fts_query_threads threads, before the query is evaluated term by
+term. The threads are taken from fts_query_max_prefetch_threads; when
+none are left, the query thread reads all the lists. A list that cannot
+be read is read again, and the error reported, when its term is
+evaluated. */
+static
+void
+fts_query_prefetch(
+/*===============*/
+	fts_query_t*	query)		/*!< in/out: query instance */
+{
+	word_vector_t		terms;
+	plist_vector_t		missing;
+	fts_prefetch_t		prefetch;
+	ulint			n_threads;
+	ib_int64_t		sig_count;
+
+	if (fts_query_threads < 2) {
+		return;
+	}
+
+	fts_query_collect_terms(query->root, &terms);
+
+	if (terms.size() < 2) {
+		return;
+	}
+
+	for (word_vector_t::const_iterator it = terms.begin();
+	     it != terms.end(); ++it) {
+		fts_plist_t*	plist;
+
+		plist = fts_plist_cache_get(query->index, &*it);
+
+		if (plist != NULL) {
+			query->plists->push_back(plist);
+		} else {
+			/* The lists read by the prefetch threads
+			are newer than the query's read view, so
+			the epoch of the query is safe for them. */
+			missing.push_back(fts_plist_create(
+				query->index, &*it, query->plist_epoch));
+		}
+	}
 
-		if (ranking->words) {
-			ranking->words = NULL;
+	/* A single list is read when its term is evaluated. */
+	if (missing.size() < 2) {
+		for (ulint i = 0; i < missing.size(); ++i) {
+			fts_plist_release(missing[i]);
 		}
 
-		ut_free(rbt_remove_node(doc_ids, node));
+		return;
+	}
 
-		ut_ad(query->total_size >=
-		      SIZEOF_RBT_NODE_ADD + sizeof(fts_ranking_t));
-		query->total_size -= SIZEOF_RBT_NODE_ADD
-			+ sizeof(fts_ranking_t);
+	std::vector<dberr_t>	errors(missing.size(), DB_SUCCESS);
+
+	prefetch.index_table = &query->fts_index_table;
+	prefetch.plists = &missing[0];
+	prefetch.errors = &errors[0];
+	prefetch.n_plists = missing.size();
+	prefetch.next = 0;
+
+	/* The query thread reads lists too. */
+	n_threads = ut_min(ulint(fts_query_threads), missing.size()) - 1;
+
+	os_fast_mutex_lock(&fts_plist_cache.mutex);
+	ut_ad(fts_plist_cache.n_prefetch_threads
+	      <= fts_query_max_prefetch_threads);
+	n_threads = ut_min(n_threads,
+			   fts_query_max_prefetch_threads
+			   - fts_plist_cache.n_prefetch_threads);
+	fts_plist_cache.n_prefetch_threads += n_threads;
+	os_fast_mutex_unlock(&fts_plist_cache.mutex);
+
+	prefetch.n_threads_active = n_threads;
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &prefetch.mutex);
+	prefetch.threads_done = os_event_create();
+	sig_count = os_event_reset(prefetch.threads_done);
+
+	for (ulint i = 0; i < n_threads; ++i) {
+		os_thread_create(fts_prefetch_thread, &prefetch, NULL);
 	}
 
-	rbt_free(doc_ids);
+	fts_prefetch_run(&prefetch, query->trx);
 
-	ut_ad(query->total_size >= SIZEOF_RBT_CREATE);
-	query->total_size -= SIZEOF_RBT_CREATE;
+	if (n_threads > 0) {
+		os_event_wait_low(prefetch.threads_done, sig_count);
+	}
+
+	os_fast_mutex_lock(&prefetch.mutex);
+	ut_a(prefetch.n_threads_active == 0);
+	os_fast_mutex_unlock(&prefetch.mutex);
+
+	os_event_free(prefetch.threads_done);
+	os_fast_mutex_free(&prefetch.mutex);
+
+	for (ulint i = 0; i < missing.size(); ++i) {
+		if (errors[i] == DB_SUCCESS) {
+			fts_plist_cache_add(missing[i]);
+			query->plists->push_back(missing[i]);
+		} else {
+			fts_plist_release(missing[i]);
+		}
+	}
 }
 
 /*******************************************************************//**
-Add the word to the documents "list" of matching words from
-the query. We make a copy of the word from the query heap. */
+Get the posting list of a query term: the list that was prefetched,
+the cached list, or else read the list from the FTS INDEX. The list is
+pinned until the query is freed.
+@return DB_SUCCESS or error code */
 static
-void
-fts_query_add_word_to_document(
-/*===========================*/
-	fts_query_t*		query,	/*!< in: query to update */
-	doc_id_t		doc_id,	/*!< in: the document to update */
-	const fts_string_t*	word)	/*!< in: the token to add */
+dberr_t
+fts_query_get_plist(
+/*================*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	token,	/*!< in: the term */
+	fts_plist_t**		plist)	/*!< out: posting list */
 {
-	ib_rbt_bound_t		parent;
-	fts_ranking_t*		ranking = NULL;
+	plist_vector_t::iterator	it;
 
-	if (query->flags == FTS_OPT_RANKING) {
-		return;
+	for (it = query->plists->begin(); it != query->plists->end(); ++it) {
+		if ((*it)->word.f_len == token->f_len
+		    && !memcmp((*it)->word.f_str, token->f_str, token->f_len)) {
+			break;
+		}
 	}
 
-	/* First we search the intersection RB tree as it could have
-	taken ownership of the words rb tree instance. */
-	if (query->intersection
-	    && rbt_search(query->intersection, &parent, &doc_id) == 0) {
+	if (it != query->plists->end() && fts_plist_is_current(*it)) {
+		*plist = *it;
 
-		ranking = rbt_value(fts_ranking_t, parent.last);
+		return(DB_SUCCESS);
 	}
 
-	if (ranking == NULL
-	    && rbt_search(query->doc_ids, &parent, &doc_id) == 0) {
+	/* The list is not pinned yet, or SYNC or OPTIMIZE has changed
+	the FTS INDEX since it was read. */
+	*plist = fts_plist_cache_get(query->index, token);
 
-		ranking = rbt_value(fts_ranking_t, parent.last);
+	if (*plist == NULL) {
+		dberr_t	error;
+
+		*plist = fts_plist_create(
+			query->index, token, query->plist_epoch);
+
+		error = fts_plist_fetch(
+			query->trx, &query->fts_index_table, *plist);
+
+		if (error != DB_SUCCESS) {
+			fts_plist_release(*plist);
+			*plist = NULL;
+
+			return(error);
+		}
+
+		fts_plist_cache_add(*plist);
 	}
 
-	if (ranking != NULL) {
-		fts_ranking_words_add(query, ranking, word);
+	if (it != query->plists->end()) {
+		fts_plist_release(*it);
+		*it = *plist;
+	} else {
+		query->plists->push_back(*plist);
 	}
+
+	return(DB_SUCCESS);
 }
 
 /*******************************************************************//**
-Check the node ilist. */
+Process a document of a posting list, like fts_query_filter_doc_ids()
+processes a document of an ilist. */
 static
 void
-fts_query_check_node(
-/*=================*/
-	fts_query_t*		query,	/*!< in: query to update */
-	const fts_string_t*	token,	/*!< in: the token to search */
-	const fts_node_t*	node)	/*!< in: node to check */
+fts_query_process_posting(
+/*======================*/
+	fts_query_t*		query,		/*!< in/out: query instance */
+	fts_word_freq_t*	word_freq,	/*!< in/out: word frequency */
+	const fts_posting_t*	posting)	/*!< in: the document */
 {
-	/* Skip nodes whose doc ids are out range. */
-	if (query->oper == FTS_EXIST
-	    && ((query->upper_doc_id > 0
-		&& node->first_doc_id > query->upper_doc_id)
-		|| (query->lower_doc_id > 0
-		    && node->last_doc_id < query->lower_doc_id))) {
-
-		/* Ignore */
+	fts_doc_freq_t*	doc_freq;
 
-	} else {
-		int		ret;
-		ib_rbt_bound_t	parent;
-		ulint		ilist_size = node->ilist_size;
-		fts_word_freq_t*word_freqs;
+	doc_freq = fts_query_add_doc_freq(
+		query, word_freq->doc_freqs, posting->doc_id);
 
-		/* The word must exist. */
-		ret = rbt_search(query->word_freqs, &parent, token);
-		ut_a(ret == 0);
+	/* Avoid duplicating frequency tally. */
+	if (doc_freq->freq == 0) {
+		doc_freq->freq = posting->freq;
+	}
 
-		word_freqs = rbt_value(fts_word_freq_t, parent.last);
+	/* We ignore error here and will check it later */
+	fts_query_process_doc_id(query, posting->doc_id, 0);
 
-		query->error = fts_query_filter_doc_ids(
-					query, token, word_freqs, node,
-					node->ilist, ilist_size, TRUE);
-	}
+	/* Add the word to the document's matched RB tree. */
+	fts_query_add_word_to_document(query, posting->doc_id, &word_freq->word);
 }
 
-/*****************************************************************//**
-Search index cache for word with wildcard match.
-@return number of words matched */
+/*******************************************************************//**
+Process the documents of the posting list of a term with the current
+query operator.
+@return DB_SUCCESS or DB_FTS_EXCEED_RESULT_CACHE_LIMIT */
 static
-ulint
-fts_cache_find_wildcard(
+dberr_t
+fts_query_process_plist(
 /*====================*/
-	fts_query_t*		query,		/*!< in: query instance */
-	const fts_index_cache_t*index_cache,	/*!< in: cache to search */
-	const fts_string_t*	token)		/*!< in: token to search */
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	token,	/*!< in: the term */
+	const fts_plist_t*	plist)	/*!< in: its posting list */
 {
+	int			ret;
 	ib_rbt_bound_t		parent;
-	const ib_vector_t*	nodes = NULL;
-	fts_string_t		srch_text;
-	byte			term[FTS_MAX_WORD_LEN + 1];
-	ulint			num_word = 0;
+	fts_word_freq_t*	word_freq;
+	const fts_posting_t*	pos;
+	const fts_posting_t*	end;
 
-	srch_text.f_len = (token->f_str[token->f_len - 1] == '%')
-			? token->f_len - 1
-			: token->f_len;
+	/* Lookup the word in our rb tree, it must exist. */
+	ret = rbt_search(query->word_freqs, &parent, token);
 
-	strncpy((char*) term, (char*) token->f_str, srch_text.f_len);
-	term[srch_text.f_len] = '\0';
-	srch_text.f_str = term;
+	ut_a(ret == 0);
 
-	/* Lookup the word in the rb tree */
-	if (rbt_search_cmp(index_cache->words, &parent, &srch_text, NULL,
-			   innobase_fts_text_cmp_prefix) == 0) {
-		const fts_tokenizer_word_t*     word;
-		ulint				i;
-		const ib_rbt_node_t*		cur_node;
-		ibool				forward = FALSE;
+	word_freq = rbt_value(fts_word_freq_t, parent.last);
 
-		word = rbt_value(fts_tokenizer_word_t, parent.last);
-		cur_node = parent.last;
+	word_freq->doc_count += plist->doc_count;
 
-		while (innobase_fts_text_cmp_prefix(
-			index_cache->charset, &srch_text, &word->text) == 0) {
+	if (plist->postings.empty()) {
+		return(DB_SUCCESS);
+	}
 
-			nodes = word->nodes;
+	pos = &plist->postings[0];
+	end = pos + plist->postings.size();
 
-			for (i = 0; nodes && i < ib_vector_size(nodes); ++i) {
-				int                     ret;
-				const fts_node_t*       node;
-				ib_rbt_bound_t          freq_parent;
-				fts_word_freq_t*	word_freqs;
+	/* When the term can only drop or rerank documents of the current
+	set, and the set is the smaller one, gallop through the list for
+	the documents of the set instead of visiting every posting. */
+	if (query->flags != FTS_OPT_RANKING
+	    && ((query->oper == FTS_EXIST && query->multi_exist)
+		|| query->oper == FTS_IGNORE
+		|| query->oper == FTS_NEGATE)
+	    && rbt_size(query->doc_ids) < plist->postings.size()) {
 
-				node = static_cast<const fts_node_t*>(
-					ib_vector_get_const(nodes, i));
+		const ib_rbt_node_t*	node;
+		const ib_rbt_node_t*	next;
 
-				ret = rbt_search(query->word_freqs,
-						 &freq_parent,
-						 &srch_text);
+		for (node = rbt_first(query->doc_ids);
+		     node != NULL && pos < end
+		     && query->total_size <= fts_result_cache_limit;
+		     node = next) {
 
-				ut_a(ret == 0);
+			doc_id_t	doc_id;
 
-				word_freqs = rbt_value(
-					fts_word_freq_t,
-					freq_parent.last);
+			doc_id = rbt_value(fts_ranking_t, node)->doc_id;
 
-				query->error = fts_query_filter_doc_ids(
-					query, &srch_text,
-					word_freqs, node,
-					node->ilist, node->ilist_size, TRUE);
+			/* FTS_IGNORE removes the node from the set. */
+			next = rbt_next(query->doc_ids, node);
 
-				if (query->error != DB_SUCCESS) {
-					return(0);
-				}
+			pos = fts_posting_gallop(pos, end, doc_id);
+
+			if (pos < end && pos->doc_id == doc_id) {
+				fts_query_process_posting(
+					query, word_freq, pos);
 			}
+		}
+	} else {
+		for (; pos < end
+		     && query->total_size <= fts_result_cache_limit;
+		     ++pos) {
 
-			num_word++;
+			fts_query_process_posting(query, word_freq, pos);
+		}
+	}
 
-			if (!forward) {
-				cur_node = rbt_prev(
-					index_cache->words, cur_node);
-			} else {
-cont_search:
-				cur_node = rbt_next(
-					index_cache->words, cur_node);
-			}
+	if (query->total_size > fts_result_cache_limit) {
+		return(DB_FTS_EXCEED_RESULT_CACHE_LIMIT);
+	} else {
+		return(DB_SUCCESS);
+	}
+}
 
-			if (!cur_node) {
-				break;
-			}
+/*****************************************************************//**
+Read the rows of a token from the FTS INDEX and process its documents.
+A term is processed from its decoded posting list. Wildcard terms and
+the words of phrase and proximity searches, which need the positions
+of the word, are filtered while the rows are read.
+@return DB_SUCCESS if all go well */
+static __attribute__((nonnull))
+dberr_t
+fts_query_index_fetch(
+/*==================*/
+	fts_query_t*		query,	/*!< in/out: query instance */
+	const fts_string_t*	token)	/*!< in: token to search */
+{
+	dberr_t		error;
 
-			word = rbt_value(fts_tokenizer_word_t, cur_node);
-		}
+	if (!query->collect_positions
+	    && query->cur_node != NULL
+	    && query->cur_node->type == FTS_AST_TERM
+	    && !query->cur_node->term.wildcard) {
 
-		if (!forward) {
-			forward = TRUE;
-			cur_node = parent.last;
-			goto cont_search;
+		fts_plist_t*	plist;
+
+		error = fts_query_get_plist(query, token, &plist);
+
+		if (error == DB_SUCCESS) {
+			error = fts_query_process_plist(query, token, plist);
 		}
+	} else {
+		fts_fetch_t	fetch;
+		que_t*		graph = NULL;
+
+		/* Setup the callback args for filtering and
+		consolidating the ilist. */
+		fetch.read_arg = query;
+		fetch.read_record = fts_query_index_fetch_nodes;
+
+		error = fts_index_fetch_nodes(
+			query->trx, &graph, &query->fts_index_table, token,
+			&fetch);
+
+		/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by
+		'query->error' */
+		ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
+
+		fts_que_graph_free(graph);
 	}
 
-	return(num_word);
+	if (error != DB_SUCCESS) {
+		query->error = error;
+	}
+
+	return(query->error);
 }
 
 /*****************************************************************//**
@@ -1139,7 +2264,6 @@ fts_query_difference(
 	const fts_string_t*	token)	/*!< in: token to search */
 {
 	ulint			n_doc_ids= 0;
-	trx_t*			trx = query->trx;
 	dict_table_t*		table = query->index->table;
 
 	ut_a(query->oper == FTS_IGNORE);
@@ -1156,12 +2280,9 @@ fts_query_difference(
 	/* There is nothing we can substract from an empty set. */
 	if (query->doc_ids && !rbt_empty(query->doc_ids)) {
 		ulint			i;
-		fts_fetch_t		fetch;
 		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
-		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
-		dberr_t			error;
 
 		rw_lock_x_lock(&cache->lock);
 
@@ -1197,21 +2318,8 @@ fts_query_difference(
 			return(query->error);
 		}
 
-		/* Setup the callback args for filtering and
-		consolidating the ilist. */
-		fetch.read_arg = query;
-		fetch.read_record = fts_query_index_fetch_nodes;
-
-		error = fts_index_fetch_nodes(
-			trx, &graph, &query->fts_index_table, token, &fetch);
-
-		/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-		ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-		if (error != DB_SUCCESS) {
-			query->error = error;
-		}
-
-		fts_que_graph_free(graph);
+		/* Read the nodes from disk. */
+		fts_query_index_fetch(query, token);
 	}
 
 	/* The size can't increase. */
@@ -1230,7 +2338,6 @@ fts_query_intersect(
 	fts_query_t*		query,	/*!< in: query instance */
 	const fts_string_t*	token)	/*!< in: the token to search */
 {
-	trx_t*			trx = query->trx;
 	dict_table_t*		table = query->index->table;
 
 	ut_a(query->oper == FTS_EXIST);
@@ -1245,12 +2352,9 @@ fts_query_intersect(
 	if (!(rbt_empty(query->doc_ids) && query->multi_exist)) {
 		ulint                   n_doc_ids = 0;
 		ulint			i;
-		fts_fetch_t		fetch;
 		const ib_vector_t*	nodes;
 		const fts_index_cache_t*index_cache;
-		que_t*			graph = NULL;
 		fts_cache_t*		cache = table->fts->cache;
-		dberr_t			error;
 
 		ut_a(!query->intersection);
 
@@ -1317,21 +2421,8 @@ fts_query_intersect(
 			return(query->error);
 		}
 
-		/* Setup the callback args for filtering and
-		consolidating the ilist. */
-		fetch.read_arg = query;
-		fetch.read_record = fts_query_index_fetch_nodes;
-
-		error = fts_index_fetch_nodes(
-			trx, &graph, &query->fts_index_table, token, &fetch);
-
-		/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-		ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-		if (error != DB_SUCCESS) {
-			query->error = error;
-		}
-
-		fts_que_graph_free(graph);
+		/* Read the nodes from disk. */
+		fts_query_index_fetch(query, token);
 
 		if (query->error == DB_SUCCESS) {
 			/* Make the intesection (rb tree) the current doc id
@@ -1408,11 +2499,7 @@ fts_query_union(
 	fts_query_t*		query,	/*!< in: query instance */
 	fts_string_t*		token)	/*!< in: token to search */
 {
-	fts_fetch_t		fetch;
 	ulint			n_doc_ids = 0;
-	trx_t*			trx = query->trx;
-	que_t*			graph = NULL;
-	dberr_t			error;
 
 	ut_a(query->oper == FTS_NONE || query->oper == FTS_DECR_RATING ||
 	     query->oper == FTS_NEGATE || query->oper == FTS_INCR_RATING);
@@ -1436,22 +2523,8 @@ fts_query_union(
 
 	fts_query_cache(query, token);
 
-	/* Setup the callback args for filtering and
-	consolidating the ilist. */
-	fetch.read_arg = query;
-	fetch.read_record = fts_query_index_fetch_nodes;
-
 	/* Read the nodes from disk. */
-	error = fts_index_fetch_nodes(
-		trx, &graph, &query->fts_index_table, token, &fetch);
-
-	/* DB_FTS_EXCEED_RESULT_CACHE_LIMIT passed by 'query->error' */
-	ut_ad(!(query->error != DB_SUCCESS && error != DB_SUCCESS));
-	if (error != DB_SUCCESS) {
-		query->error = error;
-	}
-
-	fts_que_graph_free(graph);
+	fts_query_index_fetch(query, token);
 
 	if (query->error == DB_SUCCESS) {
 
@@ -3661,6 +4734,14 @@ fts_query_free(
 		delete query->word_vector;
 	}
 
+	if (query->plists) {
+		for (ulint i = 0; i < query->plists->size(); ++i) {
+			fts_plist_release((*query->plists)[i]);
+		}
+
+		delete query->plists;
+	}
+
 	if (query->heap) {
 		mem_heap_free(query->heap);
 	}
@@ -3845,6 +4926,9 @@ fts_query(
 	start_time_ms = ut_time_ms();
 
 	query.trx = query_trx;
+	/* Before query_trx gets a read view: a SYNC or OPTIMIZE that the
+	view may not see changes the epoch after this. */
+	query.plist_epoch = fts_plist_cache_get_epoch();
 	query.index = index;
 	query.boolean_mode = boolean_mode;
 	query.deleted = fts_doc_ids_create();
@@ -3868,6 +4952,7 @@ fts_query(
 		sizeof(fts_string_t), innobase_fts_text_cmp,
                 (void *) charset);
 	query.word_vector = new word_vector_t;
+	query.plists = new plist_vector_t;
 	query.error = DB_SUCCESS;
 
 	/* Setup the RB tree that will be used to collect per term
@@ -3960,6 +5045,9 @@ fts_query(
 			        fts_result_cache_limit = 2048;
 		);
 
+		/* Read the posting lists of the terms in parallel. */
+		fts_query_prefetch(&query);
+
 		/* Traverse the Abstract Syntax Tree (AST) and execute
 		the query. */
 		query.error = fts_ast_visit(
@@ -381,7 +381,8 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 	{&buf_dblwr_mutex_key, "buf_dblwr_mutex", 0},
 	{&trx_undo_mutex_key, "trx_undo_mutex", 0},
 	{&srv_sys_mutex_key, "srv_sys_mutex", 0},
-	{&lock_sys_mutex_key, "lock_mutex", 0},
+	{&lock_sys_rec_mutex_key, "lock_rec_mutex", 0},
+	{&lock_sys_deadlock_mutex_key, "lock_deadlock_mutex", 0},
 	{&lock_sys_wait_mutex_key, "lock_wait_mutex", 0},
 	{&trx_mutex_key, "trx_mutex", 0},
 	{&srv_sys_tasks_mutex_key, "srv_threads_mutex", 0},
@@ -398,6 +399,7 @@ static PSI_mutex_info all_innodb_mutexes[] = {
 #endif /* !HAVE_ATOMIC_BUILTINS_64 */
 	{&ut_list_mutex_key, "ut_list_mutex", 0},
 	{&trx_sys_mutex_key, "trx_sys_mutex", 0},
+	{&trx_sys_view_mutex_key, "trx_sys_view_mutex", 0},
 	{&zip_pad_mutex_key, "zip_pad_mutex", 0},
 };
 # endif /* UNIV_PFS_MUTEX */
@@ -427,7 +429,8 @@ static PSI_rwlock_info all_innodb_rwlocks[] = {
 	{&index_tree_rw_lock_key, "index_tree_rw_lock", 0},
 	{&index_online_log_key, "index_online_log", 0},
 	{&dict_table_stats_key, "dict_table_stats", 0},
-	{&hash_table_rw_lock_key, "hash_table_locks", 0}
+	{&hash_table_rw_lock_key, "hash_table_locks", 0},
+	{&lock_sys_latch_key, "lock_sys_latch", 0}
 };
 # endif /* UNIV_PFS_RWLOCK */
 
@@ -444,7 +447,8 @@ static PSI_thread_info	all_innodb_threads[] = {
 	{&srv_master_thread_key, "srv_master_thread", 0},
 	{&srv_purge_thread_key, "srv_purge_thread", 0},
 	{&buf_page_cleaner_thread_key, "page_cleaner_thread", 0},
-	{&recv_writer_thread_key, "recv_writer_thread", 0}
+	{&recv_writer_thread_key, "recv_writer_thread", 0},
+	{&recv_apply_thread_key, "recv_apply_thread", 0}
 };
 # endif /* UNIV_PFS_THREAD */
 
@@ -725,6 +729,8 @@ static SHOW_VAR innodb_status_variables[]= {
   (char*) &export_vars.innodb_pages_read,		  SHOW_LONG},
   {"pages_written",
   (char*) &export_vars.innodb_pages_written,		  SHOW_LONG},
+  {"prefetch_cache_refills",
+  (char*) &export_vars.innodb_prefetch_cache_refills,	  SHOW_LONG},
   {"row_lock_current_waits",
   (char*) &export_vars.innodb_row_lock_current_waits,	  SHOW_LONG},
   {"row_lock_time",
@@ -1520,6 +1526,9 @@ innobase_release_temporary_latches(
 	trx_t*	trx = thd_to_trx(thd);
 
 	if (trx != NULL) {
+#ifdef UNIV_SYNC_DEBUG
+		ut_ad(!btr_search_own_any());
+#endif
 		trx_search_latch_release_if_reserved(trx);
 	}
 
@@ -4502,6 +4511,15 @@ innobase_kill_query(
 		THD *cur = current_thd;
 		THD *owner = trx->current_lock_mutex_owner;
 
+		if (owner && owner == cur && !lock_mutex_own()) {
+			/* We were called from a wait report made while
+			holding lock_sys->latch in S mode, and cannot
+			cancel the lock wait here. The reporting thread
+			cancels it after releasing the latch. */
+			trx->lock_wait_cancel_deferred = true;
+			DBUG_VOID_RETURN;
+		}
+
 		/* Cancel a pending lock request. */
 		if (!owner || owner != cur) {
 			lock_mutex_enter();
@@ -13150,7 +13168,7 @@ ha_innobase::optimize(
 	if (innodb_optimize_fulltext_only) {
 		if (prebuilt->table->fts && prebuilt->table->fts->cache
 		    && !dict_table_is_discarded(prebuilt->table)) {
-			fts_sync_table(prebuilt->table);
+			fts_sync_table(prebuilt->table, false, true);
 			fts_optimize_table(prebuilt->table);
 		}
 		return(HA_ADMIN_OK);
@@ -13797,6 +13815,18 @@ ha_innobase::referenced_by_foreign_key(void)
 	return(0);
 }
 
+/*******************************************************************//**
+Checks if a table is the child or the parent of a foreign key.
+@return	true if the table has FOREIGN KEY constraints */
+UNIV_INTERN
+bool
+ha_innobase::has_foreign_keys(void)
+/*===============================*/
+{
+	return(!prebuilt->table->foreign_set.empty()
+	       || dict_table_is_referenced_by_foreign_key(prebuilt->table));
+}
+
 /*******************************************************************//**
 Frees the foreign key create info for a table stored in InnoDB, if it is
 non-NULL. */
@@ -13886,6 +13916,13 @@ ha_innobase::reset()
 	reset_template();
 	ds_mrr.dsmrr_close();
 
+	/* Do not keep a grown prefetch cache between statements. Rows
+	left in it, for example after a LIMIT, are never read: the next
+	statement positions the cursor anew. */
+	prebuilt->n_fetch_cached = 0;
+	prebuilt->fetch_cache_first = 0;
+	row_sel_prefetch_cache_shrink(prebuilt);
+
 	/* TODO: This should really be reset in reset_template() but for now
 	it's safer to do it explicitly here. */
 
@@ -17572,6 +17609,32 @@ buffer_pool_load_abort(
 	}
 }
 
+/****************************************************************//**
+Update innodb_buffer_pool_dump_interval and wake up the buffer pool
+dump/load thread, so that it starts waiting for the new interval.
+This function is registered as a callback with MySQL. */
+static
+void
+buffer_pool_dump_interval_update(
+/*=============================*/
+	THD*				thd	/*!< in: thread handle */
+					__attribute__((unused)),
+	struct st_mysql_sys_var*	var	/*!< in: pointer to system
+						variable */
+					__attribute__((unused)),
+	void*				var_ptr	/*!< out: where the formal
+						string goes */
+					__attribute__((unused)),
+	const void*			save)	/*!< in: immediate result from
+						check function */
+{
+	srv_buf_dump_interval = *static_cast<const ulong*>(save);
+
+	if (!srv_read_only_mode) {
+		os_event_set(srv_buf_dump_event);
+	}
+}
+
 /** Update innodb_status_output or innodb_status_output_locks,
 which control InnoDB "status monitor" output to the error log.
 @param[in]	thd	thread handle
@@ -17875,7 +17938,10 @@ wsrep_fake_trx_id(
 	THD		*thd)	/*!< in: user thread handle */
 {
 	mutex_enter(&trx_sys->mutex);
+	/* Read views read max_trx_id without trx_sys->mutex. */
+	trx_sys_descr_change_begin();
 	trx_id_t trx_id = trx_sys_get_new_trx_id();
+	trx_sys_descr_change_end();
 	mutex_exit(&trx_sys->mutex);
 
 	(void *)wsrep_ws_handle_for_trx(wsrep_thd_ws_handle(thd), trx_id);
@@ -17928,6 +17994,14 @@ static MYSQL_SYSVAR_BOOL(doublewrite, innobase_use_doublewrite,
   "Disable with --skip-innodb-doublewrite.",
   NULL, NULL, TRUE);
 
+static MYSQL_SYSVAR_ULONG(doublewrite_segment_size, srv_doublewrite_segment_size,
+  PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
+  "Number of pages in the doublewrite segment of each buffer pool instance, "
+  "kept in the file ib_doublewrite in the data home directory. "
+  "0 (the default) makes all the buffer pool instances share the "
+  "doublewrite buffer in the system tablespace.",
+  NULL, NULL, 0, 0, BUF_DBLWR_SEG_MAX_SIZE, 0);
+
 static MYSQL_SYSVAR_BOOL(use_atomic_writes, innobase_use_atomic_writes,
   PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
   "Prevent partial page writes, via atomic writes."
@@ -18212,6 +18286,14 @@ static MYSQL_SYSVAR_BOOL(adaptive_hash_index, btr_search_enabled,
   "Disable with --skip-innodb-adaptive-hash-index.",
   NULL, innodb_adaptive_hash_index_update, TRUE);
 
+/* btr_search_index_num is constrained to machine word size for historical
+reasons. This limitation can be easily removed later. */
+static MYSQL_SYSVAR_ULINT(adaptive_hash_index_partitions, btr_search_index_num,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of InnoDB adaptive hash index partitions (default 1: disable "
+  "partitioning)",
+  NULL, NULL, 1, 1, sizeof(ulint) * 8, 0);
+
 static MYSQL_SYSVAR_ULONG(replication_delay, srv_replication_delay,
   PLUGIN_VAR_RQCMDARG,
   "Replication thread delay (ms) on the slave server if "
@@ -18283,6 +18365,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_dump_at_shutdown, srv_buffer_pool_dump_at_s
   "Dump the buffer pool into a file named @@innodb_buffer_pool_filename",
   NULL, NULL, FALSE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_dump_interval, srv_buf_dump_interval,
+  PLUGIN_VAR_RQCMDARG,
+  "Dump the buffer pool into a file named @@innodb_buffer_pool_filename every this many seconds. Default is 0, which dumps it only on request and at shutdown.",
+  NULL, buffer_pool_dump_interval_update, 0, 0, 86400, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_STR(buffer_pool_evict, srv_buffer_pool_evict,
   PLUGIN_VAR_RQCMDARG,
@@ -18300,6 +18387,11 @@ static MYSQL_SYSVAR_BOOL(buffer_pool_load_abort, innodb_buffer_pool_load_abort,
   "Abort a currently running load of the buffer pool",
   NULL, buffer_pool_load_abort, FALSE);
 
+static MYSQL_SYSVAR_ULONG(buffer_pool_load_threads, srv_n_buf_load_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that read pages when loading the buffer pool from a file named @@innodb_buffer_pool_filename",
+  NULL, NULL, 4, 1, 64, 0);
+
 /* there is no point in changing this during runtime, thus readonly */
 static MYSQL_SYSVAR_BOOL(buffer_pool_load_at_startup, srv_buffer_pool_load_at_startup,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
@@ -18440,11 +18532,40 @@ static MYSQL_SYSVAR_ULONG(ft_sort_pll_degree, fts_sort_pll_degree,
   "InnoDB Fulltext search parallel sort degree, will round up to nearest power of 2 number",
   NULL, NULL, 2, 1, 16, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_query_threads, fts_query_threads,
+  PLUGIN_VAR_RQCMDARG,
+  "InnoDB Fulltext search number of threads that read the posting lists "
+  "of the terms of a query in parallel, 1 reads them one at a time",
+  NULL, NULL, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(ft_posting_cache_size, fts_posting_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "InnoDB Fulltext search size in bytes of the cache of decoded posting "
+  "lists shared by all queries, 0 disables the cache",
+  NULL, NULL, 8 * 1024 * 1024L, 0, 4294967295UL, 0);
+
+static MYSQL_SYSVAR_ULONG(prefetch_cache_size, srv_prefetch_cache_size,
+  PLUGIN_VAR_RQCMDARG,
+  "Maximum size in bytes of the cache of rows that a table handle fetches "
+  "ahead in a long range scan. The cache starts with 8 rows and doubles "
+  "every time it is refilled, up to this size.",
+  NULL, NULL, 65536, 0, 64<<20, 0);
+
 static MYSQL_SYSVAR_ULONG(sort_buffer_size, srv_sort_buf_size,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Memory buffer size for index creation",
   NULL, NULL, 1048576, 65536, 64<<20, 0);
 
+static MYSQL_SYSVAR_ULONG(ddl_threads, srv_n_ddl_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that scan the clustered index and sort the index entries when creating indexes. Default is 1, which does it from the ALTER TABLE thread only.",
+  NULL, NULL, 1, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(fill_factor, srv_fill_factor,
+  PLUGIN_VAR_RQCMDARG,
+  "Percentage of the space on each index page that is filled with records when an index is built from sorted entries. The rest is left free for later inserts.",
+  NULL, NULL, 100, 10, 100, 0);
+
 static MYSQL_SYSVAR_ULONGLONG(online_alter_log_max_size, srv_online_max_size,
   PLUGIN_VAR_RQCMDARG,
   "Maximum modification log file size for online index creation",
@@ -18493,6 +18614,11 @@ static MYSQL_SYSVAR_LONGLONG(log_file_size, innobase_log_file_size,
   "Size of each log file in a log group.",
   NULL, NULL, 48*1024*1024L, 1*1024*1024L, LONGLONG_MAX, 1024*1024L);
 
+static MYSQL_SYSVAR_ULONG(log_apply_threads, srv_n_log_apply_threads,
+  PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+  "Number of threads that apply redo log records to pages during crash recovery. Default is 1, which applies them from the recovering thread only.",
+  NULL, NULL, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_ULONG(log_files_in_group, srv_n_log_files,
   PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
   "Number of log files in the log group. InnoDB writes to the files in a circular fashion.",
@@ -18893,11 +19019,13 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(buffer_pool_filename),
   MYSQL_SYSVAR(buffer_pool_dump_now),
   MYSQL_SYSVAR(buffer_pool_dump_at_shutdown),
+  MYSQL_SYSVAR(buffer_pool_dump_interval),
 #ifdef UNIV_DEBUG
   MYSQL_SYSVAR(buffer_pool_evict),
 #endif /* UNIV_DEBUG */
   MYSQL_SYSVAR(buffer_pool_load_now),
   MYSQL_SYSVAR(buffer_pool_load_abort),
+  MYSQL_SYSVAR(buffer_pool_load_threads),
   MYSQL_SYSVAR(buffer_pool_load_at_startup),
   MYSQL_SYSVAR(defragment),
   MYSQL_SYSVAR(defragment_n_pages),
@@ -18915,6 +19043,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(data_file_path),
   MYSQL_SYSVAR(data_home_dir),
   MYSQL_SYSVAR(doublewrite),
+  MYSQL_SYSVAR(doublewrite_segment_size),
   MYSQL_SYSVAR(use_atomic_writes),
   MYSQL_SYSVAR(use_fallocate),
   MYSQL_SYSVAR(api_enable_binlog),
@@ -18943,6 +19072,8 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(ft_min_token_size),
   MYSQL_SYSVAR(ft_num_word_optimize),
   MYSQL_SYSVAR(ft_sort_pll_degree),
+  MYSQL_SYSVAR(ft_query_threads),
+  MYSQL_SYSVAR(ft_posting_cache_size),
   MYSQL_SYSVAR(large_prefix),
   MYSQL_SYSVAR(force_load_corrupted),
   MYSQL_SYSVAR(locks_unsafe_for_binlog),
@@ -18953,6 +19084,7 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
 #endif /* UNIV_LOG_ARCHIVE */
   MYSQL_SYSVAR(page_size),
   MYSQL_SYSVAR(log_buffer_size),
+  MYSQL_SYSVAR(log_apply_threads),
   MYSQL_SYSVAR(log_file_size),
   MYSQL_SYSVAR(log_files_in_group),
   MYSQL_SYSVAR(log_group_home_dir),
@@ -18984,12 +19116,16 @@ static struct st_mysql_sys_var* innobase_system_variables[]= {
   MYSQL_SYSVAR(stats_modified_counter),
   MYSQL_SYSVAR(stats_traditional),
   MYSQL_SYSVAR(adaptive_hash_index),
+  MYSQL_SYSVAR(adaptive_hash_index_partitions),
   MYSQL_SYSVAR(stats_method),
   MYSQL_SYSVAR(replication_delay),
   MYSQL_SYSVAR(status_file),
   MYSQL_SYSVAR(strict_mode),
   MYSQL_SYSVAR(support_xa),
+  MYSQL_SYSVAR(prefetch_cache_size),
   MYSQL_SYSVAR(sort_buffer_size),
+  MYSQL_SYSVAR(ddl_threads),
+  MYSQL_SYSVAR(fill_factor),
   MYSQL_SYSVAR(online_alter_log_max_size),
   MYSQL_SYSVAR(sync_spin_loops),
   MYSQL_SYSVAR(spin_wait_delay),
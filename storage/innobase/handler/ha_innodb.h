@@ -215,6 +215,7 @@ class ha_innobase: public handler
 					List<FOREIGN_KEY_INFO> *f_key_list);
 	bool can_switch_engines();
 	uint referenced_by_foreign_key();
+	bool has_foreign_keys();
 	void free_foreign_key_create_info(char* str);
 	THR_LOCK_DATA **store_lock(THD *thd, THR_LOCK_DATA **to,
 					enum thr_lock_type lock_type);
@@ -30,6 +30,7 @@ Created 10/16/1994 Heikki Tuuri
 #include "dict0dict.h"
 #include "page0cur.h"
 #include "btr0types.h"
+#include "ut0counter.h"
 
 /** Mode flags for btr_cur operations; these can be ORed */
 enum {
@@ -927,6 +928,18 @@ extern ulint	btr_cur_n_non_sea_old;
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
 extern ulint	btr_cur_n_sea_old;
+
+/** Searches in btr_cur_search_to_nth_level() of the indexes of one
+adaptive hash index partition. Each partition is on its own cache line. */
+struct btr_cur_part_stat_t {
+	ulint	n_sea;		/*!< successful adaptive hash index lookups */
+	ulint	n_non_sea;	/*!< searches down the B-tree */
+	byte	pad[CACHE_LINE_SIZE - 2 * sizeof(ulint)];
+};
+
+/** Search counters of each adaptive hash index partition, reported
+in INFORMATION_SCHEMA.INNODB_METRICS */
+extern btr_cur_part_stat_t	btr_cur_part_stats[BTR_SEARCH_MAX_PARTITIONS];
 #endif /* !UNIV_HOTBACKUP */
 
 #ifdef UNIV_DEBUG
@@ -614,6 +614,14 @@ fts_optimize_do_table(
 	dict_table_t*	table)		/*!< in: table to optimize */
 	__attribute__((nonnull));
 /******************************************************************//**
+Ask the optimize thread to SYNC the cache of a table in the background. */
+UNIV_INTERN
+void
+fts_optimize_request_sync_table(
+/*============================*/
+	dict_table_t*	table)		/*!< in: table to sync */
+	__attribute__((nonnull));
+/******************************************************************//**
 Construct the prefix name of an FTS table.
 @return own: table name, must be freed with mem_free() */
 UNIV_INTERN
@@ -123,6 +123,14 @@ struct fts_sync_t {
 					noted as being full, we use this to
 					set the upper_limit field */
         ib_time_t	start_time;	/*!< SYNC start time */
+	bool		in_progress;	/*!< flag whether SYNC is in progress,
+					protected by the cache lock */
+	bool		unlock_cache;	/*!< flag whether the cache lock is
+					released while writing the words */
+	bool		requested;	/*!< flag whether a background SYNC
+					was requested from the optimize
+					thread and has not started yet */
+	os_event_t	event;		/*!< signalled when a SYNC finishes */
 };
 
 /** The cache for the FTS system. It is a memory-based inverted index
@@ -212,6 +220,10 @@ struct fts_node_t {
 	ulint		ilist_size_alloc;
 					/*!< Allocated size of ilist in
 					bytes */
+
+	bool		synced;		/*!< TRUE once the node is written to
+					the FTS index table by the running
+					SYNC; new doc ids go to a new node */
 };
 
 /** A tokenizer word. Contains information about one word. */
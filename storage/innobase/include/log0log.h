@@ -51,6 +51,8 @@ typedef	ib_uint64_t		lsn_t;
 struct log_t;
 /** Redo log group */
 struct log_group_t;
+/** Range of the log buffer reserved for a mini-transaction log */
+struct log_copy_t;
 
 #ifdef UNIV_DEBUG
 /** Flag: write to log file? */
@@ -69,6 +71,9 @@ extern	ibool	log_debug_writes;
 /* @} */
 /** Maximum number of log groups in log_group_t::checkpoint_buf */
 #define LOG_MAX_N_GROUPS	32
+/** Maximum number of log buffer ranges that can be reserved by
+log_reserve_for_copy() and not yet filled in */
+#define LOG_COPY_SLOTS		1024
 
 /*******************************************************************//**
 Calculates where in log files we find a specified lsn.
@@ -88,17 +93,6 @@ log_calc_where_lsn_is(
 	ib_int64_t	log_file_size);		/*!< in: log file size
 						(including the header) */
 #ifndef UNIV_HOTBACKUP
-/************************************************************//**
-Writes to the log the string given. The log must be released with
-log_release.
-@return	end lsn of the log record, zero if did not succeed */
-UNIV_INLINE
-lsn_t
-log_reserve_and_write_fast(
-/*=======================*/
-	const void*	str,	/*!< in: string */
-	ulint		len,	/*!< in: string length */
-	lsn_t*		start_lsn);/*!< out: start lsn of the log record */
 /***********************************************************************//**
 Releases the log mutex. */
 UNIV_INLINE
@@ -115,8 +109,8 @@ void
 log_free_check(void);
 /*================*/
 /************************************************************//**
-Opens the log for log_write_low. The log must be closed with log_close and
-released with log_release.
+Opens the log for log_write_low. The log must be closed with log_close or
+log_reserve_for_copy and released with log_release.
 @return	start lsn of the log record */
 UNIV_INTERN
 lsn_t
@@ -130,7 +124,8 @@ UNIV_INTERN
 void
 log_write_low(
 /*==========*/
-	byte*	str,		/*!< in: string */
+	byte*	str,		/*!< in: string, or NULL to only advance
+				the lsn and the log block headers */
 	ulint	str_len);	/*!< in: string length */
 /************************************************************//**
 Closes the log.
@@ -140,6 +135,37 @@ lsn_t
 log_close(void);
 /*===========*/
 /************************************************************//**
+Reserves len bytes of the log buffer opened with log_reserve_and_open() and
+closes the log. The range must be filled in with log_copy_low() and
+handed back with log_copy_done(); the caller may release the log mutex
+before doing that, so that the log of several mini-transactions can be
+copied to the log buffer concurrently.
+@return	end lsn of the reserved range */
+UNIV_INTERN
+lsn_t
+log_reserve_for_copy(
+/*=================*/
+	ulint		len,	/*!< in: length of data to be catenated */
+	log_copy_t*	copy);	/*!< out: the reserved range */
+/************************************************************//**
+Copies the string given to a log buffer range reserved with
+log_reserve_for_copy(). Does not need the log mutex. */
+UNIV_INTERN
+void
+log_copy_low(
+/*=========*/
+	log_copy_t*	copy,	/*!< in/out: reserved range */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len);/*!< in: string length */
+/************************************************************//**
+Marks a log buffer range reserved with log_reserve_for_copy() filled in,
+so that it can be written to the log files. Does not need the log mutex. */
+UNIV_INTERN
+void
+log_copy_done(
+/*==========*/
+	const log_copy_t*	copy);	/*!< in: reserved range */
+/************************************************************//**
 Gets the current lsn.
 @return	current lsn */
 UNIV_INLINE
@@ -775,6 +801,26 @@ struct log_group_t{
 			log_groups;	/*!< list of log groups */
 };
 
+/** Range of the log buffer reserved with log_reserve_for_copy() */
+struct log_copy_t{
+	ulint		offset;		/*!< offset in log_sys->buf where
+					the next byte is to be copied */
+	ulint		slot;		/*!< index of the slot in
+					log_sys->copy_slots tracking
+					this range */
+#ifdef UNIV_LOG_DEBUG
+	ulint		start_offset;	/*!< start offset of the range */
+	lsn_t		start_lsn;	/*!< start lsn of the range */
+#endif /* UNIV_LOG_DEBUG */
+};
+
+/** Tracks the copying of a range reserved with log_reserve_for_copy() */
+struct log_copy_slot_t{
+	lsn_t		end_lsn;	/*!< end lsn of the range */
+	volatile ibool	done;		/*!< TRUE when the range has been
+					filled in by log_copy_done() */
+};
+
 /** Redo log buffer */
 struct log_t{
 	byte		pad[64];	/*!< padding to prevent other memory
@@ -833,6 +879,20 @@ struct log_t{
 					groups */
 	volatile bool	is_extending;	/*!< this is set to true during extend
 					the log buffer size */
+	log_copy_slot_t* copy_slots;	/*!< LOG_COPY_SLOTS slots tracking
+					the ranges reserved with
+					log_reserve_for_copy(), used as a
+					ring in reservation order */
+	ulint		n_copies_reserved;/*!< number of ranges reserved
+					so far */
+	ulint		n_copies_closed;/*!< number of ranges, in the
+					reservation order, that have been
+					filled in and whose slots are free */
+	lsn_t		copied_lsn;	/*!< the log buffer is contiguous up
+					to this lsn: all the log below it has
+					been copied to the buffer, and it can
+					be written to the log files; advanced
+					by log_copies_advance() */
 	lsn_t		written_to_some_lsn;
 					/*!< first log sequence number not yet
 					written to any log group; for this to
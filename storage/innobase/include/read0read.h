@@ -62,9 +62,7 @@ UNIV_INLINE
 void
 read_view_remove(
 /*=============*/
-	read_view_t*	view,		/*!< in: read view, can be 0 */
-	bool		own_mutex);	/*!< in: true if caller owns the
-					trx_sys_t::mutex */
+	read_view_t*	view);		/*!< in: read view, can be 0 */
 /*********************************************************************//**
 Closes a consistent read view for MySQL. This function is called at an SQL
 statement end if the trx isolation level is <= TRX_ISO_READ_COMMITTED. */
@@ -651,6 +651,9 @@ struct mysql_row_templ_t {
 					it is an unsigned integer type */
 };
 
+/* Number of rows cached in fetch_cache when a scan starts to use it. The
+number doubles every time the cache is filled, up to the number of rows
+that fit in srv_prefetch_cache_size bytes. */
 #define MYSQL_FETCH_CACHE_SIZE		8
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
@@ -827,8 +830,7 @@ struct row_prebuilt_t {
 	ulint		n_rows_fetched;	/*!< number of rows fetched after
 					positioning the current cursor */
 	ulint		fetch_direction;/*!< ROW_SEL_NEXT or ROW_SEL_PREV */
-	byte*		fetch_cache[MYSQL_FETCH_CACHE_SIZE];
-					/*!< a cache for fetched rows if we
+	byte**		fetch_cache;	/*!< a cache for fetched rows if we
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
 					batch; we reserve mysql_row_len
@@ -836,7 +838,14 @@ struct row_prebuilt_t {
 					pointers point 4 bytes past the
 					allocated mem buf start, because
 					there is a 4 byte magic number at the
-					start and at the end */
+					start and at the end; NULL if not
+					allocated yet */
+	ulint		fetch_cache_size;/*!< number of rows allocated in
+					fetch_cache */
+	ulint		fetch_cache_limit;/*!< number of rows to cache before
+					returning to MySQL; grows from
+					MYSQL_FETCH_CACHE_SIZE as long as
+					the scan goes on */
 	ibool		keep_other_fields_on_keyread; /*!< when using fetch
 					cache with HA_EXTRA_KEYREAD, don't
 					overwrite other fields in mysql row
@@ -89,7 +89,10 @@ struct purge_node_t{
 	/*----------------------*/
 	/* Local storage for this graph node */
 	roll_ptr_t	roll_ptr;/* roll pointer to undo log record */
-	ib_vector_t*    undo_recs;/*!< Undo recs to purge */
+	ib_vector_t*    undo_recs;/*!< Undo recs to purge, the records of
+				group */
+	trx_purge_group_t* group;/*!< the group of undo recs that this
+				node is purging, or NULL */
 
 	undo_no_t	undo_no;/* undo number of the record */
 
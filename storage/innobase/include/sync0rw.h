@@ -138,6 +138,7 @@ extern	mysql_pfs_key_t	index_online_log_key;
 extern	mysql_pfs_key_t	dict_table_stats_key;
 extern  mysql_pfs_key_t trx_sys_rw_lock_key;
 extern  mysql_pfs_key_t hash_table_rw_lock_key;
+extern	mysql_pfs_key_t	lock_sys_latch_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 
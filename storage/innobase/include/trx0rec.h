@@ -110,6 +110,18 @@ trx_undo_rec_get_pars(
 	undo_no_t*	undo_no,	/*!< out: undo log record number */
 	table_id_t*	table_id)	/*!< out: table id */
 	__attribute__((nonnull));
+/**********************************************************************//**
+Checks if purge has work to do for an update undo log record: the record
+delete-marks a row, updates an ordering field or updates an externally
+stored field. Purge skips the other update undo log records.
+@return	true if purge has to process the record */
+UNIV_INTERN
+bool
+trx_undo_rec_needs_purge(
+/*=====================*/
+	const trx_undo_rec_t*	undo_rec)	/*!< in: update undo log
+						record */
+	__attribute__((nonnull, warn_unused_result));
 /*******************************************************************//**
 Builds a row reference from an undo log record.
 @return	pointer to remaining part of undo record */
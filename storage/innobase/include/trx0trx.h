@@ -44,7 +44,9 @@ Created 3/26/1996 Heikki Tuuri
 extern sess_t*	trx_dummy_sess;
 
 /********************************************************************//**
-Releases the search latch if trx has reserved it. */
+A transaction can no longer keep an adaptive hash index latch between
+calls from MySQL, so there is nothing to release. The function only
+asserts that. */
 UNIV_INLINE
 void
 trx_search_latch_release_if_reserved(
@@ -241,7 +243,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 UNIV_INTERN
 trx_t *
 trx_get_trx_by_xid(
@@ -321,7 +323,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys->mutex and trx_sys->mutex.
+The caller must hold lock_sys->latch and trx_sys->mutex.
 When possible, use trx_print() instead. */
 UNIV_INTERN
 void
@@ -335,7 +337,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys->mutex and trx_sys->mutex. */
+Acquires and releases lock_sys->latch and trx_sys->mutex. */
 UNIV_INTERN
 void
 trx_print(
@@ -459,6 +461,24 @@ trx_assign_rseg(
 /*============*/
 	trx_t*		trx);		/*!< A read-only transaction that
 					needs to be assigned a RBS. */
+
+/*************************************************************//**
+Callback function for trx_find_descriptor() to compare trx IDs. */
+UNIV_INTERN
+int
+trx_descr_cmp(
+/*==========*/
+	const void *a,	/*!< in: pointer to first comparison argument */
+	const void *b);	/*!< in: pointer to second comparison argument */
+
+/*************************************************************//**
+Release a slot for a given trx in the global descriptors array. */
+UNIV_INTERN
+void
+trx_release_descriptor(
+/*===================*/
+	trx_t* trx);	/*!< in: trx pointer */
+
 /*******************************************************************//**
 Transactions that aren't started by the MySQL server don't set
 the trx_t::mysql_thd field. For such transactions we set the lock
@@ -555,15 +575,17 @@ granted the lock it was waiting for, which implies that the state can be changed
 asynchronously.
 
 All these operations take place within the context of locking. Therefore state
-changes within the locking code must acquire both the lock mutex and the
-trx->mutex when changing trx->lock.que_state to TRX_QUE_LOCK_WAIT or
+changes within the locking code must acquire both the lock_sys->latch (in X
+mode, or in S mode together with the mutex of the page of a record lock) and
+the trx->mutex when changing trx->lock.que_state to TRX_QUE_LOCK_WAIT or
 trx->lock.wait_lock to non-NULL but when the lock wait ends it is sufficient
 to only acquire the trx->mutex.
-To query the state either of the mutexes is sufficient within the locking
-code and no mutex is required when the query thread is no longer waiting. */
+To query the state either the trx->mutex or the X-latch is sufficient within
+the locking code and no mutex is required when the query thread is no longer
+waiting. */
 
 /** The locks and state of an active transaction. Protected by
-lock_sys->mutex, trx->mutex or both. */
+lock_sys->latch, trx->mutex or both. */
 struct trx_lock_t {
 	ulint		n_active_thrs;	/*!< number of active query threads */
 
@@ -575,15 +597,21 @@ struct trx_lock_t {
 					TRX_QUE_LOCK_WAIT, this points to
 					the lock request, otherwise this is
 					NULL; set to non-NULL when holding
-					both trx->mutex and lock_sys->mutex;
+					both trx->mutex and lock_sys->latch;
 					set to NULL when holding
-					lock_sys->mutex; readers should
-					hold lock_sys->mutex, except when
-					they are holding trx->mutex and
+					lock_sys->latch; for a record lock,
+					an S-latch and the mutex of the page
+					suffice; readers should hold
+					lock_sys->latch in X mode, or in S
+					mode and the mutex of the page of
+					the lock, except when they are
+					holding trx->mutex and
 					wait_lock==NULL */
 	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
 					to and checked against lock_mark_counter
-					by lock_deadlock_recursive(). */
+					by lock_deadlock_search(); protected
+					by the X-latch on lock_sys->latch or
+					by lock_sys->deadlock_mutex */
 	ibool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to FALSE;
@@ -592,25 +620,26 @@ struct trx_lock_t {
 					resolution, it sets this to TRUE.
 					Protected by trx->mutex. */
 	time_t		wait_started;	/*!< lock wait started at this time,
-					protected only by lock_sys->mutex */
+					protected only by lock_sys->latch */
 
 	que_thr_t*	wait_thr;	/*!< query thread belonging to this
 					trx that is in QUE_THR_LOCK_WAIT
 					state. For threads suspended in a
 					lock wait, this is protected by
-					lock_sys->mutex. Otherwise, this may
+					lock_sys->latch. Otherwise, this may
 					only be modified by the thread that is
 					serving the running transaction. */
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys->mutex */
+					protected by lock_sys->latch in X
+					mode, or in S mode and trx->mutex */
 
 	UT_LIST_BASE_NODE_T(lock_t)
 			trx_locks;	/*!< locks requested
 					by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys->mutex; removals are
-					protected by lock_sys->mutex */
+					and lock_sys->latch; removals are
+					protected by lock_sys->latch */
 
 	ib_vector_t*	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -662,7 +691,7 @@ transactions. The trx_sys->mutex prevents a race condition between it
 and lock_trx_release_locks() [invoked by trx_commit()].
 
 * trx_print_low() may access transactions not associated with the current
-thread. The caller must be holding trx_sys->mutex and lock_sys->mutex.
+thread. The caller must be holding trx_sys->mutex and lock_sys->latch.
 
 * When a transaction handle is in the trx_sys->mysql_trx_list or
 trx_sys->trx_list, some of its fields must not be modified without
@@ -671,7 +700,7 @@ holding trx_sys->mutex exclusively.
 * The locking code (in particular, lock_deadlock_recursive() and
 lock_rec_convert_impl_to_expl()) will access transactions associated
 to other connections. The locks of transactions are protected by
-lock_sys->mutex and sometimes by trx->mutex. */
+lock_sys->latch and sometimes by trx->mutex. */
 
 struct trx_t{
 	ulint		magic_n;
@@ -679,7 +708,7 @@ struct trx_t{
 	ib_mutex_t	mutex;		/*!< Mutex protecting the fields
 					state and lock
 					(except some fields of lock, which
-					are protected by lock_sys->mutex) */
+					are protected by lock_sys->latch) */
 
 	/** State of the trx from the point of view of concurrency control
 	and the valid state transitions.
@@ -727,7 +756,7 @@ struct trx_t{
 	ACTIVE->COMMITTED is possible when the transaction is in
 	ro_trx_list or rw_trx_list.
 
-	Transitions to COMMITTED are protected by both lock_sys->mutex
+	Transitions to COMMITTED are protected by both lock_sys->latch
 	and trx->mutex.
 
 	NOTE: Some of these state change constraints are an overkill,
@@ -741,7 +770,7 @@ struct trx_t{
 
 	trx_lock_t	lock;		/*!< Information about the transaction
 					locks and state. Protected by
-					trx->mutex or lock_sys->mutex
+					trx->mutex or lock_sys->latch
 					or both */
 	ulint		is_recovered;	/*!< 0=normal transaction,
 					1=recovered, must be rolled back,
@@ -797,8 +826,9 @@ struct trx_t{
 					trx_commit_complete_for_mysql() */
 	ulint		duplicates;	/*!< TRX_DUP_IGNORE | TRX_DUP_REPLACE */
 	ulint		has_search_latch;
-					/*!< TRUE if this trx has latched the
-					search system latch in S-mode */
+					/*!< TRUE if this trx has latched an
+					adaptive hash index partition latch
+					in S-mode in row_search_for_mysql() */
 	ulint		search_latch_timeout;
 					/*!< If we notice that someone is
 					waiting for our S-lock on the search
@@ -888,6 +918,12 @@ struct trx_t{
 					/*!< TRUE if in
 					trx_sys->mysql_trx_list */
 #endif /* UNIV_DEBUG */
+	UT_LIST_NODE_T(trx_t)
+			trx_serial_list;/*!< list node for
+					trx_sys->trx_serial_list */
+	bool		in_trx_serial_list;
+					/* Set when transaction is in the
+					trx_serial_list */
 	/*------------------------------*/
 	dberr_t		error_state;	/*!< 0 if no error, otherwise error
 					number; NOTE That ONLY the thread
@@ -965,7 +1001,7 @@ struct trx_t{
 					also in the lock list trx_locks. This
 					vector needs to be freed explicitly
 					when the trx instance is destroyed.
-					Protected by lock_sys->mutex. */
+					Protected by lock_sys->latch. */
 	/*------------------------------*/
 	ibool		read_only;	/*!< TRUE if transaction is flagged
 					as a READ-ONLY transaction.
@@ -995,7 +1031,15 @@ struct trx_t{
 	THD*		current_lock_mutex_owner;
 					/*!< If this is equal to current_thd,
 					then in innobase_kill_query() we know we
-					already hold the lock_sys->mutex. */
+					already hold the lock_sys->latch,
+					in X or S mode. */
+	bool		lock_wait_cancel_deferred;
+					/*!< set by innobase_kill_query()
+					when it could not cancel the lock
+					wait because lock_sys->latch was
+					held in S mode by the same thread;
+					protected like
+					current_lock_mutex_owner */
 	/*------------------------------*/
 #ifdef UNIV_DEBUG
 	ulint		start_line;	/*!< Track where it was started from */
@@ -1098,24 +1142,6 @@ struct commit_node_t{
 	mutex_exit(&t->mutex);			\
 } while (0)
 
-/** @brief The latch protecting the adaptive search system
-
-This latch protects the
-(1) hash index;
-(2) columns of a record to which we have a pointer in the hash index;
-
-but does NOT protect:
-
-(3) next record offset field in a record;
-(4) next or previous records on the same page.
-
-Bear in mind (3) and (4) when using the hash index.
-*/
-extern rw_lock_t*	btr_search_latch_temp;
-
-/** The latch protecting the adaptive search system */
-#define btr_search_latch	(*btr_search_latch_temp)
-
 #ifndef UNIV_NONINL
 #include "trx0trx.ic"
 #endif
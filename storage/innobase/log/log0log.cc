@@ -185,6 +185,64 @@ log_buf_pool_get_oldest_modification(void)
 	return(lsn);
 }
 
+/************************************************************//**
+Frees the tracker slots of the log buffer ranges that have been filled in,
+in the order they were reserved, and advances log_sys->copied_lsn.
+@return	number of reserved ranges that are still being copied */
+static
+ulint
+log_copies_advance(void)
+/*====================*/
+{
+	log_t*	log	= log_sys;
+
+	ut_ad(mutex_own(&(log->mutex)));
+
+	while (log->n_copies_closed != log->n_copies_reserved) {
+		const log_copy_slot_t*	slot = &log->copy_slots[
+			log->n_copies_closed % LOG_COPY_SLOTS];
+
+		if (!slot->done) {
+
+			return(log->n_copies_reserved - log->n_copies_closed);
+		}
+
+		/* Do not read the log buffer before the copy is complete */
+		os_rmb;
+
+		log->copied_lsn = slot->end_lsn;
+		log->n_copies_closed++;
+	}
+
+	/* The log written with log_write_low() while holding the log
+	mutex is complete, too */
+	log->copied_lsn = log->lsn;
+
+	return(0);
+}
+
+/************************************************************//**
+Waits until at most n_max of the log buffer ranges reserved with
+log_reserve_for_copy() are still being copied. The copying threads do not
+need the log mutex, so that the caller can keep holding it. */
+static
+void
+log_wait_for_copies(
+/*================*/
+	ulint	n_max)	/*!< in: number of ranges that may still be
+			being copied */
+{
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	for (ulint i = 0; log_copies_advance() > n_max; i++) {
+		if (i < srv_n_spin_wait_rounds) {
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		} else {
+			os_thread_yield();
+		}
+	}
+}
+
 /** Extends the log buffer.
 @param[in] len	requested minimum size in bytes */
 static
@@ -229,6 +287,9 @@ log_buffer_extend(
 		mutex_enter(&(log_sys->mutex));
 	}
 
+	/* Nobody may be copying to the buffer that is freed below */
+	log_wait_for_copies(0);
+
 	move_start = ut_calc_align_down(
 		log_sys->buf_free,
 		OS_FILE_LOG_BLOCK_SIZE);
@@ -266,8 +327,8 @@ log_buffer_extend(
 }
 
 /************************************************************//**
-Opens the log for log_write_low. The log must be closed with log_close and
-released with log_release.
+Opens the log for log_write_low. The log must be closed with log_close or
+log_reserve_for_copy and released with log_release.
 @return	start lsn of the log record */
 UNIV_INTERN
 lsn_t
@@ -373,7 +434,8 @@ UNIV_INTERN
 void
 log_write_low(
 /*==========*/
-	byte*	str,		/*!< in: string */
+	byte*	str,		/*!< in: string, or NULL to only advance
+				the lsn and the log block headers */
 	ulint	str_len)	/*!< in: string length */
 {
 	log_t*	log	= log_sys;
@@ -401,10 +463,13 @@ log_write_low(
 			- LOG_BLOCK_TRL_SIZE;
 	}
 
-	ut_memcpy(log->buf + log->buf_free, str, len);
+	if (str != NULL) {
+		ut_memcpy(log->buf + log->buf_free, str, len);
+
+		str = str + len;
+	}
 
 	str_len -= len;
-	str = str + len;
 
 	log_block = static_cast<byte*>(
 		ut_align_down(
@@ -439,12 +504,13 @@ log_write_low(
 }
 
 /************************************************************//**
-Closes the log.
+Closes the log without checking the log records catenated since
+log_reserve_and_open().
 @return	lsn */
-UNIV_INTERN
+static
 lsn_t
-log_close(void)
-/*===========*/
+log_close_low(void)
+/*===============*/
 {
 	byte*		log_block;
 	ulint		first_rec_group;
@@ -524,14 +590,134 @@ log_close(void)
 	}
 function_exit:
 
+	return(lsn);
+}
+
+/************************************************************//**
+Closes the log.
+@return	lsn */
+UNIV_INTERN
+lsn_t
+log_close(void)
+/*===========*/
+{
+	lsn_t	lsn	= log_close_low();
+
 #ifdef UNIV_LOG_DEBUG
-	log_check_log_recs(log->buf + log->old_buf_free,
-			   log->buf_free - log->old_buf_free, log->old_lsn);
+	log_check_log_recs(log_sys->buf + log_sys->old_buf_free,
+			   log_sys->buf_free - log_sys->old_buf_free,
+			   log_sys->old_lsn);
 #endif
 
 	return(lsn);
 }
 
+/************************************************************//**
+Reserves len bytes of the log buffer opened with log_reserve_and_open() and
+closes the log. The range must be filled in with log_copy_low() and
+handed back with log_copy_done(); the caller may release the log mutex
+before doing that, so that the log of several mini-transactions can be
+copied to the log buffer concurrently.
+@return	end lsn of the reserved range */
+UNIV_INTERN
+lsn_t
+log_reserve_for_copy(
+/*=================*/
+	ulint		len,	/*!< in: length of data to be catenated */
+	log_copy_t*	copy)	/*!< out: the reserved range */
+{
+	log_t*		log	= log_sys;
+	log_copy_slot_t* slot;
+
+	ut_ad(mutex_own(&(log->mutex)));
+	ut_ad(len > 0);
+
+	/* Wait for a free tracker slot */
+	log_wait_for_copies(LOG_COPY_SLOTS - 1);
+
+	copy->offset = log->buf_free;
+	copy->slot = log->n_copies_reserved % LOG_COPY_SLOTS;
+#ifdef UNIV_LOG_DEBUG
+	copy->start_offset = log->buf_free;
+	copy->start_lsn = log->lsn;
+#endif /* UNIV_LOG_DEBUG */
+
+	/* Advance the lsn and initialize the log block headers over the
+	range; only the log record bytes are left to the caller */
+	log_write_low(NULL, len);
+
+	slot = &log->copy_slots[copy->slot];
+	slot->end_lsn = log->lsn;
+	slot->done = FALSE;
+
+	log->n_copies_reserved++;
+
+	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE,
+		    log->lsn - log->last_checkpoint_lsn);
+
+	return(log_close_low());
+}
+
+/************************************************************//**
+Copies the string given to a log buffer range reserved with
+log_reserve_for_copy(). Does not need the log mutex. */
+UNIV_INTERN
+void
+log_copy_low(
+/*=========*/
+	log_copy_t*	copy,	/*!< in/out: reserved range */
+	const byte*	str,	/*!< in: string */
+	ulint		str_len)/*!< in: string length */
+{
+	/* The log buffer cannot be moved or reallocated before
+	log_copy_done(): see log_wait_for_copies() */
+
+	while (str_len > 0) {
+		ulint	len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE
+			- copy->offset % OS_FILE_LOG_BLOCK_SIZE;
+
+		if (len > str_len) {
+			len = str_len;
+		}
+
+		ut_memcpy(log_sys->buf + copy->offset, str, len);
+
+		str += len;
+		str_len -= len;
+		copy->offset += len;
+
+		if (copy->offset % OS_FILE_LOG_BLOCK_SIZE
+		    == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE) {
+			/* Skip the trailer of this block and the header
+			of the next one, written by log_write_low() */
+
+			copy->offset += LOG_BLOCK_TRL_SIZE
+				+ LOG_BLOCK_HDR_SIZE;
+		}
+	}
+}
+
+/************************************************************//**
+Marks a log buffer range reserved with log_reserve_for_copy() filled in,
+so that it can be written to the log files. Does not need the log mutex. */
+UNIV_INTERN
+void
+log_copy_done(
+/*==========*/
+	const log_copy_t*	copy)	/*!< in: reserved range */
+{
+#ifdef UNIV_LOG_DEBUG
+	log_check_log_recs(log_sys->buf + copy->start_offset,
+			   copy->offset - copy->start_offset,
+			   copy->start_lsn);
+#endif /* UNIV_LOG_DEBUG */
+
+	/* Make the copied log visible before the slot is freed */
+	os_wmb;
+
+	log_sys->copy_slots[copy->slot].done = TRUE;
+}
+
 #ifdef UNIV_LOG_ARCHIVE
 /******************************************************//**
 Pads the current log block full with dummy log records. Used in producing
@@ -867,6 +1053,11 @@ log_init(void)
 	log_sys->buf_size = LOG_BUFFER_SIZE;
 	log_sys->is_extending = false;
 
+	log_sys->copy_slots = static_cast<log_copy_slot_t*>(
+		mem_zalloc(LOG_COPY_SLOTS * sizeof *log_sys->copy_slots));
+	log_sys->n_copies_reserved = 0;
+	log_sys->n_copies_closed = 0;
+
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO
 		- LOG_BUF_FLUSH_MARGIN;
 	log_sys->check_flush_or_checkpoint = TRUE;
@@ -946,6 +1137,7 @@ log_init(void)
 
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = LOG_START_LSN + LOG_BLOCK_HDR_SIZE;
+	log_sys->copied_lsn = log_sys->lsn;
 
 	MONITOR_SET(MONITOR_LSN_CHECKPOINT_AGE,
 		    log_sys->lsn - log_sys->last_checkpoint_lsn);
@@ -1143,6 +1335,9 @@ log_sys_check_flush_completion(void)
 			move_end = ut_calc_align(log_sys->buf_free,
 						 OS_FILE_LOG_BLOCK_SIZE);
 
+			/* Nobody may be copying to the moved part */
+			log_wait_for_copies(0);
+
 			ut_memmove(log_sys->buf, log_sys->buf + move_start,
 				   move_end - move_start);
 			log_sys->buf_free -= move_start;
@@ -1522,6 +1717,14 @@ log_write_up_to(
 		goto loop;
 	}
 
+	/* The log buffer must be contiguous up to log_sys->lsn before it
+	is written: wait for the log of the mini-transactions that have
+	reserved their ranges to be copied. No new ranges can be reserved
+	while we hold the log mutex. */
+	log_wait_for_copies(0);
+
+	ut_ad(log_sys->copied_lsn == log_sys->lsn);
+
 	if (!flush_to_disk
 	    && log_sys->buf_free == log_sys->buf_next_to_write) {
 		/* Nothing to write and no flush to disk requested */
@@ -3696,6 +3899,9 @@ log_shutdown(void)
 
 	mem_free(log_sys->buf_ptr);
 	log_sys->buf_ptr = NULL;
+
+	mem_free(log_sys->copy_slots);
+	log_sys->copy_slots = NULL;
 	log_sys->buf = NULL;
 	mem_free(log_sys->checkpoint_buf_ptr);
 	log_sys->checkpoint_buf_ptr = NULL;
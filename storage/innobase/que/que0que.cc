@@ -205,7 +205,9 @@ que_thr_end_lock_wait(
 	que_thr_t*	thr;
 	ibool		was_active;
 
-	ut_ad(lock_mutex_own());
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(lock_sys_latched());
+#endif /* UNIV_SYNC_DEBUG */
 	ut_ad(trx_mutex_own(trx));
 
 	thr = trx->lock.wait_thr;
@@ -167,11 +167,19 @@ For details see: row_vers_old_has_index_entry() and row_purge_poss_sec()
 Some additional issues:
 
 What if trx_sys->view_list == NULL and some transaction T1 and Purge both
-try to open read_view at same time. Only one can acquire trx_sys->mutex.
+try to open read_view at same time. Only one can acquire trx_sys->view_mutex.
 In which order will the views be opened? Should it matter? If no, why?
 
-The order does not matter. No new transactions can be created and no running
-transaction can commit or rollback (or free views).
+The snapshot of the active transactions is copied from trx_sys->descriptors
+without holding any mutex; trx_sys->descr_version tells the reader whether a
+transaction started or committed while it was copying, in which case the copy
+is retried. After READ_VIEW_SNAPSHOT_MAX_RETRIES attempts the snapshot is
+copied under trx_sys->mutex, so that a steady stream of transaction starts and
+commits cannot starve the reader. Purge always copies it under
+trx_sys->mutex. A view must never be older than the purge view, so purge bumps
+trx_sys->n_purge_views under trx_sys->view_mutex before and after it opens
+its view. A view whose snapshot was taken before that is not added to
+trx_sys->view_list; the snapshot is taken again instead.
 */
 
 /*********************************************************************//**
@@ -214,7 +222,7 @@ read_view_clone(
 	read_view_t*	clone;
 	read_view_t*	new_view;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&trx_sys->view_mutex));
 
 	/* Allocate space for two views. */
 
@@ -253,7 +261,7 @@ read_view_add(
 	read_view_t*	elem;
 	read_view_t*	prev_elem;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&trx_sys->view_mutex));
 	ut_ad(read_view_validate(view));
 
 	/* Find the correct slot for insertion. */
@@ -273,56 +281,41 @@ read_view_add(
 	ut_ad(read_view_list_validate());
 }
 
-/** Functor to create thew view trx_ids array. */
-struct	CreateView {
-
-	CreateView(read_view_t*	view)
-		: m_view(view)
-	{
-		  m_n_trx = m_view->n_trx_ids;
-		  m_view->n_trx_ids = 0;
-	}
-
-	void	operator()(const trx_t* trx)
-	{
-		ut_ad(mutex_own(&trx_sys->mutex));
-		ut_ad(trx->in_rw_trx_list);
-
-		/* trx->state cannot change from or to NOT_STARTED
-		while we are holding the trx_sys->mutex. It may change
-		from ACTIVE to PREPARED or COMMITTED. */
-
-		if (trx->id != m_view->creator_trx_id
-		    && !trx_state_eq(trx, TRX_STATE_COMMITTED_IN_MEMORY)) {
-
-			ut_ad(m_n_trx > m_view->n_trx_ids);
+/*********************************************************************//**
+Adds a view to trx_sys->view_list unless purge has opened its view after
+the snapshot of the view was taken.
+@return true if the view was added */
+static
+bool
+read_view_try_add(
+/*==============*/
+	read_view_t*	view,		/*!< in: view to add */
+	ulint		n_purge_views)	/*!< in: trx_sys->n_purge_views
+					before the snapshot was taken */
+{
+	bool	added = false;
 
-			m_view->trx_ids[m_view->n_trx_ids++] = trx->id;
+	mutex_enter(&trx_sys->view_mutex);
 
-			/* NOTE that a transaction whose trx number is <
-			trx_sys->max_trx_id can still be active, if it is
-			in the middle of its commit! Note that when a
-			transaction starts, we initialize trx->no to
-			TRX_ID_MAX. */
+	if (trx_sys->n_purge_views == n_purge_views) {
+		read_view_add(view);
+		added = true;
+	}
 
-			/* trx->no is protected by trx_sys->mutex, which
-			we are holding. It is assigned by trx_commit()
-			before lock_trx_release_locks() assigns
-			trx->state = TRX_STATE_COMMITTED_IN_MEMORY. */
+	mutex_exit(&trx_sys->view_mutex);
 
-			if (m_view->low_limit_no > trx->no) {
-				m_view->low_limit_no = trx->no;
-			}
-		}
-	}
+	return(added);
+}
 
-	read_view_t*	m_view;
-	ulint		m_n_trx;
-};
+/** Number of times read_view_open_now_low() copies the snapshot without
+trx_sys->mutex before it falls back to copying it under the mutex */
+#define READ_VIEW_SNAPSHOT_MAX_RETRIES	16
 
 /*********************************************************************//**
-Opens a read view where exactly the transactions serialized before this
-point in time are seen in the view.
+Takes a snapshot of the transactions that are active at this point in time.
+The snapshot is copied without acquiring trx_sys->mutex, unless the caller
+owns it or the copy kept being invalidated by concurrent transaction starts
+and commits. The view is not added to the view list.
 @return	own: read view struct */
 static
 read_view_t*
@@ -330,28 +323,92 @@ read_view_open_now_low(
 /*===================*/
 	trx_id_t	cr_trx_id,	/*!< in: trx_id of creating
 					transaction, or 0 used in purge */
+	bool		own_mutex,	/*!< in: true if the caller owns
+					trx_sys->mutex */
 	mem_heap_t*	heap)		/*!< in: memory heap from which
 					allocated */
 {
-	read_view_t*	view;
-	ulint		n_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
+	read_view_t*	view = NULL;
+	ulint		n_max = 0;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	bool	locked = own_mutex;
 
-	view = read_view_create_low(n_trx, heap);
+	ut_ad(!own_mutex || mutex_own(&trx_sys->mutex));
 
-	view->undo_no = 0;
-	view->type = VIEW_NORMAL;
-	view->creator_trx_id = cr_trx_id;
+	for (ulint n_retries = 0;; n_retries++) {
+		ulint		version;
+		ulint		n_used;
+		const trx_id_t*	descr;
+
+		if (!locked && n_retries == READ_VIEW_SNAPSHOT_MAX_RETRIES) {
+			/* Writers hold trx_sys->mutex, so that the copy
+			cannot be invalidated any more. */
+			mutex_enter(&trx_sys->mutex);
+			locked = true;
+		}
+
+		version = locked ? 0 : trx_sys_descr_read_begin();
+
+		if (version & 1) {
+			/* A writer is still changing the snapshot. */
+			continue;
+		}
+
+		n_used = trx_sys->descr_n_used;
+
+		/* The array may be replaced by a bigger one while we
+		copy it, but never before descr_n_used grows. */
+		os_rmb;
+		descr = trx_sys->descriptors;
+
+		if (view == NULL || n_used > n_max) {
+			/* Leave some room for transactions that start
+			before the snapshot is retried. */
+			n_max = n_used + n_used / 10 + 1;
+			view = read_view_create_low(n_max, heap);
+		}
+
+		/* No future transactions should be visible in the view */
+
+		view->low_limit_no = trx_sys->max_trx_id;
+		view->low_limit_id = view->low_limit_no;
+
+		/* NOTE that a transaction whose trx number is <
+		trx_sys->max_trx_id can still be active, if it is
+		in the middle of its commit! Note that when a
+		transaction starts, we initialize trx->no to
+		TRX_ID_MAX. */
+
+		if (view->low_limit_no > trx_sys->descr_min_no) {
+			view->low_limit_no = trx_sys->descr_min_no;
+		}
+
+		/* No active transaction should be visible, except
+		cr_trx. The descriptors are in ascending order and
+		the view wants them in descending order. */
+
+		view->n_trx_ids = 0;
+
+		for (ulint i = n_used; i--; ) {
+			trx_id_t	id = descr[i];
 
-	/* No future transactions should be visible in the view */
+			if (id != cr_trx_id) {
+				view->trx_ids[view->n_trx_ids++] = id;
+			}
+		}
 
-	view->low_limit_no = trx_sys->max_trx_id;
-	view->low_limit_id = view->low_limit_no;
+		if (locked || trx_sys_descr_read_validate(version)) {
+			break;
+		}
+	}
 
-	/* No active transaction should be visible, except cr_trx */
+	if (locked && !own_mutex) {
+		mutex_exit(&trx_sys->mutex);
+	}
 
-	ut_list_map(trx_sys->rw_trx_list, &trx_t::trx_list, CreateView(view));
+	view->undo_no = 0;
+	view->type = VIEW_NORMAL;
+	view->creator_trx_id = cr_trx_id;
 
 	if (view->n_trx_ids > 0) {
 		/* The last active transaction has the smallest id: */
@@ -360,11 +417,6 @@ read_view_open_now_low(
 		view->up_limit_id = view->low_limit_id;
 	}
 
-	/* Purge views are not added to the view list. */
-	if (cr_trx_id > 0) {
-		read_view_add(view);
-	}
-
 	return(view);
 }
 
@@ -382,12 +434,15 @@ read_view_open_now(
 					allocated */
 {
 	read_view_t*	view;
+	ulint		n_purge_views;
 
-	mutex_enter(&trx_sys->mutex);
-
-	view = read_view_open_now_low(cr_trx_id, heap);
+	/* Purge views are not added to the view list. */
+	do {
+		n_purge_views = trx_sys->n_purge_views;
+		os_rmb;
 
-	mutex_exit(&trx_sys->mutex);
+		view = read_view_open_now_low(cr_trx_id, false, heap);
+	} while (cr_trx_id > 0 && !read_view_try_add(view, n_purge_views));
 
 	return(view);
 }
@@ -411,14 +466,25 @@ read_view_purge_open(
 	trx_id_t	creator_trx_id;
 	ulint		insert_done	= 0;
 
+	/* trx_sys->view_mutex is below trx_sys->mutex in the latching
+	order. Purge opens a view once per batch, so it simply takes the
+	snapshot under trx_sys->mutex. */
 	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
+
+	/* Views whose snapshot was taken before this point must not be
+	added to the view list any more, see read_view_try_add(). */
+	trx_sys->n_purge_views++;
 
 	oldest_view = UT_LIST_GET_LAST(trx_sys->view_list);
 
 	if (oldest_view == NULL) {
 
-		view = read_view_open_now_low(0, heap);
+		view = read_view_open_now_low(0, true, heap);
+
+		trx_sys->n_purge_views++;
 
+		mutex_exit(&trx_sys->view_mutex);
 		mutex_exit(&trx_sys->mutex);
 
 		return(view);
@@ -430,6 +496,9 @@ read_view_purge_open(
 
 	ut_ad(read_view_validate(oldest_view));
 
+	trx_sys->n_purge_views++;
+
+	mutex_exit(&trx_sys->view_mutex);
 	mutex_exit(&trx_sys->mutex);
 
 	ut_a(oldest_view->creator_trx_id > 0);
@@ -487,7 +556,7 @@ read_view_close_for_mysql(
 {
 	ut_a(trx->global_read_view);
 
-	read_view_remove(trx->global_read_view, false);
+	read_view_remove(trx->global_read_view);
 
 	mem_heap_empty(trx->global_read_view_heap);
 
@@ -546,7 +615,7 @@ read_cursor_view_create_for_mysql(
 {
 	read_view_t*	view;
 	mem_heap_t*	heap;
-	ulint		n_trx;
+	ulint		n_purge_views;
 	cursor_view_t*	curview;
 
 	/* Use larger heap than in trx_create when creating a read_view
@@ -565,39 +634,21 @@ read_cursor_view_create_for_mysql(
 
 	cr_trx->n_mysql_tables_in_use = 0;
 
-	mutex_enter(&trx_sys->mutex);
-
-	n_trx = UT_LIST_GET_LEN(trx_sys->rw_trx_list);
-
-	curview->read_view = read_view_create_low(n_trx, curview->heap);
-
-	view = curview->read_view;
-	view->undo_no = cr_trx->undo_no;
-	view->type = VIEW_HIGH_GRANULARITY;
-	view->creator_trx_id = UINT64_UNDEFINED;
+	/* No active transaction, not even cr_trx, should be visible */
 
-	/* No future transactions should be visible in the view */
+	do {
+		n_purge_views = trx_sys->n_purge_views;
+		os_rmb;
 
-	view->low_limit_no = trx_sys->max_trx_id;
-	view->low_limit_id = view->low_limit_no;
+		view = read_view_open_now_low(UINT64_UNDEFINED, false,
+					      curview->heap);
 
-	/* No active transaction should be visible */
+		view->undo_no = cr_trx->undo_no;
+		view->type = VIEW_HIGH_GRANULARITY;
+		view->creator_trx_id = cr_trx->id;
+	} while (!read_view_try_add(view, n_purge_views));
 
-	ut_list_map(trx_sys->rw_trx_list, &trx_t::trx_list, CreateView(view));
-
-	view->creator_trx_id = cr_trx->id;
-
-	if (view->n_trx_ids > 0) {
-		/* The last active transaction has the smallest id: */
-
-		view->up_limit_id = view->trx_ids[view->n_trx_ids - 1];
-	} else {
-		view->up_limit_id = view->low_limit_id;
-	}
-
-	read_view_add(view);
-
-	mutex_exit(&trx_sys->mutex);
+	curview->read_view = view;
 
 	return(curview);
 }
@@ -620,7 +671,7 @@ read_cursor_view_close_for_mysql(
 	belong to this transaction */
 	trx->n_mysql_tables_in_use += curview->n_mysql_tables_in_use;
 
-	read_view_remove(curview->read_view, false);
+	read_view_remove(curview->read_view);
 
 	trx->read_view = trx->global_read_view;
 
@@ -640,7 +691,7 @@ read_cursor_set_for_mysql(
 {
 	ut_a(trx);
 
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	if (UNIV_LIKELY(curview != NULL)) {
 		trx->read_view = curview->read_view;
@@ -650,5 +701,5 @@ read_cursor_set_for_mysql(
 
 	ut_ad(read_view_validate(trx->read_view));
 
-	mutex_exit(&trx_sys->mutex);
+	mutex_exit(&trx_sys->view_mutex);
 }
@@ -877,8 +877,9 @@ row_purge_record_func(
 
 /***********************************************************//**
 Fetches an undo log record and does the purge for the recorded operation.
-If none left, or the current purge completed, returns the control to the
-parent node, which is always a query thread node. */
+When the group of records of the node is empty, claims the next group of
+the purge batch. If none left, or the current purge completed, returns
+the control to the parent node, which is always a query thread node. */
 static __attribute__((nonnull))
 void
 row_purge(
@@ -929,6 +930,8 @@ row_purge_end(
 
 	node->undo_recs = NULL;
 
+	node->group = NULL;
+
 	node->done = TRUE;
 
 	ut_a(thr->run_node != NULL);
@@ -965,24 +968,33 @@ row_purge_step(
 
 	ut_ad(que_node_get_type(node) == QUE_NODE_PURGE);
 
-	if (!(node->undo_recs == NULL || ib_vector_is_empty(node->undo_recs))) {
-		trx_purge_rec_t*purge_rec;
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			ib_vector_pop(node->undo_recs));
+	while (node->undo_recs == NULL || ib_vector_is_empty(node->undo_recs)) {
 
-		node->roll_ptr = purge_rec->roll_ptr;
+		if (node->group != NULL) {
+			trx_purge_group_done(node->group);
+		}
 
-		row_purge(node, purge_rec->undo_rec, thr);
+		node->group = trx_purge_claim_group();
 
-		if (ib_vector_is_empty(node->undo_recs)) {
+		if (node->group == NULL) {
 			row_purge_end(thr);
-		} else {
-			thr->run_node = node;
+
+			return(thr);
 		}
-	} else {
-		row_purge_end(thr);
+
+		node->undo_recs = node->group->recs;
 	}
 
+	trx_purge_rec_t*	purge_rec;
+
+	purge_rec = static_cast<trx_purge_rec_t*>(
+		ib_vector_pop(node->undo_recs));
+
+	node->roll_ptr = purge_rec->roll_ptr;
+
+	row_purge(node, purge_rec->undo_rec, thr);
+
+	thr->run_node = node;
+
 	return(thr);
 }
@@ -1216,7 +1216,7 @@ row_sel_try_search_shortcut(
 				index */
 	ibool		search_latch_locked,
 				/*!< in: whether the search holds
-				btr_search_latch */
+				the adaptive hash index latch of the index */
 	mtr_t*		mtr)	/*!< in: mtr */
 {
 	dict_index_t*	index;
@@ -1234,7 +1234,8 @@ row_sel_try_search_shortcut(
 	ut_ad(!plan->must_get_clust);
 #ifdef UNIV_SYNC_DEBUG
 	if (search_latch_locked) {
-		ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
+		ut_ad(rw_lock_own(btr_search_get_latch(index),
+				  RW_LOCK_SHARED));
 	}
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -1406,10 +1407,11 @@ row_sel(
 	    && !plan->must_get_clust
 	    && !plan->table->big_rows) {
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_lock(btr_search_get_latch(index));
 
 			search_latch_locked = TRUE;
-		} else if (rw_lock_get_writer(&btr_search_latch) == RW_LOCK_WAIT_EX) {
+		} else if (rw_lock_get_writer(btr_search_get_latch(index))
+			   == RW_LOCK_WAIT_EX) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1418,8 +1420,8 @@ row_sel(
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(btr_search_get_latch(index));
+			rw_lock_s_lock(btr_search_get_latch(index));
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan,
@@ -1444,7 +1446,7 @@ row_sel(
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(index));
 
 		search_latch_locked = FALSE;
 	}
@@ -2016,7 +2018,7 @@ row_sel(
 
 func_exit:
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(index));
 	}
 	if (UNIV_LIKELY_NULL(heap)) {
 		mem_heap_free(heap);
@@ -3390,23 +3392,118 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/*********************************************************************//**
+Frees the cache of prefetched rows of a table handle. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_free(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	i;
+	byte*	base;
+	byte*	ptr;
+
+	if (prebuilt->fetch_cache == NULL) {
+		return;
+	}
+
+	base = prebuilt->fetch_cache[0] - 4;
+	ptr = base;
+
+	for (i = 0; i < prebuilt->fetch_cache_size; i++) {
+		byte*	row;
+		ulint	magic1;
+		ulint	magic2;
+
+		magic1 = mach_read_from_4(ptr);
+		ptr += 4;
+
+		row = ptr;
+		ptr += prebuilt->mysql_row_len;
+
+		magic2 = mach_read_from_4(ptr);
+		ptr += 4;
+
+		if (ROW_PREBUILT_FETCH_MAGIC_N != magic1
+		    || row != prebuilt->fetch_cache[i]
+		    || ROW_PREBUILT_FETCH_MAGIC_N != magic2) {
+
+			fputs("InnoDB: Error: trying to free"
+				" a corrupt fetch buffer.\n", stderr);
+
+			mem_analyze_corruption(base);
+			ut_error;
+		}
+	}
+
+	mem_free(base);
+	mem_free(prebuilt->fetch_cache);
+
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_size = 0;
+}
+
+/*********************************************************************//**
+Frees the cache of prefetched rows of a table handle if it has grown beyond
+MYSQL_FETCH_CACHE_SIZE rows and holds no rows, so that an idle handle does
+not keep up to srv_prefetch_cache_size bytes. The next scan allocates the
+initial cache again. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_shrink(
+/*==========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	if (prebuilt->n_fetch_cached == 0
+	    && prebuilt->fetch_cache_size > MYSQL_FETCH_CACHE_SIZE) {
+
+		row_sel_prefetch_cache_free(prebuilt);
+	}
+}
+
+/********************************************************************//**
+Gets the number of rows that fit in srv_prefetch_cache_size bytes of the
+prefetch cache, but at least MYSQL_FETCH_CACHE_SIZE.
+@return maximum number of rows in the prefetch cache */
+UNIV_INLINE
+ulint
+row_sel_prefetch_cache_max(
+/*=======================*/
+	const row_prebuilt_t*	prebuilt)	/*!< in: prebuilt struct */
+{
+	ulint	n_rows = srv_prefetch_cache_size
+		/ (prebuilt->mysql_row_len + 8);
+
+	return(ut_max(n_rows, MYSQL_FETCH_CACHE_SIZE));
+}
+
 /********************************************************************//**
 Initialise the prefetch cache. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
 /*========================*/
-	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	ulint		n_rows)		/*!< in: number of rows to allocate */
 {
 	ulint	i;
 	ulint	sz;
 	byte*	ptr;
 
+	ut_ad(prebuilt->n_fetch_cached == 0);
+
+	row_sel_prefetch_cache_free(prebuilt);
+
+	prebuilt->fetch_cache = static_cast<byte**>(
+		mem_alloc(n_rows * sizeof *prebuilt->fetch_cache));
+	prebuilt->fetch_cache_size = n_rows;
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = n_rows * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(mem_alloc(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < n_rows; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3433,15 +3530,23 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache. Once the scan
+		has filled the initial cache, allocate all the rows that
+		srv_prefetch_cache_size allows, so that the cache can be
+		filled up to the end of a page. */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
-		row_sel_prefetch_cache_init(prebuilt);
+		row_sel_prefetch_cache_init(
+			prebuilt,
+			prebuilt->fetch_cache_limit > MYSQL_FETCH_CACHE_SIZE
+			? ut_max(row_sel_prefetch_cache_max(prebuilt),
+				 prebuilt->fetch_cache_limit)
+			: MYSQL_FETCH_CACHE_SIZE);
 	}
 
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 	ut_ad(prebuilt->fetch_cache_first == 0);
 	UNIV_MEM_INVALID(prebuilt->fetch_cache[prebuilt->n_fetch_cached],
 			 prebuilt->mysql_row_len);
@@ -3467,7 +3572,47 @@ row_sel_enqueue_cache_row_for_mysql(
 		ut_memcpy(dest, mysql_rec, prebuilt->mysql_row_len);
 	}
 
-	++prebuilt->n_fetch_cached;
+	if (prebuilt->n_fetch_cached++ == 0) {
+		srv_stats.n_prefetch_cache_refills.inc();
+	}
+}
+
+/********************************************************************//**
+Checks if more rows should be fetched into the prefetch cache before
+returning to MySQL. The cache is filled up to fetch_cache_limit rows, and
+then up to the end of the current page while there is room, so that the
+next refill does not have to restore the cursor on the same page.
+Doubles fetch_cache_limit when the cache is full.
+@return TRUE if more rows should be fetched */
+UNIV_INLINE
+ibool
+row_sel_prefetch_cache_wants_more(
+/*==============================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	const rec_t*	rec,		/*!< in: record that the cursor
+					is positioned on */
+	ibool		moves_up)	/*!< in: TRUE if the cursor moves
+					up in the index */
+{
+	if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
+
+		return(TRUE);
+	}
+
+	if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size
+	    && (moves_up
+		? !page_rec_is_supremum(page_rec_get_next_const(rec))
+		: !page_rec_is_infimum(page_rec_get_prev_const(rec)))) {
+
+		return(TRUE);
+	}
+
+	/* The scan goes on: cache more rows in the next refill. */
+	prebuilt->fetch_cache_limit = ut_min(
+		2 * prebuilt->fetch_cache_limit,
+		row_sel_prefetch_cache_max(prebuilt));
+
+	return(FALSE);
 }
 
 /*********************************************************************//**
@@ -3705,7 +3850,9 @@ row_search_for_mysql(
 		return(DB_END_OF_INDEX);
 	}
 
+	ut_ad(!trx->has_search_latch);
 #ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
 	ut_ad(!sync_thread_levels_nonempty_trx(trx->has_search_latch));
 #endif /* UNIV_SYNC_DEBUG */
 
@@ -3766,24 +3913,6 @@ row_search_for_mysql(
 	fprintf(stderr, "N tables locked %lu\n",
 		(ulong) trx->mysql_n_tables_locked);
 #endif
-	/*-------------------------------------------------------------*/
-	/* PHASE 0: Release a possible s-latch we are holding on the
-	adaptive hash index latch if there is someone waiting behind */
-
-	if (UNIV_UNLIKELY(rw_lock_get_writer(&btr_search_latch) != RW_LOCK_NOT_LOCKED)
-	    && trx->has_search_latch) {
-
-		/* There is an x-latch request on the adaptive hash index:
-		release the s-latch to reduce starvation and wait for
-		BTR_SEA_TIMEOUT rounds before trying to keep it again over
-		calls from MySQL */
-
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-
-		trx->search_latch_timeout = BTR_SEA_TIMEOUT;
-	}
-
 	/* Reset the new record lock info if srv_locks_unsafe_for_binlog
 	is set or session is using a READ COMMITED isolation level. Then
 	we are able to remove the record locks set here on an individual
@@ -3799,6 +3928,8 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+		row_sel_prefetch_cache_shrink(prebuilt);
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3823,6 +3954,8 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+			row_sel_prefetch_cache_shrink(prebuilt);
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -3930,10 +4063,9 @@ row_search_for_mysql(
 			hash index semaphore! */
 
 #ifndef UNIV_SEARCH_DEBUG
-			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
-				trx->has_search_latch = TRUE;
-			}
+			ut_ad(!trx->has_search_latch);
+			rw_lock_s_lock(btr_search_get_latch(index));
+			trx->has_search_latch = TRUE;
 #endif
 			switch (row_sel_try_search_shortcut_for_mysql(
 					&rec, prebuilt, &offsets, &heap,
@@ -3989,7 +4121,7 @@ row_search_for_mysql(
 				fputs(" shortcut\n", stderr); */
 
 				err = DB_SUCCESS;
-				goto release_search_latch_if_needed;
+				goto release_search_latch;
 
 			case SEL_EXHAUSTED:
 			shortcut_mismatch:
@@ -3999,13 +4131,10 @@ row_search_for_mysql(
 				fputs(" record not found 2\n", stderr); */
 
 				err = DB_RECORD_NOT_FOUND;
-release_search_latch_if_needed:
-				if (trx->search_latch_timeout > 0
-				    && trx->has_search_latch) {
-
-					trx->search_latch_timeout--;
-
-					rw_lock_s_unlock(&btr_search_latch);
+release_search_latch:
+				if (trx->has_search_latch) {
+					rw_lock_s_unlock(
+						btr_search_get_latch(index));
 					trx->has_search_latch = FALSE;
 				}
 
@@ -4022,16 +4151,21 @@ row_search_for_mysql(
 
 			mtr_commit(&mtr);
 			mtr_start_trx(&mtr, trx);
+
+			if (trx->has_search_latch) {
+				rw_lock_s_unlock(btr_search_get_latch(index));
+				trx->has_search_latch = FALSE;
+			}
 		}
 	}
 
 	/*-------------------------------------------------------------*/
 	/* PHASE 3: Open or restore index cursor position */
 
-	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
-		trx->has_search_latch = FALSE;
-	}
+	ut_ad(!trx->has_search_latch);
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
+#endif /* UNIV_SYNC_DEBUG */
 
 	/* The state of a running trx can only be changed by the
 	thread that is currently serving the transaction. Because we
@@ -4897,7 +5031,9 @@ row_search_for_mysql(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached
+		     < ut_max(prebuilt->fetch_cache_limit,
+			      prebuilt->fetch_cache_size));
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4950,7 +5086,8 @@ row_search_for_mysql(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (row_sel_prefetch_cache_wants_more(prebuilt, rec,
+						      moves_up)) {
 			goto next_rec;
 		}
 
@@ -5222,6 +5359,11 @@ row_search_for_mysql(
 		mem_heap_free(heap);
 	}
 
+	if (err == DB_RECORD_NOT_FOUND || err == DB_END_OF_INDEX) {
+		/* The scan ended */
+		row_sel_prefetch_cache_shrink(prebuilt);
+	}
+
 	/* Set or reset the "did semi-consistent read" flag on return.
 	The flag did_semi_consistent_read is set if and only if
 	the record being returned was fetched with a semi-consistent read. */
@@ -5236,7 +5378,9 @@ row_search_for_mysql(
 		}
 	}
 
+	ut_ad(!trx->has_search_latch);
 #ifdef UNIV_SYNC_DEBUG
+	ut_ad(!btr_search_own_any());
 	ut_ad(!sync_thread_levels_nonempty_trx(trx->has_search_latch));
 #endif /* UNIV_SYNC_DEBUG */
 
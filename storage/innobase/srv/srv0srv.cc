@@ -55,6 +55,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "lock0lock.h"
 #include "trx0purge.h"
 #include "ibuf0ibuf.h"
+#include "buf0dump.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "btr0sea.h"
@@ -70,6 +71,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "srv0mon.h"
 #include "ut0crc32.h"
 #include "btr0defragment.h"
+#include "fts0fts.h"
 
 #include "mysql/plugin.h"
 #include "mysql/service_thd_wait.h"
@@ -142,8 +144,16 @@ UNIV_INTERN ulint	srv_max_file_format_at_startup = UNIV_FORMAT_MAX;
 /** Place locks to records only i.e. do not use next-key locking except
 on duplicate key checking and foreign key checking */
 UNIV_INTERN ibool	srv_locks_unsafe_for_binlog = FALSE;
+/** Maximum size in bytes of the cache of prefetched rows of a table
+handle in a range scan */
+UNIV_INTERN ulong	srv_prefetch_cache_size = 65536;
 /** Sort buffer size in index creation */
 UNIV_INTERN ulong	srv_sort_buf_size = 1048576;
+/** Number of threads that scan and sort in index creation */
+UNIV_INTERN ulong	srv_n_ddl_threads = 1;
+/** Percentage of the space on an index page that is filled when an
+index is built from sorted entries */
+UNIV_INTERN ulong	srv_fill_factor = 100;
 /** Maximum modification log file size for online index creation */
 UNIV_INTERN unsigned long long	srv_online_max_size;
 
@@ -205,6 +215,7 @@ UNIV_INTERN ibool	srv_created_new_raw	= FALSE;
 UNIV_INTERN char*	srv_log_group_home_dir	= NULL;
 
 UNIV_INTERN ulong	srv_n_log_files		= SRV_N_LOG_FILES_MAX;
+UNIV_INTERN ulong	srv_n_log_apply_threads	= 1;
 /* size in database pages */
 UNIV_INTERN ib_uint64_t	srv_log_file_size	= IB_UINT64_MAX;
 UNIV_INTERN ib_uint64_t	srv_log_file_size_requested;
@@ -387,6 +398,11 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 UNIV_INTERN ulong	srv_doublewrite_batch_size	= 120;
 
+/** Number of pages in the doublewrite segment of each buffer pool instance
+in the file BUF_DBLWR_SEG_FILE_NAME. If zero, the batches of all the
+instances go through the doublewrite buffer above. */
+UNIV_INTERN ulong	srv_doublewrite_segment_size	= 0;
+
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
 /*-------------------------------------------*/
@@ -673,6 +689,12 @@ and/or load it during startup. */
 UNIV_INTERN char	srv_buffer_pool_dump_at_shutdown = FALSE;
 UNIV_INTERN char	srv_buffer_pool_load_at_startup = FALSE;
 
+/** Interval in seconds of the periodic buffer pool dumps, 0 if none */
+UNIV_INTERN ulong	srv_buf_dump_interval = 0;
+
+/** Number of threads that read pages during a buffer pool load */
+UNIV_INTERN ulong	srv_n_buf_load_threads = 4;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -1029,6 +1051,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		buf_load_init();
+
 		UT_LIST_INIT(srv_sys->tasks);
 	}
 
@@ -1061,6 +1085,8 @@ srv_init(void)
 	/* Initialize some INFORMATION SCHEMA internal structures */
 	trx_i_s_cache_init(trx_i_s_cache);
 
+	fts_plist_cache_init();
+
 	ut_crc32_init();
 
 	dict_mem_init();
@@ -1082,9 +1108,13 @@ srv_free(void)
 
 	trx_i_s_cache_free(trx_i_s_cache);
 
+	fts_plist_cache_free();
+
 	if (!srv_read_only_mode) {
 		os_event_free(srv_buf_dump_event);
 		srv_buf_dump_event = NULL;
+
+		buf_load_free();
 	}
 }
 
@@ -1300,7 +1330,9 @@ srv_printf_innodb_monitor(
 	      "-------------------------------------\n", file);
 	ibuf_print(file);
 
-	ha_print_info(file, btr_search_sys->hash_index);
+	for (ulint i = 0; i < btr_search_index_num; i++) {
+		ha_print_info(file, btr_search_sys->hash_tables[i]);
+	}
 
 	fprintf(file,
 		"%.2f hash searches/s, %.2f non-hash searches/s\n",
@@ -1336,7 +1368,7 @@ srv_printf_innodb_monitor(
 		(long) srv_conc_get_active_threads(),
 		srv_conc_get_waiting_threads());
 
-	/* This is a dirty read, without holding trx_sys->mutex. */
+	/* This is a dirty read, without holding trx_sys->view_mutex. */
 	fprintf(file, "%lu read views open inside InnoDB\n",
 		UT_LIST_GET_LEN(trx_sys->view_list));
 
@@ -1558,6 +1590,9 @@ srv_export_innodb_status(void)
 
 	export_vars.innodb_rows_deleted = srv_stats.n_rows_deleted;
 
+	export_vars.innodb_prefetch_cache_refills =
+		srv_stats.n_prefetch_cache_refills;
+
 	export_vars.innodb_system_rows_read = srv_stats.n_system_rows_read;
 
 	export_vars.innodb_system_rows_inserted =
@@ -1687,7 +1722,7 @@ DECLARE_THREAD(srv_monitor_thread)(
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys->mutex
+			ensure we will not be blocked by lock_sys->latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!last_srv_print_monitor) {
@@ -1805,6 +1805,9 @@ innobase_start_or_create_for_mysql(void)
 	their time to enter InnoDB. */
 
 #define BUF_POOL_SIZE_THRESHOLD (1024 * 1024 * 1024)
+	fts_query_max_prefetch_threads = (fts_query_threads - 1)
+		* max_connections;
+
 	srv_max_n_threads = 1   /* io_ibuf_thread */
 			    + 1 /* io_log_thread */
 			    + 1 /* lock_wait_timeout_thread */
@@ -1813,9 +1816,11 @@ innobase_start_or_create_for_mysql(void)
 			    + 1 /* srv_master_thread */
 			    + 1 /* srv_purge_coordinator_thread */
 			    + 1 /* buf_dump_thread */
+			    + srv_n_buf_load_threads /* buf_load_thread */
 			    + 1 /* dict_stats_thread */
 			    + 1 /* fts_optimize_thread */
 			    + 1 /* recv_writer_thread */
+			    + srv_n_log_apply_threads /* recv_apply_thread */
 			    + 1 /* buf_flush_page_cleaner_thread */
 			    + 1 /* trx_rollback_or_clean_all_recovered */
 			    + 128 /* added as margin, for use of
@@ -1826,7 +1831,11 @@ innobase_start_or_create_for_mysql(void)
 			    + srv_n_purge_threads
 			    /* FTS Parallel Sort */
 			    + fts_sort_pll_degree * FTS_NUM_AUX_INDEX
-			      * max_connections;
+			      * max_connections
+			    /* Parallel index creation */
+			    + srv_n_ddl_threads * max_connections
+			    /* FTS query prefetch */
+			    + fts_query_max_prefetch_threads;
 
 	if (srv_buf_pool_size < BUF_POOL_SIZE_THRESHOLD) {
 		/* If buffer pool is less than 1 GB,
@@ -2420,6 +2429,8 @@ innobase_start_or_create_for_mysql(void)
 			LOG_CHECKPOINT, LSN_MAX,
 			min_flushed_lsn, max_flushed_lsn);
 
+		buf_dblwr_free_seg_pages();
+
 		if (err != DB_SUCCESS) {
 
 			return(DB_ERROR);
@@ -2925,7 +2936,7 @@ srv_fts_close(void)
 		fts_t*          fts = table->fts;
 
 		if (fts != NULL) {
-			fts_sync_table(table);
+			fts_sync_table(table, false, true);
 		}
 	}
 
@@ -2934,7 +2945,7 @@ srv_fts_close(void)
 		fts_t*          fts = table->fts;
 
 		if (fts != NULL) {
-			fts_sync_table(table);
+			fts_sync_table(table, false, true);
 		}
 	}
 }
@@ -315,6 +315,31 @@ trx_undo_rec_get_pars(
 	return(ptr);
 }
 
+/**********************************************************************//**
+Checks if purge has work to do for an update undo log record: the record
+delete-marks a row, updates an ordering field or updates an externally
+stored field. Purge skips the other update undo log records.
+@return	true if purge has to process the record */
+UNIV_INTERN
+bool
+trx_undo_rec_needs_purge(
+/*=====================*/
+	const trx_undo_rec_t*	undo_rec)	/*!< in: update undo log
+						record */
+{
+	ulint	type = trx_undo_rec_get_type(undo_rec);
+
+	if (type == TRX_UNDO_DEL_MARK_REC
+	    || trx_undo_rec_get_extern_storage(undo_rec)) {
+
+		return(true);
+	}
+
+	return(type == TRX_UNDO_UPD_EXIST_REC
+	       && !(trx_undo_rec_get_cmpl_info(undo_rec)
+		    & UPD_NODE_NO_ORD_CHANGE));
+}
+
 /**********************************************************************//**
 Reads from an undo log record a stored column value.
 @return	remaining part of undo log record after reading these values */
@@ -1351,8 +1376,18 @@ trx_undo_report_row_operation(
 		} else {
 			/* Success */
 
+			/* Count the records that purge will have to
+			process in the purge lag of the table. */
+			bool	needs_purge = op_type == TRX_UNDO_MODIFY_OP
+				&& trx_undo_rec_needs_purge(undo_page + offset);
+
 			mtr_commit(&mtr);
 
+			if (needs_purge) {
+				os_atomic_increment_lint(
+					&index->table->n_purge_lag, 1);
+			}
+
 			undo->empty = FALSE;
 			undo->top_page_no = page_no;
 			undo->top_offset  = offset;
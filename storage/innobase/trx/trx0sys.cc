@@ -118,6 +118,7 @@ static const ulint	FILE_FORMAT_NAME_N
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	file_format_max_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	trx_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_sys_view_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 #ifndef UNIV_HOTBACKUP
@@ -638,6 +639,17 @@ trx_sys_init_at_db_start(void)
 
 	mtr_start(&mtr);
 
+	/* Allocate the trx descriptors array */
+	trx_sys->descr_heap = mem_heap_create(
+		sizeof(trx_id_t) * TRX_DESCR_ARRAY_INITIAL_SIZE);
+	trx_sys->descriptors = static_cast<trx_id_t*>(
+		mem_heap_alloc(trx_sys->descr_heap,
+			       sizeof(trx_id_t)
+			       * TRX_DESCR_ARRAY_INITIAL_SIZE));
+	trx_sys->descr_n_max = TRX_DESCR_ARRAY_INITIAL_SIZE;
+	trx_sys->descr_n_used = 0;
+	trx_sys->descr_min_no = TRX_ID_MAX;
+
 	sys_header = trx_sysf_get(&mtr);
 
 	if (srv_force_recovery < SRV_FORCE_NO_UNDO_LOG_SCAN) {
@@ -724,6 +736,8 @@ trx_sys_create(void)
 	trx_sys = static_cast<trx_sys_t*>(mem_zalloc(sizeof(*trx_sys)));
 
 	mutex_create(trx_sys_mutex_key, &trx_sys->mutex, SYNC_TRX_SYS);
+	mutex_create(trx_sys_view_mutex_key, &trx_sys->view_mutex,
+		     SYNC_READ_VIEW);
 }
 
 /*****************************************************************//**
@@ -1299,7 +1313,7 @@ trx_sys_close(void)
 	/* Check that all read views are closed except read view owned
 	by a purge. */
 
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	if (UT_LIST_GET_LEN(trx_sys->view_list) > 1) {
 		fprintf(stderr,
@@ -1309,7 +1323,7 @@ trx_sys_close(void)
 			UT_LIST_GET_LEN(trx_sys->view_list) - 1);
 	}
 
-	mutex_exit(&trx_sys->mutex);
+	mutex_exit(&trx_sys->view_mutex);
 
 	sess_close(trx_dummy_sess);
 	trx_dummy_sess = NULL;
@@ -1330,6 +1344,9 @@ trx_sys_close(void)
 		trx_free_prepared(trx);
 	}
 
+	ut_a(trx_sys->descr_n_used == 0);
+	mem_heap_free(trx_sys->descr_heap);
+
 	/* There can't be any active transactions. */
 	for (i = 0; i < TRX_SYS_N_RSEGS; ++i) {
 		trx_rseg_t*	rseg;
@@ -1343,6 +1360,8 @@ trx_sys_close(void)
 		}
 	}
 
+	mutex_enter(&trx_sys->view_mutex);
+
 	view = UT_LIST_GET_FIRST(trx_sys->view_list);
 
 	while (view != NULL) {
@@ -1356,6 +1375,9 @@ trx_sys_close(void)
 	}
 
 	ut_a(UT_LIST_GET_LEN(trx_sys->view_list) == 0);
+
+	mutex_exit(&trx_sys->view_mutex);
+
 	ut_a(UT_LIST_GET_LEN(trx_sys->ro_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->rw_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->mysql_trx_list) == 0);
@@ -1363,6 +1385,7 @@ trx_sys_close(void)
 	mutex_exit(&trx_sys->mutex);
 
 	mutex_free(&trx_sys->mutex);
+	mutex_free(&trx_sys->view_mutex);
 
 	mem_free(trx_sys);
 
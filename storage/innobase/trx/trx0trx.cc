@@ -94,6 +94,150 @@ trx_set_detailed_error_from_file(
 			    sizeof(trx->detailed_error));
 }
 
+/*************************************************************//**
+Callback function for trx_find_descriptor() to compare trx IDs. */
+UNIV_INTERN
+int
+trx_descr_cmp(
+/*==========*/
+	const void *a,	/*!< in: pointer to first comparison argument */
+	const void *b)	/*!< in: pointer to second comparison argument */
+{
+	const trx_id_t*	da = (const trx_id_t*) a;
+	const trx_id_t*	db = (const trx_id_t*) b;
+
+	if (*da < *db) {
+		return -1;
+	} else if (*da > *db) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/*************************************************************//**
+Reserve a slot for a given trx in the global descriptors array. */
+UNIV_INLINE
+void
+trx_reserve_descriptor(
+/*===================*/
+	const trx_t* trx)	/*!< in: trx pointer */
+{
+	ulint		n_used;
+	ulint		n_max;
+	trx_id_t*	descr;
+
+	ut_ad(srv_is_being_started
+	      || (mutex_own(&trx_sys->mutex)
+		  && (trx_sys->descr_version & 1)));
+	ut_ad(srv_is_being_started ||
+	      !trx_find_descriptor(trx_sys->descriptors,
+				   trx_sys->descr_n_used,
+				   trx->id));
+
+	n_used = trx_sys->descr_n_used + 1;
+	n_max = trx_sys->descr_n_max;
+
+	if (UNIV_UNLIKELY(n_used > n_max)) {
+
+		n_max = n_max * 2;
+
+		descr = static_cast<trx_id_t*>(
+			mem_heap_alloc(trx_sys->descr_heap,
+				       n_max * sizeof(trx_id_t)));
+
+		memcpy(descr, trx_sys->descriptors,
+		       trx_sys->descr_n_used * sizeof(trx_id_t));
+
+		trx_sys->descriptors = descr;
+		trx_sys->descr_n_max = n_max;
+
+		/* read_view_open_now_low() reads descr_n_used before
+		descriptors. It must not find the grown descr_n_used
+		together with the old array. */
+		os_wmb;
+	}
+
+	descr = trx_sys->descriptors + n_used - 1;
+
+	if (UNIV_UNLIKELY(n_used > 1 && trx->id < descr[-1])) {
+
+		/* Find the slot where it should be inserted. We could use a
+		binary search, but in reality linear search should be faster,
+		because the slot we are looking for is near the array end. */
+
+		trx_id_t*	tdescr;
+
+		for (tdescr = descr - 1;
+		     tdescr >= trx_sys->descriptors && *tdescr > trx->id;
+		     tdescr--) {
+		}
+
+		tdescr++;
+
+		ut_memmove(tdescr + 1, tdescr, (descr - tdescr) *
+			   sizeof(trx_id_t));
+
+		descr = tdescr;
+	}
+
+	*descr = trx->id;
+
+	trx_sys->descr_n_used = n_used;
+}
+
+/*************************************************************//**
+Release a slot for a given trx in the global descriptors array. */
+UNIV_INTERN
+void
+trx_release_descriptor(
+/*===================*/
+	trx_t* trx)	/*!< in: trx pointer */
+{
+	ulint		size;
+	trx_id_t*	descr;
+
+	ut_ad(mutex_own(&trx_sys->mutex));
+
+	descr = trx_find_descriptor(trx_sys->descriptors,
+				    trx_sys->descr_n_used,
+				    trx->id);
+
+	if (descr == NULL && !trx->in_trx_serial_list) {
+
+		return;
+	}
+
+	trx_sys_descr_change_begin();
+
+	if (UNIV_LIKELY(trx->in_trx_serial_list)) {
+
+		trx_t*	first;
+
+		UT_LIST_REMOVE(trx_serial_list, trx_sys->trx_serial_list,
+			       trx);
+		trx->in_trx_serial_list = false;
+
+		first = UT_LIST_GET_FIRST(trx_sys->trx_serial_list);
+		trx_sys->descr_min_no = first != NULL ? first->no : TRX_ID_MAX;
+	}
+
+	if (UNIV_LIKELY(descr != NULL)) {
+
+		size = (trx_sys->descriptors + trx_sys->descr_n_used - 1
+			- descr) * sizeof(trx_id_t);
+
+		if (UNIV_LIKELY(size > 0)) {
+
+			ut_memmove(descr, descr + 1, size);
+		}
+
+		trx_sys->descr_n_used--;
+	}
+
+	trx_sys_descr_change_end();
+}
+
 /****************************************************************//**
 Creates and initializes a transaction object. It must be explicitly
 started with trx_start_if_not_started() before using it. The default
@@ -120,6 +264,7 @@ trx_create(void)
 	trx->isolation_level = TRX_ISO_REPEATABLE_READ;
 
 	trx->no = TRX_ID_MAX;
+	trx->in_trx_serial_list = false;
 
 	trx->support_xa = TRUE;
 
@@ -326,6 +471,8 @@ trx_free_prepared(
 	UT_LIST_REMOVE(trx_list, trx_sys->rw_trx_list, trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
+	trx_release_descriptor(trx);
+
 	/* Undo trx_resurrect_table_locks(). */
 	UT_LIST_INIT(trx->lock.trx_locks);
 
@@ -699,6 +846,7 @@ trx_lists_init_at_db_start(void)
 
 	UT_LIST_INIT(trx_sys->ro_trx_list);
 	UT_LIST_INIT(trx_sys->rw_trx_list);
+	UT_LIST_INIT(trx_sys->trx_serial_list);
 
 	/* Look from the rollback segments if there exist undo logs for
 	transactions */
@@ -721,6 +869,11 @@ trx_lists_init_at_db_start(void)
 
 			trx = trx_resurrect_insert(undo, rseg);
 
+			if (trx->state == TRX_STATE_ACTIVE ||
+			    trx->state == TRX_STATE_PREPARED) {
+
+				trx_reserve_descriptor(trx);
+			}
 			trx_list_rw_insert_ordered(trx);
 
 			trx_resurrect_table_locks(trx, undo);
@@ -748,6 +901,11 @@ trx_lists_init_at_db_start(void)
 			trx_resurrect_update(trx, undo, rseg);
 
 			if (trx_created) {
+				if (trx->state == TRX_STATE_ACTIVE ||
+				    trx->state == TRX_STATE_PREPARED) {
+
+					trx_reserve_descriptor(trx);
+				}
 				trx_list_rw_insert_ordered(trx);
 			}
 
@@ -884,6 +1042,10 @@ trx_start_low(
 
 	trx->state = TRX_STATE_ACTIVE;
 
+	/* Read views must find the new id in the descriptors array
+	as soon as they can find it below trx_sys->max_trx_id. */
+	trx_sys_descr_change_begin();
+
 	trx->id = trx_sys_get_new_trx_id();
 
 	ut_ad(!trx->in_rw_trx_list);
@@ -912,8 +1074,12 @@ trx_start_low(
 			trx_sys->rw_max_trx_id = trx->id;
 		}
 #endif /* UNIV_DEBUG */
+
+		trx_reserve_descriptor(trx);
 	}
 
+	trx_sys_descr_change_end();
+
 	ut_ad(trx_sys_validate_trx_list());
 
 	mutex_exit(&trx_sys->mutex);
@@ -939,8 +1105,24 @@ trx_serialisation_number_get(
 
 	mutex_enter(&trx_sys->mutex);
 
+	trx_sys_descr_change_begin();
+
 	trx->no = trx_sys_get_new_trx_id();
 
+	if (UNIV_LIKELY(!trx->in_trx_serial_list)) {
+
+		UT_LIST_ADD_LAST(trx_serial_list, trx_sys->trx_serial_list,
+				 trx);
+
+		trx->in_trx_serial_list = true;
+
+		if (UT_LIST_GET_LEN(trx_sys->trx_serial_list) == 1) {
+			trx_sys->descr_min_no = trx->no;
+		}
+	}
+
+	trx_sys_descr_change_end();
+
 	/* If the rollack segment is not empty then the
 	new trx_t::no can't be less than any trx_t::no
 	already in the rollback segment. User threads only
@@ -1213,7 +1395,7 @@ trx_commit_in_memory(
 
 		trx->state = TRX_STATE_NOT_STARTED;
 
-		read_view_remove(trx->global_read_view, false);
+		read_view_remove(trx->global_read_view);
 
 		MONITOR_INC(MONITOR_TRX_NL_RO_COMMIT);
 	} else {
@@ -1246,13 +1428,11 @@ trx_commit_in_memory(
 
 		trx->state = TRX_STATE_NOT_STARTED;
 
-		/* We already own the trx_sys_t::mutex, by doing it here we
-		avoid a potential context switch later. */
-		read_view_remove(trx->global_read_view, true);
-
 		ut_ad(trx_sys_validate_trx_list());
 
 		mutex_exit(&trx_sys->mutex);
+
+		read_view_remove(trx->global_read_view);
 	}
 
 	if (trx->global_read_view != NULL) {
@@ -1481,6 +1661,8 @@ trx_cleanup_at_db_startup(
 	assert_trx_in_rw_list(trx);
 	ut_d(trx->in_rw_trx_list = FALSE);
 
+	trx_release_descriptor(trx);
+
 	mutex_exit(&trx_sys->mutex);
 
 	/* Change the transaction state without mutex protection, now
@@ -1859,7 +2041,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys->mutex and trx_sys->mutex.
+The caller must hold lock_sys->latch and trx_sys->mutex.
 When possible, use trx_print() instead. */
 UNIV_INTERN
 void
@@ -1881,7 +2063,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys->mutex and trx_sys->mutex. */
+Acquires and releases lock_sys->latch and trx_sys->mutex. */
 UNIV_INTERN
 void
 trx_print(
@@ -1927,7 +2109,7 @@ trx_assert_started(
 	/* trx->state can change from or to NOT_STARTED while we are holding
 	trx_sys->mutex for non-locking autocommit selects but not for other
 	types of transactions. It may change from ACTIVE to PREPARED. Unless
-	we are holding lock_sys->mutex, it may also change to COMMITTED. */
+	we are holding lock_sys->latch, it may also change to COMMITTED. */
 
 	switch (trx->state) {
 	case TRX_STATE_PREPARED:
@@ -2165,7 +2347,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 static __attribute__((nonnull, warn_unused_result))
 trx_t*
 trx_get_trx_by_xid_low(
@@ -2211,7 +2393,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 UNIV_INTERN
 trx_t*
 trx_get_trx_by_xid(
@@ -0,0 +1,485 @@
+/*****************************************************************************
+
+Copyright (c) 2015, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file btr/btr0bulk.cc
+Bottom-up loading of a B-tree from sorted index entries
+
+The entries are appended to the rightmost page of the leaf level. When
+that page is full, a node pointer to it is appended to the level above
+in the same way, and a new page is allocated. The records are inserted
+without redo logging; instead, the image of each page is logged once,
+when the page is complete. Until then the page is kept buffer-fixed, so
+that the buffer pool cannot evict it while it is not on the flush list.
+Finally the only page of the topmost level is copied to the root page,
+which must stay at the page number stored in the data dictionary.
+
+Created 04/03/2015
+*******************************************************/
+
+#include "btr0bulk.h"
+
+#ifndef UNIV_HOTBACKUP
+#include "btr0btr.h"
+#include "buf0buf.h"
+#include "dict0dict.h"
+#include "fsp0fsp.h"
+#include "log0log.h"
+#include "mtr0log.h"
+#include "page0cur.h"
+#include "page0zip.h"
+#include "srv0srv.h"
+
+/** The page being filled at a level of the index */
+struct btr_bulk_level_t {
+	ulint		page_no;	/*!< page number of the rightmost
+					page, or FIL_NULL */
+	buf_block_t*	block;		/*!< the rightmost page while it is
+					being filled (buffer-fixed), or NULL */
+};
+
+/** Bulk loader of an index */
+struct btr_bulk_t {
+	dict_index_t*	index;		/*!< the index */
+	trx_id_t	trx_id;		/*!< PAGE_MAX_TRX_ID for secondary
+					index leaf pages */
+	ulint		fill_limit;	/*!< a page is considered full when
+					its records would take more than
+					this many bytes */
+	mem_heap_t*	heap;		/*!< memory heap for record offsets */
+	ulint		n_levels;	/*!< number of levels that have
+					pages */
+	btr_bulk_level_t level[BTR_MAX_LEVELS];
+					/*!< the levels, leaf level first */
+};
+
+/*********************************************************************//**
+Starts loading entries into an empty index. The index must not be
+accessed by anything else than the loader until btr_bulk_finish().
+@return loader, or NULL if the index cannot be loaded in bulk */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: empty index */
+	trx_id_t	trx_id)	/*!< in: transaction id that is written
+				as PAGE_MAX_TRX_ID on secondary index
+				leaf pages */
+{
+	btr_bulk_t*	bulk;
+
+	/* Compressed pages would have to be compressed as a whole
+	when they are complete; let the caller insert the entries
+	one by one instead. */
+	if (dict_table_zip_size(index->table)) {
+		return(NULL);
+	}
+
+	bulk = static_cast<btr_bulk_t*>(ut_malloc(sizeof *bulk));
+
+	bulk->index = index;
+	bulk->trx_id = trx_id;
+	bulk->fill_limit = page_get_free_space_of_empty(
+		dict_table_is_comp(index->table)) * srv_fill_factor / 100;
+	bulk->heap = mem_heap_create(1024);
+	bulk->n_levels = 0;
+
+	for (ulint i = 0; i < BTR_MAX_LEVELS; i++) {
+		bulk->level[i].page_no = FIL_NULL;
+		bulk->level[i].block = NULL;
+	}
+
+	return(bulk);
+}
+
+/*********************************************************************//**
+Allocates the next page at a level and links it after the previous one. */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_page_alloc(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	ulint		level)	/*!< in: B-tree level */
+{
+	btr_bulk_level_t*	lvl	= &bulk->level[level];
+	dict_index_t*		index	= bulk->index;
+	ulint			space	= dict_index_get_space(index);
+	ulint			n_reserved;
+	buf_block_t*		block;
+	page_t*			page;
+	mtr_t			mtr;
+
+	ut_ad(!lvl->block);
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	if (!fsp_reserve_free_extents(&n_reserved, space, 1,
+				      FSP_NORMAL, &mtr)) {
+		mtr_commit(&mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	block = btr_page_alloc(index,
+			       lvl->page_no == FIL_NULL
+			       ? dict_index_get_page(index)
+			       : lvl->page_no + 1,
+			       FSP_UP, level, &mtr, &mtr);
+
+	fil_space_release_free_extents(space, n_reserved);
+
+	if (!block) {
+		mtr_commit(&mtr);
+		return(DB_OUT_OF_FILE_SPACE);
+	}
+
+	page = buf_block_get_frame(block);
+
+	btr_page_create(block, NULL, index, level, &mtr);
+	btr_page_set_next(page, NULL, FIL_NULL, &mtr);
+	btr_page_set_prev(page, NULL, lvl->page_no, &mtr);
+
+	if (lvl->page_no != FIL_NULL) {
+		buf_block_t*	prev_block = btr_block_get(
+			space, 0, lvl->page_no, RW_X_LATCH, index, &mtr);
+
+		btr_page_set_next(buf_block_get_frame(prev_block), NULL,
+				  buf_block_get_page_no(block), &mtr);
+	}
+
+	buf_block_buf_fix_inc(block, __FILE__, __LINE__);
+
+	lvl->block = block;
+	lvl->page_no = buf_block_get_page_no(block);
+
+	if (level >= bulk->n_levels) {
+		bulk->n_levels = level + 1;
+	}
+
+	mtr_commit(&mtr);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Writes the image of a page that was filled without redo logging to the
+redo log. The free space between the heap top and the page directory
+is not logged. */
+static __attribute__((nonnull))
+void
+btr_bulk_page_log(
+/*==============*/
+	page_t*	page,	/*!< in: index page */
+	mtr_t*	mtr)	/*!< in/out: mini-transaction, in MTR_LOG_ALL mode */
+{
+	byte*	heap_top = page_header_get_ptr(page, PAGE_HEAP_TOP);
+	ulint	n_slots = page_dir_get_n_slots(page);
+
+	mlog_log_string(page + PAGE_HEADER, heap_top - (page + PAGE_HEADER),
+			mtr);
+	mlog_log_string(page_dir_get_nth_slot(page, n_slots - 1),
+			n_slots * PAGE_DIR_SLOT_SIZE, mtr);
+}
+
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,
+	const dtuple_t*	tuple,
+	ulint		level);
+
+/*********************************************************************//**
+Completes the rightmost page of a level: logs its image, releases it and
+appends a node pointer to it to the level above.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_page_finish(
+/*=================*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	ulint		level,	/*!< in: B-tree level */
+	mtr_t*		mtr)	/*!< in/out: mini-transaction holding the
+				page x-latched; committed here */
+{
+	btr_bulk_level_t*	lvl	= &bulk->level[level];
+	dict_index_t*		index	= bulk->index;
+	buf_block_t*		block	= lvl->block;
+	page_t*			page	= buf_block_get_frame(block);
+	mem_heap_t*		heap;
+	dtuple_t*		node_ptr;
+	dberr_t			err;
+
+	ut_ad(page_get_n_recs(page) > 0);
+
+	if (!level && !dict_index_is_clust(index)) {
+		page_set_max_trx_id(block, NULL, bulk->trx_id, mtr);
+	}
+
+	mtr_set_log_mode(mtr, MTR_LOG_ALL);
+	btr_bulk_page_log(page, mtr);
+
+	heap = mem_heap_create(1024);
+
+	node_ptr = dict_index_build_node_ptr(
+		index, page_rec_get_next(page_get_infimum_rec(page)),
+		lvl->page_no, heap, level);
+
+	/* The leftmost node pointer of a level gets its
+	REC_INFO_MIN_REC_FLAG when it is inserted. */
+	dtuple_set_info_bits(node_ptr, dtuple_get_info_bits(node_ptr)
+			     & ~REC_INFO_MIN_REC_FLAG);
+
+	for (ulint i = 0; i < dtuple_get_n_fields(node_ptr); i++) {
+		dfield_dup(dtuple_get_nth_field(node_ptr, i), heap);
+	}
+
+	mtr_commit(mtr);
+
+	buf_block_buf_fix_dec(block);
+	lvl->block = NULL;
+
+	err = btr_bulk_insert_low(bulk, node_ptr, level + 1);
+
+	mem_heap_free(heap);
+
+	return(err);
+}
+
+/*********************************************************************//**
+Appends a record to the rightmost page of a level, starting a new page
+when the current one is full.
+@return DB_SUCCESS or error code */
+static
+dberr_t
+btr_bulk_insert_low(
+/*================*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	const dtuple_t*	tuple,	/*!< in: index entry or node pointer */
+	ulint		level)	/*!< in: B-tree level */
+{
+	btr_bulk_level_t*	lvl	= &bulk->level[level];
+	dict_index_t*		index	= bulk->index;
+	ulint			rec_size;
+	dberr_t			err;
+
+	if (level >= BTR_MAX_LEVELS - 1) {
+		return(DB_CORRUPTION);
+	}
+
+	if (!lvl->block) {
+		err = btr_bulk_page_alloc(bulk, level);
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+
+	rec_size = rec_get_converted_size(index, tuple, 0);
+
+	for (;;) {
+		buf_block_t*	block;
+		page_t*		page;
+		mtr_t		mtr;
+
+		mtr_start(&mtr);
+
+		block = btr_block_get(dict_index_get_space(index), 0,
+				      lvl->page_no, RW_X_LATCH, index, &mtr);
+		page = buf_block_get_frame(block);
+
+		mtr_set_log_mode(&mtr, MTR_LOG_NONE);
+
+		if (page_get_n_recs(page) < 2
+		    || page_get_data_size(page) + rec_size
+		    <= bulk->fill_limit) {
+			page_cur_t	cur;
+			ulint*		offsets	= NULL;
+			rec_t*		rec;
+
+			page_cur_position(
+				page_rec_get_prev(
+					page_get_supremum_rec(page)),
+				block, &cur);
+
+			rec = page_cur_tuple_insert(&cur, tuple, index,
+						    &offsets, &bulk->heap,
+						    0, &mtr);
+
+			if (rec) {
+				if (level
+				    && page_get_n_recs(page) == 1
+				    && btr_page_get_prev(page, &mtr)
+				    == FIL_NULL) {
+					btr_set_min_rec_mark(rec, &mtr);
+				}
+
+				mtr_commit(&mtr);
+				mem_heap_empty(bulk->heap);
+
+				return(DB_SUCCESS);
+			}
+
+			if (!page_get_n_recs(page)) {
+				mtr_commit(&mtr);
+				return(DB_TOO_BIG_RECORD);
+			}
+		}
+
+		err = btr_bulk_page_finish(bulk, level, &mtr);
+
+		if (err == DB_SUCCESS) {
+			err = btr_bulk_page_alloc(bulk, level);
+		}
+
+		if (err != DB_SUCCESS) {
+			return(err);
+		}
+	}
+}
+
+/*********************************************************************//**
+Appends an entry to the index. The entries must come in ascending
+order. The pages are filled up to innodb_fill_factor percent.
+@return DB_SUCCESS, DB_FAIL if the entry would have to be stored
+partly off-page (the caller should then btr_bulk_finish() and insert
+the rest of the entries one by one), or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	const dtuple_t*	tuple)	/*!< in: index entry */
+{
+	if (page_zip_rec_needs_ext(rec_get_converted_size(bulk->index,
+							  tuple, 0),
+				   dict_table_is_comp(bulk->index->table),
+				   dtuple_get_n_fields(tuple), 0)) {
+		return(DB_FAIL);
+	}
+
+	log_free_check();
+
+	return(btr_bulk_insert_low(bulk, tuple, 0));
+}
+
+/*********************************************************************//**
+Replaces the contents of the root page with the only page of the
+topmost level, and frees that page.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+btr_bulk_copy_to_root(
+/*==================*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	ulint		level)	/*!< in: topmost level */
+{
+	btr_bulk_level_t*	lvl	= &bulk->level[level];
+	dict_index_t*		index	= bulk->index;
+	ulint			space	= dict_index_get_space(index);
+	buf_block_t*		root_block;
+	buf_block_t*		block;
+	page_t*			page;
+	mtr_t			mtr;
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_index_get_lock(index), &mtr);
+
+	root_block = btr_block_get(space, 0, dict_index_get_page(index),
+				   RW_X_LATCH, index, &mtr);
+	block = btr_block_get(space, 0, lvl->page_no, RW_X_LATCH,
+			      index, &mtr);
+	page = buf_block_get_frame(block);
+
+	ut_ad(btr_page_get_prev(page, &mtr) == FIL_NULL);
+	ut_ad(btr_page_get_next(page, &mtr) == FIL_NULL);
+
+	btr_page_empty(root_block, NULL, index, level, &mtr);
+
+	if (!page_copy_rec_list_end(root_block, block,
+				    page_rec_get_next(
+					    page_get_infimum_rec(page)),
+				    index, &mtr)) {
+		mtr_commit(&mtr);
+		return(DB_CORRUPTION);
+	}
+
+	if (!level && !dict_index_is_clust(index)) {
+		page_update_max_trx_id(root_block, NULL, bulk->trx_id, &mtr);
+	}
+
+	btr_page_free(index, block, &mtr);
+
+	mtr_commit(&mtr);
+
+	buf_block_buf_fix_dec(lvl->block);
+	lvl->block = NULL;
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Completes the upper levels of the index, copies the topmost page to the
+root page and frees the loader.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: loader */
+	dberr_t		err)	/*!< in: DB_SUCCESS, or the error that
+				aborted the load; then only the loader
+				is freed */
+{
+	dict_index_t*	index = bulk->index;
+
+	/* Completing a page appends a node pointer to the level above,
+	which may create that level; bulk->n_levels is re-read on each
+	iteration. */
+	for (ulint level = 0;
+	     err == DB_SUCCESS && level < bulk->n_levels; level++) {
+		mtr_t	mtr;
+
+		if (level + 1 == bulk->n_levels) {
+			err = btr_bulk_copy_to_root(bulk, level);
+			break;
+		}
+
+		log_free_check();
+
+		mtr_start(&mtr);
+		btr_block_get(dict_index_get_space(index), 0,
+			      bulk->level[level].page_no, RW_X_LATCH,
+			      index, &mtr);
+		mtr_set_log_mode(&mtr, MTR_LOG_NONE);
+
+		err = btr_bulk_page_finish(bulk, level, &mtr);
+	}
+
+	for (ulint level = 0; level < bulk->n_levels; level++) {
+		if (bulk->level[level].block) {
+			buf_block_buf_fix_dec(bulk->level[level].block);
+		}
+	}
+
+	mem_heap_free(bulk->heap);
+	ut_free(bulk);
+
+	return(err);
+}
+#endif /* !UNIV_HOTBACKUP */
@@ -98,6 +98,8 @@ UNIV_INTERN ulint	btr_cur_n_non_sea_old	= 0;
 srv_refresh_innodb_monitor_stats().  Referenced by
 srv_printf_innodb_monitor(). */
 UNIV_INTERN ulint	btr_cur_n_sea_old	= 0;
+/** Search counters of each adaptive hash index partition */
+UNIV_INTERN btr_cur_part_stat_t	btr_cur_part_stats[BTR_SEARCH_MAX_PARTITIONS];
 
 #ifdef UNIV_DEBUG
 /* Flag to limit optimistic insert records */
@@ -552,12 +554,14 @@ btr_cur_search_to_nth_level(
 		ut_ad(cursor->low_match != ULINT_UNDEFINED
 		      || mode != PAGE_CUR_LE);
 		btr_cur_n_sea++;
+		btr_cur_part_stats[btr_search_get_part(index)].n_sea++;
 
 		return;
 	}
 # endif /* BTR_CUR_HASH_ADAPT */
 #endif /* BTR_CUR_ADAPT */
 	btr_cur_n_non_sea++;
+	btr_cur_part_stats[btr_search_get_part(index)].n_non_sea++;
 
 	/* If the hash search did not succeed, do binary search down the
 	tree */
@@ -1954,6 +1954,7 @@ buf_page_make_young_if_needed(
 	ut_a(buf_page_in_file(bpage));
 
 	if (buf_page_peek_if_too_old(bpage)) {
+		buf_page_count_access(bpage);
 		buf_page_make_young(bpage);
 	}
 }
@@ -3441,7 +3442,7 @@ buf_page_get_known_nowait(
 /*******************************************************************//**
 Given a tablespace id and page number tries to get that page. If the
 page is not in the buffer pool it is not loaded and NULL is returned.
-Suitable for using when holding the lock_sys_t::mutex.
+Suitable for using when holding the lock_sys_t::latch.
 @return	pointer to a page or NULL */
 UNIV_INTERN
 const buf_block_t*
@@ -3541,6 +3542,7 @@ buf_page_init_low(
 	bpage->buf_fix_count = 0;
 	bpage->freed_page_clock = 0;
 	bpage->access_time = 0;
+	bpage->n_accesses = 0;
 	bpage->newest_modification = 0;
 	bpage->oldest_modification = 0;
 	bpage->write_size = 0;
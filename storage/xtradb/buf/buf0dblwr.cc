@@ -37,6 +37,9 @@ Created 2011/12/19
 #include "page0zip.h"
 #include "trx0sys.h"
 
+#include <algorithm>
+#include <vector>
+
 #ifndef UNIV_HOTBACKUP
 
 #ifdef UNIV_PFS_MUTEX
@@ -50,6 +53,50 @@ UNIV_INTERN buf_dblwr_t*	buf_dblwr = NULL;
 /** Set to TRUE when the doublewrite buffer is being created */
 UNIV_INTERN ibool	buf_dblwr_being_created = FALSE;
 
+/** A page copy in the doublewrite segment file, found at a database startup
+after a crash */
+struct buf_dblwr_seg_copy_t {
+	ulint	space_id;	/*!< tablespace id of the page */
+	ulint	page_no;	/*!< page number in the tablespace */
+	lsn_t	lsn;		/*!< FIL_PAGE_LSN of the copy */
+	ulint	file_page_no;	/*!< page number of the copy in the
+				doublewrite segment file */
+
+	/** Orders the copies by page address, newest copy first */
+	bool operator<(const buf_dblwr_seg_copy_t& other) const
+	{
+		if (space_id != other.space_id) {
+			return(space_id < other.space_id);
+		}
+
+		if (page_no != other.page_no) {
+			return(page_no < other.page_no);
+		}
+
+		return(lsn > other.lsn);
+	}
+};
+
+/** The newest copy of each page in the doublewrite segment file, in page
+address order, or NULL if the file was closed cleanly. Only the index is
+kept in memory; the copies are read on demand by buf_dblwr_seg_find_page().
+Freed by buf_dblwr_seg_file_ready(). */
+static std::vector<buf_dblwr_seg_copy_t>*	buf_dblwr_seg_copies = NULL;
+
+/** The doublewrite segment file that buf_dblwr_seg_copies refers to */
+static os_file_t	buf_dblwr_seg_copies_file;
+
+/** Buffer for the page returned by buf_dblwr_seg_find_page() */
+static byte*		buf_dblwr_seg_copy_buf = NULL;
+
+/** Set if the doublewrite segment file must be created anew, because its
+layout differs from the current settings. It is created by
+buf_dblwr_seg_file_ready() once the copies in it are no longer needed. */
+static bool		buf_dblwr_seg_file_pending = false;
+
+/** Number of pages that buf_dblwr_seg_index_pages() reads at a time */
+#define BUF_DBLWR_SEG_READ_BATCH	64
+
 /****************************************************************//**
 Determines if a page number is located inside the doublewrite buffer.
 @return TRUE if the location is inside the two blocks of the
@@ -120,6 +167,386 @@ buf_dblwr_sync_datafiles()
 	fil_flush_file_spaces(FIL_TABLESPACE);
 }
 
+/****************************************************************//**
+Gets the path of the doublewrite segment file. */
+static
+void
+buf_dblwr_seg_file_name(
+/*====================*/
+	char*	name,	/*!< out: path of the file */
+	ulint	len)	/*!< in: size of name in bytes */
+{
+	ut_snprintf(name, len, "%s%c%s", srv_data_home, SRV_PATH_SEPARATOR,
+		    BUF_DBLWR_SEG_FILE_NAME);
+}
+
+/****************************************************************//**
+Reads and checks the header of the doublewrite segment file.
+@return	true if the header is valid */
+static
+bool
+buf_dblwr_seg_read_header(
+/*======================*/
+	os_file_t	file,	/*!< in: the doublewrite segment file */
+	const char*	name,	/*!< in: path of the file */
+	ulint*		n_segs,	/*!< out: number of segments */
+	ulint*		size,	/*!< out: pages in a segment */
+	bool*		clean)	/*!< out: true if no batch was in
+				progress when the file was closed */
+{
+	byte*	unaligned_header;
+	byte*	header;
+	bool	valid = false;
+
+	unaligned_header = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
+	header = static_cast<byte*>(
+		ut_align(unaligned_header, UNIV_PAGE_SIZE));
+
+	if (!os_file_read(file, header, 0, UNIV_PAGE_SIZE, FALSE)
+	    || mach_read_from_4(header + BUF_DBLWR_SEG_MAGIC)
+	    != BUF_DBLWR_SEG_MAGIC_N) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Ignoring the doublewrite segment file %s"
+			" with an invalid header", name);
+
+		goto func_exit;
+	}
+
+	if (mach_read_from_4(header + BUF_DBLWR_SEG_PAGE_SIZE)
+	    != UNIV_PAGE_SIZE) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Ignoring the doublewrite segment file %s"
+			" written with page size %lu", name,
+			(ulong) mach_read_from_4(
+				header + BUF_DBLWR_SEG_PAGE_SIZE));
+
+		goto func_exit;
+	}
+
+	*n_segs = mach_read_from_4(header + BUF_DBLWR_SEG_N_SEGS);
+	*size = mach_read_from_4(header + BUF_DBLWR_SEG_SIZE);
+	*clean = mach_read_from_4(header + BUF_DBLWR_SEG_CLEAN) != 0;
+
+	if (*n_segs == 0 || *n_segs > MAX_BUFFER_POOLS
+	    || *size == 0 || *size > BUF_DBLWR_SEG_MAX_SIZE) {
+
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Ignoring the doublewrite segment file %s"
+			" with %lu segments of %lu pages", name,
+			(ulong) *n_segs, (ulong) *size);
+
+		goto func_exit;
+	}
+
+	valid = true;
+
+func_exit:
+	ut_free(unaligned_header);
+
+	return(valid);
+}
+
+/****************************************************************//**
+Writes the header of the doublewrite segment file buf_dblwr->seg_file and
+flushes it to disk.
+@return	true if the header was written */
+static
+bool
+buf_dblwr_seg_write_header(
+/*=======================*/
+	const char*	name,	/*!< in: path of the file */
+	ulint		n_segs,	/*!< in: number of segments */
+	ulint		size,	/*!< in: pages in a segment */
+	bool		clean)	/*!< in: true if no batch is in progress
+				and none will be started */
+{
+	byte*	unaligned_header;
+	byte*	header;
+	bool	success;
+
+	unaligned_header = static_cast<byte*>(
+		ut_malloc(2 * UNIV_PAGE_SIZE));
+	header = static_cast<byte*>(
+		ut_align(unaligned_header, UNIV_PAGE_SIZE));
+
+	memset(header, 0, UNIV_PAGE_SIZE);
+	mach_write_to_4(header + BUF_DBLWR_SEG_MAGIC, BUF_DBLWR_SEG_MAGIC_N);
+	mach_write_to_4(header + BUF_DBLWR_SEG_N_SEGS, n_segs);
+	mach_write_to_4(header + BUF_DBLWR_SEG_SIZE, size);
+	mach_write_to_4(header + BUF_DBLWR_SEG_PAGE_SIZE, UNIV_PAGE_SIZE);
+	mach_write_to_4(header + BUF_DBLWR_SEG_CLEAN, clean);
+
+	success = os_file_write(name, buf_dblwr->seg_file, header,
+				0, UNIV_PAGE_SIZE)
+		&& os_file_flush(buf_dblwr->seg_file);
+
+	ut_free(unaligned_header);
+
+	return(success);
+}
+
+/****************************************************************//**
+Opens the existing doublewrite segment file if it has
+srv_buf_pool_instances segments of srv_doublewrite_segment_size pages, and
+marks it as in use. The file is not modified otherwise: the pages in it may
+still be needed by buf_dblwr_process().
+@return	true if the file can be used */
+static
+bool
+buf_dblwr_seg_file_open(void)
+/*=========================*/
+{
+	char		name[OS_FILE_MAX_PATH];
+	ibool		success;
+	ulint		n_segs;
+	ulint		size;
+	bool		clean;
+
+	buf_dblwr_seg_file_name(name, sizeof name);
+
+	buf_dblwr->seg_file = os_file_create_simple_no_error_handling(
+		innodb_file_data_key, name, OS_FILE_OPEN,
+		OS_FILE_READ_WRITE, &success, FALSE);
+
+	if (!success) {
+		return(false);
+	}
+
+	if (buf_dblwr_seg_read_header(buf_dblwr->seg_file, name,
+				      &n_segs, &size, &clean)
+	    && n_segs == srv_buf_pool_instances
+	    && size == srv_doublewrite_segment_size
+	    && buf_dblwr_seg_write_header(name, n_segs, size, false)) {
+
+		return(true);
+	}
+
+	os_file_close(buf_dblwr->seg_file);
+
+	return(false);
+}
+
+/****************************************************************//**
+Creates the doublewrite segment file anew for srv_buf_pool_instances
+segments of srv_doublewrite_segment_size pages, and marks it as in use.
+@return	true if the file can be used */
+static
+bool
+buf_dblwr_seg_file_create(void)
+/*===========================*/
+{
+	char		name[OS_FILE_MAX_PATH];
+	ibool		success;
+	ulint		n_segs	= srv_buf_pool_instances;
+	ulint		size	= srv_doublewrite_segment_size;
+
+	buf_dblwr_seg_file_name(name, sizeof name);
+
+	buf_dblwr->seg_file = os_file_create(
+		innodb_file_data_key, name,
+		OS_FILE_OVERWRITE | OS_FILE_ON_ERROR_NO_EXIT,
+		OS_FILE_NORMAL, OS_DATA_FILE, &success, FALSE);
+
+	if (!success) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Cannot create the doublewrite segment file %s;"
+			" using the doublewrite buffer in the system"
+			" tablespace", name);
+
+		return(false);
+	}
+
+	success = os_file_set_size(
+		name, buf_dblwr->seg_file,
+		(os_offset_t) (1 + n_segs * size) * UNIV_PAGE_SIZE)
+		&& buf_dblwr_seg_write_header(name, n_segs, size, false);
+
+	if (!success) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"Cannot initialize the doublewrite segment file %s;"
+			" using the doublewrite buffer in the system"
+			" tablespace", name);
+
+		os_file_close(buf_dblwr->seg_file);
+
+		return(false);
+	}
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Created the doublewrite segment file %s for %lu buffer pool"
+		" instances of %lu pages each",
+		name, (ulong) n_segs, (ulong) size);
+
+	return(true);
+}
+
+/****************************************************************//**
+Creates the doublewrite batches of the buffer pool instances. If use_file is
+set, each instance writes its batches to its own segment of the doublewrite
+segment file, so that the instances do not wait for each other. Otherwise all
+the instances share the batch pages of the doublewrite buffer in the system
+tablespace. */
+static
+void
+buf_dblwr_create_segs(
+/*==================*/
+	bool	use_file)	/*!< in: whether buf_dblwr->seg_file is
+				open for srv_buf_pool_instances segments */
+{
+	buf_dblwr->n_segs = use_file ? srv_buf_pool_instances : 1;
+
+	buf_dblwr->segs = static_cast<buf_dblwr_seg_t*>(
+		mem_zalloc(buf_dblwr->n_segs * sizeof *buf_dblwr->segs));
+
+	for (ulint i = 0; i < buf_dblwr->n_segs; i++) {
+		buf_dblwr_seg_t*	seg = &buf_dblwr->segs[i];
+
+		mutex_create(buf_dblwr_mutex_key,
+			     &seg->mutex, SYNC_DOUBLEWRITE);
+
+		seg->b_event = os_event_create();
+
+		if (!use_file) {
+			seg->size = srv_doublewrite_batch_size;
+			seg->file_page_no = ULINT_UNDEFINED;
+			seg->write_buf = buf_dblwr->write_buf;
+			seg->buf_block_arr = buf_dblwr->buf_block_arr;
+
+			continue;
+		}
+
+		seg->size = srv_doublewrite_segment_size;
+		seg->file_page_no = 1 + i * seg->size;
+
+		seg->write_buf_unaligned = static_cast<byte*>(
+			ut_malloc((1 + seg->size) * UNIV_PAGE_SIZE));
+
+		seg->write_buf = static_cast<byte*>(
+			ut_align(seg->write_buf_unaligned, UNIV_PAGE_SIZE));
+
+		seg->buf_block_arr = static_cast<buf_page_t**>(
+			mem_zalloc(seg->size * sizeof(void*)));
+	}
+}
+
+/****************************************************************//**
+Frees the doublewrite batches of the buffer pool instances, and closes the
+doublewrite segment file if it was used. If no batch can be started any
+more, the file is marked as closed cleanly, so that the next startup need
+not look for page copies in it. */
+static
+void
+buf_dblwr_free_segs(
+/*================*/
+	bool	clean)	/*!< in: true if no batch will be started */
+{
+	bool	use_file = buf_dblwr->segs[0].file_page_no
+		!= ULINT_UNDEFINED;
+
+	for (ulint i = 0; i < buf_dblwr->n_segs; i++) {
+		buf_dblwr_seg_t*	seg = &buf_dblwr->segs[i];
+
+		ut_ad(seg->b_reserved == 0);
+		ut_ad(!seg->batch_running);
+
+		os_event_free(seg->b_event);
+		mutex_free(&seg->mutex);
+
+		if (seg->write_buf_unaligned != NULL) {
+			ut_free(seg->write_buf_unaligned);
+			mem_free(seg->buf_block_arr);
+		}
+	}
+
+	if (use_file) {
+		if (clean) {
+			char	name[OS_FILE_MAX_PATH];
+
+			buf_dblwr_seg_file_name(name, sizeof name);
+
+			buf_dblwr_seg_write_header(
+				name, buf_dblwr->n_segs,
+				buf_dblwr->segs[0].size, true);
+		}
+
+		os_file_close(buf_dblwr->seg_file);
+	}
+
+	mem_free(buf_dblwr->segs);
+	buf_dblwr->segs = NULL;
+}
+
+/****************************************************************//**
+Creates the doublewrite batches of the buffer pool instances at a database
+startup. The existing doublewrite segment file is used if it has the layout
+of the current settings. Otherwise the batches are written to the system
+tablespace until buf_dblwr_seg_file_ready() creates the file anew, because
+the old file may still hold page copies that crash recovery needs. */
+static
+void
+buf_dblwr_init_segs(void)
+/*=====================*/
+{
+	bool	use_file = false;
+
+	if (srv_doublewrite_segment_size > 0
+	    && srv_use_doublewrite_buf
+	    && !srv_read_only_mode) {
+
+		use_file = buf_dblwr_seg_file_open();
+		buf_dblwr_seg_file_pending = !use_file;
+	}
+
+	buf_dblwr_create_segs(use_file);
+}
+
+/****************************************************************//**
+Forgets the page copies in the doublewrite segment file that were found at
+the database startup, and creates the file anew if buf_dblwr_init_segs()
+could not use it. Must be called before any batch is flushed, once no page
+needs to be restored from the old file any more. */
+static
+void
+buf_dblwr_seg_file_ready(void)
+/*==========================*/
+{
+	if (buf_dblwr_seg_copies != NULL) {
+		delete buf_dblwr_seg_copies;
+		buf_dblwr_seg_copies = NULL;
+
+		os_file_close(buf_dblwr_seg_copies_file);
+
+		ut_free(buf_dblwr_seg_copy_buf);
+		buf_dblwr_seg_copy_buf = NULL;
+	}
+
+	if (!buf_dblwr_seg_file_pending) {
+		return;
+	}
+
+	buf_dblwr_seg_file_pending = false;
+
+	if (buf_dblwr_seg_file_create()) {
+		buf_dblwr_free_segs(false);
+		buf_dblwr_create_segs(true);
+	}
+}
+
+/****************************************************************//**
+Gets the doublewrite batch of a buffer pool instance.
+@return	the batch */
+UNIV_INLINE
+buf_dblwr_seg_t*
+buf_dblwr_get_seg(
+/*==============*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance */
+{
+	return(&buf_dblwr->segs[buf_dblwr->n_segs == 1
+				? 0 : buf_pool_index(buf_pool)]);
+}
+
 /****************************************************************//**
 Creates or initialializes the doublewrite buffer at a database start. */
 static
@@ -146,11 +573,8 @@ buf_dblwr_init(
 	mutex_create(buf_dblwr_mutex_key,
 		     &buf_dblwr->mutex, SYNC_DOUBLEWRITE);
 
-	buf_dblwr->b_event = os_event_create();
 	buf_dblwr->s_event = os_event_create();
-	buf_dblwr->first_free = 0;
 	buf_dblwr->s_reserved = 0;
-	buf_dblwr->b_reserved = 0;
 
 	buf_dblwr->block1 = mach_read_from_4(
 		doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
@@ -169,6 +593,8 @@ buf_dblwr_init(
 
 	buf_dblwr->buf_block_arr = static_cast<buf_page_t**>(
 		mem_zalloc(buf_size * sizeof(void*)));
+
+	buf_dblwr_init_segs();
 }
 
 /****************************************************************//**
@@ -209,6 +635,10 @@ buf_dblwr_create(void)
 
 		mtr_commit(&mtr);
 		buf_dblwr_being_created = FALSE;
+
+		/* Create the doublewrite segment file of a new
+		installation */
+		buf_dblwr_seg_file_ready();
 		return;
 	}
 
@@ -347,6 +777,188 @@ buf_dblwr_create(void)
 	goto start_again;
 }
 
+/****************************************************************//**
+At a database startup, finds the page copies in the doublewrite segment file,
+so that buf_dblwr_process() can restore half-written pages from them as well.
+Nothing is done if no batch was in progress when the file was last closed.
+All the segments in the file are searched, whatever the current
+srv_doublewrite_segment_size and number of buffer pool instances are. Only the
+address, LSN and position of the newest copy of each page are kept in memory.
+*/
+static
+void
+buf_dblwr_seg_index_pages(void)
+/*===========================*/
+{
+	char		name[OS_FILE_MAX_PATH];
+	os_file_t	file;
+	ibool		success;
+	byte*		unaligned_buf;
+	byte*		buf;
+	ulint		n_segs;
+	ulint		size;
+	bool		clean;
+	std::vector<buf_dblwr_seg_copy_t>*	copies;
+
+	ut_ad(buf_dblwr_seg_copies == NULL);
+
+	buf_dblwr_seg_file_name(name, sizeof name);
+
+	file = os_file_create_simple_no_error_handling(
+		innodb_file_data_key, name, OS_FILE_OPEN,
+		OS_FILE_READ_ONLY, &success, FALSE);
+
+	if (!success) {
+		/* The doublewrite segment file has never been used */
+		return;
+	}
+
+	if (!buf_dblwr_seg_read_header(file, name, &n_segs, &size, &clean)
+	    || clean) {
+
+		os_file_close(file);
+		return;
+	}
+
+	copies = new std::vector<buf_dblwr_seg_copy_t>();
+
+	unaligned_buf = static_cast<byte*>(
+		ut_malloc((1 + BUF_DBLWR_SEG_READ_BATCH) * UNIV_PAGE_SIZE));
+	buf = static_cast<byte*>(ut_align(unaligned_buf, UNIV_PAGE_SIZE));
+
+	for (ulint i = 0; i < n_segs * size; ) {
+		ulint	n = ut_min(ulint(BUF_DBLWR_SEG_READ_BATCH),
+				   n_segs * size - i);
+
+		if (!os_file_read(file, buf,
+				  (os_offset_t) (1 + i) * UNIV_PAGE_SIZE,
+				  n * UNIV_PAGE_SIZE, FALSE)) {
+
+			ib_logf(IB_LOG_LEVEL_WARN,
+				"Cannot read the doublewrite segment file %s",
+				name);
+
+			copies->clear();
+			break;
+		}
+
+		for (ulint end = i + n; i < end; i++) {
+			const byte*		page = buf
+				+ (i + n - end) * UNIV_PAGE_SIZE;
+			buf_dblwr_seg_copy_t	copy;
+
+			/* Skip the pages of segments that were never
+			filled */
+			if (buf_page_is_zeroes(page, 0)) {
+				continue;
+			}
+
+			copy.space_id = page_get_space_id(page);
+			copy.page_no = page_get_page_no(page);
+			copy.lsn = mach_read_from_8(page + FIL_PAGE_LSN);
+			copy.file_page_no = 1 + i;
+
+			copies->push_back(copy);
+		}
+	}
+
+	ut_free(unaligned_buf);
+
+	if (copies->empty()) {
+		delete copies;
+		os_file_close(file);
+		return;
+	}
+
+	/* Keep the newest copy of each page */
+	std::sort(copies->begin(), copies->end());
+
+	ulint	n = 0;
+
+	for (ulint i = 0; i < copies->size(); i++) {
+		const buf_dblwr_seg_copy_t&	copy = (*copies)[i];
+
+		if (n == 0
+		    || copy.space_id != (*copies)[n - 1].space_id
+		    || copy.page_no != (*copies)[n - 1].page_no) {
+
+			(*copies)[n++] = copy;
+		}
+	}
+
+	copies->resize(n);
+
+	ib_logf(IB_LOG_LEVEL_INFO,
+		"Found copies of %lu pages in the doublewrite segment file %s",
+		(ulong) n, name);
+
+	buf_dblwr_seg_copies = copies;
+	buf_dblwr_seg_copies_file = file;
+	buf_dblwr_seg_copy_buf = static_cast<byte*>(
+		ut_malloc(2 * UNIV_PAGE_SIZE));
+}
+
+/****************************************************************//**
+Reads the newest copy of a page from the doublewrite segment file at a
+database startup, if it is newer than the given LSN.
+@return	the copy, valid until the next call, or NULL */
+UNIV_INTERN
+byte*
+buf_dblwr_seg_find_page(
+/*====================*/
+	ulint	space_id,	/*!< in: tablespace id */
+	ulint	page_no,	/*!< in: page number */
+	lsn_t	lsn)		/*!< in: LSN of the newest copy found
+				elsewhere, or 0 */
+{
+	buf_dblwr_seg_copy_t				key;
+	std::vector<buf_dblwr_seg_copy_t>::const_iterator	it;
+	byte*						page;
+
+	if (buf_dblwr_seg_copies == NULL) {
+		return(NULL);
+	}
+
+	key.space_id = space_id;
+	key.page_no = page_no;
+	key.lsn = LSN_MAX;
+
+	it = std::lower_bound(buf_dblwr_seg_copies->begin(),
+			      buf_dblwr_seg_copies->end(), key);
+
+	if (it == buf_dblwr_seg_copies->end()
+	    || it->space_id != space_id || it->page_no != page_no
+	    || it->lsn <= lsn) {
+
+		return(NULL);
+	}
+
+	page = static_cast<byte*>(
+		ut_align(buf_dblwr_seg_copy_buf, UNIV_PAGE_SIZE));
+
+	if (!os_file_read(buf_dblwr_seg_copies_file, page,
+			  (os_offset_t) it->file_page_no * UNIV_PAGE_SIZE,
+			  UNIV_PAGE_SIZE, FALSE)) {
+
+		return(NULL);
+	}
+
+	return(page);
+}
+
+/****************************************************************//**
+Checks whether a page was returned by buf_dblwr_seg_find_page().
+@return	true if the page is in the doublewrite segment file */
+static
+bool
+buf_dblwr_seg_is_copy(
+/*==================*/
+	const byte*	page)	/*!< in: page copy */
+{
+	return(buf_dblwr_seg_copy_buf != NULL
+	       && page == ut_align(buf_dblwr_seg_copy_buf, UNIV_PAGE_SIZE));
+}
+
 /****************************************************************//**
 At a database startup initializes the doublewrite buffer memory structure if
 we already have a doublewrite buffer created in the data files. If we are
@@ -373,6 +985,12 @@ buf_dblwr_init_or_load_pages(
         ulint	block_bytes = 0;
 	recv_dblwr_t& recv_dblwr = recv_sys->dblwr;
 
+	/* Find the page copies in the doublewrite segment file before
+	buf_dblwr_init() marks it as in use */
+	if (load_corrupt_pages) {
+		buf_dblwr_seg_index_pages();
+	}
+
 	/* We do the file i/o past the buffer pool */
 
 	unaligned_read_buf = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
@@ -469,131 +1087,194 @@ buf_dblwr_init_or_load_pages(
 }
 
 /****************************************************************//**
-Process the double write buffer pages. */
+Restores a page from the doublewrite buffer or the doublewrite segment file,
+if the page in the tablespace is corrupt or contains only zeroes. */
+static
 void
-buf_dblwr_process()
-/*===============*/
+buf_dblwr_recover_page(
+/*===================*/
+	ulint	space_id,	/*!< in: tablespace id */
+	ulint	page_no,	/*!< in: page number */
+	byte*	read_buf,	/*!< in: buffer for reading the page */
+	ulint	page_no_dblwr)	/*!< in: position of the copy */
 {
-	ulint	space_id;
-	ulint	page_no;
-	ulint	page_no_dblwr = 0;
-	byte*	page;
-	byte*	read_buf;
-	byte*	unaligned_read_buf;
-	recv_dblwr_t& recv_dblwr = recv_sys->dblwr;
+	recv_dblwr_t&	recv_dblwr = recv_sys->dblwr;
+	byte*		page;
+	ulint		zip_size;
 
-	unaligned_read_buf = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
+	if (!fil_tablespace_exists_in_mem(space_id)) {
+		/* Maybe we have dropped the single-table tablespace
+		and this page once belonged to it: do nothing */
+		return;
+	}
 
-	read_buf = static_cast<byte*>(
-		ut_align(unaligned_read_buf, UNIV_PAGE_SIZE));
+	if (!fil_check_adress_in_tablespace(space_id, page_no)) {
+		ib_logf(IB_LOG_LEVEL_WARN,
+			"A page in the doublewrite buffer is not "
+			"within space bounds; space id %lu "
+			"page number %lu, page %lu in "
+			"doublewrite buf.",
+			(ulong) space_id, (ulong) page_no,
+			page_no_dblwr);
+		return;
+	}
 
-	for (std::list<byte*>::iterator i = recv_dblwr.pages.begin();
-	     i != recv_dblwr.pages.end(); ++i, ++page_no_dblwr ) {
+	zip_size = fil_space_get_zip_size(space_id);
 
-		page = *i;
-		page_no  = mach_read_from_4(page + FIL_PAGE_OFFSET);
-		space_id = mach_read_from_4(page + FIL_PAGE_SPACE_ID);
+	/* Read in the actual page from the file */
+	fil_io(OS_FILE_READ, true, space_id, zip_size,
+	       page_no, 0,
+	       zip_size ? zip_size : UNIV_PAGE_SIZE,
+	       read_buf, NULL, 0);
 
-		if (!fil_tablespace_exists_in_mem(space_id)) {
-			/* Maybe we have dropped the single-table tablespace
-			and this page once belonged to it: do nothing */
+	/* Check if the page is corrupt */
 
-		} else if (!fil_check_adress_in_tablespace(space_id,
-							   page_no)) {
-			ib_logf(IB_LOG_LEVEL_WARN,
-				"A page in the doublewrite buffer is not "
-				"within space bounds; space id %lu "
-				"page number %lu, page %lu in "
-				"doublewrite buf.",
-				(ulong) space_id, (ulong) page_no,
-				page_no_dblwr);
+	if (buf_page_is_corrupted(true, read_buf, zip_size)) {
+
+		fprintf(stderr,
+			"InnoDB: Warning: database page"
+			" corruption or a failed\n"
+			"InnoDB: file read of"
+			" space %lu page %lu.\n"
+			"InnoDB: Trying to recover it from"
+			" the doublewrite buffer.\n",
+			(ulong) space_id, (ulong) page_no);
+
+		/* The doublewrite buffer and the doublewrite
+		segments may hold several copies of the page: use
+		the latest */
+		page = recv_dblwr.find_page(space_id, page_no);
+
+		if (page == NULL
+		    || buf_page_is_corrupted(true, page, zip_size)) {
+			fprintf(stderr,
+				"InnoDB: Dump of the page:\n");
+			buf_page_print(
+				read_buf, zip_size,
+				BUF_PAGE_PRINT_NO_CRASH);
+
+			if (page != NULL) {
+				fprintf(stderr,
+					"InnoDB: Dump of"
+					" corresponding page"
+					" in doublewrite buffer:\n");
+				buf_page_print(
+					page, zip_size,
+					BUF_PAGE_PRINT_NO_CRASH);
+			}
+
+			fprintf(stderr,
+				"InnoDB: Also the page in the"
+				" doublewrite buffer"
+				" is corrupt.\n"
+				"InnoDB: Cannot continue"
+				" operation.\n"
+				"InnoDB: You can try to"
+				" recover the database"
+				" with the my.cnf\n"
+				"InnoDB: option:\n"
+				"InnoDB:"
+				" innodb_force_recovery=6\n");
+			ut_error;
+		}
+
+		/* Write the good page from the doublewrite buffer
+		to the intended position */
+
+		fil_io(OS_FILE_WRITE, true, space_id,
+		       zip_size, page_no, 0,
+		       zip_size ? zip_size : UNIV_PAGE_SIZE,
+		       page, NULL, 0);
+
+		if (buf_dblwr_seg_is_copy(page)) {
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Recovered the page from"
+				" the doublewrite segment file.");
 		} else {
-			ulint	zip_size = fil_space_get_zip_size(space_id);
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Recovered the page from"
+				" the doublewrite buffer.");
+		}
 
-			/* Read in the actual page from the file */
-			fil_io(OS_FILE_READ, true, space_id, zip_size,
-			       page_no, 0,
-			       zip_size ? zip_size : UNIV_PAGE_SIZE,
-			       read_buf, NULL, 0);
+	} else if (buf_page_is_zeroes(read_buf, zip_size)) {
 
-			/* Check if the page is corrupt */
+		page = recv_dblwr.find_page(space_id, page_no);
 
-			if (buf_page_is_corrupted(true, read_buf, zip_size)) {
+		if (page != NULL
+		    && !buf_page_is_zeroes(page, zip_size)
+		    && !buf_page_is_corrupted(true, page, zip_size)) {
 
-				fprintf(stderr,
-					"InnoDB: Warning: database page"
-					" corruption or a failed\n"
-					"InnoDB: file read of"
-					" space %lu page %lu.\n"
-					"InnoDB: Trying to recover it from"
-					" the doublewrite buffer.\n",
-					(ulong) space_id, (ulong) page_no);
-
-				if (buf_page_is_corrupted(true,
-							  page, zip_size)) {
-					fprintf(stderr,
-						"InnoDB: Dump of the page:\n");
-					buf_page_print(
-						read_buf, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-					fprintf(stderr,
-						"InnoDB: Dump of"
-						" corresponding page"
-						" in doublewrite buffer:\n");
-					buf_page_print(
-						page, zip_size,
-						BUF_PAGE_PRINT_NO_CRASH);
-
-					fprintf(stderr,
-						"InnoDB: Also the page in the"
-						" doublewrite buffer"
-						" is corrupt.\n"
-						"InnoDB: Cannot continue"
-						" operation.\n"
-						"InnoDB: You can try to"
-						" recover the database"
-						" with the my.cnf\n"
-						"InnoDB: option:\n"
-						"InnoDB:"
-						" innodb_force_recovery=6\n");
-					ut_error;
-				}
+			/* Database page contained only zeroes, while
+			a valid copy is available in dblwr buffer. */
 
-				/* Write the good page from the
-				doublewrite buffer to the intended
-				position */
+			fil_io(OS_FILE_WRITE, true, space_id,
+			       zip_size, page_no, 0,
+			       zip_size ? zip_size : UNIV_PAGE_SIZE,
+			       page, NULL, 0);
+		}
+	}
+}
+
+/****************************************************************//**
+Process the double write buffer pages. */
+void
+buf_dblwr_process()
+/*===============*/
+{
+	ulint	page_no_dblwr = 0;
+	byte*	read_buf;
+	byte*	unaligned_read_buf;
+	recv_dblwr_t& recv_dblwr = recv_sys->dblwr;
+
+	unaligned_read_buf = static_cast<byte*>(ut_malloc(2 * UNIV_PAGE_SIZE));
 
-				fil_io(OS_FILE_WRITE, true, space_id,
-				       zip_size, page_no, 0,
-				       zip_size ? zip_size : UNIV_PAGE_SIZE,
-				       page, NULL, 0);
+	read_buf = static_cast<byte*>(
+		ut_align(unaligned_read_buf, UNIV_PAGE_SIZE));
 
-				ib_logf(IB_LOG_LEVEL_INFO,
-					"Recovered the page from"
-					" the doublewrite buffer.");
+	for (std::list<byte*>::iterator i = recv_dblwr.pages.begin();
+	     i != recv_dblwr.pages.end(); ++i, ++page_no_dblwr) {
 
-			} else if (buf_page_is_zeroes(read_buf, zip_size)) {
+		const byte*	page = *i;
 
-				if (!buf_page_is_zeroes(page, zip_size)
-				    && !buf_page_is_corrupted(true, page,
-							      zip_size)) {
+		buf_dblwr_recover_page(
+			mach_read_from_4(page + FIL_PAGE_SPACE_ID),
+			mach_read_from_4(page + FIL_PAGE_OFFSET),
+			read_buf, page_no_dblwr);
+	}
 
-					/* Database page contained only
-					zeroes, while a valid copy is
-					available in dblwr buffer. */
+	if (buf_dblwr_seg_copies != NULL) {
+		/* The pages that were only written to the doublewrite
+		segment file */
+		const std::vector<buf_dblwr_seg_copy_t>&	copies
+			= *buf_dblwr_seg_copies;
 
-					fil_io(OS_FILE_WRITE, true, space_id,
-					       zip_size, page_no, 0,
-					       zip_size ? zip_size
-							: UNIV_PAGE_SIZE,
-						page, NULL, 0);
-				}
-			}
+		for (ulint i = 0; i < copies.size(); i++) {
+			buf_dblwr_recover_page(
+				copies[i].space_id, copies[i].page_no,
+				read_buf, copies[i].file_page_no);
 		}
 	}
 
 	fil_flush_file_spaces(FIL_TABLESPACE);
 	ut_free(unaligned_read_buf);
+
+	/* The restored pages are durable: the doublewrite segment file
+	may be overwritten from now on */
+	buf_dblwr_seg_file_ready();
+}
+
+/****************************************************************//**
+Forgets the page copies in the doublewrite segment file that were found at
+the database startup. Must be called after
+recv_recovery_from_checkpoint_start(), and before any page is flushed. */
+UNIV_INTERN
+void
+buf_dblwr_free_seg_pages(void)
+/*==========================*/
+{
+	ut_ad(recv_sys->dblwr.pages.empty());
+
+	buf_dblwr_seg_file_ready();
 }
 
 /****************************************************************//**
@@ -606,9 +1287,11 @@ buf_dblwr_free(void)
 	/* Free the double write data structures. */
 	ut_a(buf_dblwr != NULL);
 	ut_ad(buf_dblwr->s_reserved == 0);
-	ut_ad(buf_dblwr->b_reserved == 0);
 
-	os_event_free(buf_dblwr->b_event);
+	/* No batch is running, and the pages of the completed batches
+	were flushed to disk by buf_dblwr_update() */
+	buf_dblwr_free_segs(true);
+
 	os_event_free(buf_dblwr->s_event);
 	ut_free(buf_dblwr->write_buf_unaligned);
 	buf_dblwr->write_buf_unaligned = NULL;
@@ -640,28 +1323,34 @@ buf_dblwr_update(
 	switch (flush_type) {
 	case BUF_FLUSH_LIST:
 	case BUF_FLUSH_LRU:
-		mutex_enter(&buf_dblwr->mutex);
+		{
+			buf_dblwr_seg_t*	seg = buf_dblwr_get_seg(
+				buf_pool_from_bpage(bpage));
 
-		ut_ad(buf_dblwr->batch_running);
-		ut_ad(buf_dblwr->b_reserved > 0);
-		ut_ad(buf_dblwr->b_reserved <= buf_dblwr->first_free);
+			mutex_enter(&seg->mutex);
 
-		buf_dblwr->b_reserved--;
+			ut_ad(seg->batch_running);
+			ut_ad(seg->b_reserved > 0);
+			ut_ad(seg->b_reserved <= seg->first_free);
 
-		if (buf_dblwr->b_reserved == 0) {
-			mutex_exit(&buf_dblwr->mutex);
-			/* This will finish the batch. Sync data files
-			to the disk. */
-			fil_flush_file_spaces(FIL_TABLESPACE);
-			mutex_enter(&buf_dblwr->mutex);
+			seg->b_reserved--;
 
-			/* We can now reuse the doublewrite memory buffer: */
-			buf_dblwr->first_free = 0;
-			buf_dblwr->batch_running = false;
-			os_event_set(buf_dblwr->b_event);
-		}
+			if (seg->b_reserved == 0) {
+				mutex_exit(&seg->mutex);
+				/* This will finish the batch. Sync data
+				files to the disk. */
+				fil_flush_file_spaces(FIL_TABLESPACE);
+				mutex_enter(&seg->mutex);
 
-		mutex_exit(&buf_dblwr->mutex);
+				/* We can now reuse the doublewrite memory
+				buffer: */
+				seg->first_free = 0;
+				seg->batch_running = false;
+				os_event_set(seg->b_event);
+			}
+
+			mutex_exit(&seg->mutex);
+		}
 		break;
 	case BUF_FLUSH_SINGLE_PAGE:
 		{
@@ -815,73 +1504,122 @@ buf_dblwr_write_block_to_datafile(
 }
 
 /********************************************************************//**
-Flushes possible buffered writes from the doublewrite memory buffer to disk,
-and also wakes up the aio thread if simulated aio is used. It is very
-important to call this function after a batch of writes has been posted,
-and also when we may have to wait for a page latch! Otherwise a deadlock
-of threads can occur. */
-UNIV_INTERN
+Writes a doublewrite batch to its place on disk and syncs it. */
+static
 void
-buf_dblwr_flush_buffered_writes(void)
-/*=================================*/
+buf_dblwr_write_seg(
+/*================*/
+	const buf_dblwr_seg_t*	seg,		/*!< in: batch */
+	ulint			first_free)	/*!< in: number of pages
+						in the batch */
 {
 	byte*		write_buf;
-	ulint		first_free;
 	ulint		len;
 
-	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
-		/* Sync the writes to the disk. */
-		buf_dblwr_sync_datafiles();
+	if (seg->file_page_no != ULINT_UNDEFINED) {
+		/* The segment of a buffer pool instance in the
+		doublewrite segment file */
+		if (!os_file_write(BUF_DBLWR_SEG_FILE_NAME, buf_dblwr->seg_file,
+				   seg->write_buf,
+				   (os_offset_t) seg->file_page_no
+				   * UNIV_PAGE_SIZE,
+				   first_free * UNIV_PAGE_SIZE)
+		    || !os_file_flush(buf_dblwr->seg_file)) {
+
+			ib_logf(IB_LOG_LEVEL_FATAL,
+				"Cannot write to the doublewrite segment"
+				" file");
+		}
+
 		return;
 	}
 
+	write_buf = seg->write_buf;
+
+	/* Write out the first block of the doublewrite buffer */
+	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
+		     first_free) * UNIV_PAGE_SIZE;
+
+	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
+	       buf_dblwr->block1, 0, len,
+	       (void*) write_buf, NULL, 0);
+
+	if (first_free > TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+		/* Write out the second block of the doublewrite buffer. */
+		len = (first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
+		       * UNIV_PAGE_SIZE;
+
+		write_buf = seg->write_buf
+			    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
+
+		fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
+		       buf_dblwr->block2, 0, len,
+		       (void*) write_buf, NULL, 0);
+	}
+
+	/* Now flush the doublewrite buffer data to disk */
+	fil_flush(TRX_SYS_SPACE);
+}
+
+/********************************************************************//**
+Flushes possible buffered writes from a doublewrite batch to disk, and also
+wakes up the aio thread if simulated aio is used. */
+static
+void
+buf_dblwr_flush_seg(
+/*================*/
+	buf_dblwr_seg_t*	seg)	/*!< in/out: batch */
+{
+	byte*		write_buf;
+	ulint		first_free;
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
 	/* Write first to doublewrite buffer blocks. We use synchronous
 	aio and thus know that file write has been completed when the
 	control returns. */
 
-	if (buf_dblwr->first_free == 0) {
+	if (seg->first_free == 0) {
 
-		mutex_exit(&buf_dblwr->mutex);
+		mutex_exit(&seg->mutex);
 
 		return;
 	}
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 		/* Another thread is running the batch right now. Wait
 		for it to finish. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	ut_a(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
+	ut_a(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
 
 	/* Disallow anyone else to post to doublewrite buffer or to
 	start another batch of flushing. */
-	buf_dblwr->batch_running = true;
-	first_free = buf_dblwr->first_free;
+	seg->batch_running = true;
+	first_free = seg->first_free;
 
 	/* Now safe to release the mutex. Note that though no other
 	thread is allowed to post to the doublewrite batch flushing
 	but any threads working on single page flushes are allowed
 	to proceed. */
-	mutex_exit(&buf_dblwr->mutex);
+	mutex_exit(&seg->mutex);
 
-	write_buf = buf_dblwr->write_buf;
+	write_buf = seg->write_buf;
 
 	for (ulint len2 = 0, i = 0;
-	     i < buf_dblwr->first_free;
+	     i < seg->first_free;
 	     len2 += UNIV_PAGE_SIZE, i++) {
 
 		const buf_block_t*	block;
 
-		block = (buf_block_t*) buf_dblwr->buf_block_arr[i];
+		block = (buf_block_t*) seg->buf_block_arr[i];
 
 		if (buf_block_get_state(block) != BUF_BLOCK_FILE_PAGE
 		    || block->page.zip.data) {
@@ -899,57 +1637,31 @@ buf_dblwr_flush_buffered_writes(void)
 		buf_dblwr_check_page_lsn(write_buf + len2);
 	}
 
-	/* Write out the first block of the doublewrite buffer */
-	len = ut_min(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE,
-		     buf_dblwr->first_free) * UNIV_PAGE_SIZE;
-
-	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block1, 0, len,
-	       (void*) write_buf, NULL, 0);
-
-	if (buf_dblwr->first_free <= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		/* No unwritten pages in the second block. */
-		goto flush;
-	}
-
-	/* Write out the second block of the doublewrite buffer. */
-	len = (buf_dblwr->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-	       * UNIV_PAGE_SIZE;
-
-	write_buf = buf_dblwr->write_buf
-		    + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
+	buf_dblwr_write_seg(seg, first_free);
 
-	fil_io(OS_FILE_WRITE, true, TRX_SYS_SPACE, 0,
-	       buf_dblwr->block2, 0, len,
-	       (void*) write_buf, NULL, 0);
-
-flush:
 	/* increment the doublewrite flushed pages counter */
-	srv_stats.dblwr_pages_written.add(buf_dblwr->first_free);
+	srv_stats.dblwr_pages_written.add(first_free);
 	srv_stats.dblwr_writes.inc();
 
-	/* Now flush the doublewrite buffer data to disk */
-	fil_flush(TRX_SYS_SPACE);
-
 	/* We know that the writes have been flushed to disk now
 	and in recovery we will find them in the doublewrite buffer
 	blocks. Next do the writes to the intended positions. */
 
-	/* Up to this point first_free and buf_dblwr->first_free are
-	same because we have set the buf_dblwr->batch_running flag
+	/* Up to this point first_free and seg->first_free are
+	same because we have set the seg->batch_running flag
 	disallowing any other thread to post any request but we
-	can't safely access buf_dblwr->first_free in the loop below.
+	can't safely access seg->first_free in the loop below.
 	This is so because it is possible that after we are done with
 	the last iteration and before we terminate the loop, the batch
 	gets finished in the IO helper thread and another thread posts
-	a new batch setting buf_dblwr->first_free to a higher value.
-	If this happens and we are using buf_dblwr->first_free in the
+	a new batch setting seg->first_free to a higher value.
+	If this happens and we are using seg->first_free in the
 	loop termination condition then we'll end up dispatching
 	the same block twice from two different threads. */
-	ut_ad(first_free == buf_dblwr->first_free);
+	ut_ad(first_free == seg->first_free);
 	for (ulint i = 0; i < first_free; i++) {
 		buf_dblwr_write_block_to_datafile(
-			buf_dblwr->buf_block_arr[i], false);
+			seg->buf_block_arr[i], false);
 	}
 
 	/* Wake possible simulated aio thread to actually post the
@@ -959,6 +1671,36 @@ buf_dblwr_flush_buffered_writes(void)
 	os_aio_simulated_wake_handler_threads();
 }
 
+/********************************************************************//**
+Flushes possible buffered writes from the doublewrite memory buffer to disk,
+and also wakes up the aio thread if simulated aio is used. It is very
+important to call this function after a batch of writes has been posted,
+and also when we may have to wait for a page latch! Otherwise a deadlock
+of threads can occur. */
+UNIV_INTERN
+void
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool)	/*!< in: buffer pool instance
+						whose writes to flush, or NULL
+						for all instances */
+{
+	if (!srv_use_doublewrite_buf || buf_dblwr == NULL) {
+		/* Sync the writes to the disk. */
+		buf_dblwr_sync_datafiles();
+		return;
+	}
+
+	if (buf_pool != NULL) {
+		buf_dblwr_flush_seg(buf_dblwr_get_seg(buf_pool));
+		return;
+	}
+
+	for (ulint i = 0; i < buf_dblwr->n_segs; i++) {
+		buf_dblwr_flush_seg(&buf_dblwr->segs[i]);
+	}
+}
+
 /********************************************************************//**
 Posts a buffer page for writing. If the doublewrite memory buffer is
 full, calls buf_dblwr_flush_buffered_writes and waits for for free
@@ -969,17 +1711,20 @@ buf_dblwr_add_to_batch(
 /*====================*/
 	buf_page_t*	bpage)	/*!< in: buffer block to write */
 {
-	ulint	zip_size;
+	ulint			zip_size;
+	buf_dblwr_seg_t*	seg;
 
 	ut_a(buf_page_in_file(bpage));
 	ut_ad(!mutex_own(&buf_pool_from_bpage(bpage)->LRU_list_mutex));
 
+	seg = buf_dblwr_get_seg(buf_pool_from_bpage(bpage));
+
 try_again:
-	mutex_enter(&buf_dblwr->mutex);
+	mutex_enter(&seg->mutex);
 
-	ut_a(buf_dblwr->first_free <= srv_doublewrite_batch_size);
+	ut_a(seg->first_free <= seg->size);
 
-	if (buf_dblwr->batch_running) {
+	if (seg->batch_running) {
 
 		/* This not nearly as bad as it looks. There is only
 		page_cleaner thread which does background flushing
@@ -987,17 +1732,17 @@ buf_dblwr_add_to_batch(
 		point. The only exception is when a user thread is
 		forced to do a flush batch because of a sync
 		checkpoint. */
-		ib_int64_t	sig_count = os_event_reset(buf_dblwr->b_event);
-		mutex_exit(&buf_dblwr->mutex);
+		ib_int64_t	sig_count = os_event_reset(seg->b_event);
+		mutex_exit(&seg->mutex);
 
-		os_event_wait_low(buf_dblwr->b_event, sig_count);
+		os_event_wait_low(seg->b_event, sig_count);
 		goto try_again;
 	}
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->size) {
+		mutex_exit(&(seg->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_seg(seg);
 
 		goto try_again;
 	}
@@ -1007,40 +1752,40 @@ buf_dblwr_add_to_batch(
 	if (zip_size) {
 		UNIV_MEM_ASSERT_RW(bpage->zip.data, zip_size);
 		/* Copy the compressed page and clear the rest. */
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(seg->write_buf
+		       + UNIV_PAGE_SIZE * seg->first_free,
 		       bpage->zip.data, zip_size);
-		memset(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free
+		memset(seg->write_buf
+		       + UNIV_PAGE_SIZE * seg->first_free
 		       + zip_size, 0, UNIV_PAGE_SIZE - zip_size);
 	} else {
 		ut_a(buf_page_get_state(bpage) == BUF_BLOCK_FILE_PAGE);
 		UNIV_MEM_ASSERT_RW(((buf_block_t*) bpage)->frame,
 				   UNIV_PAGE_SIZE);
 
-		memcpy(buf_dblwr->write_buf
-		       + UNIV_PAGE_SIZE * buf_dblwr->first_free,
+		memcpy(seg->write_buf
+		       + UNIV_PAGE_SIZE * seg->first_free,
 		       ((buf_block_t*) bpage)->frame, UNIV_PAGE_SIZE);
 	}
 
-	buf_dblwr->buf_block_arr[buf_dblwr->first_free] = bpage;
+	seg->buf_block_arr[seg->first_free] = bpage;
 
-	buf_dblwr->first_free++;
-	buf_dblwr->b_reserved++;
+	seg->first_free++;
+	seg->b_reserved++;
 
-	ut_ad(!buf_dblwr->batch_running);
-	ut_ad(buf_dblwr->first_free == buf_dblwr->b_reserved);
-	ut_ad(buf_dblwr->b_reserved <= srv_doublewrite_batch_size);
+	ut_ad(!seg->batch_running);
+	ut_ad(seg->first_free == seg->b_reserved);
+	ut_ad(seg->b_reserved <= seg->size);
 
-	if (buf_dblwr->first_free == srv_doublewrite_batch_size) {
-		mutex_exit(&(buf_dblwr->mutex));
+	if (seg->first_free == seg->size) {
+		mutex_exit(&(seg->mutex));
 
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_seg(seg);
 
 		return;
 	}
 
-	mutex_exit(&(buf_dblwr->mutex));
+	mutex_exit(&(seg->mutex));
 }
 
 /********************************************************************//**
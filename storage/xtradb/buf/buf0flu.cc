@@ -1092,7 +1092,7 @@ buf_flush_page(
 			/* avoiding deadlock possibility involves doublewrite
 			buffer, should flush it, because it might hold the
 			another block->lock. */
-			buf_dblwr_flush_buffered_writes();
+			buf_dblwr_flush_buffered_writes(NULL);
 
 			rw_lock_s_lock_gen(rw_lock, BUF_IO_WRITE);
                 }
@@ -1830,11 +1830,14 @@ Gather the aggregated stats for both flush list and LRU list flushing */
 void
 buf_flush_common(
 /*=============*/
+	const buf_pool_t* buf_pool,	/*!< in: buffer pool instance that
+					was flushed, or NULL if the flush
+					covered several instances */
 	buf_flush_t	flush_type,	/*!< in: type of flush */
 	ulint		page_count)	/*!< in: number of pages flushed */
 {
 	if (page_count) {
-		buf_dblwr_flush_buffered_writes();
+		buf_dblwr_flush_buffered_writes(buf_pool);
 	}
 
 	ut_a(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
@@ -1991,7 +1994,7 @@ buf_flush_LRU(
 
 	buf_flush_end(buf_pool, BUF_FLUSH_LRU);
 
-	buf_flush_common(BUF_FLUSH_LRU, n->flushed);
+	buf_flush_common(buf_pool, BUF_FLUSH_LRU, n->flushed);
 
 	return(true);
 }
@@ -2117,7 +2120,7 @@ buf_flush_list(
 			}
 		}
 
-		buf_flush_common(BUF_FLUSH_LIST, flush_common_batch);
+		buf_flush_common(NULL, BUF_FLUSH_LIST, flush_common_batch);
 	}
 
 	/* If we haven't flushed all the instances due to timeout or a repeat
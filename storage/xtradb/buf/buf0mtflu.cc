@@ -226,7 +226,8 @@ buf_mtflu_flush_pool_instance(
 	work_item->n_flushed = n.flushed;
 
 	buf_flush_end(work_item->wr.buf_pool, work_item->wr.flush_type);
-	buf_flush_common(work_item->wr.flush_type, work_item->n_flushed);
+	buf_flush_common(work_item->wr.buf_pool,
+			 work_item->wr.flush_type, work_item->n_flushed);
 
 	return work_item->n_flushed;
 }
@@ -265,7 +265,11 @@ static
 dberr_t
 fts_sync(
 /*=====*/
-	fts_sync_t*	sync)		/*!< in: sync state */
+	fts_sync_t*	sync,		/*!< in: sync state */
+	bool		unlock_cache,	/*!< in: release the cache lock
+					while writing the words */
+	bool		wait)		/*!< in: wait for a SYNC that is
+					in progress and then SYNC again */
 	__attribute__((nonnull));
 
 /****************************************************************//**
@@ -286,6 +290,28 @@ fts_update_max_cache_size(
 	fts_sync_t*	sync);		/*!< in: sync state */
 #endif
 
+/** Number of tokenized documents that a committing transaction collects
+before it adds them to the FTS cache under one acquisition of the cache
+lock */
+#define FTS_ADD_BATCH_SIZE	32
+
+/** A document tokenized at commit, waiting to be added to the cache */
+struct fts_batch_doc_t {
+	fts_index_cache_t*
+			index_cache;	/*!< index cache to add to */
+	doc_id_t	doc_id;		/*!< doc id of the document */
+	fts_doc_t	doc;		/*!< the tokenized document */
+};
+
+/** The documents of a committing transaction that are added to the
+FTS cache together, see fts_commit_table() */
+struct fts_add_batch_t {
+	fts_cache_t*	cache;		/*!< FTS cache of the table */
+	ulint		n_docs;		/*!< number of documents in docs */
+	fts_batch_doc_t	docs[FTS_ADD_BATCH_SIZE];
+					/*!< the tokenized documents */
+};
+
 /*********************************************************************//**
 This function fetches the document just inserted right before
 we commit the transaction, and tokenize the inserted text data
@@ -297,8 +323,10 @@ fts_add_doc_by_id(
 /*==============*/
 	fts_trx_table_t*ftt,		/*!< in: FTS trx table */
 	doc_id_t	doc_id,		/*!< in: doc id */
-	ib_vector_t*	fts_indexes __attribute__((unused)));
+	ib_vector_t*	fts_indexes __attribute__((unused)),
 					/*!< in: affected fts indexes */
+	fts_add_batch_t*batch);		/*!< in/out: documents to add
+					to the cache */
 #ifdef FTS_DOC_STATS_DEBUG
 /****************************************************************//**
 Check whether a particular word (term) exists in the FTS index.
@@ -671,6 +699,7 @@ fts_cache_create(
 		mem_heap_zalloc(heap, sizeof(fts_sync_t)));
 
 	cache->sync->table = table;
+	cache->sync->event = os_event_create();
 
 	/* Create the index cache vector that will hold the inverted indexes. */
 	cache->indexes = ib_vector_create(
@@ -1223,6 +1252,7 @@ fts_cache_destroy(
 	mutex_free(&cache->optimize_lock);
 	mutex_free(&cache->deleted_lock);
 	mutex_free(&cache->doc_id_lock);
+	os_event_free(cache->sync->event);
 
 	if (cache->stopword_info.cached_stopword) {
 		rbt_free(cache->stopword_info.cached_stopword);
@@ -1451,6 +1481,7 @@ fts_cache_add_doc(
 		}
 
 		if (fts_node == NULL
+		    || fts_node->synced
 		    || fts_node->ilist_size > FTS_ILIST_MAX_SIZE
 		    || doc_id < fts_node->last_doc_id) {
 
@@ -1820,6 +1851,8 @@ fts_drop_tables(
 		error = fts_drop_all_index_tables(trx, table->fts);
 	}
 
+	fts_plist_cache_invalidate(table->id);
+
 	return(error);
 }
 
@@ -2900,6 +2933,100 @@ fts_doc_ids_free(
 	mem_heap_free(heap);
 }
 
+/*********************************************************************//**
+Add the documents of a batch to the FTS cache, taking the cache lock once
+for the whole batch. Once the cache has grown over its configured size,
+the optimize thread is asked to SYNC it in the background. Only when the
+background SYNC cannot keep up and the cache has grown to twice its size,
+or when the caches of all the tables have grown over
+fts_max_total_cache_size, the committing thread does the SYNC itself. */
+static
+void
+fts_add_batch_flush(
+/*================*/
+	fts_add_batch_t*	batch)		/*!< in/out: documents to add */
+{
+	fts_cache_t*	cache = batch->cache;
+	fts_sync_t*	sync = cache->sync;
+	bool		must_sync;
+	bool		request_sync;
+
+	if (batch->n_docs == 0) {
+		return;
+	}
+
+	rw_lock_x_lock(&cache->lock);
+
+	for (ulint i = 0; i < batch->n_docs; ++i) {
+		fts_batch_doc_t*	batch_doc = &batch->docs[i];
+
+		fts_cache_add_doc(
+			cache, batch_doc->index_cache, batch_doc->doc_id,
+			batch_doc->doc.tokens);
+	}
+
+	must_sync = cache->total_size > 2 * fts_max_cache_size
+		|| fts_need_sync;
+
+	request_sync = !must_sync
+		&& !sync->in_progress
+		&& !sync->requested
+		&& cache->total_size > fts_max_cache_size;
+
+	if (request_sync) {
+		sync->requested = true;
+	}
+
+	rw_lock_x_unlock(&cache->lock);
+
+	for (ulint i = 0; i < batch->n_docs; ++i) {
+		fts_doc_free(&batch->docs[i].doc);
+	}
+
+	batch->n_docs = 0;
+
+	DBUG_EXECUTE_IF(
+		"fts_instrument_sync",
+		fts_sync(sync, false, true);
+	);
+
+	DBUG_EXECUTE_IF(
+		"fts_instrument_sync_unlocked",
+		fts_sync(sync, true, true);
+	);
+
+	if (must_sync) {
+		fts_sync(sync, true, true);
+	} else if (request_sync) {
+		fts_optimize_request_sync_table(sync->table);
+	}
+}
+
+/*********************************************************************//**
+Add a tokenized document to a batch, which takes over the document. A full
+batch is added to the FTS cache first. */
+static
+void
+fts_add_batch_push(
+/*===============*/
+	fts_add_batch_t*	batch,		/*!< in/out: documents to add */
+	fts_index_cache_t*	index_cache,	/*!< in: index cache */
+	doc_id_t		doc_id,		/*!< in: doc id */
+	const fts_doc_t*	doc)		/*!< in: tokenized document */
+{
+	fts_batch_doc_t*	batch_doc;
+
+	if (batch->n_docs == FTS_ADD_BATCH_SIZE) {
+		fts_add_batch_flush(batch);
+	}
+
+	batch_doc = &batch->docs[batch->n_docs++];
+
+	batch_doc->index_cache = index_cache;
+	batch_doc->doc_id = doc_id;
+	batch_doc->doc = *doc;
+}
+
 /*********************************************************************//**
 Do commit-phase steps necessary for the insertion of a new row.
 @return DB_SUCCESS or error code */
@@ -2908,7 +3035,9 @@ dberr_t
 fts_add(
 /*====*/
 	fts_trx_table_t*ftt,			/*!< in: FTS trx table */
-	fts_trx_row_t*	row)			/*!< in: row */
+	fts_trx_row_t*	row,			/*!< in: row */
+	fts_add_batch_t*batch)			/*!< in/out: documents to add
+						to the cache */
 {
 	dict_table_t*	table = ftt->table;
 	dberr_t		error = DB_SUCCESS;
@@ -2916,7 +3045,7 @@ fts_add(
 
 	ut_a(row->state == FTS_INSERT || row->state == FTS_MODIFY);
 
-	fts_add_doc_by_id(ftt, doc_id, row->fts_indexes);
+	fts_add_doc_by_id(ftt, doc_id, row->fts_indexes, batch);
 
 	if (error == DB_SUCCESS) {
 		mutex_enter(&table->fts->cache->deleted_lock);
@@ -3031,7 +3160,9 @@ dberr_t
 fts_modify(
 /*=======*/
 	fts_trx_table_t*	ftt,		/*!< in: FTS trx table */
-	fts_trx_row_t*		row)		/*!< in: row */
+	fts_trx_row_t*		row,		/*!< in: row */
+	fts_add_batch_t*	batch)		/*!< in/out: documents to add
+						to the cache */
 {
 	dberr_t	error;
 
@@ -3040,7 +3171,7 @@ fts_modify(
 	error = fts_delete(ftt, row);
 
 	if (error == DB_SUCCESS) {
-		error = fts_add(ftt, row);
+		error = fts_add(ftt, row, batch);
 	}
 
 	return(error);
@@ -3108,9 +3239,15 @@ fts_commit_table(
 	dberr_t			error = DB_SUCCESS;
 	fts_cache_t*		cache = ftt->table->fts->cache;
 	trx_t*			trx = trx_allocate_for_background();
+	fts_add_batch_t		batch;
 
 	rows = ftt->rows;
 
+	/* The rows are ordered by doc id, so the documents of a batch
+	are added to the cache in doc id order. */
+	batch.cache = cache;
+	batch.n_docs = 0;
+
 	ftt->fts_trx->trx = trx;
 
 	if (cache->get_docs == NULL) {
@@ -3129,11 +3266,11 @@ fts_commit_table(
 
 		switch (row->state) {
 		case FTS_INSERT:
-			error = fts_add(ftt, row);
+			error = fts_add(ftt, row, &batch);
 			break;
 
 		case FTS_MODIFY:
-			error = fts_modify(ftt, row);
+			error = fts_modify(ftt, row, &batch);
 			break;
 
 		case FTS_DELETE:
@@ -3145,6 +3282,8 @@ fts_commit_table(
 		}
 	}
 
+	fts_add_batch_flush(&batch);
+
 	fts_sql_commit(trx);
 
 	trx_free_for_background(trx);
@@ -3431,8 +3570,10 @@ fts_add_doc_by_id(
 /*==============*/
 	fts_trx_table_t*ftt,		/*!< in: FTS trx table */
 	doc_id_t	doc_id,		/*!< in: doc id */
-	ib_vector_t*	fts_indexes __attribute__((unused)))
+	ib_vector_t*	fts_indexes __attribute__((unused)),
 					/*!< in: affected fts indexes */
+	fts_add_batch_t*batch)		/*!< in/out: documents to add
+					to the cache */
 {
 	mtr_t		mtr;
 	mem_heap_t*	heap;
@@ -3537,14 +3678,11 @@ fts_add_doc_by_id(
 
 		 for (ulint i = 0; i < num_idx; ++i) {
 			fts_doc_t       doc;
-			dict_table_t*   table;
 			fts_get_doc_t*  get_doc;
 
 			get_doc = static_cast<fts_get_doc_t*>(
 				ib_vector_get(cache->get_docs, i));
 
-			table = get_doc->index_cache->index->table;
-
 			fts_doc_init(&doc);
 
 			fts_fetch_doc_from_rec(
@@ -3556,24 +3694,9 @@ fts_add_doc_by_id(
 				btr_pcur_store_position(doc_pcur, &mtr);
 				mtr_commit(&mtr);
 
-				rw_lock_x_lock(&table->fts->cache->lock);
-
-				fts_cache_add_doc(
-					table->fts->cache,
-					get_doc->index_cache,
-					doc_id, doc.tokens);
-
-				rw_lock_x_unlock(&table->fts->cache->lock);
-
-				DBUG_EXECUTE_IF(
-					"fts_instrument_sync",
-					fts_sync(cache->sync);
-				);
-
-				if (cache->total_size > fts_max_cache_size
-				    || fts_need_sync) {
-					fts_sync(cache->sync);
-				}
+				fts_add_batch_push(
+					batch, get_doc->index_cache,
+					doc_id, &doc);
 
 				mtr_start(&mtr);
 
@@ -3585,9 +3708,9 @@ fts_add_doc_by_id(
 
 					ut_ad(success);
 				}
+			} else {
+				fts_doc_free(&doc);
 			}
-
-			fts_doc_free(&doc);
 		}
 
 		if (!is_id_cluster) {
@@ -3944,7 +4067,9 @@ fts_sync_add_deleted_cache(
 }
 
 /*********************************************************************//**
-Write the words and ilist to disk.
+Write the words and ilist to disk. The nodes that are written are marked
+as synced and stay in the cache until the SYNC commits, so that queries
+keep finding them while the cache lock is released.
 @return DB_SUCCESS if all went well else error code */
 static __attribute__((nonnull, warn_unused_result))
 dberr_t
@@ -3952,7 +4077,10 @@ fts_sync_write_words(
 /*=================*/
 	trx_t*		trx,			/*!< in: transaction */
 	fts_index_cache_t*
-			index_cache)		/*!< in: index cache */
+			index_cache,		/*!< in: index cache */
+	bool		unlock_cache)		/*!< in: whether to release
+						the cache lock while writing
+						a node */
 {
 	fts_table_t	fts_table;
 	ulint		n_nodes = 0;
@@ -3960,8 +4088,8 @@ fts_sync_write_words(
 	const ib_rbt_node_t* rbt_node;
 	dberr_t		error = DB_SUCCESS;
 	ibool		print_error = FALSE;
-#ifdef FTS_DOC_STATS_DEBUG
 	dict_table_t*	table = index_cache->index->table;
+#ifdef FTS_DOC_STATS_DEBUG
 	ulint		n_new_words = 0;
 #endif /* FTS_DOC_STATS_DEBUG */
 
@@ -3970,11 +4098,12 @@ fts_sync_write_words(
 
 	n_words = rbt_size(index_cache->words);
 
-	/* We iterate over the entire tree, even if there is an error,
-	since we want to free the memory used during caching. */
+	/* While the cache lock is released, words can only be added to
+	the tree, never removed, so the iteration can continue from the
+	current node. */
 	for (rbt_node = rbt_first(index_cache->words);
-	     rbt_node;
-	     rbt_node = rbt_first(index_cache->words)) {
+	     rbt_node != NULL && error == DB_SUCCESS;
+	     rbt_node = rbt_next(index_cache->words, rbt_node)) {
 
 		ulint			i;
 		ulint			selected;
@@ -4007,25 +4136,40 @@ fts_sync_write_words(
 		}
 #endif /* FTS_DOC_STATS_DEBUG */
 
-		n_nodes += ib_vector_size(word->nodes);
-
-		/* We iterate over all the nodes even if there was an error,
-		this is to free the memory of the fts_node_t elements. */
-		for (i = 0; i < ib_vector_size(word->nodes); ++i) {
+		for (i = 0;
+		     i < ib_vector_size(word->nodes) && error == DB_SUCCESS;
+		     ++i) {
 
-			fts_node_t* fts_node = static_cast<fts_node_t*>(
+			fts_node_t*	fts_node = static_cast<fts_node_t*>(
 				ib_vector_get(word->nodes, i));
+			fts_node_t	node;
+
+			if (fts_node->synced) {
+				continue;
+			}
+
+			/* Mark the node before releasing the cache lock,
+			so that new documents go to a new node instead of
+			growing this ilist. The node itself is copied
+			because word->nodes can be reallocated meanwhile. */
+			fts_node->synced = true;
+			node = *fts_node;
 
-			if (error == DB_SUCCESS) {
+			++n_nodes;
 
-				error = fts_write_node(
-					trx,
-					&index_cache->ins_graph[selected],
-					&fts_table, &word->text, fts_node);
+			if (unlock_cache) {
+				rw_lock_x_unlock(&table->fts->cache->lock);
+
+				DEBUG_SYNC_C("fts_sync_write_node_unlocked");
 			}
 
-			ut_free(fts_node->ilist);
-			fts_node->ilist = NULL;
+			error = fts_write_node(
+				trx, &index_cache->ins_graph[selected],
+				&fts_table, &word->text, &node);
+
+			if (unlock_cache) {
+				rw_lock_x_lock(&table->fts->cache->lock);
+			}
 		}
 
 		if (error != DB_SUCCESS && !print_error) {
@@ -4036,9 +4180,6 @@ fts_sync_write_words(
 
 			print_error = TRUE;
 		}
-
-		/* NOTE: We are responsible for free'ing the node */
-		ut_free(rbt_remove_node(index_cache->words, rbt_node));
 	}
 
 #ifdef FTS_DOC_STATS_DEBUG
@@ -4339,7 +4480,7 @@ fts_sync_index(
 
 	ut_ad(rbt_validate(index_cache->words));
 
-	error = fts_sync_write_words(trx, index_cache);
+	error = fts_sync_write_words(trx, index_cache, sync->unlock_cache);
 
 #ifdef FTS_DOC_STATS_DEBUG
 	/* FTS_RESOLVE: the word counter info in auxiliary table "DOC_ID"
@@ -4397,6 +4538,13 @@ fts_sync_commit(
 
 		fts_sql_commit(trx);
 
+		/* Queries must read the new rows of the words. */
+		fts_plist_cache_invalidate(sync->table->id);
+
+		/* The optimize thread sets this again if the caches are
+		still over fts_max_total_cache_size. */
+		fts_need_sync = false;
+
 	} else if (error != DB_SUCCESS) {
 
 		fts_sql_rollback(trx);
@@ -4421,7 +4569,8 @@ fts_sync_commit(
 }
 
 /*********************************************************************//**
-Rollback a sync operation */
+Rollback a sync operation. The words stay in the cache and are written
+again by the next SYNC. */
 static
 void
 fts_sync_rollback(
@@ -4431,6 +4580,32 @@ fts_sync_rollback(
 	trx_t*		trx = sync->trx;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
+		const ib_rbt_node_t*	rbt_node;
+		fts_index_cache_t*	index_cache;
+
+		index_cache = static_cast<fts_index_cache_t*>(
+			ib_vector_get(cache->indexes, i));
+
+		for (rbt_node = rbt_first(index_cache->words);
+		     rbt_node != NULL;
+		     rbt_node = rbt_next(index_cache->words, rbt_node)) {
+
+			fts_tokenizer_word_t*	word;
+
+			word = rbt_value(fts_tokenizer_word_t, rbt_node);
+
+			for (ulint j = 0; j < ib_vector_size(word->nodes); ++j) {
+				fts_node_t*	fts_node;
+
+				fts_node = static_cast<fts_node_t*>(
+					ib_vector_get(word->nodes, j));
+
+				fts_node->synced = false;
+			}
+		}
+	}
+
 	rw_lock_x_unlock(&cache->lock);
 
 	fts_sql_rollback(trx);
@@ -4438,24 +4613,18 @@ fts_sync_rollback(
 }
 
 /****************************************************************//**
-Run SYNC on the table, i.e., write out data from the cache to the
-FTS auxiliary INDEX table and clear the cache at the end.
+Write the nodes of all index caches that are not synced yet.
 @return DB_SUCCESS if all OK */
-static
+static __attribute__((nonnull, warn_unused_result))
 dberr_t
-fts_sync(
-/*=====*/
+fts_sync_indexes(
+/*=============*/
 	fts_sync_t*	sync)		/*!< in: sync state */
 {
-	ulint		i;
 	dberr_t		error = DB_SUCCESS;
 	fts_cache_t*	cache = sync->table->fts->cache;
 
-	rw_lock_x_lock(&cache->lock);
-
-	fts_sync_begin(sync);
-
-	for (i = 0; i < ib_vector_size(cache->indexes); ++i) {
+	for (ulint i = 0; i < ib_vector_size(cache->indexes); ++i) {
 		fts_index_cache_t*	index_cache;
 
 		index_cache = static_cast<fts_index_cache_t*>(
@@ -4473,6 +4642,68 @@ fts_sync(
 		}
 	}
 
+	return(error);
+}
+
+/****************************************************************//**
+Run SYNC on the table, i.e., write out data from the cache to the
+FTS auxiliary INDEX table and clear the cache at the end.
+@return DB_SUCCESS if all OK */
+static
+dberr_t
+fts_sync(
+/*=====*/
+	fts_sync_t*	sync,		/*!< in: sync state */
+	bool		unlock_cache,	/*!< in: release the cache lock
+					while writing the words, so that
+					documents can be added meanwhile */
+	bool		wait)		/*!< in: if a SYNC is in progress,
+					wait for it and then SYNC again;
+					otherwise return at once */
+{
+	dberr_t		error = DB_SUCCESS;
+	fts_cache_t*	cache = sync->table->fts->cache;
+
+	rw_lock_x_lock(&cache->lock);
+
+	/* Only one SYNC can run at a time; the running one may have
+	released the cache lock while it writes the words. */
+	while (sync->in_progress) {
+		ib_int64_t	sig_count;
+
+		if (!wait) {
+			rw_lock_x_unlock(&cache->lock);
+
+			return(DB_SUCCESS);
+		}
+
+		sig_count = os_event_reset(sync->event);
+
+		rw_lock_x_unlock(&cache->lock);
+
+		os_event_wait_low(sync->event, sig_count);
+
+		rw_lock_x_lock(&cache->lock);
+	}
+
+	sync->in_progress = true;
+	sync->requested = false;
+	sync->unlock_cache = unlock_cache;
+	sync->interrupted = false;
+
+	fts_sync_begin(sync);
+
+	error = fts_sync_indexes(sync);
+
+	/* Documents added while the cache lock was released went to new
+	nodes. Write them too, this time holding the lock, so that the
+	whole cache can be cleared when the SYNC commits. */
+	if (error == DB_SUCCESS && sync->unlock_cache) {
+		sync->unlock_cache = false;
+
+		error = fts_sync_indexes(sync);
+	}
+
 	DBUG_EXECUTE_IF("fts_instrument_sync_interrupted",
 			sync->interrupted = true;
 			error = DB_INTERRUPTED;
@@ -4495,6 +4726,11 @@ fts_sync(
 
 	mutex_exit(&cache->deleted_lock);
 
+	rw_lock_x_lock(&cache->lock);
+	sync->in_progress = false;
+	os_event_set(sync->event);
+	rw_lock_x_unlock(&cache->lock);
+
 	return(error);
 }
 
@@ -4505,14 +4741,18 @@ UNIV_INTERN
 dberr_t
 fts_sync_table(
 /*===========*/
-	dict_table_t*	table)		/*!< in: table */
+	dict_table_t*	table,		/*!< in: table */
+	bool		unlock_cache,	/*!< in: release the cache lock
+					while writing the words */
+	bool		wait)		/*!< in: wait for a SYNC that is
+					in progress and then SYNC again */
 {
 	dberr_t	err = DB_SUCCESS;
 
 	ut_ad(table->fts);
 
 	if (!dict_table_is_discarded(table) && table->fts->cache) {
-		err = fts_sync(table->fts->cache->sync);
+		err = fts_sync(table->fts->cache->sync, unlock_cache, wait);
 	}
 
 	return(err);
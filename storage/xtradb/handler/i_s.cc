@@ -6254,6 +6254,15 @@ static ST_FIELD_INFO	innodb_sys_tablestats_fields_info[] =
 	 STRUCT_FLD(old_name,		""),
 	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
 
+#define SYS_TABLESTATS_PURGE_LAG	9
+	{STRUCT_FLD(field_name,		"PURGE_LAG"),
+	 STRUCT_FLD(field_length,	MY_INT64_NUM_DECIMAL_DIGITS),
+	 STRUCT_FLD(field_type,		MYSQL_TYPE_LONGLONG),
+	 STRUCT_FLD(value,		0),
+	 STRUCT_FLD(field_flags,	MY_I_S_UNSIGNED),
+	 STRUCT_FLD(old_name,		""),
+	 STRUCT_FLD(open_method,	SKIP_OPEN_TABLE)},
+
 	END_OF_ST_FIELD_INFO
 };
 
@@ -6316,6 +6325,11 @@ i_s_dict_fill_sys_tablestats(
 	OK(fields[SYS_TABLESTATS_TABLE_REF_COUNT]->store(
 		static_cast<double>(table->n_ref_count)));
 
+	/* The counter goes below zero when history that was written
+	before the table was loaded into the cache is purged. */
+	OK(fields[SYS_TABLESTATS_PURGE_LAG]->store(
+		ut_max(table->n_purge_lag, 0), TRUE));
+
 	OK(schema_table_store_record(thd, table_to_fill));
 
 	DBUG_RETURN(0);
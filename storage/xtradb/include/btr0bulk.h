@@ -0,0 +1,82 @@
+/*****************************************************************************
+
+Copyright (c) 2015, MariaDB Corporation.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free Software
+Foundation; version 2 of the License.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Suite 500, Boston, MA 02110-1335 USA
+
+*****************************************************************************/
+
+/**************************************************//**
+@file include/btr0bulk.h
+Bottom-up loading of a B-tree from sorted index entries
+
+Created 04/03/2015
+*******************************************************/
+
+#ifndef btr0bulk_h
+#define btr0bulk_h
+
+#include "univ.i"
+
+#ifndef UNIV_HOTBACKUP
+
+#include "data0data.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/** Bulk loader of an index */
+struct btr_bulk_t;
+
+/*********************************************************************//**
+Starts loading entries into an empty index. The index must not be
+accessed by anything else than the loader until btr_bulk_finish().
+@return loader, or NULL if the index cannot be loaded in bulk */
+UNIV_INTERN
+btr_bulk_t*
+btr_bulk_create(
+/*============*/
+	dict_index_t*	index,	/*!< in: empty index */
+	trx_id_t	trx_id)	/*!< in: transaction id that is written
+				as PAGE_MAX_TRX_ID on secondary index
+				leaf pages */
+	__attribute__((nonnull, warn_unused_result));
+/*********************************************************************//**
+Appends an entry to the index. The entries must come in ascending
+order. The pages are filled up to innodb_fill_factor percent.
+@return DB_SUCCESS, DB_FAIL if the entry would have to be stored
+partly off-page (the caller should then btr_bulk_finish() and insert
+the rest of the entries one by one), or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_insert(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in/out: loader */
+	const dtuple_t*	tuple)	/*!< in: index entry */
+	__attribute__((nonnull, warn_unused_result));
+/*********************************************************************//**
+Completes the upper levels of the index, copies the topmost page to the
+root page and frees the loader.
+@return DB_SUCCESS or error code */
+UNIV_INTERN
+dberr_t
+btr_bulk_finish(
+/*============*/
+	btr_bulk_t*	bulk,	/*!< in,own: loader */
+	dberr_t		err)	/*!< in: DB_SUCCESS, or the error that
+				aborted the load; then only the loader
+				is freed */
+	__attribute__((nonnull, warn_unused_result));
+
+#endif /* !UNIV_HOTBACKUP */
+
+#endif /* btr0bulk_h */
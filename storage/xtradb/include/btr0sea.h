@@ -221,6 +221,16 @@ btr_search_get_key(
 	index_id_t	index_id)	/*!< in: index ID */
 	__attribute__((pure,warn_unused_result));
 
+/*********************************************************************//**
+Returns the AHI partition number of an index, without dividing the index ID.
+@return the AHI partition number */
+UNIV_INLINE
+ulint
+btr_search_get_part(
+/*================*/
+	const dict_index_t*	index)	/*!< in: index */
+	__attribute__((pure,warn_unused_result));
+
 /*********************************************************************//**
 Initializes AHI-related fields in a newly created index. */
 UNIV_INLINE
@@ -374,7 +374,7 @@ buf_page_get_known_nowait(
 /*******************************************************************//**
 Given a tablespace id and page number tries to get that page. If the
 page is not in the buffer pool it is not loaded and NULL is returned.
-Suitable for using when holding the lock_sys_t::mutex. */
+Suitable for using when holding the lock_sys_t::latch. */
 UNIV_INTERN
 const buf_block_t*
 buf_page_try_get_func(
@@ -386,7 +386,7 @@ buf_page_try_get_func(
 	mtr_t*		mtr);	/*!< in: mini-transaction */
 
 /** Tries to get a page. If the page is not in the buffer pool it is
-not loaded.  Suitable for using when holding the lock_sys_t::mutex.
+not loaded.  Suitable for using when holding the lock_sys_t::latch.
 @param space_id	in: tablespace id
 @param page_no	in: page number
 @param mtr	in: mini-transaction
@@ -1045,6 +1045,18 @@ buf_page_is_accessed(
 	const buf_page_t*	bpage)	/*!< in: control block */
 	__attribute__((nonnull, pure));
 /*********************************************************************//**
+Counts an access to a block for buffer pool dumps. Only the first access
+and the accesses that make the block young are counted, because the
+callers write to the block descriptor anyway then. The count is only a
+heuristic, so that the caller need not hold the block mutex and an
+increment may get lost now and then. */
+UNIV_INLINE
+void
+buf_page_count_access(
+/*==================*/
+	buf_page_t*	bpage)		/*!< in/out: control block */
+	__attribute__((nonnull));
+/*********************************************************************//**
 Flag a block accessed. */
 UNIV_INLINE
 void
@@ -1637,6 +1649,12 @@ struct buf_page_t{
 					0 if the block was never accessed
 					in the buffer pool. Protected by
 					block mutex */
+	unsigned	n_accesses;	/*!< number of times the page was
+					accessed for the first time or made
+					young since it was read in, halved by
+					every buffer pool dump; a heuristic
+					that is updated without a mutex, see
+					buf_page_count_access() */
 	ibool		is_corrupt;
 # if defined UNIV_DEBUG_FILE_ACCESSES || defined UNIV_DEBUG
 	ibool		file_page_was_freed;
@@ -27,6 +27,7 @@ Created 2011/12/19 Inaam Rana
 #define buf0dblwr_h
 
 #include "univ.i"
+#include "buf0types.h"
 #include "ut0byte.h"
 #include "log0log.h"
 #include "log0recv.h"
@@ -38,6 +39,25 @@ extern buf_dblwr_t*	buf_dblwr;
 /** Set to TRUE when the doublewrite buffer is being created */
 extern ibool		buf_dblwr_being_created;
 
+/** Name of the file holding the doublewrite segments of the buffer pool
+instances, relative to srv_data_home */
+#define BUF_DBLWR_SEG_FILE_NAME		"ib_doublewrite"
+
+/** Doublewrite segment file header, on the first page of the file @{ */
+#define BUF_DBLWR_SEG_MAGIC		0	/*!< BUF_DBLWR_SEG_MAGIC_N */
+#define BUF_DBLWR_SEG_N_SEGS		4	/*!< number of segments */
+#define BUF_DBLWR_SEG_SIZE		8	/*!< pages in a segment */
+#define BUF_DBLWR_SEG_PAGE_SIZE		12	/*!< UNIV_PAGE_SIZE of the
+						pages in the file */
+#define BUF_DBLWR_SEG_CLEAN		16	/*!< nonzero if no batch
+						was in progress when the
+						file was closed */
+#define BUF_DBLWR_SEG_MAGIC_N		0x44424c53
+/* @} */
+
+/** Maximum value of srv_doublewrite_segment_size */
+#define BUF_DBLWR_SEG_MAX_SIZE		1024
+
 /****************************************************************//**
 Creates the doublewrite buffer to a new InnoDB installation. The header of the
 doublewrite buffer is placed on the trx system header page. */
@@ -65,6 +85,28 @@ void
 buf_dblwr_process(void);
 /*===================*/
 
+/****************************************************************//**
+Reads the newest copy of a page from the doublewrite segment file at a
+database startup, if it is newer than the given LSN.
+@return	the copy, valid until the next call, or NULL */
+UNIV_INTERN
+byte*
+buf_dblwr_seg_find_page(
+/*====================*/
+	ulint	space_id,	/*!< in: tablespace id */
+	ulint	page_no,	/*!< in: page number */
+	lsn_t	lsn);		/*!< in: LSN of the newest copy found
+				elsewhere, or 0 */
+
+/****************************************************************//**
+Forgets the page copies in the doublewrite segment file that were found at
+the database startup. Must be called after
+recv_recovery_from_checkpoint_start(), and before any page is flushed. */
+UNIV_INTERN
+void
+buf_dblwr_free_seg_pages(void);
+/*==========================*/
+
 /****************************************************************//**
 frees doublewrite buffer. */
 UNIV_INTERN
@@ -105,8 +147,11 @@ and also when we may have to wait for a page latch! Otherwise a deadlock
 of threads can occur. */
 UNIV_INTERN
 void
-buf_dblwr_flush_buffered_writes(void);
-/*=================================*/
+buf_dblwr_flush_buffered_writes(
+/*============================*/
+	const buf_pool_t*	buf_pool);	/*!< in: buffer pool instance
+						whose writes to flush, or NULL
+						for all instances */
 /********************************************************************//**
 Writes a page to the doublewrite buffer on disk, sync it, then write
 the page to the datafile and sync the datafile. This function is used
@@ -122,19 +167,54 @@ buf_dblwr_write_single_page(
 	buf_page_t*	bpage,	/*!< in: buffer block to write */
 	bool		sync);	/*!< in: true if sync IO requested */
 
-/** Doublewrite control struct */
-struct buf_dblwr_t{
+/** Doublewrite batch of flushed pages. The batch is written either to the
+first srv_doublewrite_batch_size pages of the doublewrite buffer in the
+system tablespace, shared by all the buffer pool instances, or to the
+segment of one buffer pool instance in the doublewrite segment file. */
+struct buf_dblwr_seg_t{
 	ib_mutex_t	mutex;	/*!< mutex protecting the first_free
 				field and write_buf */
-	ulint		block1;	/*!< the page number of the first
-				doublewrite block (64 pages) */
-	ulint		block2;	/*!< page number of the second block */
+	ulint		size;	/*!< maximum number of pages in
+				a batch */
+	ulint		file_page_no;/*!< first page of the segment in
+				buf_dblwr->seg_file, or ULINT_UNDEFINED
+				if the batch is written to the system
+				tablespace */
 	ulint		first_free;/*!< first free position in write_buf
 				measured in units of UNIV_PAGE_SIZE */
 	ulint		b_reserved;/*!< number of slots currently reserved
 				for batch flush. */
 	os_event_t	b_event;/*!< event where threads wait for a
 				batch flush to end. */
+	bool		batch_running;/*!< set to TRUE if currently a batch
+				is being written from the doublewrite
+				buffer. */
+	byte*		write_buf;/*!< write buffer used in writing to the
+				doublewrite buffer, aligned to an
+				address divisible by UNIV_PAGE_SIZE */
+	byte*		write_buf_unaligned;/*!< pointer to write_buf,
+				but unaligned, or NULL if write_buf
+				is part of buf_dblwr->write_buf */
+	buf_page_t**	buf_block_arr;/*!< array to store pointers to
+				the buffer blocks which have been
+				cached to write_buf */
+};
+
+/** Doublewrite control struct */
+struct buf_dblwr_t{
+	ib_mutex_t	mutex;	/*!< mutex protecting the single page
+				flush slots */
+	ulint		block1;	/*!< the page number of the first
+				doublewrite block (64 pages) */
+	ulint		block2;	/*!< page number of the second block */
+	buf_dblwr_seg_t* segs;	/*!< batches for the buffer pool
+				instances: one per instance when the
+				doublewrite segment file is used,
+				otherwise a single shared one */
+	ulint		n_segs;	/*!< number of elements in segs */
+	os_file_t	seg_file;/*!< the doublewrite segment file;
+				only open if the segments are kept
+				in it, see buf_dblwr_seg_t::file_page_no */
 	ulint		s_reserved;/*!< number of slots currently
 				reserved for single page flushes. */
 	os_event_t	s_event;/*!< event where threads wait for a
@@ -142,9 +222,6 @@ struct buf_dblwr_t{
 	bool*		in_use;	/*!< flag used to indicate if a slot is
 				in use. Only used for single page
 				flushes. */
-	bool		batch_running;/*!< set to TRUE if currently a batch
-				is being written from the doublewrite
-				buffer. */
 	byte*		write_buf;/*!< write buffer used in writing to the
 				doublewrite buffer, aligned to an
 				address divisible by UNIV_PAGE_SIZE
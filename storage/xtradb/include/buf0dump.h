@@ -57,10 +57,36 @@ void
 buf_load_abort();
 /*============*/
 
+/*****************************************************************//**
+Initializes the state of buffer pool loads. */
+UNIV_INTERN
+void
+buf_load_init();
+/*===========*/
+
+/*****************************************************************//**
+Frees the state of buffer pool loads. */
+UNIV_INTERN
+void
+buf_load_free();
+/*===========*/
+
+/*****************************************************************//**
+Asks a running buffer pool load to read the pages of the dump that are
+near a page before the other pages. This is called when a query has to
+read a page from disk. Does nothing if no load is running. */
+UNIV_INTERN
+void
+buf_load_prioritize(
+/*================*/
+	ulint	space,		/*!< in: space id */
+	ulint	page_no);	/*!< in: page number */
+
 /*****************************************************************//**
 This is the main thread for buffer pool dump/load. It waits for an
 event and when waked up either performs a dump or load and sleeps
-again.
+again. If innodb_buffer_pool_dump_interval is set, it also dumps the
+buffer pool when it has not been waked up for that many seconds.
 @return this function does not return, it calls os_thread_exit() */
 extern "C" UNIV_INTERN
 os_thread_ret_t
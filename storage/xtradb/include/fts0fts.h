@@ -353,6 +353,18 @@ extern ulong		fts_max_total_cache_size;
 /** Variable specifying the FTS result cache limit for each query */
 extern ulong		fts_result_cache_limit;
 
+/** Variable specifying the number of threads that read the posting
+lists of the terms of a query */
+extern ulong		fts_query_threads;
+
+/** Maximum number of threads that all the queries may run at a time to
+read posting lists, counted in srv_max_n_threads */
+extern ulint		fts_query_max_prefetch_threads;
+
+/** Variable specifying the size of the cache of decoded posting lists
+shared by all queries */
+extern ulong		fts_posting_cache_size;
+
 /** Variable specifying the maximum FTS max token size */
 extern ulong		fts_max_token_size;
 
@@ -571,6 +583,30 @@ fts_query(
 						freed by the caller.*/
 	__attribute__((nonnull, warn_unused_result));
 
+/*******************************************************************//**
+Create the cache of decoded posting lists. */
+UNIV_INTERN
+void
+fts_plist_cache_init(void);
+/*======================*/
+
+/*******************************************************************//**
+Free the cache of decoded posting lists. */
+UNIV_INTERN
+void
+fts_plist_cache_free(void);
+/*======================*/
+
+/*******************************************************************//**
+Remove the posting lists of a table from the cache. This must be called
+after SYNC or OPTIMIZE has committed changes to the FTS INDEX tables of
+the table. */
+UNIV_INTERN
+void
+fts_plist_cache_invalidate(
+/*=======================*/
+	table_id_t	table_id);		/*!< in: table id */
+
 /******************************************************************//**
 Retrieve the FTS Relevance Ranking result for doc with doc_id
 @return the relevance ranking value. */
@@ -833,7 +869,13 @@ UNIV_INTERN
 dberr_t
 fts_sync_table(
 /*===========*/
-	dict_table_t*	table)			/*!< in: table */
+	dict_table_t*	table,			/*!< in: table */
+	bool		unlock_cache,		/*!< in: release the cache
+						lock while writing the
+						words */
+	bool		wait)			/*!< in: wait for a SYNC that
+						is in progress and then SYNC
+						again */
 	__attribute__((nonnull));
 
 /****************************************************************//**
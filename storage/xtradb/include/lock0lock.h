@@ -35,6 +35,7 @@ Created 5/7/1996 Heikki Tuuri
 #include "que0types.h"
 #include "lock0types.h"
 #include "read0types.h"
+#include "sync0rw.h"
 #include "hash0hash.h"
 #include "srv0srv.h"
 #include "ut0vec.h"
@@ -554,6 +555,17 @@ lock_rec_hash(
 	ulint	space,	/*!< in: space */
 	ulint	page_no);/*!< in: page number */
 
+/*********************************************************************//**
+Gets the mutex protecting the record lock queue of a page, that is,
+the lock_sys->rec_hash cell of the page.
+@return mutex to hold together with an S-latch on lock_sys->latch */
+UNIV_INLINE
+ib_mutex_t*
+lock_rec_get_mutex(
+/*===============*/
+	ulint	space,	/*!< in: space */
+	ulint	page_no);/*!< in: page number */
+
 /**********************************************************************//**
 Looks for a set bit in a record lock bitmap. Returns ULINT_UNDEFINED,
 if none found.
@@ -657,7 +669,7 @@ lock_print_info_all_transactions(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 UNIV_INTERN
 ulint
 lock_number_of_rows_locked(
@@ -929,13 +941,40 @@ struct lock_op_t{
 	enum lock_mode	mode;	/*!< lock mode */
 };
 
+/** Number of mutexes protecting the cells of lock_sys->rec_hash;
+must be a power of 2 */
+#define LOCK_REC_N_MUTEXES	64
+
 /** The lock system struct */
 struct lock_sys_t{
-	ib_mutex_t	mutex;			/*!< Mutex protecting the
-						locks */
+	rw_lock_t	latch;			/*!< Latch protecting the
+						locks. Holding it in X mode
+						gives exclusive access to
+						all locks. Holding it in S
+						mode together with the
+						rec_mutexes[] entry of a
+						page allows the record lock
+						queue of that page to be
+						read and modified, and the
+						waiting record locks on the
+						page to be granted or
+						cancelled. Locks are only
+						removed from rec_hash and
+						table locks are only
+						created and removed in X
+						mode. */
+	ib_mutex_t	rec_mutexes[LOCK_REC_N_MUTEXES];
+						/*!< Mutexes protecting the
+						cells of rec_hash, see
+						lock_rec_get_mutex() */
+	ib_mutex_t	deadlock_mutex;		/*!< Mutex serializing the
+						deadlock checks that are made
+						holding latch in S mode */
 	hash_table_t*	rec_hash;		/*!< hash table of the record
 						locks */
-	ulint		rec_num;
+	ulint		rec_num;		/*!< number of record locks in
+						rec_hash; updated with atomic
+						operations */
 	ib_mutex_t	wait_mutex;		/*!< Mutex protecting the
 						next two fields */
 	srv_slot_t*	waiting_threads;	/*!< Array  of user threads
@@ -950,7 +989,7 @@ struct lock_sys_t{
 						/*!< TRUE if rollback of all
 						recovered transactions is
 						complete. Protected by
-						lock_sys->mutex */
+						lock_sys->latch */
 
 	ulint		n_lock_max_wait_time;	/*!< Max wait time */
 
@@ -966,20 +1005,38 @@ struct lock_sys_t{
 /** The lock system */
 extern lock_sys_t*	lock_sys;
 
-/** Test if lock_sys->mutex can be acquired without waiting. */
-#define lock_mutex_enter_nowait() mutex_enter_nowait(&lock_sys->mutex)
+/** Test if lock_sys->latch can be X-latched without waiting.
+@return 0 if the latch was acquired */
+#define lock_mutex_enter_nowait() (!rw_lock_x_lock_nowait(&lock_sys->latch))
+
+/** Test if lock_sys->latch is X-latched by the current thread. */
+#define lock_mutex_own()						\
+	(rw_lock_get_writer(&lock_sys->latch) == RW_LOCK_EX		\
+	 && lock_sys->latch.recursive					\
+	 && os_thread_eq(lock_sys->latch.writer_thread,			\
+			 os_thread_get_curr_id()))
+
+#ifdef UNIV_SYNC_DEBUG
+/** Test if lock_sys->latch is held by the current thread in any mode. */
+#define lock_sys_latched()						\
+	(rw_lock_own(&lock_sys->latch, RW_LOCK_EX)			\
+	 || rw_lock_own(&lock_sys->latch, RW_LOCK_SHARED))
+#endif /* UNIV_SYNC_DEBUG */
 
-/** Test if lock_sys->mutex is owned. */
-#define lock_mutex_own() mutex_own(&lock_sys->mutex)
+/** Test if the record lock queue of a page may be accessed, that is,
+lock_sys->latch is X-latched or the mutex of the page is owned. */
+#define lock_rec_own(space, page_no)					\
+	(lock_mutex_own()						\
+	 || mutex_own(lock_rec_get_mutex(space, page_no)))
 
-/** Acquire the lock_sys->mutex. */
+/** X-latch lock_sys->latch. */
 #define lock_mutex_enter() do {			\
-	mutex_enter(&lock_sys->mutex);		\
+	rw_lock_x_lock(&lock_sys->latch);	\
 } while (0)
 
-/** Release the lock_sys->mutex. */
+/** Release the X-latch on lock_sys->latch. */
 #define lock_mutex_exit() do {			\
-	mutex_exit(&lock_sys->mutex);		\
+	rw_lock_x_unlock(&lock_sys->latch);	\
 } while (0)
 
 /** Test if lock_sys->wait_mutex is owned. */
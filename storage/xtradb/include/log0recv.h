@@ -481,6 +481,18 @@ struct recv_sys_t{
 	hash_table_t*	addr_hash;/*!< hash table of file addresses of pages */
 	ulint		n_addrs;/*!< number of not processed hashed file
 				addresses in the hash table */
+#ifndef UNIV_HOTBACKUP
+	ulint		apply_next_cell;
+				/*!< in a parallel apply batch, the next
+				cell of addr_hash to be claimed by an apply
+				thread; protected by mutex */
+	ulint		n_apply_threads_active;
+				/*!< number of running apply threads;
+				protected by mutex */
+	os_event_t	apply_threads_done;
+				/*!< set when the last apply thread of a
+				batch exits */
+#endif /* !UNIV_HOTBACKUP */
 
 	recv_dblwr_t	dblwr;
 };
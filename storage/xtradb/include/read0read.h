@@ -89,9 +89,7 @@ UNIV_INLINE
 void
 read_view_remove(
 /*=============*/
-	read_view_t*	view,		/*!< in: read view, can be 0 */
-	bool		own_mutex);	/*!< in: true if caller owns the
-					trx_sys_t::mutex */
+	read_view_t*	view);		/*!< in: read view, can be 0 */
 /*********************************************************************//**
 Frees memory allocated by a read view. */
 UNIV_INTERN
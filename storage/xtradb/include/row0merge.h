@@ -123,7 +123,8 @@ struct index_def_t {
 /** Structure for reporting duplicate records. */
 struct row_merge_dup_t {
 	dict_index_t*		index;	/*!< index being sorted */
-	struct TABLE*		table;	/*!< MySQL table object */
+	struct TABLE*		table;	/*!< MySQL table object, or NULL
+					if duplicates are only counted */
 	const ulint*		col_map;/*!< mapping of column numbers
 					in table to the rebuilt table
 					(index->table), or NULL if not
@@ -383,7 +384,7 @@ row_merge_sort(
 					index entries */
 	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
 	int*			tmpfd,	/*!< in/out: temporary file handle */
-	const bool		update_progress, /*!< in: update progress status variable or not */
+	const bool		update_progress, /*!< in: update progress status variable and report the progress to the client, or not */
 	const float		pct_progress, /*!< in: total progress percent until now */
 	const float		pct_cost) /*!< in: current progress percent */
 	__attribute__((nonnull));
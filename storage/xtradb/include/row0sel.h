@@ -63,6 +63,21 @@ sel_col_prefetch_buf_free(
 /*======================*/
 	sel_buf_t*	prefetch_buf);	/*!< in, own: prefetch buffer */
 /*********************************************************************//**
+Frees the cache of prefetched rows of a table handle. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_free(
+/*========================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct */
+/*********************************************************************//**
+Frees the cache of prefetched rows of a table handle if it has grown beyond
+MYSQL_FETCH_CACHE_SIZE rows and holds no rows. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_shrink(
+/*==========================*/
+	row_prebuilt_t*	prebuilt);	/*!< in/out: prebuilt struct */
+/*********************************************************************//**
 Gets the plan node for the nth table in a join.
 @return	plan node */
 UNIV_INLINE
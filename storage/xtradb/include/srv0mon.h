@@ -30,6 +30,7 @@ Created 12/15/2009	Jimmy Yang
 #define srv0mon_h
 
 #include "univ.i"
+#include "btr0types.h"
 #ifndef UNIV_HOTBACKUP
 
 
@@ -347,6 +348,15 @@ enum monitor_id_t {
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
 	MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
 	MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+	/* One counter per adaptive hash index partition */
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART_LAST =
+		MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART
+		+ BTR_SEARCH_MAX_PARTITIONS - 1,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART,
+	MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART_LAST =
+		MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART
+		+ BTR_SEARCH_MAX_PARTITIONS - 1,
 
 	/* Tablespace related counters */
 	MONITOR_MODULE_FIL_SYSTEM,
@@ -173,6 +173,9 @@ struct srv_stats_t {
 	/** Number of times secondary index lookup triggered cluster lookup */
 	ulint_ctr_64_t		n_sec_rec_cluster_reads;
 
+	/** Number of times the cache of prefetched rows was refilled */
+	ulint_ctr_64_t		n_prefetch_cache_refills;
+
 	/** Number of times prefix optimization avoided triggering cluster lookup */
 	ulint_ctr_64_t		n_sec_rec_cluster_reads_avoided;
 
@@ -207,6 +210,12 @@ and/or load it during startup. */
 extern char		srv_buffer_pool_dump_at_shutdown;
 extern char		srv_buffer_pool_load_at_startup;
 
+/** Interval in seconds of the periodic buffer pool dumps, 0 if none */
+extern ulong		srv_buf_dump_interval;
+
+/** Number of threads that read pages during a buffer pool load */
+extern ulong		srv_n_buf_load_threads;
+
 /* Whether to disable file system cache if it is defined */
 extern char		srv_disable_sort_file_cache;
 
@@ -279,8 +288,16 @@ extern ulint	srv_max_file_format_at_startup;
 on duplicate key checking and foreign key checking */
 extern ibool	srv_locks_unsafe_for_binlog;
 
+/** Maximum size in bytes of the cache of prefetched rows of a table
+handle in a range scan */
+extern ulong	srv_prefetch_cache_size;
 /** Sort buffer size in index creation */
 extern ulong	srv_sort_buf_size;
+/** Number of threads that scan and sort in index creation */
+extern ulong	srv_n_ddl_threads;
+/** Percentage of the space on an index page that is filled when an
+index is built from sorted entries */
+extern ulong	srv_fill_factor;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long	srv_online_max_size;
 
@@ -354,6 +371,9 @@ extern my_bool	srv_prefix_index_cluster_optimization;
 /** Maximum number of srv_n_log_files, or innodb_log_files_in_group */
 #define SRV_N_LOG_FILES_MAX 100
 extern ulong	srv_n_log_files;
+/** Number of threads applying redo log records in crash recovery,
+or innodb_log_apply_threads */
+extern ulong	srv_n_log_apply_threads;
 extern ib_uint64_t	srv_log_file_size;
 extern ib_uint64_t	srv_log_file_size_requested;
 extern ulint	srv_log_buffer_size;
@@ -510,6 +530,7 @@ extern my_bool			srv_stats_sample_traditional;
 
 extern ibool	srv_use_doublewrite_buf;
 extern ulong	srv_doublewrite_batch_size;
+extern ulong	srv_doublewrite_segment_size;
 extern ulong	srv_checksum_algorithm;
 
 extern ulong	srv_log_arch_expire_sec;
@@ -703,6 +724,7 @@ extern mysql_pfs_key_t	srv_monitor_thread_key;
 extern mysql_pfs_key_t	srv_master_thread_key;
 extern mysql_pfs_key_t	srv_purge_thread_key;
 extern mysql_pfs_key_t	recv_writer_thread_key;
+extern mysql_pfs_key_t	recv_apply_thread_key;
 extern mysql_pfs_key_t	srv_log_tracking_thread_key;
 
 /* This macro register the current thread and its key with performance
@@ -899,7 +921,7 @@ srv_printf_innodb_monitor(
 /*======================*/
 	FILE*	file,		/*!< in: output stream */
 	ibool	nowait,		/*!< in: whether to wait for the
-				lock_sys_t::mutex */
+				lock_sys_t::latch */
 	ulint*	trx_start,	/*!< out: file position of the start of
 				the list of active transactions */
 	ulint*	trx_end);	/*!< out: file position of the end of
@@ -1149,6 +1171,8 @@ struct export_var_t{
 	ulint innodb_rows_inserted;		/*!< srv_n_rows_inserted */
 	ulint innodb_rows_updated;		/*!< srv_n_rows_updated */
 	ulint innodb_rows_deleted;		/*!< srv_n_rows_deleted */
+	ulint innodb_prefetch_cache_refills;	/*!< srv_stats.
+						n_prefetch_cache_refills */
 	ulint innodb_system_rows_read; /*!< srv_n_system_rows_read */
 	ulint innodb_system_rows_inserted; /*!< srv_n_system_rows_inserted */
 	ulint innodb_system_rows_updated; /*!< srv_n_system_rows_updated */
@@ -122,9 +122,11 @@ extern mysql_pfs_key_t	sync_thread_mutex_key;
 extern mysql_pfs_key_t	buf_dblwr_mutex_key;
 extern mysql_pfs_key_t	trx_undo_mutex_key;
 extern mysql_pfs_key_t	trx_mutex_key;
-extern mysql_pfs_key_t	lock_sys_mutex_key;
+extern mysql_pfs_key_t	lock_sys_rec_mutex_key;
+extern mysql_pfs_key_t	lock_sys_deadlock_mutex_key;
 extern mysql_pfs_key_t	lock_sys_wait_mutex_key;
 extern mysql_pfs_key_t	trx_sys_mutex_key;
+extern mysql_pfs_key_t	trx_sys_view_mutex_key;
 extern mysql_pfs_key_t	srv_sys_mutex_key;
 extern mysql_pfs_key_t	srv_sys_tasks_mutex_key;
 #ifndef HAVE_ATOMIC_BUILTINS
@@ -878,10 +880,13 @@ or row lock! */
 /*------------------------------------- MySQL query cache mutex */
 /*------------------------------------- MySQL binlog mutex */
 /*-------------------------------*/
-#define SYNC_LOCK_WAIT_SYS	300
-#define SYNC_LOCK_SYS		299
+#define SYNC_LOCK_WAIT_SYS	302
+#define SYNC_LOCK_SYS		301
+#define SYNC_LOCK_DEADLOCK	300
+#define SYNC_LOCK_REC_HASH	299
 #define SYNC_TRX_SYS		298
 #define SYNC_TRX		297
+#define SYNC_READ_VIEW		296
 #define SYNC_THREADS		295
 #define SYNC_REC_LOCK		294
 #define SYNC_TRX_SYS_HEADER	290
@@ -34,6 +34,8 @@ Created 3/26/1996 Heikki Tuuri
 #include "page0page.h"
 #include "usr0sess.h"
 #include "fil0fil.h"
+#include "hash0hash.h"
+#include "ut0vec.h"
 
 /** The global data structure coordinating a purge */
 extern trx_purge_t*	purge_sys;
@@ -112,6 +114,25 @@ enum purge_state_t {
 	PURGE_STATE_DISABLED		/*!< Purge was never started */
 };
 
+/*******************************************************************//**
+Claims the next group of undo log records of the current purge batch for
+a purge thread. The purge threads claim the groups without waiting for
+each other or for the purge coordinator, so that a thread that is done
+with its groups takes over work that would otherwise wait for a busier
+thread.
+@return group, or NULL if all the groups of the batch have been claimed */
+UNIV_INTERN
+trx_purge_group_t*
+trx_purge_claim_group(void);
+/*=======================*/
+/*******************************************************************//**
+Subtracts the records of a purged group from the purge lag of their
+table, if the table is in the dictionary cache. */
+UNIV_INTERN
+void
+trx_purge_group_done(
+/*=================*/
+	const trx_purge_group_t*	group);	/*!< in: purged group */
 /*******************************************************************//**
 Get the purge state.
 @return purge state. */
@@ -203,6 +224,18 @@ struct trx_purge_t{
 					purge: can be emptied after purge
 					completes */
 	/*-----------------------------*/
+	ib_vector_t*	groups;		/*!< The trx_purge_group_t* of the
+					current batch, in the order of their
+					first records; allocated from heap */
+	volatile ulint	n_groups_claimed;/*!< Number of groups claimed by
+					the purge threads; may exceed the
+					number of groups. Updated with atomic
+					operations */
+	hash_table_t*	group_hash;	/*!< The groups of the current batch
+					that can take more records, hashed on
+					the table id; used by the coordinator
+					while it fetches the batch */
+	/*-----------------------------*/
 	ib_bh_t*	ib_bh;		/*!< Binary min-heap, ordered on
 					rseg_queue_t::trx_no. It is protected
 					by the bh_mutex */
@@ -215,6 +248,26 @@ struct trx_purge_rec_t {
 	roll_ptr_t	roll_ptr;	/*!< File pointr to UNDO record */
 };
 
+/** Maximum number of undo log records in a trx_purge_group_t. The
+records of a heavily modified table are split into many groups, so
+that all the purge threads can work on them. */
+#define TRX_PURGE_GROUP_SIZE	64
+
+/** Undo log records of one table that one purge thread purges. A purge
+batch is split into these groups, and the purge threads claim them with
+trx_purge_claim_group(). */
+struct trx_purge_group_t {
+	table_id_t	table_id;	/*!< Table of the records */
+	ib_vector_t*	recs;		/*!< The trx_purge_rec_t to purge,
+					at most TRX_PURGE_GROUP_SIZE */
+	lint		n_lag;		/*!< Number of the records that
+					are counted in the purge lag of
+					the table, see
+					dict_table_t::n_purge_lag */
+	trx_purge_group_t* hash;	/*!< Hash chain node in
+					trx_purge_t::group_hash */
+};
+
 #ifndef UNIV_NONINL
 #include "trx0purge.ic"
 #endif
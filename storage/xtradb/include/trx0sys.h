@@ -197,6 +197,39 @@ trx_find_descriptor(
 	const trx_id_t*	descriptors,	/*!< in: descriptors array */
 	ulint		n_descr,	/*!< in: array size */
 	trx_id_t	trx_id);	/*!< in: trx pointer */
+/*************************************************************//**
+Marks the start of a change to trx_sys->max_trx_id, to the descriptors
+array or to trx_sys->descr_min_no. The caller must hold trx_sys->mutex
+and end the change with trx_sys_descr_change_end(). */
+UNIV_INLINE
+void
+trx_sys_descr_change_begin(void);
+/*============================*/
+/*************************************************************//**
+Marks the end of a change started by trx_sys_descr_change_begin(). */
+UNIV_INLINE
+void
+trx_sys_descr_change_end(void);
+/*==========================*/
+/*************************************************************//**
+Starts reading trx_sys->max_trx_id, the descriptors array and
+trx_sys->descr_min_no without holding trx_sys->mutex. Spins for a while
+for a change in progress to end.
+@return version to pass to trx_sys_descr_read_validate(); odd if a change
+was still in progress */
+UNIV_INLINE
+ulint
+trx_sys_descr_read_begin(void);
+/*==========================*/
+/*************************************************************//**
+Checks that the values read after trx_sys_descr_read_begin() were not
+changed meanwhile.
+@return true if the values read are consistent */
+UNIV_INLINE
+bool
+trx_sys_descr_read_validate(
+/*========================*/
+	ulint	version);	/*!< in: trx_sys_descr_read_begin() */
 
 #ifdef UNIV_DEBUG
 /* Flag to control TRX_RSEG_N_SLOTS behavior debugging. */
@@ -227,7 +260,7 @@ trx_read_trx_id(
 Looks for the trx instance with the given id in the rw trx_list.
 The caller must be holding trx_sys->mutex.
 @return	the trx handle or NULL if not found;
-the pointer must not be dereferenced unless lock_sys->mutex was
+the pointer must not be dereferenced unless lock_sys->latch was
 acquired before calling this function and is still being held */
 UNIV_INLINE
 trx_t*
@@ -247,9 +280,9 @@ trx_rw_min_trx_id(void);
 /****************************************************************//**
 Returns pointer to a transaction instance if a rw transaction with the given id
 is active. Caller must hold trx_sys->mutex. If the caller is not holding
-lock_sys->mutex, the transaction may already have been committed.
+lock_sys->latch, the transaction may already have been committed.
 @return transaction instance if active, or NULL;
-the pointer must not be dereferenced unless lock_sys->mutex was
+the pointer must not be dereferenced unless lock_sys->latch was
 acquired before calling this function and is still being held */
 UNIV_INLINE
 trx_t*
@@ -260,7 +293,7 @@ trx_rw_get_active_trx_by_id(
 					that will be set if corrupt */
 /****************************************************************//**
 Checks if a rw transaction with the given id is active. Caller must hold
-trx_sys->mutex. If the caller is not holding lock_sys->mutex, the
+trx_sys->mutex. If the caller is not holding lock_sys->latch, the
 transaction may already have been committed.
 @return	true if rw transaction it with a given id is active. */
 UNIV_INLINE
@@ -272,7 +305,7 @@ trx_rw_is_active_low(
 					that will be set if corrupt */
 /****************************************************************//**
 Checks if a rw transaction with the given id is active. If the caller is
-not holding lock_sys->mutex, the transaction may already have been
+not holding lock_sys->latch, the transaction may already have been
 committed.
 @return	true if rw transaction it with a given id is active. */
 UNIV_INLINE
@@ -676,14 +709,32 @@ struct trx_sys_t{
 					transaction number */
 	char		pad1[64];	/*!< Ensure max_trx_id does not share
 					cache line with other fields. */
-	trx_id_t*	descriptors;	/*!< Array of trx descriptors */
+	trx_id_t*	descriptors;	/*!< Array of trx descriptors: the
+					ids of the active and prepared
+					read-write transactions, in ascending
+					order. Read views copy it without
+					holding mutex, see descr_version. */
 	ulint		descr_n_max;	/*!< The current size of the descriptors
 					array. */
+	mem_heap_t*	descr_heap;	/*!< Memory heap of the descriptors
+					array. A grown array is allocated anew
+					and the old one is only freed at
+					shutdown, because a read view may
+					still be copying it. */
 	char		pad2[64];	/*!< Ensure static descriptor fields
 					do not share cache lines with
 					descr_n_used */
 	ulint		descr_n_used;	/*!< Number of used elements in the
 					descriptors array. */
+	trx_id_t	descr_min_no;	/*!< trx_t::no of the first
+					transaction in trx_serial_list, or
+					TRX_ID_MAX if the list is empty */
+	volatile ulint	descr_version;	/*!< Incremented at the start and at
+					the end of every change to max_trx_id,
+					descriptors and descr_min_no, so that
+					it is odd while a change is in
+					progress; see
+					trx_sys_descr_change_begin() */
 	char		pad3[64];	/*!< Ensure descriptors do not share
 					cache line with other fields */
 #ifdef UNIV_DEBUG
@@ -737,6 +788,14 @@ struct trx_sys_t{
 					list (update undo logs for committed
 					transactions), protected by
 					rseg->mutex */
+	ib_mutex_t	view_mutex;	/*!< mutex protecting view_list and
+					n_purge_views */
+	ulint		n_purge_views;	/*!< Incremented before and after
+					read_view_purge_open() opens a view.
+					A view whose snapshot was taken before
+					this changed may be older than the
+					purge view, and must not be added to
+					view_list. */
 	UT_LIST_BASE_NODE_T(read_view_t) view_list;
 					/*!< List of read views sorted
 					on trx no, biggest first */
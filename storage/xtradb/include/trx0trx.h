@@ -243,7 +243,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 UNIV_INTERN
 trx_t *
 trx_get_trx_by_xid(
@@ -334,7 +334,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys->mutex and trx_sys->mutex.
+The caller must hold lock_sys->latch and trx_sys->mutex.
 When possible, use trx_print() instead. */
 UNIV_INTERN
 void
@@ -348,7 +348,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys->mutex and trx_sys->mutex. */
+Acquires and releases lock_sys->latch and trx_sys->mutex. */
 UNIV_INTERN
 void
 trx_print(
@@ -586,15 +586,17 @@ granted the lock it was waiting for, which implies that the state can be changed
 asynchronously.
 
 All these operations take place within the context of locking. Therefore state
-changes within the locking code must acquire both the lock mutex and the
-trx->mutex when changing trx->lock.que_state to TRX_QUE_LOCK_WAIT or
+changes within the locking code must acquire both the lock_sys->latch (in X
+mode, or in S mode together with the mutex of the page of a record lock) and
+the trx->mutex when changing trx->lock.que_state to TRX_QUE_LOCK_WAIT or
 trx->lock.wait_lock to non-NULL but when the lock wait ends it is sufficient
 to only acquire the trx->mutex.
-To query the state either of the mutexes is sufficient within the locking
-code and no mutex is required when the query thread is no longer waiting. */
+To query the state either the trx->mutex or the X-latch is sufficient within
+the locking code and no mutex is required when the query thread is no longer
+waiting. */
 
 /** The locks and state of an active transaction. Protected by
-lock_sys->mutex, trx->mutex or both. */
+lock_sys->latch, trx->mutex or both. */
 struct trx_lock_t {
 	ulint		n_active_thrs;	/*!< number of active query threads */
 
@@ -606,15 +608,21 @@ struct trx_lock_t {
 					TRX_QUE_LOCK_WAIT, this points to
 					the lock request, otherwise this is
 					NULL; set to non-NULL when holding
-					both trx->mutex and lock_sys->mutex;
+					both trx->mutex and lock_sys->latch;
 					set to NULL when holding
-					lock_sys->mutex; readers should
-					hold lock_sys->mutex, except when
-					they are holding trx->mutex and
+					lock_sys->latch; for a record lock,
+					an S-latch and the mutex of the page
+					suffice; readers should hold
+					lock_sys->latch in X mode, or in S
+					mode and the mutex of the page of
+					the lock, except when they are
+					holding trx->mutex and
 					wait_lock==NULL */
 	ib_uint64_t	deadlock_mark;	/*!< A mark field that is initialized
 					to and checked against lock_mark_counter
-					by lock_deadlock_recursive(). */
+					by lock_deadlock_search(); protected
+					by the X-latch on lock_sys->latch or
+					by lock_sys->deadlock_mutex */
 	ibool		was_chosen_as_deadlock_victim;
 					/*!< when the transaction decides to
 					wait for a lock, it sets this to FALSE;
@@ -623,25 +631,26 @@ struct trx_lock_t {
 					resolution, it sets this to TRUE.
 					Protected by trx->mutex. */
 	time_t		wait_started;	/*!< lock wait started at this time,
-					protected only by lock_sys->mutex */
+					protected only by lock_sys->latch */
 
 	que_thr_t*	wait_thr;	/*!< query thread belonging to this
 					trx that is in QUE_THR_LOCK_WAIT
 					state. For threads suspended in a
 					lock wait, this is protected by
-					lock_sys->mutex. Otherwise, this may
+					lock_sys->latch. Otherwise, this may
 					only be modified by the thread that is
 					serving the running transaction. */
 
 	mem_heap_t*	lock_heap;	/*!< memory heap for trx_locks;
-					protected by lock_sys->mutex */
+					protected by lock_sys->latch in X
+					mode, or in S mode and trx->mutex */
 
 	UT_LIST_BASE_NODE_T(lock_t)
 			trx_locks;	/*!< locks requested
 					by the transaction;
 					insertions are protected by trx->mutex
-					and lock_sys->mutex; removals are
-					protected by lock_sys->mutex */
+					and lock_sys->latch; removals are
+					protected by lock_sys->latch */
 
 	ib_vector_t*	table_locks;	/*!< All table locks requested by this
 					transaction, including AUTOINC locks */
@@ -693,7 +702,7 @@ transactions. The trx_sys->mutex prevents a race condition between it
 and lock_trx_release_locks() [invoked by trx_commit()].
 
 * trx_print_low() may access transactions not associated with the current
-thread. The caller must be holding trx_sys->mutex and lock_sys->mutex.
+thread. The caller must be holding trx_sys->mutex and lock_sys->latch.
 
 * When a transaction handle is in the trx_sys->mysql_trx_list or
 trx_sys->trx_list, some of its fields must not be modified without
@@ -702,7 +711,7 @@ holding trx_sys->mutex exclusively.
 * The locking code (in particular, lock_deadlock_recursive() and
 lock_rec_convert_impl_to_expl()) will access transactions associated
 to other connections. The locks of transactions are protected by
-lock_sys->mutex and sometimes by trx->mutex. */
+lock_sys->latch and sometimes by trx->mutex. */
 
 struct trx_t{
 	ulint		magic_n;
@@ -710,7 +719,7 @@ struct trx_t{
 	ib_mutex_t	mutex;		/*!< Mutex protecting the fields
 					state and lock
 					(except some fields of lock, which
-					are protected by lock_sys->mutex) */
+					are protected by lock_sys->latch) */
 
 	/** State of the trx from the point of view of concurrency control
 	and the valid state transitions.
@@ -758,7 +767,7 @@ struct trx_t{
 	ACTIVE->COMMITTED is possible when the transaction is in
 	ro_trx_list or rw_trx_list.
 
-	Transitions to COMMITTED are protected by both lock_sys->mutex
+	Transitions to COMMITTED are protected by both lock_sys->latch
 	and trx->mutex.
 
 	NOTE: Some of these state change constraints are an overkill,
@@ -772,7 +781,7 @@ struct trx_t{
 
 	trx_lock_t	lock;		/*!< Information about the transaction
 					locks and state. Protected by
-					trx->mutex or lock_sys->mutex
+					trx->mutex or lock_sys->latch
 					or both */
 	ulint		is_recovered;	/*!< 0=normal transaction,
 					1=recovered, must be rolled back,
@@ -1003,7 +1012,7 @@ struct trx_t{
 					also in the lock list trx_locks. This
 					vector needs to be freed explicitly
 					when the trx instance is destroyed.
-					Protected by lock_sys->mutex. */
+					Protected by lock_sys->latch. */
 	/*------------------------------*/
 	ibool		read_only;	/*!< TRUE if transaction is flagged
 					as a READ-ONLY transaction.
@@ -1033,7 +1042,15 @@ struct trx_t{
 	THD*		current_lock_mutex_owner;
 					/*!< If this is equal to current_thd,
 					then in innobase_kill_query() we know we
-					already hold the lock_sys->mutex. */
+					already hold the lock_sys->latch,
+					in X or S mode. */
+	bool		lock_wait_cancel_deferred;
+					/*!< set by innobase_kill_query()
+					when it could not cancel the lock
+					wait because lock_sys->latch was
+					held in S mode by the same thread;
+					protected like
+					current_lock_mutex_owner */
 	/*------------------------------*/
 #ifdef UNIV_DEBUG
 	ulint		start_line;	/*!< Track where it was started from */
@@ -87,6 +87,8 @@ struct trx_undo_arr_t;
 struct trx_undo_inf_t;
 /** The control structure used in the purge operation */
 struct trx_purge_t;
+/** Undo log records of one table that one purge thread purges */
+struct trx_purge_group_t;
 /** Rollback command node in a query graph */
 struct roll_node_t;
 /** Commit command node in a query graph */
@@ -367,6 +367,15 @@ struct lock_deadlock_ctx_t {
 
 	ibool		too_deep;	/*!< TRUE if search was too deep and
 					was aborted */
+
+	bool		shared;		/*!< true if the search is made
+					holding lock_sys->latch in S mode
+					and lock_sys->deadlock_mutex */
+
+	ib_mutex_t*	mutex;		/*!< in a shared search, the
+					lock_sys->rec_mutexes[] entry
+					of the page of wait_lock that
+					is currently held, or NULL */
 };
 
 /** DFS visited node information used during deadlock checking. */
@@ -383,15 +392,22 @@ int thd_need_ordering_with(const MYSQL_THD thd, const MYSQL_THD other_thd);
 
 /** Stack to use during DFS search. Currently only a single stack is required
 because there is no parallel deadlock check. This stack is protected by
-the lock_sys_t::mutex. */
+the X-latch on lock_sys_t::latch or by lock_sys_t::deadlock_mutex. */
 static lock_stack_t*	lock_stack;
 
 /** The count of the types of locks. */
 static const ulint	lock_types = UT_ARR_SIZE(lock_compatibility_matrix);
 
+#ifdef UNIV_PFS_RWLOCK
+/* Key to register rwlock with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_sys_latch_key;
+#endif /* UNIV_PFS_RWLOCK */
+
 #ifdef UNIV_PFS_MUTEX
 /* Key to register mutex with performance schema */
-UNIV_INTERN mysql_pfs_key_t	lock_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	lock_sys_rec_mutex_key;
+/* Key to register mutex with performance schema */
+UNIV_INTERN mysql_pfs_key_t	lock_sys_deadlock_mutex_key;
 /* Key to register mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	lock_sys_wait_mutex_key;
 #endif /* UNIV_PFS_MUTEX */
@@ -622,7 +638,15 @@ lock_sys_create(
 
 	lock_sys->last_slot = lock_sys->waiting_threads;
 
-	mutex_create(lock_sys_mutex_key, &lock_sys->mutex, SYNC_LOCK_SYS);
+	rw_lock_create(lock_sys_latch_key, &lock_sys->latch, SYNC_LOCK_SYS);
+
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_create(lock_sys_rec_mutex_key,
+			     &lock_sys->rec_mutexes[i], SYNC_LOCK_REC_HASH);
+	}
+
+	mutex_create(lock_sys_deadlock_mutex_key,
+		     &lock_sys->deadlock_mutex, SYNC_LOCK_DEADLOCK);
 
 	mutex_create(lock_sys_wait_mutex_key,
 		     &lock_sys->wait_mutex, SYNC_LOCK_WAIT_SYS);
@@ -652,7 +676,13 @@ lock_sys_close(void)
 
 	hash_table_free(lock_sys->rec_hash);
 
-	mutex_free(&lock_sys->mutex);
+	rw_lock_free(&lock_sys->latch);
+
+	for (ulint i = 0; i < LOCK_REC_N_MUTEXES; i++) {
+		mutex_free(&lock_sys->rec_mutexes[i]);
+	}
+
+	mutex_free(&lock_sys->deadlock_mutex);
 	mutex_free(&lock_sys->wait_mutex);
 
 	mem_free(lock_stack);
@@ -728,7 +758,7 @@ lock_get_src_table(
 	Other transactions could want to convert one of our implicit
 	record locks to an explicit one. For that, they would need our
 	trx mutex. Waiting locks can be removed while only holding
-	lock_sys->mutex, but this is a running transaction and cannot
+	lock_sys->latch, but this is a running transaction and cannot
 	thus be holding any waiting locks. */
 	trx_mutex_enter(trx);
 
@@ -842,6 +872,76 @@ lock_is_table_exclusive(
 	return(ok);
 }
 
+#ifdef UNIV_DEBUG
+/*********************************************************************//**
+Checks if the queue of a lock may be accessed by the current thread: it
+holds lock_sys->latch in X mode, or the lock is a record lock and the
+thread holds the mutex of its page.
+@return true if the queue of the lock is latched */
+static
+bool
+lock_queue_own(
+/*===========*/
+	const lock_t*	lock)	/*!< in: lock */
+{
+	return(lock_mutex_own()
+	       || (lock_get_type_low(lock) == LOCK_REC
+		   && lock_rec_own(lock->un_member.rec_lock.space,
+				   lock->un_member.rec_lock.page_no)));
+}
+#endif /* UNIV_DEBUG */
+
+/*********************************************************************//**
+Latches the record lock queue of a page for an operation that only
+accesses that page. Normally this S-latches lock_sys->latch and acquires
+the mutex of the page. Galera transactions may cancel lock waits on other
+pages, and acquire lock_sys->latch in X mode instead.
+@return the page mutex that was acquired, or NULL if lock_sys->latch
+was X-latched */
+static
+ib_mutex_t*
+lock_rec_latch_enter(
+/*=================*/
+	const trx_t*	trx,	/*!< in: transaction requesting the
+				lock, or NULL */
+	ulint		space,	/*!< in: space */
+	ulint		page_no)/*!< in: page number */
+{
+	ib_mutex_t*	mutex;
+
+#ifdef WITH_WSREP
+	if (trx != NULL && wsrep_on(trx->mysql_thd)) {
+		lock_mutex_enter();
+		return(NULL);
+	}
+#endif /* WITH_WSREP */
+
+	rw_lock_s_lock(&lock_sys->latch);
+
+	mutex = lock_rec_get_mutex(space, page_no);
+
+	mutex_enter(mutex);
+
+	return(mutex);
+}
+
+/*********************************************************************//**
+Releases the latches acquired by lock_rec_latch_enter(). */
+static
+void
+lock_rec_latch_exit(
+/*================*/
+	ib_mutex_t*	mutex)	/*!< in: return value of
+				lock_rec_latch_enter() */
+{
+	if (mutex == NULL) {
+		lock_mutex_exit();
+	} else {
+		mutex_exit(mutex);
+		rw_lock_s_unlock(&lock_sys->latch);
+	}
+}
+
 /*********************************************************************//**
 Sets the wait flag of a lock and the back pointer in trx to lock. */
 UNIV_INLINE
@@ -854,7 +954,7 @@ lock_set_lock_and_trx_wait(
 	ut_ad(lock);
 	ut_ad(lock->trx == trx);
 	ut_ad(trx->lock.wait_lock == NULL);
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 	ut_ad(trx_mutex_own(trx));
 
 	trx->lock.wait_lock = lock;
@@ -872,7 +972,7 @@ lock_reset_lock_and_trx_wait(
 {
 	ut_ad(lock->trx->lock.wait_lock == lock);
 	ut_ad(lock_get_wait(lock));
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	lock->trx->lock.wait_lock = NULL;
 	lock->type_mode &= ~LOCK_WAIT;
@@ -1247,7 +1347,7 @@ lock_rec_get_next_on_page_const(
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 
 	space = lock->un_member.rec_lock.space;
@@ -1296,7 +1396,7 @@ lock_rec_get_first_on_page_addr(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(space, page_no));
 
 	for (lock = static_cast<lock_t*>(
 			HASH_GET_FIRST(lock_sys->rec_hash,
@@ -1324,11 +1424,12 @@ lock_rec_expl_exist_on_page(
 	ulint	space,	/*!< in: space id */
 	ulint	page_no)/*!< in: page number */
 {
-	lock_t*	lock;
+	lock_t*		lock;
+	ib_mutex_t*	mutex;
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(NULL, space, page_no);
 	lock = lock_rec_get_first_on_page_addr(space, page_no);
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
 
 	return(lock);
 }
@@ -1348,7 +1449,7 @@ lock_rec_get_first_on_page(
 	ulint	space	= buf_block_get_space(block);
 	ulint	page_no	= buf_block_get_page_no(block);
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(space, page_no));
 
 	hash = buf_block_get_lock_hash_val(block);
 
@@ -1377,7 +1478,7 @@ lock_rec_get_next(
 	ulint	heap_no,/*!< in: heap number of the record */
 	lock_t*	lock)	/*!< in: lock */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	do {
 		ut_ad(lock_get_type_low(lock) == LOCK_REC);
@@ -1412,7 +1513,8 @@ lock_rec_get_first(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 
 	for (lock = lock_rec_get_first_on_page(block); lock;
 	     lock = lock_rec_get_next_on_page(lock)) {
@@ -1482,7 +1584,7 @@ lock_rec_get_prev(
 	ulint	page_no;
 	lock_t*	found_lock	= NULL;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(in_lock));
 	ut_ad(lock_get_type_low(in_lock) == LOCK_REC);
 
 	space = in_lock->un_member.rec_lock.space;
@@ -1579,7 +1681,8 @@ lock_rec_has_expl(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad((precise_mode & LOCK_MODE_MASK) == LOCK_S
 	      || (precise_mode & LOCK_MODE_MASK) == LOCK_X);
 	ut_ad(!(precise_mode & LOCK_INSERT_INTENTION));
@@ -1636,7 +1739,8 @@ lock_rec_other_has_expl_req(
 {
 	const lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 	ut_ad(gap == 0 || gap == LOCK_GAP);
 	ut_ad(wait == 0 || wait == LOCK_WAIT);
@@ -1667,7 +1771,7 @@ wsrep_kill_victim(
 	const trx_t * const trx,
 	const lock_t *lock)
 {
-        ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
         ut_ad(trx_mutex_own(lock->trx));
 	my_bool bf_this  = wsrep_thd_is_BF(trx->mysql_thd, FALSE);
 	my_bool bf_other = wsrep_thd_is_BF(lock->trx->mysql_thd, TRUE);
@@ -1743,7 +1847,8 @@ lock_rec_other_has_conflicting(
 	const lock_t*		lock;
 	ibool			is_supremum;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 
 	is_supremum = (heap_no == PAGE_HEAP_NO_SUPREMUM);
 
@@ -1753,9 +1858,14 @@ lock_rec_other_has_conflicting(
 
 #ifdef WITH_WSREP
 		if (lock_rec_has_to_wait(TRUE, trx, mode, lock, is_supremum)) {
-			trx_mutex_enter(lock->trx);
-			wsrep_kill_victim((trx_t *)trx, (lock_t *)lock);
-			trx_mutex_exit(lock->trx);
+			/* Only Galera transactions, which hold
+			lock_sys->latch in X mode, may kill others */
+			if (wsrep_on(trx->mysql_thd)) {
+				trx_mutex_enter(lock->trx);
+				wsrep_kill_victim((trx_t *)trx,
+						  (lock_t *)lock);
+				trx_mutex_exit(lock->trx);
+			}
 #else
  		if (lock_rec_has_to_wait(trx, mode, lock, is_supremum)) {
 #endif /* WITH_WSREP */
@@ -1781,7 +1891,7 @@ lock_rec_find_similar_on_page(
 	lock_t*		lock,		/*!< in: lock_rec_get_first_on_page() */
 	const trx_t*	trx)		/*!< in: transaction */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock == NULL || lock_queue_own(lock));
 
 	for (/* No op */;
 	     lock != NULL;
@@ -1919,7 +2029,7 @@ lock_rec_other_trx_holds_expl(
 Return approximate number or record locks (bits set in the bitmap) for
 this transaction. Since delete-marked records may be removed, the
 record count will not be precise.
-The caller must be holding lock_sys->mutex. */
+The caller must be holding lock_sys->latch. */
 UNIV_INTERN
 ulint
 lock_number_of_rows_locked(
@@ -2005,7 +2115,8 @@ lock_rec_create(
 	ulint		n_bytes;
 	const page_t*	page;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -2033,6 +2144,14 @@ lock_rec_create(
 	n_bits = page_dir_get_n_heap(page) + LOCK_PAGE_BITMAP_MARGIN;
 	n_bytes = 1 + n_bits / 8;
 
+	/* Other threads holding lock_sys->latch in S mode may be
+	creating locks for trx on other pages. The lock heap of trx
+	is protected by trx->mutex in that case. */
+
+	if (!caller_owns_trx_mutex) {
+		trx_mutex_enter(trx);
+	}
+
 	lock = static_cast<lock_t*>(
 		mem_heap_alloc(trx->lock.lock_heap, sizeof(lock_t) + n_bytes));
 
@@ -2053,7 +2172,7 @@ lock_rec_create(
 	/* Set the bit corresponding to rec */
 	lock_rec_set_nth_bit(lock, heap_no);
 
-	index->table->n_rec_locks++;
+	os_atomic_increment_ulint(&index->table->n_rec_locks, 1);
 
 	ut_ad(index->table->n_ref_count > 0 || !index->table->can_be_evicted);
 
@@ -2101,15 +2220,12 @@ lock_rec_create(
 			   victim lock release. This will eventually call
 			   lock_grant, which wants to grant trx mutex again
 			*/
-			if (caller_owns_trx_mutex) {
-				trx_mutex_exit(trx);
-			}
+			trx_mutex_exit(trx);
+
 			lock_cancel_waiting_and_release(
 				c_lock->trx->lock.wait_lock);
 
-			if (caller_owns_trx_mutex) {
-				trx_mutex_enter(trx);
-			}
+			trx_mutex_enter(trx);
 
 			/* trx might not wait for c_lock, but some other lock
 			   does not matter if wait_lock was released above
@@ -2127,6 +2243,10 @@ lock_rec_create(
 					(ulonglong) c_lock->trx->id);
 			}
 
+			if (!caller_owns_trx_mutex) {
+				trx_mutex_exit(trx);
+			}
+
 			/* have to bail out here to avoid lock_set_lock... */
 			return(lock);
 		}
@@ -2140,11 +2260,8 @@ lock_rec_create(
 		    lock_rec_fold(space, page_no), lock);
 #endif /* WITH_WSREP */
 
-	lock_sys->rec_num++;
+	os_atomic_increment_ulint(&lock_sys->rec_num, 1);
 
-	if (!caller_owns_trx_mutex) {
-		trx_mutex_enter(trx);
-	}
 	ut_ad(trx_mutex_own(trx));
 
 	if (type_mode & LOCK_WAIT) {
@@ -2164,11 +2281,11 @@ lock_rec_create(
 
 /*********************************************************************//**
 Enqueues a waiting request for a lock which cannot be granted immediately.
-Checks for deadlocks.
-@return DB_LOCK_WAIT, DB_DEADLOCK, or DB_QUE_THR_SUSPENDED, or
-DB_SUCCESS_LOCKED_REC; DB_SUCCESS_LOCKED_REC means that
-there was a deadlock, but another transaction was chosen as a victim,
-and we got the lock immediately: no need to wait then */
+Does NOT check for deadlocks: the caller must invoke
+lock_deadlock_check_rec_wait() after releasing the record lock queue.
+@return DB_LOCK_WAIT, or DB_QUE_THR_SUSPENDED, or DB_SUCCESS_LOCKED_REC;
+DB_SUCCESS_LOCKED_REC means that a Galera transaction got the lock
+immediately: no need to wait then */
 static
 dberr_t
 lock_rec_enqueue_waiting(
@@ -2192,13 +2309,12 @@ lock_rec_enqueue_waiting(
 	que_thr_t*		thr)	/*!< in: query thread */
 {
 	trx_t*			trx;
-	lock_t*			lock;
-	trx_id_t		victim_trx_id;
 	ulint			sec;
 	ulint			ms;
 
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad(!srv_read_only_mode);
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 
@@ -2235,40 +2351,16 @@ lock_rec_enqueue_waiting(
 
 	/* Enqueue the lock request that will wait to be granted, note that
 	we already own the trx mutex. */
-	lock = lock_rec_create(
+	lock_rec_create(
 #ifdef WITH_WSREP
                 c_lock, thr,
 #endif /* WITH_WSREP */
                 type_mode | LOCK_WAIT, block, heap_no, index, trx, TRUE);
 
-	/* Release the mutex to obey the latching order.
-	This is safe, because lock_deadlock_check_and_resolve()
-	is invoked when a lock wait is enqueued for the currently
-	running transaction. Because trx is a running transaction
-	(it is not currently suspended because of a lock wait),
-	its state can only be changed by this thread, which is
-	currently associated with the transaction. */
-
-	trx_mutex_exit(trx);
-
-	victim_trx_id = lock_deadlock_check_and_resolve(lock, trx);
-
-	trx_mutex_enter(trx);
-
-	if (victim_trx_id != 0) {
-
-		ut_ad(victim_trx_id == trx->id);
-
-		lock_reset_lock_and_trx_wait(lock);
-		lock_rec_reset_nth_bit(lock, heap_no);
+	if (trx->lock.wait_lock == NULL) {
 
-		return(DB_DEADLOCK);
-
-	} else if (trx->lock.wait_lock == NULL) {
-
-		/* If there was a deadlock but we chose another
-		transaction as a victim, it is possible that we
-		already have the lock now granted! */
+		/* A Galera transaction may have cancelled the
+		conflicting lock request and got the lock granted. */
 
 		return(DB_SUCCESS_LOCKED_REC);
 	}
@@ -2325,7 +2417,8 @@ lock_rec_add_to_queue(
 	lock_t*	lock;
 	lock_t*	first_lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad(caller_owns_trx_mutex == trx_mutex_own(trx));
 	ut_ad(dict_index_is_clust(index) || !dict_index_is_online_ddl(index));
 #ifdef UNIV_DEBUG
@@ -2466,7 +2559,8 @@ lock_rec_lock_fast(
 	trx_t*			trx;
 	enum lock_rec_req_status status = LOCK_REC_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2552,7 +2646,8 @@ lock_rec_lock_slow(
 #endif
 	dberr_t			err = DB_SUCCESS;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2640,7 +2735,8 @@ lock_rec_lock(
 	dict_index_t*		index,	/*!< in: index of record */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_S
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IS));
 	ut_ad((LOCK_MODE_MASK & mode) != LOCK_X
@@ -2685,7 +2781,7 @@ lock_rec_has_to_wait_in_queue(
 	ulint		bit_mask;
 	ulint		bit_offset;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(wait_lock));
 	ut_ad(lock_get_wait(wait_lock));
 	ut_ad(lock_get_type_low(wait_lock) == LOCK_REC);
 
@@ -2721,14 +2817,14 @@ lock_rec_has_to_wait_in_queue(
 
 /*************************************************************//**
 Grants a lock to a waiting lock request and releases the waiting transaction.
-The caller must hold lock_sys->mutex but not lock->trx->mutex. */
+The caller must hold lock_sys->latch but not lock->trx->mutex. */
 static
 void
 lock_grant(
 /*=======*/
 	lock_t*	lock)	/*!< in/out: waiting lock request */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 
 	lock_reset_lock_and_trx_wait(lock);
 
@@ -2785,7 +2881,7 @@ lock_rec_cancel(
 {
 	que_thr_t*	thr;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_queue_own(lock));
 	ut_ad(lock_get_type_low(lock) == LOCK_REC);
 
 	/* Reset the bit (there can be only one set bit) in the lock bitmap */
@@ -2837,11 +2933,11 @@ lock_rec_dequeue_from_page(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_sys->rec_hash,
 		    lock_rec_fold(space, page_no), in_lock);
-	lock_sys->rec_num--;
+	os_atomic_decrement_ulint(&lock_sys->rec_num, 1);
 
 	UT_LIST_REMOVE(trx_locks, trx_lock->trx_locks, in_lock);
 
@@ -2888,11 +2984,11 @@ lock_rec_discard(
 	space = in_lock->un_member.rec_lock.space;
 	page_no = in_lock->un_member.rec_lock.page_no;
 
-	in_lock->index->table->n_rec_locks--;
+	os_atomic_decrement_ulint(&in_lock->index->table->n_rec_locks, 1);
 
 	HASH_DELETE(lock_t, hash, lock_sys->rec_hash,
 		    lock_rec_fold(space, page_no), in_lock);
-	lock_sys->rec_num--;
+	os_atomic_decrement_ulint(&lock_sys->rec_num, 1);
 
 	UT_LIST_REMOVE(trx_locks, trx_lock->trx_locks, in_lock);
 
@@ -2949,7 +3045,8 @@ lock_rec_reset_and_release_wait(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
 
 	for (lock = lock_rec_get_first(block, heap_no);
 	     lock != NULL;
@@ -2985,7 +3082,10 @@ lock_rec_inherit_to_gap(
 {
 	lock_t*	lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_rec_own(buf_block_get_space(block),
+			  buf_block_get_page_no(block)));
+	ut_ad(lock_rec_own(buf_block_get_space(heir_block),
+			  buf_block_get_page_no(heir_block)));
 
 	/* If srv_locks_unsafe_for_binlog is TRUE or session is using
 	READ COMMITTED isolation level, we do not want locks set
@@ -3027,9 +3127,12 @@ lock_rec_inherit_to_gap_if_gap_lock(
 						does NOT reset the locks
 						on this record */
 {
-	lock_t*	lock;
+	lock_t*		lock;
+	ib_mutex_t*	mutex;
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		NULL, buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	for (lock = lock_rec_get_first(block, heap_no);
 	     lock != NULL;
@@ -3046,7 +3149,7 @@ lock_rec_inherit_to_gap_if_gap_lock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
 }
 
 /*************************************************************//**
@@ -3800,6 +3903,7 @@ lock_update_delete(
 	const page_t*	page = block->frame;
 	ulint		heap_no;
 	ulint		next_heap_no;
+	ib_mutex_t*	mutex;
 
 	ut_ad(page == page_align(rec));
 
@@ -3815,7 +3919,9 @@ lock_update_delete(
 								       FALSE));
 	}
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		NULL, buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	/* Let the next record inherit the locks from rec, in gap mode */
 
@@ -3825,7 +3931,7 @@ lock_update_delete(
 
 	lock_rec_reset_and_release_wait(block, heap_no);
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
 }
 
 /*********************************************************************//**
@@ -3980,7 +4086,8 @@ lock_deadlock_lock_print(
 	}
 }
 
-/** Used in deadlock tracking. Protected by lock_sys->mutex. */
+/** Used in deadlock tracking. Protected by the X-latch on lock_sys->latch
+or by lock_sys->deadlock_mutex. */
 static ib_uint64_t	lock_mark_counter = 0;
 
 /** Check if the search is too deep. */
@@ -3988,6 +4095,53 @@ static ib_uint64_t	lock_mark_counter = 0;
 	(c->depth > LOCK_MAX_DEPTH_IN_DEADLOCK_CHECK		\
 	 || c->cost > LOCK_MAX_N_STEPS_IN_DEADLOCK_CHECK)
 
+/** Test if the deadlock search state of a context may be accessed. */
+#define lock_deadlock_own(c)					\
+	(lock_mutex_own()					\
+	 || ((c)->shared && mutex_own(&lock_sys->deadlock_mutex)))
+
+/********************************************************************//**
+In a shared deadlock search, acquires the mutex protecting the queue of
+a lock, releasing the page mutex held before. Does nothing in a search
+that is made holding lock_sys->latch in X mode. */
+static
+void
+lock_deadlock_latch(
+/*================*/
+	lock_deadlock_ctx_t*	ctx,	/*!< in/out: deadlock context */
+	const lock_t*		lock)	/*!< in: lock whose queue is going
+					to be searched, or NULL to release
+					the page mutex */
+{
+	ib_mutex_t*	mutex = NULL;
+
+	if (!ctx->shared) {
+		return;
+	}
+
+	ut_ad(mutex_own(&lock_sys->deadlock_mutex));
+
+	/* Table lock queues cannot change while lock_sys->latch
+	is being held in S mode. */
+
+	if (lock != NULL && lock_get_type_low(lock) == LOCK_REC) {
+		mutex = lock_rec_get_mutex(lock->un_member.rec_lock.space,
+					   lock->un_member.rec_lock.page_no);
+	}
+
+	if (mutex != ctx->mutex) {
+		if (ctx->mutex != NULL) {
+			mutex_exit(ctx->mutex);
+		}
+
+		if (mutex != NULL) {
+			mutex_enter(mutex);
+		}
+
+		ctx->mutex = mutex;
+	}
+}
+
 /********************************************************************//**
 Get the next lock in the queue that is owned by a transaction whose
 sub-tree has not already been searched.
@@ -4002,7 +4156,7 @@ lock_get_next_lock(
 	ulint			heap_no)/*!< in: heap no if rec lock else
 					ULINT_UNDEFINED */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_deadlock_own(ctx));
 
 	do {
 		if (lock_get_type_low(lock) == LOCK_REC) {
@@ -4041,13 +4195,20 @@ lock_get_first_lock(
 {
 	const lock_t*		lock;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_deadlock_own(ctx));
 
 	lock = ctx->wait_lock;
 
 	if (lock_get_type_low(lock) == LOCK_REC) {
 
 		*heap_no = lock_rec_find_set_bit(lock);
+
+		if (ctx->shared && !lock_get_wait(lock)) {
+			/* The lock wait ended after the transaction
+			was found waiting: there is no edge to follow. */
+			return(NULL);
+		}
+
 		ut_ad(*heap_no != ULINT_UNDEFINED);
 
 		lock = lock_rec_get_first_on_page_addr(
@@ -4066,7 +4227,7 @@ lock_get_first_lock(
 	}
 
 	ut_a(lock != NULL);
-	ut_a(lock != ctx->wait_lock);
+	ut_a(ctx->shared || lock != ctx->wait_lock);
 	ut_ad(lock_get_type_low(lock) == lock_get_type_low(ctx->wait_lock));
 
 	return(lock);
@@ -4165,7 +4326,7 @@ lock_deadlock_pop(
 /*==============*/
 	lock_deadlock_ctx_t*	ctx)		/*!< in/out: context */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_deadlock_own(ctx));
 
 	ut_ad(ctx->depth > 0);
 
@@ -4183,7 +4344,7 @@ lock_deadlock_push(
 	const lock_t*		lock,		/*!< in: current lock */
 	ulint			heap_no)	/*!< in: heap number */
 {
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_deadlock_own(ctx));
 
 	/* Save current search state. */
 
@@ -4216,7 +4377,7 @@ lock_deadlock_search(
 	const lock_t*	lock;
 	ulint		heap_no;
 
-	ut_ad(lock_mutex_own());
+	ut_ad(lock_deadlock_own(ctx));
 	ut_ad(!trx_mutex_own(ctx->start));
 
 	ut_ad(ctx->start != NULL);
@@ -4244,6 +4405,8 @@ lock_deadlock_search(
 			heap_no = stack->heap_no;
 			ctx->wait_lock = stack->wait_lock;
 
+			lock_deadlock_latch(ctx, ctx->wait_lock);
+
 			lock = lock_get_next_lock(ctx, lock, heap_no);
 		}
 
@@ -4273,6 +4436,12 @@ lock_deadlock_search(
 
 			/* Found a cycle. */
 
+			if (ctx->shared) {
+				/* Let the caller confirm and resolve the
+				deadlock holding lock_sys->latch in X mode. */
+				return(ctx->start->id);
+			}
+
 			lock_deadlock_notify(ctx, lock);
 
 			return(lock_deadlock_select_victim(ctx)->id);
@@ -4317,7 +4486,13 @@ lock_deadlock_search(
 				waitee_ptr->waitees[waitee_ptr->used++] = lock->trx;
 			}
 
-			if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT) {
+			/* In a shared search, the lock wait may end at
+			any time. lock_get_first_lock() checks if it did,
+			holding the mutex of the page of wait_lock. */
+			const lock_t*	wait_lock = lock->trx->lock.wait_lock;
+
+			if (lock->trx->lock.que_state == TRX_QUE_LOCK_WAIT
+			    && wait_lock != NULL) {
 
 				/* Another trx ahead has requested a lock in an
 				incompatible mode, and is itself waiting for a lock. */
@@ -4341,10 +4516,15 @@ lock_deadlock_search(
 					return(ctx->start->id);
 				}
 
-				ctx->wait_lock = lock->trx->lock.wait_lock;
+				ctx->wait_lock = wait_lock;
+
+				lock_deadlock_latch(ctx, wait_lock);
+
 				lock = lock_get_first_lock(ctx, &heap_no);
 
-				if (lock->trx->lock.deadlock_mark > ctx->mark_start) {
+				if (lock != NULL
+				    && lock->trx->lock.deadlock_mark
+				    > ctx->mark_start) {
 					lock = lock_get_next_lock(ctx, lock, heap_no);
 				}
 
@@ -4415,15 +4595,28 @@ lock_deadlock_trx_rollback(
 	trx_mutex_exit(trx);
 }
 
+/** The most transactions whose lock wait cancel
+lock_deadlock_search_shared() defers until the latch is released */
+#define LOCK_MAX_DEFERRED_CANCELS	64
+
 static
 void
 lock_report_waiters_to_mysql(
 /*=======================*/
 	struct thd_wait_reports*	waitee_buf_ptr,	/*!< in: set of trxs */
 	THD*				mysql_thd,	/*!< in: THD */
-	trx_id_t			victim_trx_id)	/*!< in: Trx selected
+	trx_id_t			victim_trx_id,	/*!< in: Trx selected
 							as deadlock victim, if
 							any */
+	trx_id_t*			cancel_ids,	/*!< out: ids of the
+							killed trxs whose lock
+							wait is to be cancelled,
+							or NULL if
+							lock_sys->latch is held
+							in X mode */
+	ulint*				n_cancel)	/*!< in/out: number of
+							elements in
+							cancel_ids */
 {
 	struct thd_wait_reports*	p;
 	struct thd_wait_reports*	q;
@@ -4441,11 +4634,23 @@ lock_report_waiters_to_mysql(
 				transaction, then we will get a call back into
 				innobase_kill_query. We mark this by setting
 				current_lock_mutex_owner, so we can avoid trying
-				to recursively take lock_sys->mutex. */
+				to recursively take lock_sys->latch. */
 				w_trx->current_lock_mutex_owner = mysql_thd;
 				thd_report_wait_for(mysql_thd, w_trx->mysql_thd);
 				w_trx->current_lock_mutex_owner = NULL;
 			}
+			if (w_trx->lock_wait_cancel_deferred) {
+				ut_ad(cancel_ids != NULL);
+				w_trx->lock_wait_cancel_deferred = false;
+				if (*n_cancel < LOCK_MAX_DEFERRED_CANCELS
+				    && w_trx->id != 0) {
+					cancel_ids[(*n_cancel)++] = w_trx->id;
+				} else {
+					/* Leave it to the lock wait
+					timeout thread. */
+					os_event_set(lock_sys->timeout_event);
+				}
+			}
 			++i;
 		}
 		q = p->next;
@@ -4500,6 +4705,8 @@ lock_deadlock_check_and_resolve(
 		ctx.too_deep = FALSE;
 		ctx.wait_lock = lock;
 		ctx.mark_start = lock_mark_counter;
+		ctx.shared = false;
+		ctx.mutex = NULL;
 
 		if (waitee_buf_ptr) {
 			waitee_buf_ptr->next = NULL;
@@ -4512,7 +4719,8 @@ lock_deadlock_check_and_resolve(
 		if (waitee_buf_ptr) {
 			lock_report_waiters_to_mysql(waitee_buf_ptr,
 						     start_mysql_thd,
-						     victim_trx_id);
+						     victim_trx_id,
+						     NULL, NULL);
 		}
 
 		/* Search too deep, we rollback the joining transaction. */
@@ -4562,6 +4770,188 @@ lock_deadlock_check_and_resolve(
 	return(victim_trx_id);
 }
 
+/********************************************************************//**
+Cancels the lock waits of transactions that were killed by
+thd_report_wait_for() during a deadlock search holding lock_sys->latch in
+S mode, when innobase_kill_query() could not cancel them. */
+static
+void
+lock_cancel_deferred_waits(
+/*=======================*/
+	const trx_id_t*	cancel_ids,	/*!< in: ids of the killed trxs */
+	ulint		n_cancel)	/*!< in: number of elements in
+					cancel_ids */
+{
+	ut_ad(!lock_mutex_own());
+
+	lock_mutex_enter();
+	mutex_enter(&trx_sys->mutex);
+
+	for (ulint i = 0; i < n_cancel; i++) {
+		/* The transaction may have ended after the latch was
+		released, and its id cannot have been reused. */
+		trx_t*	trx = trx_get_rw_trx_by_id(cancel_ids[i]);
+
+		if (trx == NULL) {
+			continue;
+		}
+
+		trx_mutex_enter(trx);
+
+		if (trx->lock.wait_lock != NULL) {
+			lock_cancel_waiting_and_release(trx->lock.wait_lock);
+		}
+
+		trx_mutex_exit(trx);
+	}
+
+	mutex_exit(&trx_sys->mutex);
+	lock_mutex_exit();
+}
+
+/********************************************************************//**
+Searches for a deadlock caused by a record lock wait holding
+lock_sys->latch in S mode. The record lock queues are latched one page
+at a time, so that the search does not block other transactions from
+acquiring record locks. A deadlock found this way may be a false one,
+caused by the waits-for graph changing during the search.
+@return 0 if no deadlock was found, otherwise the id of the waiting
+transaction */
+static
+trx_id_t
+lock_deadlock_search_shared(
+/*========================*/
+	const trx_t*	trx)	/*!< in: transaction that is waiting */
+{
+	trx_id_t		victim_trx_id = 0;
+	lock_deadlock_ctx_t	ctx;
+	struct thd_wait_reports	waitee_buf;
+	struct thd_wait_reports*waitee_buf_ptr;
+	const lock_t*		lock;
+	trx_id_t		cancel_ids[LOCK_MAX_DEFERRED_CANCELS];
+	ulint			n_cancel = 0;
+
+	if (trx->mysql_thd && thd_need_wait_for(trx->mysql_thd)) {
+		waitee_buf_ptr = &waitee_buf;
+		waitee_buf_ptr->next = NULL;
+		waitee_buf_ptr->used = 0;
+	} else {
+		waitee_buf_ptr = NULL;
+	}
+
+	rw_lock_s_lock(&lock_sys->latch);
+
+	mutex_enter(&lock_sys->deadlock_mutex);
+
+	ctx.cost = 0;
+	ctx.depth = 0;
+	ctx.start = trx;
+	ctx.too_deep = FALSE;
+	ctx.mark_start = lock_mark_counter;
+	ctx.shared = true;
+	ctx.mutex = NULL;
+
+	lock = trx->lock.wait_lock;
+
+	if (lock != NULL) {
+		ctx.wait_lock = lock;
+
+		lock_deadlock_latch(&ctx, lock);
+
+		/* The lock may have been granted before we
+		acquired the mutex of its page. */
+
+		if (trx->lock.wait_lock == lock) {
+			victim_trx_id = lock_deadlock_search(
+				&ctx, waitee_buf_ptr);
+		}
+
+		lock_deadlock_latch(&ctx, NULL);
+	}
+
+	mutex_exit(&lock_sys->deadlock_mutex);
+
+	/* The waitees cannot release their locks and go away while
+	we are holding lock_sys->latch. */
+
+	if (waitee_buf_ptr) {
+		lock_report_waiters_to_mysql(waitee_buf_ptr,
+					     trx->mysql_thd, 0,
+					     cancel_ids, &n_cancel);
+	}
+
+	rw_lock_s_unlock(&lock_sys->latch);
+
+	DEBUG_SYNC_C("lock_deadlock_search_shared_done");
+
+	/* A waitee that was killed by a report above can only be
+	woken up from its own lock wait under the X latch. */
+
+	if (n_cancel > 0) {
+		lock_cancel_deferred_waits(cancel_ids, n_cancel);
+	}
+
+	return(victim_trx_id);
+}
+
+/********************************************************************//**
+Checks if a record lock wait enqueued by lock_rec_enqueue_waiting()
+results in a deadlock, and resolves it. The waits-for graph is first
+searched holding lock_sys->latch in S mode. Only if that search finds a
+deadlock or is aborted, the check is repeated and the deadlock resolved
+holding lock_sys->latch in X mode.
+@return DB_DEADLOCK if trx was chosen as the victim, otherwise
+DB_LOCK_WAIT */
+static
+dberr_t
+lock_deadlock_check_rec_wait(
+/*=========================*/
+	trx_t*	trx)	/*!< in/out: transaction that is waiting */
+{
+	const lock_t*	lock;
+	dberr_t		err = DB_LOCK_WAIT;
+
+	ut_ad(!lock_mutex_own());
+	ut_ad(!trx_mutex_own(trx));
+
+#ifdef WITH_WSREP
+	/* Galera transactions enqueue their lock waits holding
+	lock_sys->latch in X mode, and check for deadlocks likewise. */
+	if (!wsrep_on(trx->mysql_thd)
+	    && !lock_deadlock_search_shared(trx)) {
+#else
+	if (!lock_deadlock_search_shared(trx)) {
+#endif /* WITH_WSREP */
+
+		return(err);
+	}
+
+	DEBUG_SYNC_C("lock_deadlock_found_shared");
+
+	lock_mutex_enter();
+
+	lock = trx->lock.wait_lock;
+
+	if (lock != NULL && lock_deadlock_check_and_resolve(lock, trx)) {
+
+		/* The joining transaction was chosen as the victim.
+		Cancel the wait, so that the transactions that have
+		started to wait behind it can proceed. */
+
+		trx_mutex_enter(trx);
+
+		lock_cancel_waiting_and_release(trx->lock.wait_lock);
+
+		trx_mutex_exit(trx);
+
+		err = DB_DEADLOCK;
+	}
+
+	lock_mutex_exit();
+
+	return(err);
+}
+
 /*========================= TABLE LOCKS ==============================*/
 
 /*********************************************************************//**
@@ -5194,6 +5584,7 @@ lock_rec_unlock(
 	ulint		heap_no;
 	const char*	stmt;
 	size_t		stmt_len;
+	ib_mutex_t*	mutex;
 
 	ut_ad(trx);
 	ut_ad(rec);
@@ -5203,7 +5594,9 @@ lock_rec_unlock(
 
 	heap_no = page_rec_get_heap_no(rec);
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		trx, buf_block_get_space(block),
+		buf_block_get_page_no(block));
 	trx_mutex_enter(trx);
 
 	first_lock = lock_rec_get_first(block, heap_no);
@@ -5218,7 +5611,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
 	trx_mutex_exit(trx);
 
 	stmt = innobase_get_stmt(trx->mysql_thd, &stmt_len);
@@ -5237,6 +5630,11 @@ lock_rec_unlock(
 	ut_a(!lock_get_wait(lock));
 	lock_rec_reset_nth_bit(lock, heap_no);
 
+	/* lock_grant() acquires the mutex of the waiting transaction.
+	Under a shared lock_sys->latch another thread may be doing the
+	same the other way around, so release our own first. */
+	trx_mutex_exit(trx);
+
 	/* Check if we can now grant waiting lock requests */
 
 	for (lock = first_lock; lock != NULL;
@@ -5250,8 +5648,7 @@ lock_rec_unlock(
 		}
 	}
 
-	lock_mutex_exit();
-	trx_mutex_exit(trx);
+	lock_rec_latch_exit(mutex);
 }
 
 /*********************************************************************//**
@@ -5484,7 +5881,7 @@ lock_remove_recovered_trx_record_locks(
 			continue;
 		}
 
-		/* Because we are holding the lock_sys->mutex,
+		/* Because we are holding the lock_sys->latch,
 		implicit locks cannot be converted to explicit ones
 		while we are scanning the explicit locks. */
 
@@ -5908,7 +6305,7 @@ lock_print_info_all_transactions(
 	}
 
 loop:
-	/* Since we temporarily release lock_sys->mutex and
+	/* Since we temporarily release lock_sys->latch and
 	trx_sys->mutex when reading a database page in below,
 	variable trx may be obsolete now and we must loop
 	through the trx list to get probably the same trx,
@@ -6129,7 +6526,7 @@ lock_table_queue_validate(
 		/* lock->trx->state cannot change from or to NOT_STARTED
 		while we are holding the trx_sys->mutex. It may change
 		from ACTIVE to PREPARED, but it may not change to
-		COMMITTED, because we are holding the lock_sys->mutex. */
+		COMMITTED, because we are holding the lock_sys->latch. */
 		ut_ad(trx_assert_started(lock->trx));
 
 		if (!lock_get_wait(lock)) {
@@ -6217,7 +6614,7 @@ lock_rec_queue_validate(
 
 		ut_ad(lock_mutex_own());
 		/* trx_id cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys->mutex */
+		because lock_trx_release_locks() acquires lock_sys->latch */
 
 		if (trx_desc != NULL
 		    && lock_rec_other_has_expl_req(LOCK_S, 0, LOCK_WAIT,
@@ -6498,7 +6895,7 @@ lock_validate()
 	ut_a(lock_validate_table_locks(&trx_sys->ro_trx_list));
 
 	/* Iterate over all the record locks and validate the locks. We
-	don't want to hog the lock_sys_t::mutex and the trx_sys_t::mutex.
+	don't want to hog the lock_sys_t::latch and the trx_sys_t::mutex.
 	Release both mutexes during the validation check. */
 
 	for (ulint i = 0; i < hash_get_n_cells(lock_sys->rec_hash); i++) {
@@ -6557,6 +6954,7 @@ lock_rec_insert_check_and_lock(
 	dberr_t		err;
 	ulint		next_rec_heap_no;
 	ibool		inherit_in = *inherit;
+	ib_mutex_t*	mutex;
 #ifdef WITH_WSREP
 	lock_t*		c_lock=NULL;
 #endif
@@ -6580,7 +6978,9 @@ lock_rec_insert_check_and_lock(
 	next_rec = page_rec_get_next_const(rec);
 	next_rec_heap_no = page_rec_get_heap_no(next_rec);
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		trx, buf_block_get_space(block),
+		buf_block_get_page_no(block));
 	/* Because this code is invoked for a running transaction by
 	the thread that is serving the transaction, it is not necessary
 	to hold trx->mutex here. */
@@ -6595,7 +6995,7 @@ lock_rec_insert_check_and_lock(
 	if (UNIV_LIKELY(lock == NULL)) {
 		/* We optimize CPU time usage in the simplest case */
 
-		lock_mutex_exit();
+		lock_rec_latch_exit(mutex);
 
 		if (inherit_in && !dict_index_is_clust(index)) {
 			/* Update the page max trx id field */
@@ -6651,7 +7051,11 @@ lock_rec_insert_check_and_lock(
 		err = DB_SUCCESS;
 	}
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
+
+	if (err == DB_LOCK_WAIT) {
+		err = lock_deadlock_check_rec_wait(trx);
+	}
 
 	switch (err) {
 	case DB_SUCCESS_LOCKED_REC:
@@ -6730,8 +7134,13 @@ lock_rec_convert_impl_to_expl(
 	if (trx_id != 0) {
 		trx_id_t*	impl_trx_desc;
 		ulint		heap_no = page_rec_get_heap_no(rec);
+		ib_mutex_t*	mutex;
 
-		lock_mutex_enter();
+		DEBUG_SYNC_C("lock_rec_convert_impl_to_expl");
+
+		mutex = lock_rec_latch_enter(
+			NULL, buf_block_get_space(block),
+			buf_block_get_page_no(block));
 
 		/* If the transaction is still active and has no
 		explicit x-lock set on the record, set one for it */
@@ -6742,8 +7151,9 @@ lock_rec_convert_impl_to_expl(
 						    trx_id);
 		mutex_exit(&trx_sys->mutex);
 
-		/* trx_id cannot be committed until lock_mutex_exit()
-		because lock_trx_release_locks() acquires lock_sys->mutex */
+		/* trx_id may release its descriptor meanwhile, but it cannot
+		release its locks until lock_rec_latch_exit() because
+		lock_trx_release_locks() acquires lock_sys->latch in X mode */
 
 		if (impl_trx_desc != NULL
 		    && !lock_rec_has_expl(LOCK_X | LOCK_REC_NOT_GAP, block,
@@ -6762,7 +7172,7 @@ lock_rec_convert_impl_to_expl(
 				impl_trx, FALSE);
 		}
 
-		lock_mutex_exit();
+		lock_rec_latch_exit(mutex);
 	}
 }
 
@@ -6787,8 +7197,9 @@ lock_clust_rec_modify_check_and_lock(
 	const ulint*		offsets,/*!< in: rec_get_offsets(rec, index) */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	dberr_t	err;
-	ulint	heap_no;
+	dberr_t		err;
+	ulint		heap_no;
+	ib_mutex_t*	mutex;
 
 	ut_ad(rec_offs_validate(rec, index, offsets));
 	ut_ad(dict_index_is_clust(index));
@@ -6812,7 +7223,9 @@ lock_clust_rec_modify_check_and_lock(
 
 	lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		thr_get_trx(thr), buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
@@ -6821,7 +7234,11 @@ lock_clust_rec_modify_check_and_lock(
 
 	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
+
+	if (err == DB_LOCK_WAIT) {
+		err = lock_deadlock_check_rec_wait(thr_get_trx(thr));
+	}
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -6853,8 +7270,9 @@ lock_sec_rec_modify_check_and_lock(
 				(can be NULL if BTR_NO_LOCKING_FLAG) */
 	mtr_t*		mtr)	/*!< in/out: mini-transaction */
 {
-	dberr_t	err;
-	ulint	heap_no;
+	dberr_t		err;
+	ulint		heap_no;
+	ib_mutex_t*	mutex;
 
 	ut_ad(!dict_index_is_clust(index));
 	ut_ad(!dict_index_is_online_ddl(index) || (flags & BTR_CREATE_FLAG));
@@ -6876,7 +7294,9 @@ lock_sec_rec_modify_check_and_lock(
 	index record, and this would not have been possible if another active
 	transaction had modified this secondary index record. */
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		thr_get_trx(thr), buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
 
@@ -6885,7 +7305,11 @@ lock_sec_rec_modify_check_and_lock(
 
 	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
+
+	if (err == DB_LOCK_WAIT) {
+		err = lock_deadlock_check_rec_wait(thr_get_trx(thr));
+	}
 
 #ifdef UNIV_DEBUG
 	{
@@ -6947,8 +7371,9 @@ lock_sec_rec_read_check_and_lock(
 					LOCK_REC_NOT_GAP */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	dberr_t	err;
-	ulint	heap_no;
+	dberr_t		err;
+	ulint		heap_no;
+	ib_mutex_t*	mutex;
 
 	ut_ad(!dict_index_is_clust(index));
 	ut_ad(!dict_index_is_online_ddl(index));
@@ -6984,7 +7409,9 @@ lock_sec_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		thr_get_trx(thr), buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
@@ -6996,7 +7423,11 @@ lock_sec_rec_read_check_and_lock(
 
 	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
+
+	if (err == DB_LOCK_WAIT) {
+		err = lock_deadlock_check_rec_wait(thr_get_trx(thr));
+	}
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -7034,8 +7465,9 @@ lock_clust_rec_read_check_and_lock(
 					LOCK_REC_NOT_GAP */
 	que_thr_t*		thr)	/*!< in: query thread */
 {
-	dberr_t	err;
-	ulint	heap_no;
+	dberr_t		err;
+	ulint		heap_no;
+	ib_mutex_t*	mutex;
 
 	ut_ad(dict_index_is_clust(index));
 	ut_ad(block->frame == page_align(rec));
@@ -7065,7 +7497,9 @@ lock_clust_rec_read_check_and_lock(
 		lock_rec_convert_impl_to_expl(block, rec, index, offsets);
 	}
 
-	lock_mutex_enter();
+	mutex = lock_rec_latch_enter(
+		thr_get_trx(thr), buf_block_get_space(block),
+		buf_block_get_page_no(block));
 
 	ut_ad(mode != LOCK_X
 	      || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
@@ -7077,7 +7511,11 @@ lock_clust_rec_read_check_and_lock(
 
 	MONITOR_INC(MONITOR_NUM_RECLOCK_REQ);
 
-	lock_mutex_exit();
+	lock_rec_latch_exit(mutex);
+
+	if (err == DB_LOCK_WAIT) {
+		err = lock_deadlock_check_rec_wait(thr_get_trx(thr));
+	}
 
 	ut_ad(lock_rec_queue_validate(FALSE, block, rec, index, offsets));
 
@@ -7505,26 +7943,32 @@ lock_trx_release_locks(
 {
 	assert_trx_in_list(trx);
 
+	mutex_enter(&trx_sys->mutex);
+
 	if (trx_state_eq(trx, TRX_STATE_PREPARED)) {
-		mutex_enter(&trx_sys->mutex);
 		ut_a(trx_sys->n_prepared_trx > 0);
 		trx_sys->n_prepared_trx--;
 		if (trx->is_recovered) {
 			ut_a(trx_sys->n_prepared_recovered_trx > 0);
 			trx_sys->n_prepared_recovered_trx--;
 		}
-		mutex_exit(&trx_sys->mutex);
 	} else {
 		ut_ad(trx_state_eq(trx, TRX_STATE_ACTIVE));
 	}
 
+	/* The transaction has been serialised, so read views opened from
+	now on may see its changes, although it keeps its locks until
+	lock_release() below. Remove it from the descriptors array before
+	acquiring lock_sys->latch, so that trx_sys->mutex is never waited
+	for while holding lock_sys->latch in X mode. */
+	/* The following also removes trx from trx_serial_list */
+	trx_release_descriptor(trx);
+
+	mutex_exit(&trx_sys->mutex);
+
 	/* The transition of trx->state to TRX_STATE_COMMITTED_IN_MEMORY
-	is protected by both the lock_sys->mutex and the trx->mutex.
-	We also lock trx_sys->mutex, because state transition to
-	TRX_STATE_COMMITTED_IN_MEMORY must be atomic with removing trx
-	from the descriptors array. */
+	is protected by both the lock_sys->latch and the trx->mutex. */
 	lock_mutex_enter();
-	mutex_enter(&trx_sys->mutex);
 	trx_mutex_enter(trx);
 
 	/* The following assignment makes the transaction committed in memory
@@ -7543,8 +7987,6 @@ lock_trx_release_locks(
 
 	/*--------------------------------------*/
 	trx->state = TRX_STATE_COMMITTED_IN_MEMORY;
-	/* The following also removes trx from trx_serial_list */
-	trx_release_descriptor(trx);
 	/*--------------------------------------*/
 
 	/* If the background thread trx_rollback_or_clean_recovered()
@@ -7562,8 +8004,6 @@ lock_trx_release_locks(
 
 	trx_mutex_exit(trx);
 
-	mutex_exit(&trx_sys->mutex);
-
 	lock_release(trx);
 
 	lock_mutex_exit();
@@ -89,10 +89,11 @@ lock_wait_table_release_slot(
 
 	/* Note: When we reserve the slot we use the trx_t::mutex to update
 	the slot values to change the state to reserved. Here we are using the
-	lock mutex to change the state of the slot to free. This is by design,
-	because when we query the slot state we always hold both the lock and
-	trx_t::mutex. To reduce contention on the lock mutex when reserving the
-	slot we avoid acquiring the lock mutex. */
+	lock_sys->latch in X mode to change the state of the slot to free.
+	This is by design, because when we query the slot state we always
+	hold both the lock_sys->latch (in S or X mode) and trx_t::mutex.
+	To reduce contention on the lock_sys->latch when reserving the
+	slot we avoid acquiring it. */
 
 	lock_mutex_enter();
 
@@ -423,13 +424,16 @@ lock_wait_release_thread_if_suspended(
 	que_thr_t*	thr)	/*!< in: query thread associated with the
 				user OS thread	 */
 {
-	ut_ad(lock_mutex_own());
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(lock_sys_latched());
+#endif /* UNIV_SYNC_DEBUG */
 	ut_ad(trx_mutex_own(thr_get_trx(thr)));
 
-	/* We own both the lock mutex and the trx_t::mutex but not the
-	lock wait mutex. This is OK because other threads will see the state
-	of this slot as being in use and no other thread can change the state
-	of the slot to free unless that thread also owns the lock mutex. */
+	/* We own the lock_sys->latch in S or X mode and the trx_t::mutex
+	but not the lock wait mutex. This is OK because other threads will
+	see the state of this slot as being in use and no other thread can
+	change the state of the slot to free unless that thread owns the
+	lock_sys->latch in X mode. */
 
 	if (thr->slot != NULL && thr->slot->in_use && thr->slot->thr == thr) {
 		trx_t*	trx = thr_get_trx(thr);
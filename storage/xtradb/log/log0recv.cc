@@ -57,6 +57,7 @@ Created 9/20/1997 Heikki Tuuri
 #include "trx0rec.h"
 #include "fil0fil.h"
 #ifndef UNIV_HOTBACKUP
+# include "buf0dblwr.h"
 # include "buf0rea.h"
 # include "srv0srv.h"
 # include "srv0start.h"
@@ -174,6 +175,7 @@ UNIV_INTERN mysql_pfs_key_t	recv_sys_mutex_key;
 #ifndef UNIV_HOTBACKUP
 # ifdef UNIV_PFS_THREAD
 UNIV_INTERN mysql_pfs_key_t	recv_writer_thread_key;
+UNIV_INTERN mysql_pfs_key_t	recv_apply_thread_key;
 # endif /* UNIV_PFS_THREAD */
 
 # ifdef UNIV_PFS_MUTEX
@@ -1901,6 +1903,154 @@ recv_read_in_area(
 	return(n);
 }
 
+/*******************************************************************//**
+Applies the log records of the not yet processed pages in one cell of
+recv_sys->addr_hash. Pages that are not in the buffer pool are read in,
+and the i/o handler applies the log records to them. The caller must own
+recv_sys->mutex, which is released while a page is processed. */
+static
+void
+recv_apply_hashed_cell(
+/*===================*/
+	ulint	i)	/*!< in: cell number in recv_sys->addr_hash */
+{
+	recv_addr_t*	recv_addr;
+	mtr_t		mtr;
+
+	ut_ad(mutex_own(&recv_sys->mutex));
+
+	for (recv_addr = static_cast<recv_addr_t*>(
+			HASH_GET_FIRST(recv_sys->addr_hash, i));
+	     recv_addr != 0;
+	     recv_addr = static_cast<recv_addr_t*>(
+			HASH_GET_NEXT(addr_hash, recv_addr))) {
+
+		ulint	space = recv_addr->space;
+		ulint	zip_size = fil_space_get_zip_size(space);
+		ulint	page_no = recv_addr->page_no;
+
+		if (recv_addr->state != RECV_NOT_PROCESSED) {
+			continue;
+		}
+
+		mutex_exit(&(recv_sys->mutex));
+
+		if (buf_page_peek(space, page_no)) {
+			buf_block_t*	block;
+
+			mtr_start(&mtr);
+
+			block = buf_page_get(
+				space, zip_size, page_no,
+				RW_X_LATCH, &mtr);
+			buf_block_dbg_add_level(
+				block, SYNC_NO_ORDER_CHECK);
+
+			recv_recover_page(FALSE, block);
+			mtr_commit(&mtr);
+		} else {
+			recv_read_in_area(space, zip_size, page_no);
+		}
+
+		mutex_enter(&(recv_sys->mutex));
+	}
+}
+
+/*******************************************************************//**
+A thread that applies log records in a parallel apply batch. Each thread
+claims cells of recv_sys->addr_hash until all have been claimed; as the
+cells are chosen by a hash of the page address, the threads work on
+different pages.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(recv_apply_thread)(
+/*==============================*/
+	void*	arg __attribute__((unused)))
+			/*!< in: a dummy parameter required by
+			os_thread_create */
+{
+#ifdef UNIV_PFS_THREAD
+	pfs_register_thread(recv_apply_thread_key);
+#endif /* UNIV_PFS_THREAD */
+
+	mutex_enter(&(recv_sys->mutex));
+
+	while (recv_sys->apply_next_cell
+	       < hash_get_n_cells(recv_sys->addr_hash)) {
+
+		recv_apply_hashed_cell(recv_sys->apply_next_cell++);
+	}
+
+	if (--recv_sys->n_apply_threads_active == 0) {
+		os_event_set(recv_sys->apply_threads_done);
+	}
+
+	mutex_exit(&(recv_sys->mutex));
+
+	/* We count the number of threads in os_thread_exit().
+	A created thread should always use that to exit and not
+	use return() to exit. */
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*******************************************************************//**
+Applies the log records of the hash table with srv_n_log_apply_threads
+threads, and reports the progress to the error log every 10 seconds.
+The caller must own recv_sys->mutex. */
+static
+void
+recv_apply_hashed_log_recs_parallel(void)
+/*=====================================*/
+{
+	ulint		n_pages = recv_sys->n_addrs;
+	ulint		start_time = ut_time_ms();
+	ulint		last_report_time = start_time;
+	ib_int64_t	sig_count;
+
+	ut_ad(mutex_own(&recv_sys->mutex));
+
+	recv_sys->apply_threads_done = os_event_create();
+	sig_count = os_event_reset(recv_sys->apply_threads_done);
+	recv_sys->apply_next_cell = 0;
+	recv_sys->n_apply_threads_active = srv_n_log_apply_threads;
+
+	for (ulint i = 0; i < srv_n_log_apply_threads; i++) {
+		os_thread_create(recv_apply_thread, NULL, NULL);
+	}
+
+	while (recv_sys->n_apply_threads_active != 0) {
+		ulint	now;
+
+		mutex_exit(&(recv_sys->mutex));
+
+		os_event_wait_time_low(recv_sys->apply_threads_done,
+				       1000000, sig_count);
+
+		mutex_enter(&(recv_sys->mutex));
+
+		now = ut_time_ms();
+
+		if (now - last_report_time >= 10000) {
+			ulint	n_applied = n_pages - recv_sys->n_addrs;
+
+			ib_logf(IB_LOG_LEVEL_INFO,
+				"Applied log records to " ULINTPF
+				" of " ULINTPF " pages, "
+				ULINTPF " pages/s",
+				n_applied, n_pages,
+				n_applied * 1000 / (now - start_time));
+
+			last_report_time = now;
+		}
+	}
+
+	os_event_free(recv_sys->apply_threads_done);
+	recv_sys->apply_threads_done = NULL;
+}
+
 /*******************************************************************//**
 Empties the hash table of stored log records, applying them to appropriate
 pages. */
@@ -1918,10 +2068,10 @@ recv_apply_hashed_log_recs(
 				the caller must in this case own the log
 				mutex */
 {
-	recv_addr_t* recv_addr;
 	ulint	i;
 	ibool	has_printed	= FALSE;
-	mtr_t	mtr;
+	ulint	n_pages;
+	ulint	start_time;
 loop:
 	mutex_enter(&(recv_sys->mutex));
 
@@ -1943,62 +2093,37 @@ recv_apply_hashed_log_recs(
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
-
-		for (recv_addr = static_cast<recv_addr_t*>(
-				HASH_GET_FIRST(recv_sys->addr_hash, i));
-		     recv_addr != 0;
-		     recv_addr = static_cast<recv_addr_t*>(
-				HASH_GET_NEXT(addr_hash, recv_addr))) {
-
-			ulint	space = recv_addr->space;
-			ulint	zip_size = fil_space_get_zip_size(space);
-			ulint	page_no = recv_addr->page_no;
+	n_pages = recv_sys->n_addrs;
+	start_time = ut_time_ms();
 
-			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ib_logf(IB_LOG_LEVEL_INFO,
-						"Starting an apply batch"
-						" of log records"
-						" to the database...");
-					fputs("InnoDB: Progress in percent: ",
-					      stderr);
-					has_printed = TRUE;
-				}
-
-				mutex_exit(&(recv_sys->mutex));
+	if (n_pages != 0) {
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Starting an apply batch of log records"
+			" to the database...");
+		has_printed = TRUE;
+	}
 
-				if (buf_page_peek(space, page_no)) {
-					buf_block_t*	block;
+	if (has_printed && srv_n_log_apply_threads > 1) {
+		recv_apply_hashed_log_recs_parallel();
+	} else if (has_printed) {
+		fputs("InnoDB: Progress in percent: ", stderr);
 
-					mtr_start(&mtr);
+		for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
 
-					block = buf_page_get(
-						space, zip_size, page_no,
-						RW_X_LATCH, &mtr);
-					buf_block_dbg_add_level(
-						block, SYNC_NO_ORDER_CHECK);
+			recv_apply_hashed_cell(i);
 
-					recv_recover_page(FALSE, block);
-					mtr_commit(&mtr);
-				} else {
-					recv_read_in_area(space, zip_size,
-							  page_no);
-				}
+			if ((i * 100) / hash_get_n_cells(recv_sys->addr_hash)
+			    != ((i + 1) * 100)
+			    / hash_get_n_cells(recv_sys->addr_hash)) {
 
-				mutex_enter(&(recv_sys->mutex));
+				fprintf(stderr, "%lu ", (ulong)
+					((i * 100)
+					 / hash_get_n_cells(
+						 recv_sys->addr_hash)));
 			}
 		}
 
-		if (has_printed
-		    && (i * 100) / hash_get_n_cells(recv_sys->addr_hash)
-		    != ((i + 1) * 100)
-		    / hash_get_n_cells(recv_sys->addr_hash)) {
-
-			fprintf(stderr, "%lu ", (ulong)
-				((i * 100)
-				 / hash_get_n_cells(recv_sys->addr_hash)));
-		}
+		fprintf(stderr, "\n");
 	}
 
 	/* Wait until all the pages have been processed */
@@ -2013,8 +2138,15 @@ recv_apply_hashed_log_recs(
 	}
 
 	if (has_printed) {
+		ulint	elapsed = ut_time_ms() - start_time;
 
-		fprintf(stderr, "\n");
+		ib_logf(IB_LOG_LEVEL_INFO,
+			"Applied log records to " ULINTPF " pages in "
+			ULINTPF " ms, " ULINTPF " pages/s, using "
+			ULINTPF " thread(s)",
+			n_pages, elapsed,
+			n_pages * 1000 / (elapsed ? elapsed : 1),
+			(ulint) srv_n_log_apply_threads);
 	}
 
 	if (!allow_ibuf) {
@@ -4109,6 +4241,15 @@ byte* recv_dblwr_t::find_page(ulint space_id, ulint page_no)
 		}
 	}
 
+#ifndef UNIV_HOTBACKUP
+	/* The copy in the doublewrite segment file may be newer */
+	if (byte* seg_page = buf_dblwr_seg_find_page(
+		    space_id, page_no,
+		    result ? mach_read_from_8(result + FIL_PAGE_LSN) : 0)) {
+		result = seg_page;
+	}
+#endif /* !UNIV_HOTBACKUP */
+
 	return(result);
 }
 
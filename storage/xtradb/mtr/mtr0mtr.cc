@@ -241,6 +241,7 @@ mtr_log_reserve_and_write(
 	dyn_array_t*	mlog;
 	ulint		data_size;
 	byte*		first_data;
+	log_copy_t	copy;
 
 	ut_ad(!srv_read_only_mode);
 
@@ -255,52 +256,40 @@ mtr_log_reserve_and_write(
 				     | MLOG_SINGLE_REC_FLAG);
 	}
 
-	if (mlog->heap == NULL) {
-		ulint	len;
+	data_size = dyn_array_get_data_size(mlog);
 
-		len = mtr->log_mode != MTR_LOG_NO_REDO
-			? dyn_block_get_used(mlog) : 0;
+	/* Open the database log for log_reserve_for_copy */
+	mtr->start_lsn = log_reserve_and_open(data_size);
 
-		mtr->end_lsn = log_reserve_and_write_fast(
-			first_data, len, &mtr->start_lsn);
+	if (mtr->log_mode != MTR_LOG_ALL) {
+		ut_ad(mtr->log_mode == MTR_LOG_NONE
+		      || mtr->log_mode == MTR_LOG_NO_REDO);
 
-		if (mtr->end_lsn) {
+		mtr->end_lsn = log_close();
 
-			/* Success. We have the log mutex.
-			Add pages to flush list and exit */
-			mtr_add_dirtied_pages_to_flush_list(mtr);
+		mtr_add_dirtied_pages_to_flush_list(mtr);
 
-			return;
-		}
-	} else {
-		mutex_enter(&log_sys->mutex);
+		return;
 	}
 
-	data_size = dyn_array_get_data_size(mlog);
-
-	/* Open the database log for log_write_low */
-	mtr->start_lsn = log_open(data_size);
-
-	if (mtr->log_mode == MTR_LOG_ALL) {
+	/* Only reserve the log buffer range while holding the log mutex */
+	mtr->end_lsn = log_reserve_for_copy(data_size, &copy);
 
-		for (dyn_block_t* block = mlog;
-		     block != 0;
-		     block = dyn_array_get_next_block(mlog, block)) {
+	mtr_add_dirtied_pages_to_flush_list(mtr);
 
-			log_write_low(
-				dyn_block_get_data(block),
-				dyn_block_get_used(block));
-		}
+	/* The log mutex has been released: copy the log concurrently with
+	other mini-transactions. The range cannot be written to the log
+	files before log_copy_done(). */
+	for (dyn_block_t* block = mlog;
+	     block != 0;
+	     block = dyn_array_get_next_block(mlog, block)) {
 
-	} else {
-		ut_ad(mtr->log_mode == MTR_LOG_NONE
-		      || mtr->log_mode == MTR_LOG_NO_REDO);
-		/* Do nothing */
+		log_copy_low(&copy,
+			     dyn_block_get_data(block),
+			     dyn_block_get_used(block));
 	}
 
-	mtr->end_lsn = log_close();
-
-	mtr_add_dirtied_pages_to_flush_list(mtr);
+	log_copy_done(&copy);
 }
 #endif /* !UNIV_HOTBACKUP */
 
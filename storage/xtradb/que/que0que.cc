@@ -208,7 +208,9 @@ que_thr_end_lock_wait(
 	ulint		ms;
 	ib_uint64_t	now;
 
-	ut_ad(lock_mutex_own());
+#ifdef UNIV_SYNC_DEBUG
+	ut_ad(lock_sys_latched());
+#endif /* UNIV_SYNC_DEBUG */
 	ut_ad(trx_mutex_own(trx));
 
 	thr = trx->lock.wait_thr;
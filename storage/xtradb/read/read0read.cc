@@ -168,11 +168,19 @@ For details see: row_vers_old_has_index_entry() and row_purge_poss_sec()
 Some additional issues:
 
 What if trx_sys->view_list == NULL and some transaction T1 and Purge both
-try to open read_view at same time. Only one can acquire trx_sys->mutex.
+try to open read_view at same time. Only one can acquire trx_sys->view_mutex.
 In which order will the views be opened? Should it matter? If no, why?
 
-The order does not matter. No new transactions can be created and no running
-transaction can commit or rollback (or free views).
+The snapshot of the active transactions is copied from trx_sys->descriptors
+without holding any mutex; trx_sys->descr_version tells the reader whether a
+transaction started or committed while it was copying, in which case the copy
+is retried. After READ_VIEW_SNAPSHOT_MAX_RETRIES attempts the snapshot is
+copied under trx_sys->mutex, so that a steady stream of transaction starts and
+commits cannot starve the reader. Purge always copies it under
+trx_sys->mutex. A view must never be older than the purge view, so purge bumps
+trx_sys->n_purge_views under trx_sys->view_mutex before and after it opens
+its view. A view whose snapshot was taken before that is not added to
+trx_sys->view_list; the snapshot is taken again instead.
 */
 
 /*********************************************************************//**
@@ -233,7 +241,7 @@ read_view_clone(
 	trx_id_t*	old_descriptors;
 	ulint		old_max_descr;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&trx_sys->view_mutex));
 
 	clone = read_view_create_low(view->n_descr, prebuilt_clone);
 
@@ -265,7 +273,7 @@ read_view_add(
 	read_view_t*	elem;
 	read_view_t*	prev_elem;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(mutex_own(&trx_sys->view_mutex));
 	ut_ad(read_view_validate(view));
 
 	/* Find the correct slot for insertion. */
@@ -286,8 +294,40 @@ read_view_add(
 }
 
 /*********************************************************************//**
-Opens a read view where exactly the transactions serialized before this
-point in time are seen in the view.
+Adds a view to trx_sys->view_list unless purge has opened its view after
+the snapshot of the view was taken.
+@return true if the view was added */
+static
+bool
+read_view_try_add(
+/*==============*/
+	read_view_t*	view,		/*!< in: view to add */
+	ulint		n_purge_views)	/*!< in: trx_sys->n_purge_views
+					before the snapshot was taken */
+{
+	bool	added = false;
+
+	mutex_enter(&trx_sys->view_mutex);
+
+	if (trx_sys->n_purge_views == n_purge_views) {
+		read_view_add(view);
+		added = true;
+	}
+
+	mutex_exit(&trx_sys->view_mutex);
+
+	return(added);
+}
+
+/** Number of times read_view_open_now_low() copies the snapshot without
+trx_sys->mutex before it falls back to copying it under the mutex */
+#define READ_VIEW_SNAPSHOT_MAX_RETRIES	16
+
+/*********************************************************************//**
+Takes a snapshot of the transactions that are active at this point in time.
+The snapshot is copied without acquiring trx_sys->mutex, unless the caller
+owns it or the copy kept being invalidated by concurrent transaction starts
+and commits. The view is not added to the view list.
 @return	own: read view struct */
 static
 read_view_t*
@@ -295,68 +335,81 @@ read_view_open_now_low(
 /*===================*/
 	trx_id_t	cr_trx_id,	/*!< in: trx_id of creating
 					transaction, or 0 used in purge */
+	bool		own_mutex,	/*!< in: true if the caller owns
+					trx_sys->mutex */
 	read_view_t*&	view)		/*!< in,out: pre-allocated view array or
 					NULL if a new one needs to be created */
 {
-	trx_id_t*	descr;
-	ulint		i;
+	bool	locked = own_mutex;
 
-	ut_ad(mutex_own(&trx_sys->mutex));
+	ut_ad(!own_mutex || mutex_own(&trx_sys->mutex));
 
-	view = read_view_create_low(trx_sys->descr_n_used, view);
+	for (ulint n_retries = 0;; n_retries++) {
+		ulint		version;
+		ulint		n_used;
+		const trx_id_t*	descr;
 
-	view->undo_no = 0;
-	view->type = VIEW_NORMAL;
-	view->creator_trx_id = cr_trx_id;
+		if (!locked && n_retries == READ_VIEW_SNAPSHOT_MAX_RETRIES) {
+			/* Writers hold trx_sys->mutex, so that the copy
+			cannot be invalidated any more. */
+			mutex_enter(&trx_sys->mutex);
+			locked = true;
+		}
 
-	/* No future transactions should be visible in the view */
+		version = locked ? 0 : trx_sys_descr_read_begin();
 
-	view->low_limit_no = trx_sys->max_trx_id;
-	view->low_limit_id = view->low_limit_no;
+		if (version & 1) {
+			/* A writer is still changing the snapshot. */
+			continue;
+		}
 
-	descr = trx_find_descriptor(trx_sys->descriptors,
-				    trx_sys->descr_n_used,
-				    cr_trx_id);
-	if (UNIV_LIKELY(descr != NULL)) {
-		ut_ad(trx_sys->descr_n_used > 0);
-		ut_ad(view->n_descr > 0);
+		n_used = trx_sys->descr_n_used;
 
-		view->n_descr--;
+		/* The array may be replaced by a bigger one while we
+		copy it, but never before descr_n_used grows. */
+		os_rmb;
+		descr = trx_sys->descriptors;
 
-		i = descr - trx_sys->descriptors;
-	} else {
-		i = trx_sys->descr_n_used;
-	}
+		view = read_view_create_low(n_used, view);
 
-	if (UNIV_LIKELY(i > 0)) {
-		/* Copy the [0; i-1] range */
-		memcpy(view->descriptors, trx_sys->descriptors,
-		       i * sizeof(trx_id_t));
-	}
+		/* No future transactions should be visible in the view */
 
-	if (UNIV_UNLIKELY(i + 1 < trx_sys->descr_n_used)) {
-		/* Copy the [i+1; descr_n_used-1] range */
-		memcpy(view->descriptors + i,
-		       trx_sys->descriptors + i + 1,
-		       (trx_sys->descr_n_used - i - 1) *
-		       sizeof(trx_id_t));
- 	}
+		view->low_limit_no = trx_sys->max_trx_id;
+		view->low_limit_id = view->low_limit_no;
 
-	/* NOTE that a transaction whose trx number is < trx_sys->max_trx_id can
-	still be active, if it is in the middle of its commit! Note that when a
-	transaction starts, we initialize trx->no to TRX_ID_MAX. */
+		/* NOTE that a transaction whose trx number is <
+		trx_sys->max_trx_id can still be active, if it is in the
+		middle of its commit! Note that when a transaction starts,
+		we initialize trx->no to TRX_ID_MAX. */
 
-	if (UT_LIST_GET_LEN(trx_sys->trx_serial_list) > 0) {
+		if (view->low_limit_no > trx_sys->descr_min_no) {
+			view->low_limit_no = trx_sys->descr_min_no;
+		}
+
+		/* No active transaction should be visible, except
+		cr_trx */
 
-		trx_id_t	trx_no;
+		view->n_descr = 0;
 
-		trx_no = UT_LIST_GET_FIRST(trx_sys->trx_serial_list)->no;
+		for (ulint i = 0; i < n_used; i++) {
+			if (descr[i] != cr_trx_id) {
+				view->descriptors[view->n_descr++] = descr[i];
+			}
+		}
 
-		if (trx_no < view->low_limit_no) {
-			view->low_limit_no = trx_no;
+		if (locked || trx_sys_descr_read_validate(version)) {
+			break;
 		}
 	}
 
+	if (locked && !own_mutex) {
+		mutex_exit(&trx_sys->mutex);
+	}
+
+	view->undo_no = 0;
+	view->type = VIEW_NORMAL;
+	view->creator_trx_id = cr_trx_id;
+
 	if (UNIV_LIKELY(view->n_descr > 0)) {
 		/* The last active transaction has the smallest id: */
 		view->up_limit_id = view->descriptors[0];
@@ -364,11 +417,6 @@ read_view_open_now_low(
 		view->up_limit_id = view->low_limit_id;
 	}
 
-	/* Purge views are not added to the view list. */
-	if (cr_trx_id > 0) {
-		read_view_add(view);
-	}
-
 	return(view);
 }
 
@@ -385,11 +433,15 @@ read_view_open_now(
 	read_view_t*&	view)		/*!< in,out: pre-allocated view array or
 					NULL if a new one needs to be created */
 {
-	mutex_enter(&trx_sys->mutex);
+	ulint	n_purge_views;
 
-	view = read_view_open_now_low(cr_trx_id, view);
+	/* Purge views are not added to the view list. */
+	do {
+		n_purge_views = trx_sys->n_purge_views;
+		os_rmb;
 
-	mutex_exit(&trx_sys->mutex);
+		view = read_view_open_now_low(cr_trx_id, false, view);
+	} while (cr_trx_id > 0 && !read_view_try_add(view, n_purge_views));
 
 	return(view);
 }
@@ -416,14 +468,25 @@ read_view_purge_open(
 	trx_id_t	creator_trx_id;
 	ulint		insert_done	= 0;
 
+	/* trx_sys->view_mutex is below trx_sys->mutex in the latching
+	order. Purge opens a view once per batch, so it simply takes the
+	snapshot under trx_sys->mutex. */
 	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
+
+	/* Views whose snapshot was taken before this point must not be
+	added to the view list any more, see read_view_try_add(). */
+	trx_sys->n_purge_views++;
 
 	oldest_view = UT_LIST_GET_LAST(trx_sys->view_list);
 
 	if (oldest_view == NULL) {
 
-		view = read_view_open_now_low(0, prebuilt_view);
+		view = read_view_open_now_low(0, true, prebuilt_view);
 
+		trx_sys->n_purge_views++;
+
+		mutex_exit(&trx_sys->view_mutex);
 		mutex_exit(&trx_sys->mutex);
 
 		return(view);
@@ -435,6 +498,9 @@ read_view_purge_open(
 
 	ut_ad(read_view_validate(oldest_view));
 
+	trx_sys->n_purge_views++;
+
+	mutex_exit(&trx_sys->view_mutex);
 	mutex_exit(&trx_sys->mutex);
 
 	ut_a(oldest_view->creator_trx_id > 0);
@@ -492,7 +558,7 @@ read_view_close_for_mysql(
 {
 	ut_a(trx->global_read_view);
 
-	read_view_remove(trx->global_read_view, false);
+	read_view_remove(trx->global_read_view);
 
 	trx->read_view = NULL;
 	trx->global_read_view = NULL;
@@ -543,12 +609,12 @@ read_fill_i_s_xtradb_read_view(i_s_xtradb_read_view_t* rv)
 {
 	read_view_t*    view;
 
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	if (UT_LIST_GET_LEN(trx_sys->view_list)) {
 		view = UT_LIST_GET_LAST(trx_sys->view_list);
 	} else {
-		mutex_exit(&trx_sys->mutex);
+		mutex_exit(&trx_sys->view_mutex);
 		return NULL;
 	}
 
@@ -562,7 +628,7 @@ read_fill_i_s_xtradb_read_view(i_s_xtradb_read_view_t* rv)
 	rv->up_limit_id = view->up_limit_id;
 	rv->low_limit_id = view->low_limit_id;
 
-	mutex_exit(&trx_sys->mutex);
+	mutex_exit(&trx_sys->view_mutex);
 
 	return rv;
 }
@@ -606,6 +672,7 @@ read_cursor_view_create_for_mysql(
 {
 	read_view_t*	view;
 	mem_heap_t*	heap;
+	ulint		n_purge_views;
 	cursor_view_t*	curview;
 
 	/* Use larger heap than in trx_create when creating a read_view
@@ -624,16 +691,18 @@ read_cursor_view_create_for_mysql(
 
 	cr_trx->n_mysql_tables_in_use = 0;
 
-	mutex_enter(&trx_sys->mutex);
-
 	curview->read_view = NULL;
-	read_view_open_now_low(UINT64_UNDEFINED, curview->read_view);
 
-	view = curview->read_view;
-	view->undo_no = cr_trx->undo_no;
-	view->type = VIEW_HIGH_GRANULARITY;
+	do {
+		n_purge_views = trx_sys->n_purge_views;
+		os_rmb;
 
-	mutex_exit(&trx_sys->mutex);
+		view = read_view_open_now_low(UINT64_UNDEFINED, false,
+					      curview->read_view);
+
+		view->undo_no = cr_trx->undo_no;
+		view->type = VIEW_HIGH_GRANULARITY;
+	} while (!read_view_try_add(view, n_purge_views));
 
 	return(curview);
 }
@@ -656,7 +725,7 @@ read_cursor_view_close_for_mysql(
 	belong to this transaction */
 	trx->n_mysql_tables_in_use += curview->n_mysql_tables_in_use;
 
-	read_view_remove(curview->read_view, false);
+	read_view_remove(curview->read_view);
 	read_view_free(curview->read_view);
 
 	trx->read_view = trx->global_read_view;
@@ -677,7 +746,7 @@ read_cursor_set_for_mysql(
 {
 	ut_a(trx);
 
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	if (UNIV_LIKELY(curview != NULL)) {
 		trx->read_view = curview->read_view;
@@ -687,5 +756,5 @@ read_cursor_set_for_mysql(
 
 	ut_ad(read_view_validate(trx->read_view));
 
-	mutex_exit(&trx_sys->mutex);
+	mutex_exit(&trx_sys->view_mutex);
 }
@@ -978,8 +978,8 @@ row_ins_foreign_check_on_constraint(
 	/* Since we are going to delete or update a row, we have to invalidate
 	the MySQL query cache for table. A deadlock of threads is not possible
 	here because the caller of this function does not hold any latches with
-	the sync0sync.h rank above the lock_sys_t::mutex. The query cache mutex
-       	has a rank just above the lock_sys_t::mutex. */
+	the sync0sync.h rank above the lock_sys_t::latch. The query cache mutex
+       	has a rank just above the lock_sys_t::latch. */
 
 	row_ins_invalidate_query_cache(thr, table->name);
 
@@ -26,6 +26,7 @@ Completed by Sunny Bains and Marko Makela
 #include <log.h>
 
 #include "row0merge.h"
+#include "btr0bulk.h"
 #include "row0ext.h"
 #include "row0log.h"
 #include "row0ins.h"
@@ -547,7 +548,7 @@ row_merge_dup_report(
 	row_merge_dup_t*	dup,	/*!< in/out: for reporting duplicates */
 	const dfield_t*		entry)	/*!< in: duplicate index entry */
 {
-	if (!dup->n_dup++) {
+	if (!dup->n_dup++ && dup->table) {
 		/* Only report the first duplicate record,
 		but count all duplicate records. */
 		innobase_fields_to_mysql(dup->table, dup->index, entry);
@@ -1842,7 +1843,8 @@ row_merge_read_clustered_index(
 	if (max_doc_id && err == DB_SUCCESS) {
 		/* Sync fts cache for other fts indexes to keep all
 		fts indexes consistent in sync_doc_id. */
-		err = fts_sync_table(const_cast<dict_table_t*>(new_table));
+		err = fts_sync_table(
+			const_cast<dict_table_t*>(new_table), false, true);
 
 		if (err == DB_SUCCESS) {
 			fts_update_next_doc_id(
@@ -1855,6 +1857,598 @@ row_merge_read_clustered_index(
 	DBUG_RETURN(err);
 }
 
+/** Clustered index scan that is split into key ranges, each of which
+is read by its own thread into its own sort buffers. */
+struct row_merge_scan_t {
+	trx_t*			trx;	/*!< transaction */
+	struct TABLE*		table;	/*!< MySQL table object, for
+					reporting erroneous records */
+	const dict_table_t*	old_table;/*!< table where rows are read
+					from and indexes are created */
+	dict_index_t*		clust_index;/*!< clustered index of
+					old_table */
+	bool			online;	/*!< true if creating indexes
+					online */
+	dict_index_t**		index;	/*!< indexes to be created */
+	merge_file_t*		files;	/*!< temporary files */
+	const ulint*		key_numbers;/*!< MySQL key numbers */
+	ulint			n_index;/*!< number of indexes */
+	os_fast_mutex_t		mutex;	/*!< protects the members below
+					and the offsets and record counts
+					of files[] */
+	ulint			n_active;/*!< number of running threads */
+	os_event_t		done;	/*!< set when n_active drops
+					to 0 */
+	dberr_t			err;	/*!< first error of any thread */
+	ulint			error_key_num;/*!< MySQL key number of
+					the index that caused err */
+};
+
+/** Key range of a parallel clustered index scan */
+struct row_merge_scan_range_t {
+	row_merge_scan_t*	scan;	/*!< the scan */
+	const dtuple_t*		start;	/*!< first key of the range,
+					or NULL if it starts at the
+					beginning of the index */
+	const dtuple_t*		end;	/*!< first key after the range,
+					or NULL if it ends at the end
+					of the index */
+	ib_int64_t		read_rows;/*!< number of rows read so far;
+					only for progress reporting */
+};
+
+/*********************************************************************//**
+Splits the clustered index into key ranges of about the same size,
+using the node pointers of the root page as the boundaries.
+@return number of key ranges, at most n_ranges; 1 if the root page is
+a leaf page */
+static __attribute__((nonnull, warn_unused_result))
+ulint
+row_merge_scan_split(
+/*=================*/
+	dict_index_t*	clust_index,	/*!< in: clustered index */
+	ulint		n_ranges,	/*!< in: wanted number of ranges */
+	const dtuple_t**bounds,		/*!< out: n_ranges - 1 boundaries
+					between the ranges, in ascending
+					order */
+	mem_heap_t*	heap)		/*!< in/out: memory heap where
+					the boundaries are allocated */
+{
+	mtr_t		mtr;
+	buf_block_t*	block;
+	page_t*		page;
+	rec_t*		rec;
+	ulint		n_recs;
+	ulint		pos = 0;
+
+	mtr_start(&mtr);
+	mtr_s_lock(dict_index_get_lock(clust_index), &mtr);
+
+	block = btr_block_get(
+		dict_index_get_space(clust_index),
+		dict_table_zip_size(clust_index->table),
+		dict_index_get_page(clust_index),
+		RW_S_LATCH, clust_index, &mtr);
+	page = buf_block_get_frame(block);
+	n_recs = page_get_n_recs(page);
+
+	if (btr_page_get_level(page, &mtr) == 0 || n_recs < 2) {
+		mtr_commit(&mtr);
+		return(1);
+	}
+
+	if (n_ranges > n_recs) {
+		n_ranges = n_recs;
+	}
+
+	rec = page_rec_get_next(page_get_infimum_rec(page));
+
+	for (ulint i = 1; i < n_ranges; i++) {
+		/* The first node pointer carries the minimum record
+		flag, so it is never a boundary. */
+		while (pos < i * n_recs / n_ranges) {
+			rec = page_rec_get_next(rec);
+			pos++;
+		}
+
+		dtuple_t*	tuple = dict_index_build_data_tuple(
+			clust_index, rec,
+			dict_index_get_n_unique_in_tree(clust_index), heap);
+
+		/* Copy the key out of the page before it is released. */
+		for (ulint j = 0; j < dtuple_get_n_fields(tuple); j++) {
+			dfield_dup(dtuple_get_nth_field(tuple, j), heap);
+		}
+
+		bounds[i - 1] = tuple;
+	}
+
+	mtr_commit(&mtr);
+
+	return(n_ranges);
+}
+
+/*********************************************************************//**
+Sorts the buffer of a parallel clustered index scan and appends it to the
+temporary file of its index as a new run.
+@return DB_SUCCESS or error code */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_scan_write(
+/*=================*/
+	row_merge_scan_t*	scan,	/*!< in/out: parallel scan */
+	ulint			i,	/*!< in: number of the index */
+	row_merge_buf_t*	buf,	/*!< in/out: sort buffer */
+	row_merge_block_t*	block)	/*!< out: file buffer */
+{
+	merge_file_t*	file = &scan->files[i];
+	ulint		offset;
+
+	if (dict_index_is_unique(buf->index)) {
+		/* Only count the duplicates, so that several threads
+		do not copy them to table->record[0] at once. */
+		row_merge_dup_t	dup = {buf->index, NULL, NULL, 0};
+
+		row_merge_buf_sort(buf, &dup);
+
+		if (dup.n_dup) {
+			os_fast_mutex_lock(&scan->mutex);
+
+			if (scan->err == DB_SUCCESS) {
+				/* Sort the buffer again to report
+				the first duplicate of the scan. */
+				dup.table = scan->table;
+				dup.n_dup = 0;
+				row_merge_buf_sort(buf, &dup);
+
+				scan->err = DB_DUPLICATE_KEY;
+				scan->error_key_num = scan->key_numbers[i];
+			}
+
+			os_fast_mutex_unlock(&scan->mutex);
+
+			return(DB_DUPLICATE_KEY);
+		}
+	} else {
+		row_merge_buf_sort(buf, NULL);
+	}
+
+	row_merge_buf_write(buf, file, block);
+
+	os_fast_mutex_lock(&scan->mutex);
+	offset = file->offset++;
+	file->n_rec += buf->n_tuples;
+	os_fast_mutex_unlock(&scan->mutex);
+
+	if (!row_merge_write(file->fd, offset, block)) {
+		return(DB_TEMP_FILE_WRITE_FAILURE);
+	}
+
+	UNIV_MEM_INVALID(&block[0], srv_sort_buf_size);
+
+	return(DB_SUCCESS);
+}
+
+/*********************************************************************//**
+Reads one key range of the clustered index and writes the entries of
+the indexes to be created to their temporary files, in runs of sorted
+blocks. This is the loop of row_merge_read_clustered_index() for the
+case where only secondary indexes are created, so that no column has
+to be converted, checked or filled in.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_merge_scan_thread)(
+/*==================================*/
+	void*	arg)	/*!< in/out: key range to read
+			(row_merge_scan_range_t) */
+{
+	row_merge_scan_range_t*	range
+		= static_cast<row_merge_scan_range_t*>(arg);
+	row_merge_scan_t*	scan = range->scan;
+	dict_index_t*		clust_index = scan->clust_index;
+	const ulint		n_index = scan->n_index;
+	row_merge_buf_t**	merge_buf;
+	row_merge_block_t*	block;
+	ulint			block_size = srv_sort_buf_size;
+	mem_heap_t*		row_heap;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+	doc_id_t		doc_id = 0;
+	dberr_t			err = DB_SUCCESS;
+	ulint			error_key_num = 0;
+
+	block = static_cast<row_merge_block_t*>(
+		os_mem_alloc_large(&block_size, FALSE));
+	merge_buf = static_cast<row_merge_buf_t**>(
+		mem_alloc(n_index * sizeof *merge_buf));
+
+	for (ulint i = 0; i < n_index; i++) {
+		merge_buf[i] = row_merge_buf_create(scan->index[i]);
+	}
+
+	row_heap = mem_heap_create(sizeof(mrec_buf_t));
+
+	mtr_start(&mtr);
+
+	if (range->start) {
+		/* Position the cursor on the last record before the
+		range, so that the loop below moves to its first one. */
+		btr_pcur_open(clust_index, range->start, PAGE_CUR_L,
+			      BTR_SEARCH_LEAF, &pcur, &mtr);
+	} else {
+		btr_pcur_open_at_index_side(
+			true, clust_index, BTR_SEARCH_LEAF, &pcur, true, 0,
+			&mtr);
+	}
+
+	for (;;) {
+		const rec_t*	rec;
+		ulint*		offsets;
+		const dtuple_t*	row;
+		row_ext_t*	ext;
+		page_cur_t*	cur	= btr_pcur_get_page_cur(&pcur);
+
+		page_cur_move_to_next(cur);
+
+		if (page_cur_is_after_last(cur)) {
+			if (UNIV_UNLIKELY(trx_is_interrupted(scan->trx))
+			    || scan->err != DB_SUCCESS) {
+				err = DB_INTERRUPTED;
+				break;
+			}
+
+			if (rw_lock_get_waiters(
+				    dict_index_get_lock(clust_index))) {
+				/* Yield to the waiters on the clustered
+				index tree lock, likely the purge thread,
+				as in row_merge_read_clustered_index(). */
+				btr_pcur_move_to_prev_on_page(&pcur);
+				btr_pcur_store_position(&pcur, &mtr);
+				mtr_commit(&mtr);
+
+				os_thread_yield();
+
+				mtr_start(&mtr);
+				btr_pcur_restore_position(
+					BTR_SEARCH_LEAF, &pcur, &mtr);
+
+				if (!btr_pcur_move_to_next_user_rec(
+					    &pcur, &mtr)) {
+					break;
+				}
+			} else {
+				ulint		next_page_no;
+				buf_block_t*	block;
+
+				next_page_no = btr_page_get_next(
+					page_cur_get_page(cur), &mtr);
+
+				if (next_page_no == FIL_NULL) {
+					break;
+				}
+
+				block = page_cur_get_block(cur);
+				block = btr_block_get(
+					buf_block_get_space(block),
+					buf_block_get_zip_size(block),
+					next_page_no, BTR_SEARCH_LEAF,
+					clust_index, &mtr);
+
+				btr_leaf_page_release(page_cur_get_block(cur),
+						      BTR_SEARCH_LEAF, &mtr);
+				page_cur_set_before_first(block, cur);
+				page_cur_move_to_next(cur);
+
+				ut_ad(!page_cur_is_after_last(cur));
+			}
+		}
+
+		rec = page_cur_get_rec(cur);
+
+		SRV_CORRUPT_TABLE_CHECK(rec,
+		{
+			err = DB_CORRUPTION;
+		});
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+
+		offsets = rec_get_offsets(rec, clust_index, NULL,
+					  ULINT_UNDEFINED, &row_heap);
+
+		if (range->end
+		    && cmp_dtuple_rec(range->end, rec, offsets) <= 0) {
+			/* The rest belongs to the next range. */
+			break;
+		}
+
+		if (scan->online) {
+			/* Perform a REPEATABLE READ, for the reasons
+			given in row_merge_read_clustered_index(). */
+			if (!read_view_sees_trx_id(
+				    scan->trx->read_view,
+				    row_get_rec_trx_id(
+					    rec, clust_index, offsets))) {
+				rec_t*	old_vers;
+
+				row_vers_build_for_consistent_read(
+					rec, &mtr, clust_index, &offsets,
+					scan->trx->read_view, &row_heap,
+					row_heap, &old_vers);
+
+				rec = old_vers;
+
+				if (!rec) {
+					mem_heap_empty(row_heap);
+					continue;
+				}
+			}
+		}
+
+		if (rec_get_deleted_flag(
+			    rec, dict_table_is_comp(scan->old_table))) {
+			mem_heap_empty(row_heap);
+			continue;
+		}
+
+		ut_ad(!rec_offs_any_null_extern(rec, offsets));
+
+		row = row_build(ROW_COPY_POINTERS, clust_index,
+				rec, offsets, scan->old_table,
+				NULL, NULL, &ext, row_heap);
+
+		for (ulint i = 0; i < n_index; i++) {
+			row_merge_buf_t*	buf = merge_buf[i];
+
+			if (row_merge_buf_add(buf, NULL, scan->old_table,
+					      NULL, row, ext, &doc_id)) {
+				continue;
+			}
+
+			/* The buffer is full. Write it out and add
+			the entry to the emptied buffer. */
+			ut_ad(buf->n_tuples);
+
+			err = row_merge_scan_write(scan, i, buf, block);
+
+			if (err != DB_SUCCESS) {
+				error_key_num = scan->key_numbers[i];
+				break;
+			}
+
+			merge_buf[i] = buf = row_merge_buf_empty(buf);
+
+			if (!row_merge_buf_add(buf, NULL, scan->old_table,
+					       NULL, row, ext, &doc_id)) {
+				/* An empty buffer should have enough
+				room for at least one record. */
+				ut_error;
+			}
+		}
+
+		if (err != DB_SUCCESS) {
+			break;
+		}
+
+		mem_heap_empty(row_heap);
+		range->read_rows++;
+	}
+
+	mtr_commit(&mtr);
+	btr_pcur_close(&pcur);
+	mem_heap_free(row_heap);
+
+	for (ulint i = 0; i < n_index; i++) {
+		if (err == DB_SUCCESS && merge_buf[i]->n_tuples) {
+			err = row_merge_scan_write(
+				scan, i, merge_buf[i], block);
+
+			if (err != DB_SUCCESS) {
+				error_key_num = scan->key_numbers[i];
+			}
+		}
+
+		row_merge_buf_free(merge_buf[i]);
+	}
+
+	mem_free(merge_buf);
+	os_mem_free_large(block, block_size);
+
+	os_fast_mutex_lock(&scan->mutex);
+
+	if (scan->err == DB_SUCCESS && err != DB_SUCCESS) {
+		scan->err = err;
+		scan->error_key_num = error_key_num;
+	}
+
+	if (--scan->n_active == 0) {
+		os_event_set(scan->done);
+	}
+
+	os_fast_mutex_unlock(&scan->mutex);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/********************************************************************//**
+Reads the clustered index of the table with srv_n_ddl_threads threads,
+each of which reads a key range into its own sort buffers, and creates
+temporary files containing the entries for the secondary indexes to be
+created. Can only be used when old_table == new_table and no FULLTEXT
+index is created.
+@return	DB_SUCCESS or error */
+static __attribute__((nonnull, warn_unused_result))
+dberr_t
+row_merge_read_clustered_index_parallel(
+/*====================================*/
+	trx_t*			trx,	/*!< in: transaction */
+	struct TABLE*		table,	/*!< in/out: MySQL table object,
+					for reporting erroneous records */
+	const dict_table_t*	old_table,/*!< in: table where rows are
+					read from and indexes are created */
+	bool			online,	/*!< in: true if creating indexes
+					online */
+	dict_index_t**		index,	/*!< in: indexes to be created */
+	merge_file_t*		files,	/*!< in: temporary files */
+	const ulint*		key_numbers,
+					/*!< in: MySQL key numbers to create */
+	ulint			n_index,/*!< in: number of indexes to create */
+	float			pct_cost)/*!< in: percent of task weight
+					out of total alter job */
+{
+	row_merge_scan_t	scan;
+	row_merge_scan_range_t*	ranges;
+	const dtuple_t**	bounds;
+	mem_heap_t*		heap;
+	ulint			n_ranges;
+	ib_int64_t		table_total_rows;
+	DBUG_ENTER("row_merge_read_clustered_index_parallel");
+
+	ut_ad(!online || trx->read_view);
+
+	table_total_rows = dict_table_get_n_rows(old_table);
+	if (table_total_rows == 0) {
+		/* We don't know total row count */
+		table_total_rows = 1;
+	}
+
+	trx->op_info = "reading clustered index";
+
+	scan.trx = trx;
+	scan.table = table;
+	scan.old_table = old_table;
+	scan.clust_index = dict_table_get_first_index(old_table);
+	scan.online = online;
+	scan.index = index;
+	scan.files = files;
+	scan.key_numbers = key_numbers;
+	scan.n_index = n_index;
+	scan.err = DB_SUCCESS;
+	scan.error_key_num = 0;
+
+	heap = mem_heap_create(1024);
+	bounds = static_cast<const dtuple_t**>(
+		mem_heap_alloc(heap, srv_n_ddl_threads * sizeof *bounds));
+	n_ranges = row_merge_scan_split(
+		scan.clust_index, srv_n_ddl_threads, bounds, heap);
+	ranges = static_cast<row_merge_scan_range_t*>(
+		mem_heap_alloc(heap, n_ranges * sizeof *ranges));
+
+	sql_print_information("InnoDB: Online DDL : Reading clustered index"
+			      " with %lu threads", n_ranges);
+
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &scan.mutex);
+	scan.done = os_event_create();
+	scan.n_active = n_ranges;
+
+	for (ulint i = 0; i < n_ranges; i++) {
+		ranges[i].scan = &scan;
+		ranges[i].start = i ? bounds[i - 1] : NULL;
+		ranges[i].end = i + 1 < n_ranges ? bounds[i] : NULL;
+		ranges[i].read_rows = 0;
+
+		os_thread_create(row_merge_scan_thread, &ranges[i], NULL);
+	}
+
+	for (;;) {
+		ulint		n_active;
+		ib_int64_t	read_rows = 0;
+
+		os_event_wait_time_low(scan.done, 1000000, 0);
+
+		os_fast_mutex_lock(&scan.mutex);
+		n_active = scan.n_active;
+		os_fast_mutex_unlock(&scan.mutex);
+
+		if (!n_active) {
+			break;
+		}
+
+		/* Update the innodb_onlineddl_pct_progress status
+		variable; the row counts may be slightly stale. */
+		for (ulint i = 0; i < n_ranges; i++) {
+			read_rows += ranges[i].read_rows;
+		}
+
+		onlineddl_pct_progress = (read_rows >= table_total_rows
+					  ? pct_cost
+					  : pct_cost * read_rows
+					  / table_total_rows) * 100;
+	}
+
+	os_event_free(scan.done);
+	os_fast_mutex_free(&scan.mutex);
+	mem_heap_free(heap);
+
+	if (scan.err == DB_SUCCESS) {
+		for (ulint i = 0; i < n_index; i++) {
+			merge_file_t*	file = &files[i];
+
+			if (file->offset == 0) {
+				/* The file must contain at least
+				the end-of-chunk marker of an
+				empty block. */
+				row_merge_buf_t*	buf
+					= row_merge_buf_create(index[i]);
+				row_merge_block_t*	block;
+				ulint			block_size
+					= srv_sort_buf_size;
+
+				block = static_cast<row_merge_block_t*>(
+					os_mem_alloc_large(&block_size, FALSE));
+				row_merge_buf_write(buf, file, block);
+
+				if (!row_merge_write(file->fd, file->offset++,
+						     block)) {
+					scan.err = DB_TEMP_FILE_WRITE_FAILURE;
+					scan.error_key_num = key_numbers[i];
+				}
+
+				os_mem_free_large(block, block_size);
+				row_merge_buf_free(buf);
+
+				if (scan.err != DB_SUCCESS) {
+					break;
+				}
+			}
+
+			if (!online) {
+				continue;
+			}
+
+			/* Note the newest transaction that modified
+			this index when the scan was completed. We
+			prevent older readers from accessing this
+			index, to ensure read consistency. */
+			trx_id_t	max_trx_id;
+
+			rw_lock_x_lock(dict_index_get_lock(index[i]));
+			ut_a(dict_index_get_online_status(index[i])
+			     == ONLINE_INDEX_CREATION);
+
+			max_trx_id = row_log_get_max_trx(index[i]);
+
+			if (max_trx_id > index[i]->trx_id) {
+				index[i]->trx_id = max_trx_id;
+			}
+
+			rw_lock_x_unlock(dict_index_get_lock(index[i]));
+		}
+	}
+
+	if (scan.err != DB_SUCCESS) {
+		trx->error_key_num = scan.error_key_num;
+	}
+
+	trx->op_info = "";
+
+	DBUG_RETURN(scan.err);
+}
+
 /** Write a record via buffer 2 and read the next record to buffer N.
 @param N	number of the buffer (0 or 1)
 @param INDEX	record descriptor
@@ -2213,7 +2807,10 @@ row_merge_sort(
 					*/
 	const bool		update_progress,
 					/*!< in: update progress
-					status variable or not */
+					status variable and report the
+					progress to the client, or not
+					(when not called from the thread
+					of trx->mysql_thd) */
 	const float 		pct_progress,
 					/*!< in: total progress percent
 					until now */
@@ -2256,7 +2853,9 @@ row_merge_sort(
 	of file marker).  Thus, it must be at least one block. */
 	ut_ad(file->offset > 0);
 
-	thd_progress_init(trx->mysql_thd, num_runs);
+	if (update_progress) {
+		thd_progress_init(trx->mysql_thd, num_runs);
+	}
 	sql_print_information("InnoDB: Online DDL : merge-sorting has estimated %lu runs", num_runs);
 
 	/* Merge the runs until we have one big run */
@@ -2265,7 +2864,9 @@ row_merge_sort(
 
 		/* Report progress of merge sort to MySQL for
 		show processlist progress field */
-		thd_progress_report(trx->mysql_thd, cur_run, num_runs);
+		if (update_progress) {
+			thd_progress_report(trx->mysql_thd, cur_run, num_runs);
+		}
 		sql_print_information("InnoDB: Online DDL : merge-sorting current run %lu estimated %lu runs", cur_run, num_runs);
 
 		error = row_merge(trx, dup, file, block, tmpfd,
@@ -2289,11 +2890,207 @@ row_merge_sort(
 
 	mem_free(run_offset);
 
-	thd_progress_end(trx->mysql_thd);
+	if (update_progress) {
+		thd_progress_end(trx->mysql_thd);
+	}
 
 	DBUG_RETURN(error);
 }
 
+/** Merge sort of the temporary files of several indexes, where each
+file is sorted by a single thread. */
+struct row_merge_psort_t {
+	trx_t*			trx;	/*!< transaction */
+	row_merge_dup_t*	dup;	/*!< descriptors of the indexes */
+	merge_file_t*		files;	/*!< temporary files */
+	dberr_t*		errors;	/*!< out: result of each sort */
+	ulint			n_index;/*!< number of indexes */
+	os_fast_mutex_t		mutex;	/*!< protects the members below */
+	bool*			claimed;/*!< whether the file of each
+					index has been claimed by a
+					thread */
+	ulint			n_active;/*!< number of running threads */
+	os_event_t		done;	/*!< set when n_active drops
+					to 0 */
+};
+
+/*********************************************************************//**
+Claims the next index that a thread of a parallel merge sort should sort.
+@return number of the index, or ULINT_UNDEFINED if all have been claimed */
+static __attribute__((nonnull, warn_unused_result))
+ulint
+row_merge_psort_next(
+/*=================*/
+	row_merge_psort_t*	psort,	/*!< in/out: parallel merge sort */
+	bool			unique)	/*!< in: true to claim an index
+					that may report duplicates, false
+					to claim any other index */
+{
+	ulint	i;
+
+	os_fast_mutex_lock(&psort->mutex);
+
+	for (i = 0; i < psort->n_index; i++) {
+		if (!psort->claimed[i]
+		    && dict_index_is_unique(psort->dup[i].index) == unique) {
+			psort->claimed[i] = true;
+			break;
+		}
+	}
+
+	os_fast_mutex_unlock(&psort->mutex);
+
+	return(i < psort->n_index ? i : ULINT_UNDEFINED);
+}
+
+/*********************************************************************//**
+Sorts the temporary files of non-unique indexes until all have been
+claimed, using its own file buffers and temporary file.
+@return a dummy parameter */
+extern "C" UNIV_INTERN
+os_thread_ret_t
+DECLARE_THREAD(row_merge_psort_thread)(
+/*===================================*/
+	void*	arg)	/*!< in/out: parallel merge sort
+			(row_merge_psort_t) */
+{
+	row_merge_psort_t*	psort = static_cast<row_merge_psort_t*>(arg);
+	ulint			block_size = 3 * srv_sort_buf_size;
+	row_merge_block_t*	block;
+	int			tmpfd;
+	ulint			i;
+
+	block = static_cast<row_merge_block_t*>(
+		os_mem_alloc_large(&block_size, FALSE));
+	tmpfd = row_merge_file_create_low();
+
+	while ((i = row_merge_psort_next(psort, false))
+	       != ULINT_UNDEFINED) {
+		if (!block || tmpfd < 0) {
+			psort->errors[i] = DB_OUT_OF_MEMORY;
+			continue;
+		}
+
+		psort->errors[i] = row_merge_sort(
+			psort->trx, &psort->dup[i], &psort->files[i],
+			block, &tmpfd, false, 0, 0);
+	}
+
+	row_merge_file_destroy_low(tmpfd);
+
+	if (block) {
+		os_mem_free_large(block, block_size);
+	}
+
+	os_fast_mutex_lock(&psort->mutex);
+
+	if (--psort->n_active == 0) {
+		os_event_set(psort->done);
+	}
+
+	os_fast_mutex_unlock(&psort->mutex);
+
+	os_thread_exit(NULL);
+
+	OS_THREAD_DUMMY_RETURN;
+}
+
+/*********************************************************************//**
+Merge sorts the temporary files of all indexes except FULLTEXT ones with
+srv_n_ddl_threads threads. Each file is sorted by a single thread. Only
+the calling thread sorts the files of unique indexes, because a duplicate
+key is reported to the MySQL table object and one thread at a time may
+do that; the calling thread then helps the other threads. Only the
+calling thread runs in trx->mysql_thd, so it alone reports the progress
+of the sorts it does. */
+static __attribute__((nonnull))
+void
+row_merge_sort_parallel(
+/*====================*/
+	trx_t*			trx,	/*!< in: transaction */
+	row_merge_dup_t*	dup,	/*!< in: descriptors of the indexes */
+	merge_file_t*		files,	/*!< in/out: temporary files */
+	ulint			n_index,/*!< in: number of indexes */
+	row_merge_block_t*	block,	/*!< in/out: 3 buffers */
+	int*			tmpfd,	/*!< in/out: temporary file handle */
+	float			pct_progress,
+					/*!< in: total progress percent
+					until now */
+	const float*		pct_cost,
+					/*!< in: progress percent of
+					sorting each index */
+	dberr_t*		errors)	/*!< out: result of each sort */
+{
+	row_merge_psort_t	psort;
+	ulint			n_threads = 0;
+	ulint			n_sorted = 0;
+	ulint			i;
+	DBUG_ENTER("row_merge_sort_parallel");
+
+	psort.claimed = static_cast<bool*>(
+		mem_alloc(n_index * sizeof *psort.claimed));
+
+	for (i = 0; i < n_index; i++) {
+		errors[i] = DB_SUCCESS;
+		psort.claimed[i] = !!(dup[i].index->type & DICT_FTS);
+
+		if (!psort.claimed[i]) {
+			n_sorted++;
+			n_threads += !dict_index_is_unique(dup[i].index);
+		}
+	}
+
+	/* The calling thread is one of the srv_n_ddl_threads. */
+	if (n_threads > srv_n_ddl_threads - 1) {
+		n_threads = srv_n_ddl_threads - 1;
+	}
+
+	sql_print_information("InnoDB: Online DDL : Start merge-sorting"
+			      " %lu indexes with %lu threads",
+			      n_sorted, n_threads + 1);
+
+	psort.trx = trx;
+	psort.dup = dup;
+	psort.files = files;
+	psort.errors = errors;
+	psort.n_index = n_index;
+	psort.n_active = n_threads;
+
+	os_fast_mutex_init(PFS_NOT_INSTRUMENTED, &psort.mutex);
+	psort.done = os_event_create();
+
+	for (i = 0; i < n_threads; i++) {
+		os_thread_create(row_merge_psort_thread, &psort, NULL);
+	}
+
+	while ((i = row_merge_psort_next(&psort, true)) != ULINT_UNDEFINED) {
+		errors[i] = row_merge_sort(trx, &dup[i], &files[i],
+					   block, tmpfd, true,
+					   pct_progress, pct_cost[i]);
+		pct_progress += pct_cost[i];
+	}
+
+	while ((i = row_merge_psort_next(&psort, false)) != ULINT_UNDEFINED) {
+		errors[i] = row_merge_sort(trx, &dup[i], &files[i],
+					   block, tmpfd, true,
+					   pct_progress, pct_cost[i]);
+		pct_progress += pct_cost[i];
+	}
+
+	if (n_threads) {
+		os_event_wait(psort.done);
+	}
+
+	os_event_free(psort.done);
+	os_fast_mutex_free(&psort.mutex);
+	mem_free(psort.claimed);
+
+	sql_print_information("InnoDB: Online DDL : End of merge-sorting"
+			      " %lu indexes", n_sorted);
+
+	DBUG_VOID_RETURN;
+}
+
 /*************************************************************//**
 Copy externally stored columns to the data tuple. */
 static __attribute__((nonnull))
@@ -2364,6 +3161,7 @@ row_merge_insert_index_tuples(
 	mrec_buf_t*		buf;
 	ib_int64_t		inserted_rows = 0;
 	float			curr_progress;
+	btr_bulk_t*		bulk;
 	DBUG_ENTER("row_merge_insert_index_tuples");
 
 	ut_ad(!srv_read_only_mode);
@@ -2372,6 +3170,10 @@ row_merge_insert_index_tuples(
 
 	tuple_heap = mem_heap_create(1000);
 
+	/* Build the index bottom-up unless it is compressed, in which
+	case the entries are inserted one by one. */
+	bulk = btr_bulk_create(index, trx_id);
+
 	{
 		ulint i	= 1 + REC_OFFS_HEADER_SIZE
 			+ dict_index_get_n_fields(index);
@@ -2399,6 +3201,7 @@ row_merge_insert_index_tuples(
 			rec_t*		rec;
 			btr_cur_t	cursor;
 			mtr_t		mtr;
+			ulint*		ins_offsets;
 
 			b = row_merge_read_rec(block, buf, b, index,
 					       fd, &foffs, &mrec, offsets);
@@ -2454,6 +3257,27 @@ row_merge_insert_index_tuples(
 			}
 
 			ut_ad(dtuple_validate(dtuple));
+
+			if (bulk) {
+				error = btr_bulk_insert(bulk, dtuple);
+
+				if (error == DB_SUCCESS) {
+					goto inserted;
+				} else if (error != DB_FAIL) {
+					goto err_exit;
+				}
+
+				/* The bulk loader does not store columns
+				off-page. Complete the tree and insert this
+				and the remaining entries one by one. */
+				error = btr_bulk_finish(bulk, DB_SUCCESS);
+				bulk = NULL;
+
+				if (error != DB_SUCCESS) {
+					goto err_exit;
+				}
+			}
+
 			log_free_check();
 
 			mtr_start(&mtr);
@@ -2478,7 +3302,7 @@ row_merge_insert_index_tuples(
 				      > 0);
 			}
 #endif /* UNIV_DEBUG */
-			ulint*	ins_offsets = NULL;
+			ins_offsets = NULL;
 
 			error = btr_cur_optimistic_insert(
 				BTR_NO_UNDO_LOG_FLAG | BTR_NO_LOCKING_FLAG
@@ -2537,7 +3361,7 @@ row_merge_insert_index_tuples(
 			if (error != DB_SUCCESS) {
 				goto err_exit;
 			}
-
+inserted:
 			mem_heap_empty(tuple_heap);
 			mem_heap_empty(ins_heap);
 
@@ -2557,6 +3381,10 @@ row_merge_insert_index_tuples(
 	}
 
 err_exit:
+	if (bulk) {
+		error = btr_bulk_finish(bulk, error);
+	}
+
 	mem_heap_free(tuple_heap);
 	mem_heap_free(ins_heap);
 	mem_heap_free(heap);
@@ -3548,6 +4376,9 @@ row_merge_build_indexes(
 	fts_psort_t*		merge_info = NULL;
 	ib_int64_t		sig_count = 0;
 	bool			fts_psort_initiated = false;
+	row_merge_dup_t*	sort_dup = NULL;
+	dberr_t*		sort_errors = NULL;
+	float*			sort_pct_cost = NULL;
 
 	float total_static_cost = 0;
 	float total_dynamic_cost = 0;
@@ -3641,11 +4472,20 @@ row_merge_build_indexes(
 	/* Read clustered index of the table and create files for
 	secondary index entries for merge sort */
 
-	error = row_merge_read_clustered_index(
-		trx, table, old_table, new_table, online, indexes,
-		fts_sort_idx, psort_info, merge_files, key_numbers,
-		n_indexes, add_cols, col_map,
-		add_autoinc, sequence, block, pct_cost);
+	if (srv_n_ddl_threads > 1 && old_table == new_table
+	    && !fts_sort_idx) {
+		/* Only secondary indexes are created: split the
+		scan into key ranges that are read in parallel. */
+		error = row_merge_read_clustered_index_parallel(
+			trx, table, old_table, online, indexes,
+			merge_files, key_numbers, n_indexes, pct_cost);
+	} else {
+		error = row_merge_read_clustered_index(
+			trx, table, old_table, new_table, online, indexes,
+			fts_sort_idx, psort_info, merge_files, key_numbers,
+			n_indexes, add_cols, col_map,
+			add_autoinc, sequence, block, pct_cost);
+	}
 
 	pct_progress += pct_cost;
 
@@ -3665,6 +4505,46 @@ row_merge_build_indexes(
 	/* Now we have files containing index entries ready for
 	sorting and inserting. */
 
+	for (i = j = 0; i < n_indexes; i++) {
+		j += !(indexes[i]->type & DICT_FTS);
+	}
+
+	if (srv_n_ddl_threads > 1 && j > 1) {
+		/* Sort the files of several indexes at once before
+		inserting the entries of each index in turn. */
+		sort_dup = static_cast<row_merge_dup_t*>(
+			mem_alloc(n_indexes * sizeof *sort_dup));
+		sort_errors = static_cast<dberr_t*>(
+			mem_alloc(n_indexes * sizeof *sort_errors));
+		sort_pct_cost = static_cast<float*>(
+			mem_alloc(n_indexes * sizeof *sort_pct_cost));
+
+		for (i = 0; i < n_indexes; i++) {
+			row_merge_dup_t	dup = {
+				indexes[i], table, col_map, 0};
+
+			sort_dup[i] = dup;
+			sort_pct_cost[i] = (indexes[i]->type & DICT_FTS)
+				? 0
+				: (COST_BUILD_INDEX_STATIC +
+				   (total_dynamic_cost * merge_files[i].offset /
+				    total_index_blocks)) /
+				(total_static_cost + total_dynamic_cost)
+				* PCT_COST_MERGESORT_INDEX * 100;
+		}
+
+		row_merge_sort_parallel(trx, sort_dup, merge_files,
+					n_indexes, block, &tmpfd,
+					pct_progress, sort_pct_cost,
+					sort_errors);
+
+		/* The sorts are done; only the inserts remain to be
+		counted below. */
+		for (i = 0; i < n_indexes; i++) {
+			pct_progress += sort_pct_cost[i];
+		}
+	}
+
 	for (i = 0; i < n_indexes; i++) {
 		dict_index_t*	sort_idx = indexes[i];
 
@@ -3748,11 +4628,14 @@ row_merge_build_indexes(
 				" index %s (%lu / %lu), estimated cost : %2.4f",
 				indexes[i]->name, (i+1), n_indexes, pct_cost);
 
-			error = row_merge_sort(
-				trx, &dup, &merge_files[i],
-				block, &tmpfd, true, pct_progress, pct_cost);
-
-			pct_progress += pct_cost;
+			if (sort_errors) {
+				error = sort_errors[i];
+			} else {
+				error = row_merge_sort(
+					trx, &dup, &merge_files[i], block,
+					&tmpfd, true, pct_progress, pct_cost);
+				pct_progress += pct_cost;
+			}
 
 			sql_print_information("InnoDB: Online DDL : End of "
 				" merge-sorting index %s (%lu / %lu)",
@@ -3844,6 +4727,12 @@ row_merge_build_indexes(
 		dict_mem_index_free(fts_sort_idx);
 	}
 
+	if (sort_dup) {
+		mem_free(sort_dup);
+		mem_free(sort_errors);
+		mem_free(sort_pct_cost);
+	}
+
 	mem_free(merge_files);
 	os_mem_free_large(block, block_size);
 
@@ -847,6 +847,8 @@ row_create_prebuilt(
 
 	prebuilt->mysql_row_len = mysql_row_len;
 
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+
 	return(prebuilt);
 }
 
@@ -859,8 +861,6 @@ row_prebuilt_free(
 	row_prebuilt_t*	prebuilt,	/*!< in, own: prebuilt struct */
 	ibool		dict_locked)	/*!< in: TRUE=data dictionary locked */
 {
-	ulint	i;
-
 	if (UNIV_UNLIKELY
 	    (prebuilt->magic_n != ROW_PREBUILT_ALLOCATED
 	     || prebuilt->magic_n2 != ROW_PREBUILT_ALLOCATED)) {
@@ -909,38 +909,7 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 
-	if (prebuilt->fetch_cache[0] != NULL) {
-		byte*	base = prebuilt->fetch_cache[0] - 4;
-		byte*	ptr = base;
-
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			byte*	row;
-			ulint	magic1;
-			ulint	magic2;
-
-			magic1 = mach_read_from_4(ptr);
-			ptr += 4;
-
-			row = ptr;
-			ptr += prebuilt->mysql_row_len;
-
-			magic2 = mach_read_from_4(ptr);
-			ptr += 4;
-
-			if (ROW_PREBUILT_FETCH_MAGIC_N != magic1
-			    || row != prebuilt->fetch_cache[i]
-			    || ROW_PREBUILT_FETCH_MAGIC_N != magic2) {
-
-				fputs("InnoDB: Error: trying to free"
-					" a corrupt fetch buffer.\n", stderr);
-
-				mem_analyze_corruption(base);
-				ut_error;
-			}
-		}
-
-		mem_free(base);
-	}
+	row_sel_prefetch_cache_free(prebuilt);
 
 	dict_table_close(prebuilt->table, dict_locked, TRUE);
 
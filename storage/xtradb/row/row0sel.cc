@@ -3396,23 +3396,118 @@ row_sel_dequeue_cached_row_for_mysql(
 	}
 }
 
+/*********************************************************************//**
+Frees the cache of prefetched rows of a table handle. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_free(
+/*========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	ulint	i;
+	byte*	base;
+	byte*	ptr;
+
+	if (prebuilt->fetch_cache == NULL) {
+		return;
+	}
+
+	base = prebuilt->fetch_cache[0] - 4;
+	ptr = base;
+
+	for (i = 0; i < prebuilt->fetch_cache_size; i++) {
+		byte*	row;
+		ulint	magic1;
+		ulint	magic2;
+
+		magic1 = mach_read_from_4(ptr);
+		ptr += 4;
+
+		row = ptr;
+		ptr += prebuilt->mysql_row_len;
+
+		magic2 = mach_read_from_4(ptr);
+		ptr += 4;
+
+		if (ROW_PREBUILT_FETCH_MAGIC_N != magic1
+		    || row != prebuilt->fetch_cache[i]
+		    || ROW_PREBUILT_FETCH_MAGIC_N != magic2) {
+
+			fputs("InnoDB: Error: trying to free"
+				" a corrupt fetch buffer.\n", stderr);
+
+			mem_analyze_corruption(base);
+			ut_error;
+		}
+	}
+
+	mem_free(base);
+	mem_free(prebuilt->fetch_cache);
+
+	prebuilt->fetch_cache = NULL;
+	prebuilt->fetch_cache_size = 0;
+}
+
+/*********************************************************************//**
+Frees the cache of prefetched rows of a table handle if it has grown beyond
+MYSQL_FETCH_CACHE_SIZE rows and holds no rows, so that an idle handle does
+not keep up to srv_prefetch_cache_size bytes. The next scan allocates the
+initial cache again. */
+UNIV_INTERN
+void
+row_sel_prefetch_cache_shrink(
+/*==========================*/
+	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+{
+	if (prebuilt->n_fetch_cached == 0
+	    && prebuilt->fetch_cache_size > MYSQL_FETCH_CACHE_SIZE) {
+
+		row_sel_prefetch_cache_free(prebuilt);
+	}
+}
+
+/********************************************************************//**
+Gets the number of rows that fit in srv_prefetch_cache_size bytes of the
+prefetch cache, but at least MYSQL_FETCH_CACHE_SIZE.
+@return maximum number of rows in the prefetch cache */
+UNIV_INLINE
+ulint
+row_sel_prefetch_cache_max(
+/*=======================*/
+	const row_prebuilt_t*	prebuilt)	/*!< in: prebuilt struct */
+{
+	ulint	n_rows = srv_prefetch_cache_size
+		/ (prebuilt->mysql_row_len + 8);
+
+	return(ut_max(n_rows, MYSQL_FETCH_CACHE_SIZE));
+}
+
 /********************************************************************//**
 Initialise the prefetch cache. */
 UNIV_INLINE
 void
 row_sel_prefetch_cache_init(
 /*========================*/
-	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	ulint		n_rows)		/*!< in: number of rows to allocate */
 {
 	ulint	i;
 	ulint	sz;
 	byte*	ptr;
 
+	ut_ad(prebuilt->n_fetch_cached == 0);
+
+	row_sel_prefetch_cache_free(prebuilt);
+
+	prebuilt->fetch_cache = static_cast<byte**>(
+		mem_alloc(n_rows * sizeof *prebuilt->fetch_cache));
+	prebuilt->fetch_cache_size = n_rows;
+
 	/* Reserve space for the magic number. */
-	sz = UT_ARR_SIZE(prebuilt->fetch_cache) * (prebuilt->mysql_row_len + 8);
+	sz = n_rows * (prebuilt->mysql_row_len + 8);
 	ptr = static_cast<byte*>(mem_alloc(sz));
 
-	for (i = 0; i < UT_ARR_SIZE(prebuilt->fetch_cache); i++) {
+	for (i = 0; i < n_rows; i++) {
 
 		/* A user has reported memory corruption in these
 		buffers in Linux. Put magic numbers there to help
@@ -3439,15 +3534,23 @@ row_sel_fetch_last_buf(
 	row_prebuilt_t*	prebuilt)	/*!< in/out: prebuilt struct */
 {
 	ut_ad(!prebuilt->templ_contains_blob);
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
 
-	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+	if (prebuilt->fetch_cache_size < prebuilt->fetch_cache_limit) {
+		/* Allocate memory for the fetch cache. Once the scan
+		has filled the initial cache, allocate all the rows that
+		srv_prefetch_cache_size allows, so that the cache can be
+		filled up to the end of a page. */
 		ut_ad(prebuilt->n_fetch_cached == 0);
 
-		row_sel_prefetch_cache_init(prebuilt);
+		row_sel_prefetch_cache_init(
+			prebuilt,
+			prebuilt->fetch_cache_limit > MYSQL_FETCH_CACHE_SIZE
+			? ut_max(row_sel_prefetch_cache_max(prebuilt),
+				 prebuilt->fetch_cache_limit)
+			: MYSQL_FETCH_CACHE_SIZE);
 	}
 
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_size);
 	ut_ad(prebuilt->fetch_cache_first == 0);
 	UNIV_MEM_INVALID(prebuilt->fetch_cache[prebuilt->n_fetch_cached],
 			 prebuilt->mysql_row_len);
@@ -3473,7 +3576,47 @@ row_sel_enqueue_cache_row_for_mysql(
 		ut_memcpy(dest, mysql_rec, prebuilt->mysql_row_len);
 	}
 
-	++prebuilt->n_fetch_cached;
+	if (prebuilt->n_fetch_cached++ == 0) {
+		srv_stats.n_prefetch_cache_refills.inc();
+	}
+}
+
+/********************************************************************//**
+Checks if more rows should be fetched into the prefetch cache before
+returning to MySQL. The cache is filled up to fetch_cache_limit rows, and
+then up to the end of the current page while there is room, so that the
+next refill does not have to restore the cursor on the same page.
+Doubles fetch_cache_limit when the cache is full.
+@return TRUE if more rows should be fetched */
+UNIV_INLINE
+ibool
+row_sel_prefetch_cache_wants_more(
+/*==============================*/
+	row_prebuilt_t*	prebuilt,	/*!< in/out: prebuilt struct */
+	const rec_t*	rec,		/*!< in: record that the cursor
+					is positioned on */
+	ibool		moves_up)	/*!< in: TRUE if the cursor moves
+					up in the index */
+{
+	if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit) {
+
+		return(TRUE);
+	}
+
+	if (prebuilt->n_fetch_cached < prebuilt->fetch_cache_size
+	    && (moves_up
+		? !page_rec_is_supremum(page_rec_get_next_const(rec))
+		: !page_rec_is_infimum(page_rec_get_prev_const(rec)))) {
+
+		return(TRUE);
+	}
+
+	/* The scan goes on: cache more rows in the next refill. */
+	prebuilt->fetch_cache_limit = ut_min(
+		2 * prebuilt->fetch_cache_limit,
+		row_sel_prefetch_cache_max(prebuilt));
+
+	return(FALSE);
 }
 
 /*********************************************************************//**
@@ -3796,6 +3939,8 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+		row_sel_prefetch_cache_shrink(prebuilt);
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -3820,6 +3965,8 @@ row_search_for_mysql(
 			prebuilt->n_rows_fetched = 0;
 			prebuilt->n_fetch_cached = 0;
 			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_SIZE;
+			row_sel_prefetch_cache_shrink(prebuilt);
 
 		} else if (UNIV_LIKELY(prebuilt->n_fetch_cached > 0)) {
 			row_sel_dequeue_cached_row_for_mysql(buf, prebuilt);
@@ -4916,7 +5063,9 @@ row_search_for_mysql(
 		not cache rows because there the cursor is a scrollable
 		cursor. */
 
-		ut_a(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+		ut_a(prebuilt->n_fetch_cached
+		     < ut_max(prebuilt->fetch_cache_limit,
+			      prebuilt->fetch_cache_size));
 
 		/* We only convert from InnoDB row format to MySQL row
 		format when ICP is disabled. */
@@ -4969,7 +5118,8 @@ row_search_for_mysql(
 			row_sel_enqueue_cache_row_for_mysql(buf, prebuilt);
 		}
 
-		if (prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE) {
+		if (row_sel_prefetch_cache_wants_more(prebuilt, rec,
+						      moves_up)) {
 			goto next_rec;
 		}
 
@@ -5241,6 +5391,11 @@ row_search_for_mysql(
 		mem_heap_free(heap);
 	}
 
+	if (err == DB_RECORD_NOT_FOUND || err == DB_END_OF_INDEX) {
+		/* The scan ended */
+		row_sel_prefetch_cache_shrink(prebuilt);
+	}
+
 	/* Set or reset the "did semi-consistent read" flag on return.
 	The flag did_semi_consistent_read is set if and only if
 	the record being returned was fetched with a semi-consistent read. */
@@ -1152,6 +1152,12 @@ row_undo_mod(
 		err = row_undo_mod_clust(node, thr);
 	}
 
+	if (err == DB_SUCCESS && trx_undo_rec_needs_purge(node->undo_rec)) {
+		/* The record was counted in the purge lag of the table
+		when it was written, but it will not be purged. */
+		os_atomic_decrement_lint(&node->table->n_purge_lag, 1);
+	}
+
 	dict_table_close(node->table, dict_locked, FALSE);
 
 	node->table = NULL;
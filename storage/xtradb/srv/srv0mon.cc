@@ -1066,6 +1066,84 @@ static monitor_info_t	innodb_counter_info[] =
 	 MONITOR_NONE,
 	 MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+#define MONITOR_AHI_PART(n)						\
+	{"adaptive_hash_searches_partition_" #n, "adaptive_hash_index",	\
+	 "Number of successful searches using Adaptive Hash Index"	\
+	 " partition " #n,						\
+	 MONITOR_EXISTING,						\
+	 MONITOR_DEFAULT_START,						\
+	 static_cast<monitor_id_t>(					\
+	 MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART + n)}
+
+#define MONITOR_AHI_BTREE_PART(n)					\
+	{"adaptive_hash_searches_btree_partition_" #n,			\
+	 "adaptive_hash_index",						\
+	 "Number of searches using B-tree on an index of Adaptive Hash"	\
+	 " Index partition " #n,					\
+	 MONITOR_EXISTING,						\
+	 MONITOR_DEFAULT_START,						\
+	 static_cast<monitor_id_t>(					\
+	 MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART + n)}
+
+	MONITOR_AHI_PART(0), MONITOR_AHI_PART(1), MONITOR_AHI_PART(2),
+	MONITOR_AHI_PART(3), MONITOR_AHI_PART(4), MONITOR_AHI_PART(5),
+	MONITOR_AHI_PART(6), MONITOR_AHI_PART(7), MONITOR_AHI_PART(8),
+	MONITOR_AHI_PART(9), MONITOR_AHI_PART(10), MONITOR_AHI_PART(11),
+	MONITOR_AHI_PART(12), MONITOR_AHI_PART(13), MONITOR_AHI_PART(14),
+	MONITOR_AHI_PART(15), MONITOR_AHI_PART(16), MONITOR_AHI_PART(17),
+	MONITOR_AHI_PART(18), MONITOR_AHI_PART(19), MONITOR_AHI_PART(20),
+	MONITOR_AHI_PART(21), MONITOR_AHI_PART(22), MONITOR_AHI_PART(23),
+	MONITOR_AHI_PART(24), MONITOR_AHI_PART(25), MONITOR_AHI_PART(26),
+	MONITOR_AHI_PART(27), MONITOR_AHI_PART(28), MONITOR_AHI_PART(29),
+	MONITOR_AHI_PART(30), MONITOR_AHI_PART(31), MONITOR_AHI_PART(32),
+	MONITOR_AHI_PART(33), MONITOR_AHI_PART(34), MONITOR_AHI_PART(35),
+	MONITOR_AHI_PART(36), MONITOR_AHI_PART(37), MONITOR_AHI_PART(38),
+	MONITOR_AHI_PART(39), MONITOR_AHI_PART(40), MONITOR_AHI_PART(41),
+	MONITOR_AHI_PART(42), MONITOR_AHI_PART(43), MONITOR_AHI_PART(44),
+	MONITOR_AHI_PART(45), MONITOR_AHI_PART(46), MONITOR_AHI_PART(47),
+	MONITOR_AHI_PART(48), MONITOR_AHI_PART(49), MONITOR_AHI_PART(50),
+	MONITOR_AHI_PART(51), MONITOR_AHI_PART(52), MONITOR_AHI_PART(53),
+	MONITOR_AHI_PART(54), MONITOR_AHI_PART(55), MONITOR_AHI_PART(56),
+	MONITOR_AHI_PART(57), MONITOR_AHI_PART(58), MONITOR_AHI_PART(59),
+	MONITOR_AHI_PART(60), MONITOR_AHI_PART(61), MONITOR_AHI_PART(62),
+	MONITOR_AHI_PART(63),
+
+	MONITOR_AHI_BTREE_PART(0), MONITOR_AHI_BTREE_PART(1),
+	MONITOR_AHI_BTREE_PART(2), MONITOR_AHI_BTREE_PART(3),
+	MONITOR_AHI_BTREE_PART(4), MONITOR_AHI_BTREE_PART(5),
+	MONITOR_AHI_BTREE_PART(6), MONITOR_AHI_BTREE_PART(7),
+	MONITOR_AHI_BTREE_PART(8), MONITOR_AHI_BTREE_PART(9),
+	MONITOR_AHI_BTREE_PART(10), MONITOR_AHI_BTREE_PART(11),
+	MONITOR_AHI_BTREE_PART(12), MONITOR_AHI_BTREE_PART(13),
+	MONITOR_AHI_BTREE_PART(14), MONITOR_AHI_BTREE_PART(15),
+	MONITOR_AHI_BTREE_PART(16), MONITOR_AHI_BTREE_PART(17),
+	MONITOR_AHI_BTREE_PART(18), MONITOR_AHI_BTREE_PART(19),
+	MONITOR_AHI_BTREE_PART(20), MONITOR_AHI_BTREE_PART(21),
+	MONITOR_AHI_BTREE_PART(22), MONITOR_AHI_BTREE_PART(23),
+	MONITOR_AHI_BTREE_PART(24), MONITOR_AHI_BTREE_PART(25),
+	MONITOR_AHI_BTREE_PART(26), MONITOR_AHI_BTREE_PART(27),
+	MONITOR_AHI_BTREE_PART(28), MONITOR_AHI_BTREE_PART(29),
+	MONITOR_AHI_BTREE_PART(30), MONITOR_AHI_BTREE_PART(31),
+	MONITOR_AHI_BTREE_PART(32), MONITOR_AHI_BTREE_PART(33),
+	MONITOR_AHI_BTREE_PART(34), MONITOR_AHI_BTREE_PART(35),
+	MONITOR_AHI_BTREE_PART(36), MONITOR_AHI_BTREE_PART(37),
+	MONITOR_AHI_BTREE_PART(38), MONITOR_AHI_BTREE_PART(39),
+	MONITOR_AHI_BTREE_PART(40), MONITOR_AHI_BTREE_PART(41),
+	MONITOR_AHI_BTREE_PART(42), MONITOR_AHI_BTREE_PART(43),
+	MONITOR_AHI_BTREE_PART(44), MONITOR_AHI_BTREE_PART(45),
+	MONITOR_AHI_BTREE_PART(46), MONITOR_AHI_BTREE_PART(47),
+	MONITOR_AHI_BTREE_PART(48), MONITOR_AHI_BTREE_PART(49),
+	MONITOR_AHI_BTREE_PART(50), MONITOR_AHI_BTREE_PART(51),
+	MONITOR_AHI_BTREE_PART(52), MONITOR_AHI_BTREE_PART(53),
+	MONITOR_AHI_BTREE_PART(54), MONITOR_AHI_BTREE_PART(55),
+	MONITOR_AHI_BTREE_PART(56), MONITOR_AHI_BTREE_PART(57),
+	MONITOR_AHI_BTREE_PART(58), MONITOR_AHI_BTREE_PART(59),
+	MONITOR_AHI_BTREE_PART(60), MONITOR_AHI_BTREE_PART(61),
+	MONITOR_AHI_BTREE_PART(62), MONITOR_AHI_BTREE_PART(63),
+
+#undef MONITOR_AHI_PART
+#undef MONITOR_AHI_BTREE_PART
+
 	/* ========== Counters for tablespace ========== */
 	{"module_file", "file_system", "Tablespace and File System Manager",
 	 MONITOR_MODULE,
@@ -2000,6 +2078,24 @@ srv_mon_process_existing_counter(
 		break;
 
 	default:
+		if (monitor_id >= MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART
+		    && monitor_id <= MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART_LAST) {
+			value = btr_cur_part_stats[
+				monitor_id
+				- MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_PART].n_sea;
+			break;
+		}
+
+		if (monitor_id >= MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART
+		    && monitor_id
+		    <= MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART_LAST) {
+			value = btr_cur_part_stats[
+				monitor_id
+				- MONITOR_OVLD_ADAPTIVE_HASH_SEARCH_BTREE_PART]
+				.n_non_sea;
+			break;
+		}
+
 		ut_error;
 	}
 
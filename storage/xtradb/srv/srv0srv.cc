@@ -56,6 +56,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "lock0lock.h"
 #include "trx0purge.h"
 #include "ibuf0ibuf.h"
+#include "buf0dump.h"
 #include "buf0flu.h"
 #include "buf0lru.h"
 #include "btr0sea.h"
@@ -72,6 +73,7 @@ Created 10/8/1995 Heikki Tuuri
 #include "ut0crc32.h"
 #include "os0file.h"
 #include "btr0defragment.h"
+#include "fts0fts.h"
 #include "mysql/plugin.h"
 #include "mysql/service_thd_wait.h"
 #include "fil0pagecompress.h"
@@ -161,8 +163,16 @@ UNIV_INTERN ulint	srv_max_file_format_at_startup = UNIV_FORMAT_MAX;
 /** Place locks to records only i.e. do not use next-key locking except
 on duplicate key checking and foreign key checking */
 UNIV_INTERN ibool	srv_locks_unsafe_for_binlog = FALSE;
+/** Maximum size in bytes of the cache of prefetched rows of a table
+handle in a range scan */
+UNIV_INTERN ulong	srv_prefetch_cache_size = 65536;
 /** Sort buffer size in index creation */
 UNIV_INTERN ulong	srv_sort_buf_size = 1048576;
+/** Number of threads that scan and sort in index creation */
+UNIV_INTERN ulong	srv_n_ddl_threads = 1;
+/** Percentage of the space on an index page that is filled when an
+index is built from sorted entries */
+UNIV_INTERN ulong	srv_fill_factor = 100;
 /** Maximum modification log file size for online index creation */
 UNIV_INTERN unsigned long long	srv_online_max_size;
 
@@ -237,6 +247,7 @@ UNIV_INTERN ibool	srv_created_new_raw	= FALSE;
 UNIV_INTERN char*	srv_log_group_home_dir	= NULL;
 
 UNIV_INTERN ulong	srv_n_log_files		= SRV_N_LOG_FILES_MAX;
+UNIV_INTERN ulong	srv_n_log_apply_threads	= 1;
 /* size in database pages */
 UNIV_INTERN ib_uint64_t	srv_log_file_size	= IB_UINT64_MAX;
 UNIV_INTERN ib_uint64_t	srv_log_file_size_requested;
@@ -521,6 +532,11 @@ batch flushing i.e.: LRU flushing and flush_list flushing. The rest
 of the pages are used for single page flushing. */
 UNIV_INTERN ulong	srv_doublewrite_batch_size	= 120;
 
+/** Number of pages in the doublewrite segment of each buffer pool instance
+in the file BUF_DBLWR_SEG_FILE_NAME. If zero, the batches of all the
+instances go through the doublewrite buffer above. */
+UNIV_INTERN ulong	srv_doublewrite_segment_size	= 0;
+
 UNIV_INTERN ulong	srv_replication_delay		= 0;
 
 UNIV_INTERN ulong	srv_pass_corrupt_table = 0; /* 0:disable 1:enable */
@@ -820,6 +836,12 @@ and/or load it during startup. */
 UNIV_INTERN char	srv_buffer_pool_dump_at_shutdown = FALSE;
 UNIV_INTERN char	srv_buffer_pool_load_at_startup = FALSE;
 
+/** Interval in seconds of the periodic buffer pool dumps, 0 if none */
+UNIV_INTERN ulong	srv_buf_dump_interval = 0;
+
+/** Number of threads that read pages during a buffer pool load */
+UNIV_INTERN ulong	srv_n_buf_load_threads = 4;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint	SRV_PURGE_SLOT	= 1;
 
@@ -1182,6 +1204,8 @@ srv_init(void)
 
 		srv_buf_dump_event = os_event_create();
 
+		buf_load_init();
+
 		srv_checkpoint_completed_event = os_event_create();
 
 		if (srv_track_changed_pages) {
@@ -1221,6 +1245,8 @@ srv_init(void)
 	/* Initialize some INFORMATION SCHEMA internal structures */
 	trx_i_s_cache_init(trx_i_s_cache);
 
+	fts_plist_cache_init();
+
 	ut_crc32_init();
 
 	dict_mem_init();
@@ -1242,9 +1268,13 @@ srv_free(void)
 
 	trx_i_s_cache_free(trx_i_s_cache);
 
+	fts_plist_cache_free();
+
 	if (!srv_read_only_mode) {
 		os_event_free(srv_buf_dump_event);
 		srv_buf_dump_event = NULL;
+
+		buf_load_free();
 	}
 }
 
@@ -1589,6 +1619,7 @@ srv_printf_innodb_monitor(
 		srv_conc_get_waiting_threads());
 
 	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	fprintf(file, "%lu read views open inside InnoDB\n",
 		UT_LIST_GET_LEN(trx_sys->view_list));
@@ -1612,6 +1643,7 @@ srv_printf_innodb_monitor(
 		}
 	}
 
+	mutex_exit(&trx_sys->view_mutex);
 	mutex_exit(&trx_sys->mutex);
 
 	n_reserved = fil_space_get_n_reserved_extents(0);
@@ -1951,6 +1983,9 @@ srv_export_innodb_status(void)
 
 	export_vars.innodb_rows_deleted = srv_stats.n_rows_deleted;
 
+	export_vars.innodb_prefetch_cache_refills =
+		srv_stats.n_prefetch_cache_refills;
+
 	export_vars.innodb_system_rows_read = srv_stats.n_system_rows_read;
 
 	export_vars.innodb_system_rows_inserted =
@@ -2085,7 +2120,7 @@ DECLARE_THREAD(srv_monitor_thread)(
 		if (srv_print_innodb_monitor) {
 			/* Reset mutex_skipped counter everytime
 			srv_print_innodb_monitor changes. This is to
-			ensure we will not be blocked by lock_sys->mutex
+			ensure we will not be blocked by lock_sys->latch
 			for short duration information printing,
 			such as requested by sync_array_print_long_waits() */
 			if (!last_srv_print_monitor) {
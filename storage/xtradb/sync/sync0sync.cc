@@ -1266,7 +1266,10 @@ sync_thread_add_level(
 	case SYNC_THREADS:
 	case SYNC_LOCK_SYS:
 	case SYNC_LOCK_WAIT_SYS:
+	case SYNC_LOCK_DEADLOCK:
+	case SYNC_LOCK_REC_HASH:
 	case SYNC_TRX_SYS:
+	case SYNC_READ_VIEW:
 	case SYNC_IBUF_BITMAP_MUTEX:
 	case SYNC_RSEG:
 	case SYNC_TRX_UNDO:
@@ -1289,7 +1292,7 @@ sync_thread_add_level(
 		}
 		break;
 	case SYNC_TRX:
-		/* Either the thread must own the lock_sys->mutex, or
+		/* Either the thread must own the lock_sys->latch, or
 		it is allowed to own only ONE trx->mutex. */
 		if (!sync_thread_levels_g(array, level, FALSE)) {
 			ut_a(sync_thread_levels_g(array, level - 1, TRUE));
@@ -133,6 +133,8 @@ trx_purge_sys_create(
 
 	purge_sys->heap = mem_heap_create(256);
 
+	purge_sys->group_hash = hash_create(1024);
+
 	ut_a(n_purge_threads > 0);
 
 	purge_sys->sess = sess_open();
@@ -184,6 +186,8 @@ trx_purge_sys_close(void)
 
 	mem_heap_free(purge_sys->heap);
 
+	hash_table_free(purge_sys->group_hash);
+
 	ib_bh_free(purge_sys->ib_bh);
 
 	os_event_free(purge_sys->event);
@@ -838,9 +842,7 @@ trx_purge_get_next_rec(
 	rec2 = rec;
 
 	for (;;) {
-		ulint		type;
 		trx_undo_rec_t*	next_rec;
-		ulint		cmpl_info;
 
 		/* Try first to find the next record which requires a purge
 		operation from the same page of the same undo log */
@@ -857,21 +859,7 @@ trx_purge_get_next_rec(
 
 		rec2 = next_rec;
 
-		type = trx_undo_rec_get_type(rec2);
-
-		if (type == TRX_UNDO_DEL_MARK_REC) {
-
-			break;
-		}
-
-		cmpl_info = trx_undo_rec_get_cmpl_info(rec2);
-
-		if (trx_undo_rec_get_extern_storage(rec2)) {
-			break;
-		}
-
-		if ((type == TRX_UNDO_UPD_EXIST_REC)
-		    && !(cmpl_info & UPD_NODE_NO_ORD_CHANGE)) {
+		if (trx_undo_rec_needs_purge(rec2)) {
 			break;
 		}
 	}
@@ -960,7 +948,76 @@ trx_purge_fetch_next_rec(
 }
 
 /*******************************************************************//**
-This function runs a purge batch.
+Adds a fetched undo log record to the group of its table in the current
+purge batch, starting a new group if the table has none or its group
+is full. */
+static
+void
+trx_purge_add_rec_to_group(
+/*=======================*/
+	trx_purge_t*	purge_sys,	/*!< in/out: purge instance */
+	trx_undo_rec_t*	undo_rec,	/*!< in: record to purge */
+	roll_ptr_t	roll_ptr)	/*!< in: roll pointer to the record */
+{
+	trx_purge_group_t*	group;
+	trx_purge_rec_t		purge_rec;
+	ulint			type;
+	ulint			cmpl_info;
+	bool			updated_extern;
+	undo_no_t		undo_no;
+	table_id_t		table_id;
+	ulint			fold;
+
+	trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info,
+			      &updated_extern, &undo_no, &table_id);
+
+	fold = ut_fold_ull(table_id);
+
+	HASH_SEARCH(hash, purge_sys->group_hash, fold,
+		    trx_purge_group_t*, group, ut_ad(1),
+		    group->table_id == table_id);
+
+	if (group != NULL
+	    && ib_vector_size(group->recs) >= TRX_PURGE_GROUP_SIZE) {
+
+		HASH_DELETE(trx_purge_group_t, hash, purge_sys->group_hash,
+			    fold, group);
+
+		group = NULL;
+	}
+
+	if (group == NULL) {
+		group = static_cast<trx_purge_group_t*>(
+			mem_heap_alloc(purge_sys->heap, sizeof(*group)));
+
+		group->table_id = table_id;
+		group->recs = ib_vector_create(
+			ib_heap_allocator_create(purge_sys->heap),
+			sizeof(trx_purge_rec_t), TRX_PURGE_GROUP_SIZE);
+		group->n_lag = 0;
+
+		HASH_INSERT(trx_purge_group_t, hash, purge_sys->group_hash,
+			    fold, group);
+
+		ib_vector_push(purge_sys->groups, &group);
+	}
+
+	purge_rec.undo_rec = undo_rec;
+	purge_rec.roll_ptr = roll_ptr;
+
+	ib_vector_push(group->recs, &purge_rec);
+
+	/* Only the records that purge has work for were counted in
+	the purge lag of the table when they were written. */
+	if (trx_undo_rec_needs_purge(undo_rec)) {
+		group->n_lag++;
+	}
+}
+
+/*******************************************************************//**
+Fetches the undo log records of a purge batch and splits them into
+groups of records of the same table, which the purge threads claim
+with trx_purge_claim_group().
 @return	number of undo log pages handled in the batch */
 static
 ulint
@@ -974,7 +1031,6 @@ trx_purge_attach_undo_recs(
 	que_thr_t*	thr;
 	ulint		i = 0;
 	ulint		n_pages_handled = 0;
-	ulint		n_thrs = UT_LIST_GET_LEN(purge_sys->query->thrs);
 
 	ut_a(n_purge_threads > 0);
 
@@ -991,7 +1047,9 @@ trx_purge_attach_undo_recs(
 		node = (purge_node_t*) thr->child;
 
 		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
+		ut_a(!thr->is_active);
 		ut_a(node->undo_recs == NULL);
+		ut_a(node->group == NULL);
 		ut_a(node->done);
 
 		node->done = FALSE;
@@ -1001,27 +1059,19 @@ trx_purge_attach_undo_recs(
 	however is allowed because we only use purge threads as needed. */
 	ut_a(i == n_purge_threads);
 
-	/* Fetch and parse the UNDO records. The UNDO records are added
-	to a per purge node vector. */
-	thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
-	ut_a(n_thrs > 0 && thr != NULL);
+	/* The groups are allocated from purge_sys->heap, which was
+	emptied when the batch started. */
+	purge_sys->groups = ib_vector_create(
+		ib_heap_allocator_create(purge_sys->heap),
+		sizeof(trx_purge_group_t*), 16);
+	purge_sys->n_groups_claimed = 0;
+	hash_table_clear(purge_sys->group_hash);
 
 	ut_ad(trx_purge_check_limit());
 
-	i = 0;
-
 	for (;;) {
-		purge_node_t*		node;
-		trx_purge_rec_t*	purge_rec;
-
-		ut_a(!thr->is_active);
-
-		/* Get the purge node. */
-		node = (purge_node_t*) thr->child;
-		ut_a(que_node_get_type(node) == QUE_NODE_PURGE);
-
-		purge_rec = static_cast<trx_purge_rec_t*>(
-			mem_heap_zalloc(node->heap, sizeof(*purge_rec)));
+		trx_undo_rec_t*	undo_rec;
+		roll_ptr_t	roll_ptr;
 
 		/* Track the max {trx_id, undo_no} for truncating the
 		UNDO logs once we have purged the records. */
@@ -1034,37 +1084,24 @@ trx_purge_attach_undo_recs(
 		}
 
 		/* Fetch the next record, and advance the purge_sys->iter. */
-		purge_rec->undo_rec = trx_purge_fetch_next_rec(
-			&purge_rec->roll_ptr, &n_pages_handled, node->heap);
-
-		if (purge_rec->undo_rec != NULL) {
-
-			if (node->undo_recs == NULL) {
-				node->undo_recs = ib_vector_create(
-					ib_heap_allocator_create(node->heap),
-					sizeof(trx_purge_rec_t),
-					batch_size);
-			} else {
-				ut_a(!ib_vector_is_empty(node->undo_recs));
-			}
+		undo_rec = trx_purge_fetch_next_rec(
+			&roll_ptr, &n_pages_handled, purge_sys->heap);
 
-			ib_vector_push(node->undo_recs, purge_rec);
-
-			if (n_pages_handled >= batch_size) {
-
-				break;
-			}
-		} else {
+		if (undo_rec == NULL) {
 			break;
 		}
 
-		thr = UT_LIST_GET_NEXT(thrs, thr);
-
-		if (!(++i % n_purge_threads)) {
-			thr = UT_LIST_GET_FIRST(purge_sys->query->thrs);
+		/* The dummy record stands for an undo log that needs
+		no purge: there is nothing to hand to the threads. */
+		if (undo_rec != &trx_purge_dummy_rec) {
+			trx_purge_add_rec_to_group(
+				purge_sys, undo_rec, roll_ptr);
 		}
 
-		ut_a(thr != NULL);
+		if (n_pages_handled >= batch_size) {
+
+			break;
+		}
 	}
 
 	ut_ad(trx_purge_check_limit());
@@ -1072,6 +1109,60 @@ trx_purge_attach_undo_recs(
 	return(n_pages_handled);
 }
 
+/*******************************************************************//**
+Claims the next group of undo log records of the current purge batch for
+a purge thread. The purge threads claim the groups without waiting for
+each other or for the purge coordinator, so that a thread that is done
+with its groups takes over work that would otherwise wait for a busier
+thread.
+@return group, or NULL if all the groups of the batch have been claimed */
+UNIV_INTERN
+trx_purge_group_t*
+trx_purge_claim_group(void)
+/*=======================*/
+{
+	ulint	i = os_atomic_increment_ulint(
+		&purge_sys->n_groups_claimed, 1) - 1;
+
+	if (i >= ib_vector_size(purge_sys->groups)) {
+		return(NULL);
+	}
+
+	return(*static_cast<trx_purge_group_t**>(
+		       ib_vector_get(purge_sys->groups, i)));
+}
+
+/*******************************************************************//**
+Subtracts the records of a purged group from the purge lag of their
+table, if the table is in the dictionary cache. */
+UNIV_INTERN
+void
+trx_purge_group_done(
+/*=================*/
+	const trx_purge_group_t*	group)	/*!< in: purged group */
+{
+	dict_table_t*	table;
+
+	if (group->n_lag == 0) {
+		return;
+	}
+
+	/* Prevent DROP TABLE etc. from running while we have the
+	table open, like row_purge_parse_undo_rec() does */
+	rw_lock_s_lock(&dict_operation_lock);
+
+	table = dict_table_open_on_id(
+		group->table_id, FALSE, DICT_TABLE_OP_OPEN_ONLY_IF_CACHED);
+
+	if (table != NULL) {
+		os_atomic_decrement_lint(&table->n_purge_lag, group->n_lag);
+
+		dict_table_close(table, FALSE, FALSE);
+	}
+
+	rw_lock_s_unlock(&dict_operation_lock);
+}
+
 /*******************************************************************//**
 Calculate the DML delay required.
 @return delay in microseconds or ULINT_MAX */
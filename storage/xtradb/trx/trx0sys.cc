@@ -122,6 +122,7 @@ static const ulint	FILE_FORMAT_NAME_N
 /* Key to register the mutex with performance schema */
 UNIV_INTERN mysql_pfs_key_t	file_format_max_mutex_key;
 UNIV_INTERN mysql_pfs_key_t	trx_sys_mutex_key;
+UNIV_INTERN mysql_pfs_key_t	trx_sys_view_mutex_key;
 #endif /* UNIV_PFS_RWLOCK */
 
 #ifndef UNIV_HOTBACKUP
@@ -643,13 +644,16 @@ trx_sys_init_at_db_start(void)
 	mtr_start(&mtr);
 
 	/* Allocate the trx descriptors array */
+	trx_sys->descr_heap = mem_heap_create(
+		sizeof(trx_id_t) * TRX_DESCR_ARRAY_INITIAL_SIZE);
 	trx_sys->descriptors = static_cast<trx_id_t*>(
-		ut_malloc(sizeof(trx_id_t) *
-			  TRX_DESCR_ARRAY_INITIAL_SIZE));
+		mem_heap_alloc(trx_sys->descr_heap,
+			       sizeof(trx_id_t)
+			       * TRX_DESCR_ARRAY_INITIAL_SIZE));
 	trx_sys->descr_n_max = TRX_DESCR_ARRAY_INITIAL_SIZE;
 	trx_sys->descr_n_used = 0;
-	srv_descriptors_memory = TRX_DESCR_ARRAY_INITIAL_SIZE *
-		sizeof(trx_id_t);
+	trx_sys->descr_min_no = TRX_ID_MAX;
+	srv_descriptors_memory = mem_heap_get_size(trx_sys->descr_heap);
 
 	sys_header = trx_sysf_get(&mtr);
 
@@ -737,6 +741,8 @@ trx_sys_create(void)
 	trx_sys = static_cast<trx_sys_t*>(mem_zalloc(sizeof(*trx_sys)));
 
 	mutex_create(trx_sys_mutex_key, &trx_sys->mutex, SYNC_TRX_SYS);
+	mutex_create(trx_sys_view_mutex_key, &trx_sys->view_mutex,
+		     SYNC_READ_VIEW);
 }
 
 /*****************************************************************//**
@@ -1312,7 +1318,7 @@ trx_sys_close(void)
 	/* Check that all read views are closed except read view owned
 	by a purge. */
 
-	mutex_enter(&trx_sys->mutex);
+	mutex_enter(&trx_sys->view_mutex);
 
 	if (UT_LIST_GET_LEN(trx_sys->view_list) > 1) {
 		fprintf(stderr,
@@ -1322,7 +1328,7 @@ trx_sys_close(void)
 			UT_LIST_GET_LEN(trx_sys->view_list) - 1);
 	}
 
-	mutex_exit(&trx_sys->mutex);
+	mutex_exit(&trx_sys->view_mutex);
 
 	sess_close(trx_dummy_sess);
 	trx_dummy_sess = NULL;
@@ -1356,6 +1362,8 @@ trx_sys_close(void)
 		}
 	}
 
+	mutex_enter(&trx_sys->view_mutex);
+
 	view = UT_LIST_GET_FIRST(trx_sys->view_list);
 
 	while (view != NULL) {
@@ -1369,6 +1377,9 @@ trx_sys_close(void)
 	}
 
 	ut_a(UT_LIST_GET_LEN(trx_sys->view_list) == 0);
+
+	mutex_exit(&trx_sys->view_mutex);
+
 	ut_a(UT_LIST_GET_LEN(trx_sys->ro_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->rw_trx_list) == 0);
 	ut_a(UT_LIST_GET_LEN(trx_sys->mysql_trx_list) == 0);
@@ -1376,9 +1387,10 @@ trx_sys_close(void)
 	mutex_exit(&trx_sys->mutex);
 
 	mutex_free(&trx_sys->mutex);
+	mutex_free(&trx_sys->view_mutex);
 
 	ut_ad(trx_sys->descr_n_used == 0);
-	ut_free(trx_sys->descriptors);
+	mem_heap_free(trx_sys->descr_heap);
 
 	mem_free(trx_sys);
 
@@ -128,7 +128,9 @@ trx_reserve_descriptor(
 	ulint		n_max;
 	trx_id_t*	descr;
 
-	ut_ad(mutex_own(&trx_sys->mutex) || srv_is_being_started);
+	ut_ad(srv_is_being_started
+	      || (mutex_own(&trx_sys->mutex)
+		  && (trx_sys->descr_version & 1)));
 	ut_ad(srv_is_being_started ||
 	      !trx_find_descriptor(trx_sys->descriptors,
 				   trx_sys->descr_n_used,
@@ -141,12 +143,22 @@ trx_reserve_descriptor(
 
 		n_max = n_max * 2;
 
-		trx_sys->descriptors = static_cast<trx_id_t*>(
-			ut_realloc(trx_sys->descriptors,
-				   n_max * sizeof(trx_id_t)));
+		descr = static_cast<trx_id_t*>(
+			mem_heap_alloc(trx_sys->descr_heap,
+				       n_max * sizeof(trx_id_t)));
 
+		memcpy(descr, trx_sys->descriptors,
+		       trx_sys->descr_n_used * sizeof(trx_id_t));
+
+		trx_sys->descriptors = descr;
 		trx_sys->descr_n_max = n_max;
-		srv_descriptors_memory = n_max * sizeof(trx_id_t);
+		srv_descriptors_memory = mem_heap_get_size(
+			trx_sys->descr_heap);
+
+		/* read_view_open_now_low() reads descr_n_used before
+		descriptors. It must not find the grown descr_n_used
+		together with the old array. */
+		os_wmb;
 	}
 
 	descr = trx_sys->descriptors + n_used - 1;
@@ -190,31 +202,43 @@ trx_release_descriptor(
 
 	ut_ad(mutex_own(&trx_sys->mutex));
 
+	descr = trx_find_descriptor(trx_sys->descriptors,
+				    trx_sys->descr_n_used,
+				    trx->id);
+
+	if (descr == NULL && !trx->in_trx_serial_list) {
+
+		return;
+	}
+
+	trx_sys_descr_change_begin();
+
 	if (UNIV_LIKELY(trx->in_trx_serial_list)) {
 
+		trx_t*	first;
+
 		UT_LIST_REMOVE(trx_serial_list, trx_sys->trx_serial_list,
 			       trx);
 		trx->in_trx_serial_list = false;
-	}
 
-	descr = trx_find_descriptor(trx_sys->descriptors,
-				    trx_sys->descr_n_used,
-				    trx->id);
+		first = UT_LIST_GET_FIRST(trx_sys->trx_serial_list);
+		trx_sys->descr_min_no = first != NULL ? first->no : TRX_ID_MAX;
+	}
 
-	if (UNIV_UNLIKELY(descr == NULL)) {
+	if (UNIV_LIKELY(descr != NULL)) {
 
-		return;
-	}
+		size = (trx_sys->descriptors + trx_sys->descr_n_used - 1
+			- descr) * sizeof(trx_id_t);
 
-	size = (trx_sys->descriptors + trx_sys->descr_n_used - 1 - descr) *
-		sizeof(trx_id_t);
+		if (UNIV_LIKELY(size > 0)) {
 
-	if (UNIV_LIKELY(size > 0)) {
+			ut_memmove(descr, descr + 1, size);
+		}
 
-		ut_memmove(descr, descr + 1, size);
+		trx_sys->descr_n_used--;
 	}
 
-	trx_sys->descr_n_used--;
+	trx_sys_descr_change_end();
 }
 
 /****************************************************************//**
@@ -1071,6 +1095,10 @@ trx_start_low(
 
 	trx->state = TRX_STATE_ACTIVE;
 
+	/* Read views must find the new id in the descriptors array
+	as soon as they can find it below trx_sys->max_trx_id. */
+	trx_sys_descr_change_begin();
+
 	trx->id = trx_sys_get_new_trx_id();
 
 	ut_ad(!trx->in_rw_trx_list);
@@ -1104,6 +1132,8 @@ trx_start_low(
 		trx_reserve_descriptor(trx);
 	}
 
+	trx_sys_descr_change_end();
+
 	ut_ad(trx_sys_validate_trx_list());
 
 	mutex_exit(&trx_sys->mutex);
@@ -1129,6 +1159,8 @@ trx_serialisation_number_get(
 
 	mutex_enter(&trx_sys->mutex);
 
+	trx_sys_descr_change_begin();
+
 	trx->no = trx_sys_get_new_trx_id();
 
 	if (UNIV_LIKELY(!trx->in_trx_serial_list)) {
@@ -1137,8 +1169,14 @@ trx_serialisation_number_get(
 				 trx);
 
 		trx->in_trx_serial_list = true;
+
+		if (UT_LIST_GET_LEN(trx_sys->trx_serial_list) == 1) {
+			trx_sys->descr_min_no = trx->no;
+		}
 	}
 
+	trx_sys_descr_change_end();
+
 	/* If the rollack segment is not empty then the
 	new trx_t::no can't be less than any trx_t::no
 	already in the rollback segment. User threads only
@@ -1418,7 +1456,7 @@ trx_commit_in_memory(
 
 		trx->state = TRX_STATE_NOT_STARTED;
 
-		read_view_remove(trx->global_read_view, false);
+		read_view_remove(trx->global_read_view);
 
 		MONITOR_INC(MONITOR_TRX_NL_RO_COMMIT);
 	} else {
@@ -1453,13 +1491,11 @@ trx_commit_in_memory(
 
 		trx->state = TRX_STATE_NOT_STARTED;
 
-		/* We already own the trx_sys_t::mutex, by doing it here we
-		avoid a potential context switch later. */
-		read_view_remove(trx->global_read_view, true);
-
 		ut_ad(trx_sys_validate_trx_list());
 
 		mutex_exit(&trx_sys->mutex);
+
+		read_view_remove(trx->global_read_view);
 	}
 
 	if (trx->global_read_view != NULL) {
@@ -1746,7 +1782,6 @@ trx_clone_read_view(
 	trx_t*	from_trx)	/*!< in: donor transaction */
 {
 	ut_ad(lock_mutex_own());
-	ut_ad(mutex_own(&trx_sys->mutex));
 	ut_ad(trx_mutex_own(from_trx));
 	ut_ad(trx->read_view == NULL);
 
@@ -1756,11 +1791,15 @@ trx_clone_read_view(
 		return(NULL);
 	}
 
+	mutex_enter(&trx_sys->view_mutex);
+
 	trx->read_view = read_view_clone(from_trx->read_view,
 					 trx->prebuilt_view);
 
 	read_view_add(trx->read_view);
 
+	mutex_exit(&trx_sys->view_mutex);
+
 	trx->global_read_view = trx->read_view;
 
 	return(trx->read_view);
@@ -2127,7 +2166,7 @@ trx_print_low(
 
 /**********************************************************************//**
 Prints info about a transaction.
-The caller must hold lock_sys->mutex and trx_sys->mutex.
+The caller must hold lock_sys->latch and trx_sys->mutex.
 When possible, use trx_print() instead. */
 UNIV_INTERN
 void
@@ -2149,7 +2188,7 @@ trx_print_latched(
 
 /**********************************************************************//**
 Prints info about a transaction.
-Acquires and releases lock_sys->mutex and trx_sys->mutex. */
+Acquires and releases lock_sys->latch and trx_sys->mutex. */
 UNIV_INTERN
 void
 trx_print(
@@ -2195,7 +2234,7 @@ trx_assert_started(
 	/* trx->state can change from or to NOT_STARTED while we are holding
 	trx_sys->mutex for non-locking autocommit selects but not for other
 	types of transactions. It may change from ACTIVE to PREPARED. Unless
-	we are holding lock_sys->mutex, it may also change to COMMITTED. */
+	we are holding lock_sys->latch, it may also change to COMMITTED. */
 
 	switch (trx->state) {
 	case TRX_STATE_PREPARED:
@@ -2433,7 +2472,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 static __attribute__((nonnull, warn_unused_result))
 trx_t*
 trx_get_trx_by_xid_low(
@@ -2479,7 +2518,7 @@ This function is used to find one X/Open XA distributed transaction
 which is in the prepared state
 @return	trx or NULL; on match, the trx->xid will be invalidated;
 note that the trx may have been committed, unless the caller is
-holding lock_sys->mutex */
+holding lock_sys->latch */
 UNIV_INTERN
 trx_t*
 trx_get_trx_by_xid(
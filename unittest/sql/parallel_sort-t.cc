@@ -0,0 +1,156 @@
+/*
+   Copyright (c) 2015, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+/*
+  Tests and times parallel_sort_keys() and radixsort_for_key_prefix()
+  against the my_qsort2() sort of a filesort buffer.
+
+  The number of keys can be given as the first argument, e.g.
+    parallel_sort-t 10000000
+*/
+#include <my_global.h>
+#include <my_pthread.h>
+#include <my_sys.h>
+
+#include <stdio.h>
+
+#include <tap.h>
+
+#include "../sql/filesort_utils.cc"
+
+static const size_t key_lengths[]= { 8, 32 };
+static const uint thread_counts[]= { 2, 4, 8 };
+
+/* 1100 keys of 1024 bytes overflowed the stack of a recursive sort */
+static const size_t deep_count= 1100, deep_length= 1024;
+
+static uchar *key_data;
+static uchar **keys, **sorted_keys, **work_buffer;
+
+/* Fills the keys with the same pseudo random bytes on every call */
+static void fill_keys(size_t count, size_t key_length)
+{
+  uint32 seed= 1;
+  for (size_t i= 0; i < count; i++)
+  {
+    keys[i]= key_data + i * key_length;
+    for (size_t j= 0; j < key_length; j++)
+    {
+      seed= seed * 1103515245 + 12345;
+      keys[i][j]= (uchar) (seed >> 24);
+    }
+  }
+}
+
+/* Returns TRUE if the keys pointed to by a and b come in the same order */
+static bool same_order(uchar **a, uchar **b, size_t count, size_t key_length)
+{
+  for (size_t i= 0; i < count; i++)
+  {
+    if (memcmp(a[i], b[i], key_length))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+  Fills the keys so that key i differs from the keys after it in byte
+  i % key_length. A radix sort that recursed into every bucket would go
+  key_length levels deep.
+*/
+static void fill_deep_keys(size_t count, size_t key_length)
+{
+  for (size_t i= 0; i < count; i++)
+  {
+    keys[i]= key_data + i * key_length;
+    bzero(keys[i], key_length);
+    keys[i][i % key_length]= (uchar) (1 + i / key_length);
+  }
+}
+
+static double msec_since(ulonglong start)
+{
+  return (my_interval_timer() - start) / 1e6;
+}
+
+int main(int argc, char **argv)
+{
+  size_t count= argc > 1 ? (size_t) atol(argv[1]) : 1000000;
+  size_t max_length= key_lengths[array_elements(key_lengths) - 1];
+
+  MY_INIT(argv[0]);
+  plan(array_elements(key_lengths) * (array_elements(thread_counts) + 1) + 1);
+
+  key_data= (uchar *) my_malloc(MY_MAX(count * max_length,
+                                       deep_count * deep_length),
+                                MYF(MY_FAE));
+  keys= (uchar **) my_malloc(MY_MAX(count, deep_count) * sizeof(uchar*),
+                             MYF(MY_FAE));
+  sorted_keys= (uchar **) my_malloc(MY_MAX(count, deep_count) * sizeof(uchar*),
+                                    MYF(MY_FAE));
+  work_buffer= (uchar **) my_malloc(count * sizeof(uchar*), MYF(MY_FAE));
+
+  for (uint i= 0; i < array_elements(key_lengths); i++)
+  {
+    size_t key_length= key_lengths[i];
+    ulonglong start;
+
+    fill_keys(count, key_length);
+    memcpy(sorted_keys, keys, count * sizeof(uchar*));
+    start= my_interval_timer();
+    my_qsort2(sorted_keys, count, sizeof(uchar*), get_ptr_compare(key_length),
+              &key_length);
+    diag("%lu keys of %lu bytes, 1 thread: %.1f ms",
+         (ulong) count, (ulong) key_length, msec_since(start));
+
+    fill_keys(count, key_length);
+    start= my_interval_timer();
+    radixsort_for_key_prefix(keys, (uint) count, key_length, NULL,
+                             MYF(MY_FAE));
+    diag("%lu keys of %lu bytes, radix sort: %.1f ms",
+         (ulong) count, (ulong) key_length, msec_since(start));
+    ok(same_order(keys, sorted_keys, count, key_length),
+       "radix sort of %lu byte keys", (ulong) key_length);
+
+    for (uint j= 0; j < array_elements(thread_counts); j++)
+    {
+      uint threads= thread_counts[j];
+      fill_keys(count, key_length);
+      start= my_interval_timer();
+      parallel_sort_keys(keys, count, key_length, threads, work_buffer);
+      diag("%lu keys of %lu bytes, %u threads: %.1f ms",
+           (ulong) count, (ulong) key_length, threads, msec_since(start));
+      ok(same_order(keys, sorted_keys, count, key_length),
+         "%u threads sort %lu byte keys", threads, (ulong) key_length);
+    }
+  }
+
+  fill_deep_keys(deep_count, deep_length);
+  memcpy(sorted_keys, keys, deep_count * sizeof(uchar*));
+  my_qsort2(sorted_keys, deep_count, sizeof(uchar*),
+            get_ptr_compare(deep_length), (void*) &deep_length);
+  radixsort_for_key_prefix(keys, (uint) deep_count, deep_length, NULL,
+                           MYF(MY_FAE));
+  ok(same_order(keys, sorted_keys, deep_count, deep_length),
+     "radix sort of keys that differ in one byte each");
+
+  my_free(work_buffer);
+  my_free(sorted_keys);
+  my_free(keys);
+  my_free(key_data);
+  my_end(0);
+  return exit_status();
+}